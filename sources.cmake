@@ -124,6 +124,7 @@ src/karts/abstract_kart_animation.cpp
 src/karts/cannon_animation.cpp
 src/karts/controller/ai_base_controller.cpp
 src/karts/controller/ai_properties.cpp
+src/karts/controller/ai_scheduler.cpp
 src/karts/controller/controller.cpp
 src/karts/controller/end_controller.cpp
 src/karts/controller/network_player_controller.cpp
@@ -136,6 +137,7 @@ src/karts/kart_gfx.cpp
 src/karts/kart_model.cpp
 src/karts/kart_properties.cpp
 src/karts/kart_properties_manager.cpp
+src/karts/kart_spatial_index.cpp
 src/karts/kart_with_stats.cpp
 src/karts/max_speed.cpp
 src/karts/moveable.cpp
@@ -161,10 +163,16 @@ src/modes/world_with_rank.cpp
 src/network/client_network_manager.cpp
 src/network/event.cpp
 src/network/game_setup.cpp
+src/network/kart_interpolation_buffer.cpp
+src/network/kart_snapshot.cpp
+src/network/network_bot.cpp
 src/network/network_interface.cpp
 src/network/network_manager.cpp
+src/network/network_statistics.cpp
 src/network/network_string.cpp
 src/network/network_world.cpp
+src/network/packet_batch.cpp
+src/network/packet_capture.cpp
 src/network/protocol.cpp
 src/network/protocol_manager.cpp
 src/network/protocols/client_lobby_room_protocol.cpp
@@ -204,9 +212,11 @@ src/online/xml_request.cpp
 src/physics/btKart.cpp
 src/physics/btKartRaycast.cpp
 src/physics/btUprightConstraint.cpp
+src/physics/bvh_cache.cpp
 src/physics/irr_debug_drawer.cpp
 src/physics/physical_object.cpp
 src/physics/physics.cpp
+src/physics/physics_benchmark.cpp
 src/physics/triangle_mesh.cpp
 src/race/grand_prix_data.cpp
 src/race/grand_prix_manager.cpp
@@ -304,6 +314,7 @@ src/tracks/lod_node_loader.cpp
 src/tracks/quad.cpp
 src/tracks/quad_graph.cpp
 src/tracks/quad_set.cpp
+src/tracks/spatial_grid.cpp
 src/tracks/terrain_info.cpp
 src/tracks/track.cpp
 src/tracks/track_manager.cpp
@@ -324,6 +335,7 @@ src/utils/string_utils.cpp
 src/utils/time.cpp
 src/utils/translation.cpp
 src/utils/vec3.cpp
+src/utils/worker_pool.cpp
 )
 set(STK_HEADERS
 src/achievements/achievement.hpp
@@ -455,6 +467,7 @@ src/karts/abstract_kart_animation.hpp
 src/karts/cannon_animation.hpp
 src/karts/controller/ai_base_controller.hpp
 src/karts/controller/ai_properties.hpp
+src/karts/controller/ai_scheduler.hpp
 src/karts/controller/controller.hpp
 src/karts/controller/end_controller.hpp
 src/karts/controller/kart_control.hpp
@@ -468,6 +481,7 @@ src/karts/kart_gfx.hpp
 src/karts/kart_model.hpp
 src/karts/kart_properties.hpp
 src/karts/kart_properties_manager.hpp
+src/karts/kart_spatial_index.hpp
 src/karts/kart_with_stats.hpp
 src/karts/max_speed.hpp
 src/karts/moveable.hpp
@@ -489,13 +503,21 @@ src/modes/tutorial_world.hpp
 src/modes/world.hpp
 src/modes/world_status.hpp
 src/modes/world_with_rank.hpp
+src/network/bit_stream.hpp
 src/network/client_network_manager.hpp
 src/network/event.hpp
 src/network/game_setup.hpp
+src/network/kart_interpolation_buffer.hpp
+src/network/kart_snapshot.hpp
+src/network/network_bot.hpp
 src/network/network_interface.hpp
 src/network/network_manager.hpp
+src/network/network_statistics.hpp
 src/network/network_string.hpp
+src/network/network_string_view.hpp
 src/network/network_world.hpp
+src/network/packet_batch.hpp
+src/network/packet_capture.hpp
 src/network/protocol.hpp
 src/network/protocol_manager.hpp
 src/network/protocols/client_lobby_room_protocol.hpp
@@ -537,10 +559,12 @@ src/online/xml_request.hpp
 src/physics/btKart.hpp
 src/physics/btKartRaycast.hpp
 src/physics/btUprightConstraint.hpp
+src/physics/bvh_cache.hpp
 src/physics/irr_debug_drawer.hpp
 src/physics/kart_motion_state.hpp
 src/physics/physical_object.hpp
 src/physics/physics.hpp
+src/physics/physics_benchmark.hpp
 src/physics/stk_dynamics_world.hpp
 src/physics/triangle_mesh.hpp
 src/physics/user_pointer.hpp
@@ -642,6 +666,7 @@ src/tracks/lod_node_loader.hpp
 src/tracks/quad.hpp
 src/tracks/quad_graph.hpp
 src/tracks/quad_set.hpp
+src/tracks/spatial_grid.hpp
 src/tracks/terrain_info.hpp
 src/tracks/track.hpp
 src/tracks/track_manager.hpp
@@ -658,10 +683,12 @@ src/utils/helpers.hpp
 src/utils/interpolation_array.hpp
 src/utils/leak_check.hpp
 src/utils/log.hpp
+src/utils/mpsc_queue.hpp
 src/utils/no_copy.hpp
 src/utils/profiler.hpp
 src/utils/ptr_vector.hpp
 src/utils/random_generator.hpp
+src/utils/snapshot_buffer.hpp
 src/utils/string_utils.hpp
 src/utils/synchronised.hpp
 src/utils/time.hpp
@@ -669,4 +696,5 @@ src/utils/translation.hpp
 src/utils/types.hpp
 src/utils/vec3.hpp
 src/utils/vs.hpp
+src/utils/worker_pool.hpp
 )
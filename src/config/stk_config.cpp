@@ -179,7 +179,9 @@ void STKConfig::init_defaults()
     m_title_music                = NULL;
     m_enable_networking          = true;
     m_smooth_normals             = false;
+    m_quantized_bvh              = false;
     m_same_powerup_mode          = POWERUP_MODE_ONLY_IF_SAME;
+    m_broadphase                 = BROADPHASE_AXIS_SWEEP;
     m_ai_acceleration            = 1.0f;
     m_disable_steer_while_unskid = false;
     m_camera_follow_skid         = false;
@@ -246,6 +248,14 @@ void STKConfig::getAllData(const XMLNode * root)
     {
         physics_node->get("smooth-normals",     &m_smooth_normals    );
         physics_node->get("smooth-angle-limit", &m_smooth_angle_limit);
+        physics_node->get("quantized-bvh",      &m_quantized_bvh     );
+        std::string broadphase;
+        if(physics_node->get("broadphase", &broadphase) &&
+           !setBroadphase(broadphase))
+        {
+            Log::warn("StkConfig", "Invalid broadphase '%s' - ignored.",
+                      broadphase.c_str());
+        }
     }
 
     if (const XMLNode *startup_node= root->getNode("startup"))
@@ -402,3 +412,19 @@ void  STKConfig::getAllScores(std::vector<int> *all_scores, int num_karts)
         (*all_scores)[i] = (*all_scores)[i+1] + m_score_increase[i];
     }
 }   // getAllScores
+
+// ----------------------------------------------------------------------------
+/** Sets the broadphase used by the physics.
+ *  \param name Name of the broadphase: "axis-sweep" or "dbvt".
+ *  \return False if the name is unknown (the broadphase is not changed).
+ */
+bool STKConfig::setBroadphase(const std::string &name)
+{
+    if(name=="axis-sweep")
+        m_broadphase = BROADPHASE_AXIS_SWEEP;
+    else if(name=="dbvt")
+        m_broadphase = BROADPHASE_DBVT;
+    else
+        return false;
+    return true;
+}   // setBroadphase
@@ -59,6 +59,14 @@ public:
           POWERUP_MODE_ONLY_IF_SAME}
           m_same_powerup_mode;
 
+    /** The broadphase used by the physics:
+     *  - AXIS_SWEEP: sweep and prune over the track's bounding box.
+     *  - DBVT: dynamic AABB trees, which handles many fast moving objects
+     *          better and does not depend on the world size. */
+    enum {BROADPHASE_AXIS_SWEEP,
+          BROADPHASE_DBVT}
+          m_broadphase;
+
     static float UNDEFINED;
     float m_anvil_weight;              /**<Additional kart weight if anvil is
                                            attached.                           */
@@ -98,6 +106,8 @@ public:
      *  triangle are more than this value, the physics will use the normal
      *  of the triangle in smoothing normal. */
     float m_smooth_angle_limit;
+    bool  m_quantized_bvh;           /**< If the BVH of the track meshes
+                                      *  should use quantized AABBs.        */
     int   m_max_skidmarks;           /**<Maximum number of skid marks/kart.  */
     float m_skid_fadeout_time;       /**<Time till skidmarks fade away.      */
     float m_near_ground;             /**<Determines when a kart is not near
@@ -167,6 +177,7 @@ public:
     const std::string &getMainMenuPicture(int n);
     const std::string &getBackgroundPicture(int n);
     void  getAllScores(std::vector<int> *all_scores, int num_karts);
+    bool  setBroadphase(const std::string &name);
     // ------------------------------------------------------------------------
     /** Returns the default kart properties for each kart. */
     const KartProperties &
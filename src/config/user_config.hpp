@@ -347,6 +347,25 @@ namespace UserConfigParams
                             &m_race_setup_group,
                             "Game mode. 0=standard, 1=time trial, 2=follow "
                             "the leader, 3=3 strikes") );
+    PARAM_PREFIX IntUserConfigParam          m_ai_budget
+            PARAM_DEFAULT(  IntUserConfigParam(0, "ai_budget",
+                            &m_race_setup_group,
+                            "Time in microseconds per simulation step for the "
+                            "slowly changing AI decisions (items, crash "
+                            "lookahead, nearest karts). 0 means no limit.") );
+    PARAM_PREFIX IntUserConfigParam          m_ai_max_interval
+            PARAM_DEFAULT(  IntUserConfigParam(4, "ai_max_interval",
+                            &m_race_setup_group,
+                            "Maximum number of simulation steps between two "
+                            "updates of the slowly changing AI decisions of "
+                            "a kart, even if this exceeds ai_budget.") );
+    PARAM_PREFIX IntUserConfigParam          m_ai_threads
+            PARAM_DEFAULT(  IntUserConfigParam(0, "ai_threads",
+                            &m_race_setup_group,
+                            "Number of additional threads used to compute "
+                            "the AI decisions. 0 computes them in the main "
+                            "thread, -1 uses one thread per additional core. "
+                            "The results do not depend on this setting.") );
     PARAM_PREFIX StringUserConfigParam m_default_kart
             PARAM_DEFAULT( StringUserConfigParam("tux", "kart",
                            "Kart to select by default (the last used kart)") );
@@ -437,6 +456,11 @@ namespace UserConfigParams
     PARAM_PREFIX IntUserConfigParam         m_max_fps
             PARAM_DEFAULT(  IntUserConfigParam(120, "max_fps",
                        &m_video_group, "Maximum fps, should be at least 60") );
+    PARAM_PREFIX IntUserConfigParam         m_simulation_fps
+            PARAM_DEFAULT(  IntUserConfigParam(60, "simulation_fps",
+                       &m_video_group, "Number of simulation steps per second, "
+                       "independent of the frame rate. 0 simulates one step "
+                       "per frame.") );
 
     // ---- Debug - not saved to config file
     /** If gamepad debugging is enabled. */
@@ -482,6 +506,19 @@ namespace UserConfigParams
 
     PARAM_PREFIX bool m_race_now          PARAM_DEFAULT( false );
 
+    /** If not 0, the BVH of each loaded track is built in both modes, and
+     *  the memory usage and the time for this number of raycasts is
+     *  printed. */
+    PARAM_PREFIX int  m_bvh_benchmark     PARAM_DEFAULT( 0 );
+
+    /** If not 0, the physics benchmark is run for this number of steps
+     *  in profile mode instead of the race (see PhysicsBenchmark). */
+    PARAM_PREFIX int  m_physics_benchmark PARAM_DEFAULT( 0 );
+
+    /** File the results of the physics benchmark are written to, stdout
+     *  if empty. */
+    PARAM_PREFIX std::string m_physics_benchmark_file PARAM_DEFAULT( "" );
+
     /** True to test funky ambient/diffuse/specularity in RGB &
      *  all anisotropic */
     PARAM_PREFIX bool m_rendering_debug   PARAM_DEFAULT( false );
@@ -529,9 +566,23 @@ namespace UserConfigParams
                             "stun.voxgratia.org",
                             "stun.xten.com") );
 
-    PARAM_PREFIX StringUserConfigParam m_packets_log_filename
-            PARAM_DEFAULT( StringUserConfigParam("packets_log.txt", "packets_log_filename",
-                                                 "Where to log received and sent packets.") );
+    PARAM_PREFIX StringUserConfigParam m_packet_capture_filename
+            PARAM_DEFAULT( StringUserConfigParam("packet_capture.stkcap", "packet_capture_filename",
+                                                 "Binary file in which received and sent packets are "
+                                                 "captured (empty to disable). Use "
+                                                 "tools/decode_packet_capture.py to read it.") );
+
+    PARAM_PREFIX FloatUserConfigParam m_network_interpolation_delay
+            PARAM_DEFAULT( FloatUserConfigParam(0.2f, "network_interpolation_delay",
+                                                "Delay (in seconds) with which clients show remote karts, "
+                                                "used to interpolate between received positions. Kart "
+                                                "states are sent 10 times per second, so this should "
+                                                "be at least 0.2 to cover one late packet.") );
+
+    PARAM_PREFIX FloatUserConfigParam m_network_max_extrapolation
+            PARAM_DEFAULT( FloatUserConfigParam(0.25f, "network_max_extrapolation",
+                                                "Maximum time (in seconds) for which the position of "
+                                                "a remote kart is extrapolated if no update arrives.") );
 
     // ---- Graphic Quality
     PARAM_PREFIX GroupUserConfigParam        m_graphics_quality
@@ -345,7 +345,7 @@ void Camera::smoothMoveCamera(float dt, const Vec3 &wanted_position,
 void Camera::computeNormalCameraPosition(Vec3 *wanted_position,
                                          Vec3 *wanted_target)
 {
-    *wanted_target = m_kart->getXYZ();
+    *wanted_target = m_kart->getSmoothedXYZ();
     wanted_target->setY(wanted_target->getY()+ 0.75f);
 
     // This first line moves the camera around behind the kart, pointing it
@@ -361,7 +361,7 @@ void Camera::computeNormalCameraPosition(Vec3 *wanted_position,
     Vec3 relative_position(-m_distance*m_rotation_range*dampened_steer*0.5f,
                             m_distance*tan_up+0.75f,
                            -m_distance);
-    *wanted_position = m_kart->getTrans()(relative_position);
+    *wanted_position = m_kart->getSmoothedTrans()(relative_position);
 
 }   // computeNormalCameraPosition
 
@@ -455,7 +455,7 @@ void Camera::update(float dt)
     // high above the kart straight down.
     if (UserConfigParams::m_camera_debug==1)
     {
-        core::vector3df xyz = m_kart->getXYZ().toIrrVector();
+        core::vector3df xyz = m_kart->getSmoothedXYZ().toIrrVector();
         m_camera->setTarget(xyz);
         xyz.Y = xyz.Y+55;
         xyz.Z -= 5.0f;
@@ -480,7 +480,7 @@ void Camera::update(float dt)
 
         // Aim at the usual same position of the kart (i.e. slightly
         // above the kart).
-        core::vector3df wanted_target(m_kart->getXYZ().toIrrVector()
+        core::vector3df wanted_target(m_kart->getSmoothedXYZ().toIrrVector()
                                       +core::vector3df(0, above_kart, 0) );
         core::vector3df current_target   = m_camera->getTarget();
         // Note: this code is replicated from smoothMoveCamera so that
@@ -513,7 +513,7 @@ void Camera::positionCamera(float dt, float above_kart, float cam_angle,
                            float side_way, float distance, float smoothing)
 {
     Vec3 wanted_position;
-    Vec3 wanted_target = m_kart->getXYZ();
+    Vec3 wanted_target = m_kart->getSmoothedXYZ();
     if(UserConfigParams::m_camera_debug==2)
         wanted_target.setY(m_kart->getVehicle()->getWheelInfo(2).m_raycastInfo.m_contactPointWS.getY());
     else
@@ -522,7 +522,7 @@ void Camera::positionCamera(float dt, float above_kart, float cam_angle,
     Vec3 relative_position(side_way,
                            fabsf(distance)*tan_up+above_kart,
                            distance);
-    btTransform t=m_kart->getTrans();
+    btTransform t=m_kart->getSmoothedTrans();
     if(stk_config->m_camera_follow_skid &&
         m_kart->getSkidding()->getVisualSkidRotation()!=0)
     {
@@ -554,7 +554,7 @@ void Camera::positionCamera(float dt, float above_kart, float cam_angle,
     if (kart && !kart->isFlying())
     {
         // Rotate the up vector (0,1,0) by the rotation ... which is just column 1
-        Vec3 up = m_kart->getTrans().getBasis().getColumn(1);
+        Vec3 up = m_kart->getSmoothedTrans().getBasis().getColumn(1);
         float f = 0.04f;  // weight for new up vector to reduce shaking
         m_camera->setUpVector(f      * up.toIrrVector() +
             (1.0f - f) * m_camera->getUpVector());
@@ -574,7 +574,7 @@ void Camera::handleEndCamera(float dt)
     // First test if the kart is close enough to the next end camera, and
     // if so activate it.
     if( m_end_cameras.size()>0 &&
-        m_end_cameras[m_next_end_camera].isReached(m_kart->getXYZ()))
+        m_end_cameras[m_next_end_camera].isReached(m_kart->getSmoothedXYZ()))
     {
         m_current_end_camera = m_next_end_camera;
         if(m_end_cameras[m_current_end_camera].m_type
@@ -603,7 +603,7 @@ void Camera::handleEndCamera(float dt)
             // after changing the relative position in order to get the right
             // position here).
             const core::vector3df &cp = m_camera->getPosition();
-            const Vec3            &kp = m_kart->getXYZ();
+            const Vec3            &kp = m_kart->getSmoothedXYZ();
             // Estimate the fov, assuming that the vector from the camera to
             // the kart and the kart length are orthogonal to each other
             // --> tan (fov) = kart_length / camera_kart_distance
@@ -612,7 +612,7 @@ void Camera::handleEndCamera(float dt)
             float fov = 6*atan2(m_kart->getKartLength(),
                                 (cp-kp.toIrrVector()).getLength());
             m_camera->setFOV(fov);
-            m_camera->setTarget(m_kart->getXYZ().toIrrVector());
+            m_camera->setTarget(m_kart->getSmoothedXYZ().toIrrVector());
             break;
         }
     case EndCameraInformation::EC_AHEAD_OF_KART:
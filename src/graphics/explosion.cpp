@@ -33,18 +33,71 @@
 
 const float burst_time = 0.1f;
 
-/** Creates an explosion effect. */
-Explosion::Explosion(const Vec3& coord, const char* explosion_sound, const char * particle_file)
-                     : HitSFX(coord, explosion_sound)
+/** Creates an explosion effect.
+ *  \param coord Position of the explosion.
+ *  \param explosion_sound Name of the sfx to play.
+ *  \param particle_file The particles to use.
+ *  \param start If false the explosion is only created, but not shown
+ *         till reset() is called (see ProjectileManager::reset).
+ */
+Explosion::Explosion(const Vec3& coord, const char* explosion_sound,
+                     const char * particle_file, bool start)
+                     : HitSFX(coord, explosion_sound, start)
 {
+    m_sound           = explosion_sound;
+    m_particle_file   = particle_file;
     // short emision time, explosion, not constant flame
     m_remaining_time  = burst_time;
     
     ParticleKindManager* pkm = ParticleKindManager::get();
     ParticleKind* particles = pkm->getParticles(particle_file);
     m_emitter = new ParticleEmitter(particles, coord,  NULL);
+
+    const video::SMaterial &material = m_emitter->getNode()->getMaterial(0);
+    m_ambient_color   = material.AmbientColor;
+    m_diffuse_color   = material.DiffuseColor;
+    m_emissive_color  = material.EmissiveColor;
+
+    if(!start)
+        stop();
 }   // Explosion
 
+//-----------------------------------------------------------------------------
+/** Starts this explosion again at a new position. This is used to reuse
+ *  a finished explosion instead of creating a new one.
+ *  \param coord Position of the explosion.
+ */
+void Explosion::reset(const Vec3 &coord)
+{
+    HitSFX::reset(coord);
+    m_remaining_time  = burst_time;
+
+    scene::IParticleSystemSceneNode* node = m_emitter->getNode();
+    video::SMaterial &material = node->getMaterial(0);
+    material.AmbientColor  = m_ambient_color;
+    material.DiffuseColor  = m_diffuse_color;
+    material.EmissiveColor = m_emissive_color;
+
+    // Setting the same particle type again restores the emission rate.
+    m_emitter->setParticleType(m_emitter->getParticlesInfo());
+    m_emitter->setPosition(coord);
+    node->setVisible(true);
+}   // reset
+
+//-----------------------------------------------------------------------------
+/** Stops the sfx and the particle emission, and hides the particles. This
+ *  is used to keep an explosion to be reused later.
+ */
+void Explosion::stop()
+{
+    HitSFX::stop();
+    scene::IParticleSystemSceneNode* node = m_emitter->getNode();
+    node->getEmitter()->setMinParticlesPerSecond(0);
+    node->getEmitter()->setMaxParticlesPerSecond(0);
+    m_emitter->clearParticles();
+    node->setVisible(false);
+}   // stop
+
 //-----------------------------------------------------------------------------
 /** Destructor stops the explosion sfx from being played and frees its memory.
  */
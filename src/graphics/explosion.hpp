@@ -22,6 +22,9 @@
 #include "graphics/hit_sfx.hpp"
 #include "utils/no_copy.hpp"
 
+#include <SColor.h>
+#include <string>
+
 namespace irr
 {
     namespace scene { class IParticleSystemSceneNode;  }
@@ -43,10 +46,31 @@ private:
     float            m_remaining_time;
     ParticleEmitter* m_emitter;
 
+    /** Name of the sfx and of the particle file, used to find a matching
+     *  explosion to reuse. */
+    std::string      m_sound;
+    std::string      m_particle_file;
+
+    /** The original colours of the particles, which are faded out in
+     *  updateAndDelete, and restored when the explosion is reused. */
+    video::SColor    m_ambient_color;
+    video::SColor    m_diffuse_color;
+    video::SColor    m_emissive_color;
+
 public:
-         Explosion(const Vec3& coord, const char* explosion_sound, const char * particle_file );
+         Explosion(const Vec3& coord, const char* explosion_sound,
+                   const char * particle_file, bool start=true);
         ~Explosion();
+    void reset(const Vec3 &coord);
+    void stop();
     bool updateAndDelete(float delta_t);
+    // ------------------------------------------------------------------------
+    /** Returns true if this explosion uses the given sfx and particles. */
+    bool matches(const char *explosion_sound,
+                 const char *particle_file) const
+    {
+        return m_sound==explosion_sound && m_particle_file==particle_file;
+    }   // matches
     bool hasEnded () { return  m_remaining_time <= -explosion_time;  }
 
 } ;
@@ -113,24 +113,15 @@ void ParticleSystemProxy::setFlip() {
     delete[] quaternions;
 }
 
-void ParticleSystemProxy::setHeightmap(const std::vector<std::vector<float> > &hm,
+void ParticleSystemProxy::setHeightmap(const std::vector<float> &hm,
     float f1, float f2, float f3, float f4) {
     track_x = f1, track_z = f2, track_x_len = f3, track_z_len = f4;
 
-    unsigned width = hm.size();
-    unsigned height = hm[0].size();
-    float *hm_array = new float[width * height];
-    for (unsigned i = 0; i < width; i++)
-    {
-        for (unsigned j = 0; j < height; j++)
-        {
-            hm_array[i * height + j] = hm[i][j];
-        }
-    }
+    // The height map is already stored row by row in a flat array
     has_height_map = true;
     glGenBuffers(1, &heighmapbuffer);
     glBindBuffer(GL_TEXTURE_BUFFER, heighmapbuffer);
-    glBufferData(GL_TEXTURE_BUFFER, width * height * sizeof(float), hm_array, GL_STATIC_DRAW);
+    glBufferData(GL_TEXTURE_BUFFER, hm.size() * sizeof(float), &hm[0], GL_STATIC_DRAW);
     glGenTextures(1, &heightmaptexture);
     glBindTexture(GL_TEXTURE_BUFFER, heightmaptexture);
     glTexBuffer(GL_TEXTURE_BUFFER, GL_R32F, heighmapbuffer);
@@ -145,8 +136,6 @@ void ParticleSystemProxy::setHeightmap(const std::vector<std::vector<float> > &h
     HeightmapSimulationBind(tfb_buffers[1], initial_values_buffer);
 
     glBindVertexArray(0);
-
-    delete[] hm_array;
 }
 
 static
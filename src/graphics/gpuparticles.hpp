@@ -56,7 +56,7 @@ public:
     virtual void OnRegisterSceneNode();
     void setAlphaAdditive(bool);
     void setIncreaseFactor(float);
-    void setHeightmap(const std::vector<std::vector<float> >&, float, float, float, float);
+    void setHeightmap(const std::vector<float>&, float, float, float, float);
     void setFlip();
 };
 
@@ -36,6 +36,10 @@ private:
      *  less loud if only an AI is hit. */
     bool m_player_kart_hit;
 
+protected:
+    /** Resets this effect so that it can be reused. */
+    void reset() { m_player_kart_hit = false; }
+
 public:
                  /** Constructor for a hit effect. */
                  HitEffect() {m_player_kart_hit = false; }
@@ -22,11 +22,28 @@
 #include "audio/sfx_manager.hpp"
 #include "race/race_manager.hpp"
 
-/** Creates a sound effect when something was hit. */
-HitSFX::HitSFX(const Vec3& coord, const char* explosion_sound)
+/** Creates a sound effect when something was hit.
+ *  \param coord Where the sfx is played.
+ *  \param explosion_sound Name of the sfx.
+ *  \param play If false the sfx is only loaded, and started later with
+ *         reset() (used to prepare hit effects before a race).
+ */
+HitSFX::HitSFX(const Vec3& coord, const char* explosion_sound, bool play)
              : HitEffect()
 {
     m_sfx = sfx_manager->createSoundSource( explosion_sound );
+    if(play)
+        reset(coord);
+}   // HitSFX
+
+//-----------------------------------------------------------------------------
+/** Plays the sfx at the given position. This is also used to reuse a
+ *  finished hit effect.
+ *  \param coord Where the sfx is played.
+ */
+void HitSFX::reset(const Vec3 &coord)
+{
+    HitEffect::reset();
     m_sfx->position(coord);
 
     // in multiplayer mode, sounds are NOT positional (because we have
@@ -35,16 +52,23 @@ HitSFX::HitSFX(const Vec3& coord, const char* explosion_sound)
     float vol = race_manager->getNumLocalPlayers() > 1 ? 0.5f : 1.0f;
     m_sfx->volume(vol);
     m_sfx->play();
-}   // HitSFX
+}   // reset
 
 //-----------------------------------------------------------------------------
-/** Destructor stops the explosion sfx from being played and frees its memory.
+/** Stops the sfx if it is still playing.
  */
-HitSFX::~HitSFX()
+void HitSFX::stop()
 {
     if (m_sfx->getStatus() == SFXManager::SFX_PLAYING)
         m_sfx->stop();
+}   // stop
 
+//-----------------------------------------------------------------------------
+/** Destructor stops the explosion sfx from being played and frees its memory.
+ */
+HitSFX::~HitSFX()
+{
+    stop();
     sfx_manager->deleteSFX(m_sfx);
 }   // ~HitEffect
 
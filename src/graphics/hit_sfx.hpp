@@ -33,8 +33,11 @@ private:
     SFXBase*       m_sfx;
 
 public:
-         HitSFX(const Vec3& coord, const char* explosion_sound);
+         HitSFX(const Vec3& coord, const char* explosion_sound,
+                bool play=true);
         ~HitSFX();
+    void reset(const Vec3 &coord);
+    void stop();
     virtual bool updateAndDelete(float dt);
     virtual void setPlayerKartHit();
 
@@ -104,12 +104,13 @@ public:
 
 class HeightMapCollisionAffector : public scene::IParticleAffector
 {
-    std::vector< std::vector<float> > m_height_map;
+    /** The height map, which is owned and shared by the track. */
+    const std::vector<float> &m_height_map;
     Track* m_track;
     bool m_first_time;
 
 public:
-    HeightMapCollisionAffector(Track* t) : m_height_map(t->buildHeightMap())
+    HeightMapCollisionAffector(Track* t) : m_height_map(t->getHeightMap())
     {
         m_track = t;
         m_first_time = true;
@@ -134,12 +135,13 @@ public:
                                  /track_z_len*(HEIGHT_MAP_RESOLUTION) );
             if (i >= HEIGHT_MAP_RESOLUTION || j >= HEIGHT_MAP_RESOLUTION) continue;
             if (i < 0 || j < 0) continue;
+            const float height = m_height_map[i*HEIGHT_MAP_RESOLUTION+j];
 
             /*
             // debug draw
             core::vector3df lp = curr.pos;
             core::vector3df lp2 = curr.pos;
-            lp2.Y = m_height_map[i][j] + 0.02f;
+            lp2.Y = height + 0.02f;
 
             irr_driver->getVideoDriver()->draw3DLine(lp, lp2, video::SColor(255,255,0,0));
             core::vector3df lp3 = lp2;
@@ -154,13 +156,12 @@ public:
 
             if (m_first_time)
             {
-                curr.pos.Y = m_height_map[i][j]
-                           + (curr.pos.Y - m_height_map[i][j])
+                curr.pos.Y = height + (curr.pos.Y - height)
                                 *((rand()%500)/500.0f);
             }
             else
             {
-                if (curr.pos.Y < m_height_map[i][j])
+                if (curr.pos.Y < height)
                 {
                     //curr.color = video::SColor(255,255,0,0);
                     curr.endTime = curr.startTime; // destroy particle
@@ -593,7 +594,7 @@ void ParticleEmitter::addHeightMapAffector(Track* t)
         float track_z = aabb_min->getZ();
         const float track_x_len = aabb_max->getX() - aabb_min->getX();
         const float track_z_len = aabb_max->getZ() - aabb_min->getZ();
-        static_cast<ParticleSystemProxy *>(m_node)->setHeightmap(t->buildHeightMap(),
+        static_cast<ParticleSystemProxy *>(m_node)->setHeightmap(t->getHeightMap(),
             track_x, track_z, track_x_len, track_z_len);
     }
 }
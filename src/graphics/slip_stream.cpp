@@ -30,6 +30,7 @@
 #include "modes/world.hpp"
 #include "tracks/quad.hpp"
 #include "utils/constants.hpp"
+#include "utils/snapshot_buffer.hpp"
 
 #include <SMesh.h>
 #include <SMeshBuffer.h>
@@ -139,6 +140,36 @@ void SlipStream::reset()
     m_kart->increaseMaxSpeed(MaxSpeed::MS_INCREASE_SLIPSTREAM, 0, 0, 0, 0);
 }   // reset
 
+//-----------------------------------------------------------------------------
+/** Saves the slipstream state of the kart.
+ *  \param buffer The snapshot buffer to write to.
+ */
+void SlipStream::saveState(SnapshotBuffer *buffer) const
+{
+    buffer->add((int)m_slipstream_mode);
+    buffer->add(m_slipstream_time);
+    int target = m_target_kart ? m_target_kart->getWorldKartId() : -1;
+    buffer->add(target);
+}   // saveState
+
+//-----------------------------------------------------------------------------
+/** Restores the slipstream state of the kart.
+ *  \param buffer The snapshot buffer to read from.
+ */
+void SlipStream::restoreState(SnapshotBuffer *buffer)
+{
+    int mode, target;
+    buffer->get(&mode);
+    buffer->get(&m_slipstream_time);
+    buffer->get(&target);
+    if(m_slipstream_mode==SS_USE && mode!=SS_USE)
+        setIntensity(0, NULL);
+    m_slipstream_mode = mode==SS_USE     ? SS_USE
+                      : mode==SS_COLLECT ? SS_COLLECT : SS_NONE;
+    m_target_kart     = target>=0 ? World::getWorld()->getKart(target)
+                                  : NULL;
+}   // restoreState
+
 //-----------------------------------------------------------------------------
 /** Creates the mesh for the slipstream effect. This function creates a
  *  first a series of circles (with a certain number of vertices each and
@@ -391,10 +422,27 @@ void SlipStream::update(float dt)
 
     // Note that this loop can not be simply replaced with a shorter loop
     // using only the karts with a better position - since a kart might
-    // be a lap behind
-    for(unsigned int i=0; i<num_karts; i++)
+    // be a lap behind. But only karts close to this kart can give
+    // slipstream (see the quick test below), so they are taken from the
+    // kart spatial index - except in debug mode, where the debug color
+    // of all karts is updated.
+    if(UserConfigParams::m_slipstream_debug)
+    {
+        m_close_karts.resize(num_karts);
+        for(unsigned int i=0; i<num_karts; i++)
+            m_close_karts[i] = i;
+    }
+    else
+    {
+        KartSpatialIndex *index = world->getKartSpatialIndex();
+        float max_l = index->getMaxSlipstreamLength()
+                    + 0.5f*( index->getMaxKartLength()
+                            +m_kart->getKartLength()    );
+        index->getKartsInRange(m_kart->getXYZ(), max_l, &m_close_karts);
+    }
+    for(unsigned int j=0; j<m_close_karts.size(); j++)
     {
-        m_target_kart= world->getKart(i);
+        m_target_kart= world->getKart(m_close_karts[j]);
         // Don't test for slipstream with itself, a kart that is being
         // rescued or exploding, or an eliminated kart
         if(m_target_kart==m_kart               ||
@@ -450,7 +498,12 @@ void SlipStream::update(float dt)
             m_kart->getController()->isPlayerController())
             m_target_kart->getSlipstream()
                          ->setDebugColor(video::SColor(255, 0, 0, 255));
-    }   // for i < num_karts
+    }   // for j < m_close_karts.size()
+
+    // Same as looping over all karts: if no slipstream was found, the
+    // target is the last kart.
+    if(!is_sstreaming && num_karts>0)
+        m_target_kart = world->getKart(num_karts-1);
 
     if(!is_sstreaming)
     {
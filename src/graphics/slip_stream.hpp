@@ -20,6 +20,7 @@
 #define HEADER_SLIP_STREAM_HPP
 
 #include <matrix4.h>
+#include <vector>
 namespace irr
 {
     namespace video { class SMaterial; class SColor; }
@@ -32,6 +33,7 @@ using namespace irr;
 
 class AbstractKart;
 class Quad;
+class SnapshotBuffer;
 
 /**
   * \ingroup graphics
@@ -80,6 +82,10 @@ private:
      ** overtake the right kart. */
     AbstractKart* m_target_kart;
 
+    /** The world kart ids of the karts tested for slipstream in update,
+     *  kept here to avoid reallocating it every frame. */
+    std::vector<unsigned int> m_close_karts;
+
     void         createMesh(const video::SMaterial &m);
     void         setDebugColor(const video::SColor &color);
 public:
@@ -87,6 +93,8 @@ public:
     virtual     ~SlipStream  ();
     void         reset();
     virtual void update(float dt);
+    void         saveState(SnapshotBuffer *buffer) const;
+    void         restoreState(SnapshotBuffer *buffer);
     void         setIntensity(float f, const AbstractKart* kart);
     void         updateSlipstreamPower();
     bool         isSlipstreamReady() const;
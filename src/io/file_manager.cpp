@@ -942,6 +942,19 @@ std::string FileManager::getUserConfigFile(const std::string &fname) const
     return m_user_config_dir+fname;
 }   // getUserConfigFile
 
+//-----------------------------------------------------------------------------
+/** Returns the full path of a file in the directory in which data computed
+ *  from tracks (e.g. the BVH or the height map) is cached. The directory is
+ *  created if it does not exist.
+ *  \param name Name of the file.
+ */
+std::string FileManager::getCachedTrackFile(const std::string &name)
+{
+    std::string dir = m_user_config_dir+"track-cache";
+    checkAndCreateDirectory(dir);
+    return dir+"/"+name;
+}   // getCachedTrackFile
+
 //-----------------------------------------------------------------------------
 /** Returns the full path of a music file by searching all music search paths.
  *  It throws an exception if the file is not found.
@@ -39,6 +39,7 @@
 #include "physics/triangle_mesh.hpp"
 #include "tracks/track.hpp"
 #include "utils/constants.hpp"
+#include "utils/snapshot_buffer.hpp"
 
 /** Initialises the attachment each kart has.
  */
@@ -214,6 +215,57 @@ void Attachment::clear()
     m_kart->updateWeight();
 }   // clear
 
+// -----------------------------------------------------------------------------
+/** Saves the type of the attachment and its timers.
+ *  \param buffer The snapshot buffer to write to.
+ */
+void Attachment::saveState(SnapshotBuffer *buffer) const
+{
+    buffer->add(m_type);
+    buffer->add(m_time_left);
+    buffer->add(m_initial_speed);
+    buffer->add(m_node_scale);
+    int previous_owner = m_previous_owner
+                       ? m_previous_owner->getWorldKartId() : -1;
+    buffer->add(previous_owner);
+}   // saveState
+
+// -----------------------------------------------------------------------------
+/** Restores the attachment. If the type differs, the attachment is changed
+ *  (which also changes the weight of the kart for anvils). The state of an
+ *  attachment plugin (e.g. the swatter) starts from the beginning.
+ *  \param buffer The snapshot buffer to read from.
+ */
+void Attachment::restoreState(SnapshotBuffer *buffer)
+{
+    AttachmentType type;
+    float          time_left, initial_speed, node_scale;
+    int            previous_owner;
+    buffer->get(&type);
+    buffer->get(&time_left);
+    buffer->get(&initial_speed);
+    buffer->get(&node_scale);
+    buffer->get(&previous_owner);
+    AbstractKart *owner = previous_owner>=0
+                        ? World::getWorld()->getKart(previous_owner) : NULL;
+    if(type!=m_type)
+    {
+        if(type==ATTACH_NOTHING)
+            clear();
+        else
+        {
+            set(type, time_left, owner);
+            m_kart->updateWeight();
+        }
+    }
+    m_time_left      = time_left;
+    m_initial_speed  = initial_speed;
+    m_node_scale     = node_scale;
+    m_previous_owner = owner;
+    m_node->setScale(core::vector3df(m_node_scale, m_node_scale,
+                                     m_node_scale));
+}   // restoreState
+
 // -----------------------------------------------------------------------------
 /** Randomly selects the new attachment. For a server process, the
 *   attachment can be passed into this function.
@@ -247,7 +299,8 @@ void Attachment::hitBanana(Item *item, int new_attachment)
     case ATTACH_BOMB:
         {
         add_a_new_item = false;
-        HitEffect *he = new Explosion(m_kart->getXYZ(), "explosion", "explosion_bomb.xml");
+        HitEffect *he = projectile_manager->newExplosion(m_kart->getXYZ(),
+                                        "explosion", "explosion_bomb.xml");
         if(m_kart->getController()->isPlayerController())
             he->setPlayerKartHit();
         projectile_manager->addHitEffect(he);
@@ -445,7 +498,8 @@ void Attachment::update(float dt)
         }
         if(m_time_left<=0.0)
         {
-            HitEffect *he = new Explosion(m_kart->getXYZ(), "explosion", "explosion_bomb.xml");
+            HitEffect *he = projectile_manager->newExplosion(m_kart->getXYZ(),
+                                        "explosion", "explosion_bomb.xml");
             if(m_kart->getController()->isPlayerController())
                 he->setPlayerKartHit();
             projectile_manager->addHitEffect(he);
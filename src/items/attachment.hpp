@@ -30,6 +30,7 @@ using namespace irr;
 class AbstractKart;
 class Item;
 class SFXBase;
+class SnapshotBuffer;
 
 /** This objects is permanently available in a kart and stores information
  *  about addons. If a kart has no attachment, this object will have the
@@ -107,6 +108,8 @@ public:
          ~Attachment();
     void  clear ();
     void  hitBanana(Item *item, int new_attachment=-1);
+    void  saveState(SnapshotBuffer *buffer) const;
+    void  restoreState(SnapshotBuffer *buffer);
     void  update (float dt);
     void  handleCollisionWithKart(AbstractKart *other);
     void  set (AttachmentType type, float time,
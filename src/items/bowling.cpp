@@ -25,6 +25,7 @@
 #include "io/xml_node.hpp"
 #include "karts/abstract_kart.hpp"
 #include "utils/random_generator.hpp"
+#include "utils/snapshot_buffer.hpp"
 
 #include "utils/log.hpp" //TODO: remove after debugging is done
 
@@ -56,7 +57,6 @@ Bowling::Bowling(AbstractKart *kart)
     }
 
     createPhysics(y_offset, btVector3(0.0f, 0.0f, m_speed*2),
-                  new btSphereShape(0.5f*m_extend.getY()),
                   1.0f /*restitution*/,
                   -70.0f /*gravity*/,
                   true /*rotates*/);
@@ -82,6 +82,31 @@ Bowling::Bowling(AbstractKart *kart)
 
 }   // Bowling
 
+// -----------------------------------------------------------------------------
+/** Creates a bowling ball from a snapshot (see
+ *  ProjectileManager::restoreState). The position, velocities and speed
+ *  are all taken from the snapshot. The rolling sound is started, since
+ *  it is played for as long as the ball exists.
+ *  \param kart The kart that fired the ball.
+ *  \param buffer The snapshot buffer to read the state from.
+ */
+Bowling::Bowling(AbstractKart *kart, SnapshotBuffer *buffer)
+       : Flyable(kart, PowerupManager::POWERUP_BOWLING, 50.0f /* mass */)
+{
+    m_has_hit_kart = false;
+    createPhysics(0.0f, Vec3(0, 0, 0), 1.0f /*restitution*/,
+                  -70.0f /*gravity*/, true /*rotates*/);
+    setAdjustUpVelocity(false);
+    int flag = getBody()->getCollisionFlags();
+    flag = flag & (~ btCollisionObject::CF_NO_CONTACT_RESPONSE);
+    getBody()->setCollisionFlags(flag);
+
+    m_roll_sfx = sfx_manager->createSoundSource("bowling_roll");
+    m_roll_sfx->play();
+    m_roll_sfx->setLoop(true);
+    restoreState(buffer);
+}   // Bowling
+
 // ----------------------------------------------------------------------------
 /** Destructor, removes any playing sfx.
  */
@@ -100,6 +125,9 @@ Bowling::~Bowling()
 void Bowling::init(const XMLNode &node, scene::IMesh *bowling)
 {
     Flyable::init(node, bowling, PowerupManager::POWERUP_BOWLING);
+    const Vec3 &extend = m_st_extend[PowerupManager::POWERUP_BOWLING];
+    setShape(PowerupManager::POWERUP_BOWLING,
+             new btSphereShape(0.5f*extend.getY()));
     m_st_max_distance         = 20.0f;
     m_st_max_distance_squared = 20.0f * 20.0f;
     m_st_force_to_target      = 10.0f;
@@ -215,3 +243,25 @@ HitEffect* Bowling::getHitEffect() const
     else
         return new HitSFX(getXYZ(), "crash");
 }   // getHitEffect
+
+// ----------------------------------------------------------------------------
+/** Saves the state of the bowling ball (see Flyable::saveState).
+ *  \param buffer The snapshot buffer to write to.
+ */
+void Bowling::saveState(SnapshotBuffer *buffer) const
+{
+    Flyable::saveState(buffer);
+    buffer->add(m_has_hit_kart);
+    buffer->add(m_speed);
+}   // saveState
+
+// ----------------------------------------------------------------------------
+/** Restores the state saved with saveState.
+ *  \param buffer The snapshot buffer to read from.
+ */
+void Bowling::restoreState(SnapshotBuffer *buffer)
+{
+    Flyable::restoreState(buffer);
+    buffer->get(&m_has_hit_kart);
+    buffer->get(&m_speed);
+}   // restoreState
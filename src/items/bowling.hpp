@@ -51,10 +51,13 @@ private:
 
 public:
              Bowling(AbstractKart* kart);
+             Bowling(AbstractKart* kart, SnapshotBuffer *buffer);
     virtual ~Bowling();
     static  void init(const XMLNode &node, scene::IMesh *bowling);
     virtual bool updateAndDelete(float dt);
     virtual bool hit(AbstractKart* kart, PhysicalObject* obj=NULL);
+    virtual void saveState(SnapshotBuffer *buffer) const;
+    virtual void restoreState(SnapshotBuffer *buffer);
     virtual HitEffect *getHitEffect() const;
 
 
@@ -25,6 +25,7 @@
 #include "karts/abstract_kart.hpp"
 #include "utils/constants.hpp"
 #include "utils/random_generator.hpp"
+#include "utils/snapshot_buffer.hpp"
 
 #include "utils/log.hpp" //TODO: remove after debugging is done
 
@@ -90,7 +91,6 @@ Cake::Cake (AbstractKart *kart) : Flyable(kart, PowerupManager::POWERUP_CAKE)
         m_initial_velocity = Vec3(0.0f, up_velocity, m_speed);
 
         createPhysics(forward_offset, m_initial_velocity,
-                      new btCylinderShape(0.5f*m_extend),
                       0.5f /* restitution */, -m_gravity,
                       true /* rotation */, false /* backwards */, &trans);
     }
@@ -104,7 +104,6 @@ Cake::Cake (AbstractKart *kart) : Flyable(kart, PowerupManager::POWERUP_CAKE)
         m_initial_velocity = Vec3(0.0f, up_velocity, m_speed);
 
         createPhysics(forward_offset, m_initial_velocity,
-                      new btCylinderShape(0.5f*m_extend),
                       0.5f /* restitution */, -m_gravity,
                       true /* rotation */, backwards, &trans);
     }
@@ -119,6 +118,24 @@ Cake::Cake (AbstractKart *kart) : Flyable(kart, PowerupManager::POWERUP_CAKE)
 
 }   // Cake
 
+// -----------------------------------------------------------------------------
+/** Creates a cake from a snapshot (see ProjectileManager::restoreState).
+ *  Unlike the constructor above no target is selected, the position and
+ *  velocities are all taken from the snapshot.
+ *  \param kart The kart that fired the cake.
+ *  \param buffer The snapshot buffer to read the state from.
+ */
+Cake::Cake(AbstractKart *kart, SnapshotBuffer *buffer)
+    : Flyable(kart, PowerupManager::POWERUP_CAKE)
+{
+    m_target = NULL;
+    createPhysics(0.0f, Vec3(0, 0, 0), 0.5f /* restitution */, -m_gravity,
+                  true /* rotation */);
+    setAdjustUpVelocity(false);
+    m_body->setActivationState(DISABLE_DEACTIVATION);
+    restoreState(buffer);
+}   // Cake
+
 // -----------------------------------------------------------------------------
 /** Initialises the object from an entry in the powerup.xml file.
  *  \param node The xml node for this object.
@@ -127,6 +144,8 @@ Cake::Cake (AbstractKart *kart) : Flyable(kart, PowerupManager::POWERUP_CAKE)
 void Cake::init(const XMLNode &node, scene::IMesh *cake_model)
 {
     Flyable::init(node, cake_model, PowerupManager::POWERUP_CAKE);
+    const Vec3 &extend = m_st_extend[PowerupManager::POWERUP_CAKE];
+    setShape(PowerupManager::POWERUP_CAKE, new btCylinderShape(0.5f*extend));
     float max_distance        = 80.0f;
     m_gravity                 = 9.8f;
 
@@ -159,3 +178,23 @@ bool Cake::hit(AbstractKart* kart, PhysicalObject* obj)
 
     return was_real_hit;
 }   // hit
+
+// ----------------------------------------------------------------------------
+/** Saves the state of the cake (see Flyable::saveState).
+ *  \param buffer The snapshot buffer to write to.
+ */
+void Cake::saveState(SnapshotBuffer *buffer) const
+{
+    Flyable::saveState(buffer);
+    buffer->add(m_initial_velocity);
+}   // saveState
+
+// ----------------------------------------------------------------------------
+/** Restores the state saved with saveState.
+ *  \param buffer The snapshot buffer to read from.
+ */
+void Cake::restoreState(SnapshotBuffer *buffer)
+{
+    Flyable::restoreState(buffer);
+    buffer->get(&m_initial_velocity);
+}   // restoreState
@@ -48,8 +48,11 @@ private:
     Moveable*    m_target;
 public:
                  Cake (AbstractKart *kart);
+                 Cake (AbstractKart *kart, SnapshotBuffer *buffer);
     static  void init     (const XMLNode &node, scene::IMesh *cake_model);
     virtual bool hit(AbstractKart* kart, PhysicalObject* obj=NULL);
+    virtual void saveState(SnapshotBuffer *buffer) const;
+    virtual void restoreState(SnapshotBuffer *buffer);
     // ------------------------------------------------------------------------
     virtual void hitTrack ()                      { hit(NULL);               }
     // ------------------------------------------------------------------------
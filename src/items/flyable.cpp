@@ -35,9 +35,11 @@
 #include "karts/abstract_kart.hpp"
 #include "karts/explosion_animation.hpp"
 #include "modes/world.hpp"
+#include "physics/kart_motion_state.hpp"
 #include "physics/physics.hpp"
 #include "tracks/track.hpp"
 #include "utils/constants.hpp"
+#include "utils/snapshot_buffer.hpp"
 #include "utils/string_utils.hpp"
 #include "utils/vs.hpp"
 
@@ -48,6 +50,11 @@ float         Flyable::m_st_min_height  [PowerupManager::POWERUP_MAX];
 float         Flyable::m_st_max_height  [PowerupManager::POWERUP_MAX];
 float         Flyable::m_st_force_updown[PowerupManager::POWERUP_MAX];
 Vec3          Flyable::m_st_extend      [PowerupManager::POWERUP_MAX];
+btCollisionShape* Flyable::m_st_shape   [PowerupManager::POWERUP_MAX];
+std::vector<scene::ISceneNode*>
+              Flyable::m_st_free_nodes  [PowerupManager::POWERUP_MAX];
+std::vector<btRigidBody*>
+              Flyable::m_st_free_bodies [PowerupManager::POWERUP_MAX];
 // ----------------------------------------------------------------------------
 
 Flyable::Flyable(AbstractKart *kart, PowerupManager::PowerupType type,
@@ -72,16 +79,38 @@ Flyable::Flyable(AbstractKart *kart, PowerupManager::PowerupType type,
     m_owner_has_temporary_immunity = true;
     m_do_terrain_info              = true;
     m_max_lifespan = -1;
+    m_projectile_id                = 0;
 
-    // Add the graphical model
-    setNode(irr_driver->addMesh(m_st_model[type]));
-    irr_driver->applyObjectPassShader(getNode());
+    // Add the graphical model, reusing the node of a removed flyable
+    // of the same type if possible.
+    std::vector<scene::ISceneNode*> &free_nodes = m_st_free_nodes[type];
+    if(free_nodes.size()>0)
+    {
+        setNode(free_nodes.back());
+        free_nodes.pop_back();
+        getNode()->setScale(core::vector3df(1.0f, 1.0f, 1.0f));
+        getNode()->setVisible(true);
+    }
+    else
+    {
+        setNode(irr_driver->addMesh(m_st_model[type]));
+        irr_driver->applyObjectPassShader(getNode());
 #ifdef DEBUG
-    std::string debug_name("flyable: ");
-    debug_name += type;
-    getNode()->setName(debug_name.c_str());
+        std::string debug_name("flyable: ");
+        debug_name += type;
+        getNode()->setName(debug_name.c_str());
 #endif
+    }
 
+    // Likewise reuse a rigid body, which is then reinitialised in
+    // createBody (called from createPhysics).
+    std::vector<btRigidBody*> &free_bodies = m_st_free_bodies[type];
+    if(free_bodies.size()>0)
+    {
+        m_body         = free_bodies.back();
+        m_motion_state = (KartMotionState*)m_body->getMotionState();
+        free_bodies.pop_back();
+    }
 }   // Flyable
 
 // ----------------------------------------------------------------------------
@@ -90,7 +119,6 @@ Flyable::Flyable(AbstractKart *kart, PowerupManager::PowerupType type,
  *         positioned. Necessary to avoid exploding a rocket inside of the
  *         firing kart.
  *  \param velocity Initial velocity of the flyable.
- *  \param shape Collision shape of the flyable.
  *  \param gravity Gravity to use for this flyable.
  *  \param rotates True if the item should rotate, otherwise the angular factor
  *         is set to 0 preventing rotations from happening.
@@ -99,7 +127,6 @@ Flyable::Flyable(AbstractKart *kart, PowerupManager::PowerupType type,
  *         otherwise the kart's heading will be used.
  */
 void Flyable::createPhysics(float forw_offset, const Vec3 &velocity,
-                            btCollisionShape *shape,
                             float restitution, const float gravity,
                             const bool rotates, const bool turn_around,
                             const btTransform* custom_direction)
@@ -127,7 +154,8 @@ void Flyable::createPhysics(float forw_offset, const Vec3 &velocity,
 
     trans  *= offset_transform;
 
-    m_shape = shape;
+    m_shape = m_st_shape[m_type];
+    assert(m_shape);
     createBody(m_mass, trans, m_shape, restitution);
     m_user_pointer.set(this);
     World::getWorld()->getPhysics()->addBody(getBody());
@@ -192,11 +220,87 @@ void Flyable::init(const XMLNode &node, scene::IMesh *model,
     m_st_model[type]  = model;
 }   // init
 
+// ----------------------------------------------------------------------------
+/** Sets the collision shape used by all flyables of the given type. This
+ *  is called from the init function of each flyable type, after
+ *  Flyable::init has determined the size of the model.
+ *  \param type The type of flyable.
+ *  \param shape The new shape, which is then owned by this class.
+ */
+void Flyable::setShape(PowerupManager::PowerupType type,
+                       btCollisionShape *shape)
+{
+    if(m_st_shape[type]) delete m_st_shape[type];
+    m_st_shape[type] = shape;
+}   // setShape
+
+// ----------------------------------------------------------------------------
+/** Makes sure that at least n scene nodes and rigid bodies are available
+ *  for flyables of the given type, so that firing them during a race
+ *  does not need to create any. This is called when a race is started.
+ *  \param type The type of flyable.
+ *  \param n Number of flyables to prepare.
+ */
+void Flyable::preWarm(PowerupManager::PowerupType type, unsigned int n)
+{
+    std::vector<scene::ISceneNode*> &free_nodes = m_st_free_nodes[type];
+    while(free_nodes.size()<n)
+    {
+        scene::ISceneNode *node = irr_driver->addMesh(m_st_model[type]);
+        irr_driver->applyObjectPassShader(node);
+        node->setVisible(false);
+        free_nodes.push_back(node);
+    }
+
+    assert(m_st_shape[type]);
+    std::vector<btRigidBody*> &free_bodies = m_st_free_bodies[type];
+    while(free_bodies.size()<n)
+    {
+        btRigidBody::btRigidBodyConstructionInfo
+            info(0.0f, new KartMotionState(), m_st_shape[type]);
+        free_bodies.push_back(new btRigidBody(info));
+    }
+}   // preWarm
+
+// ----------------------------------------------------------------------------
+/** Frees all scene nodes and rigid bodies kept for reuse. This must be
+ *  done before the scene is cleared at the end of a race.
+ */
+void Flyable::clearPools()
+{
+    for(unsigned int type=0; type<PowerupManager::POWERUP_MAX; type++)
+    {
+        std::vector<scene::ISceneNode*> &free_nodes = m_st_free_nodes[type];
+        for(unsigned int i=0; i<free_nodes.size(); i++)
+            irr_driver->removeNode(free_nodes[i]);
+        free_nodes.clear();
+
+        std::vector<btRigidBody*> &free_bodies = m_st_free_bodies[type];
+        for(unsigned int i=0; i<free_bodies.size(); i++)
+        {
+            delete free_bodies[i]->getMotionState();
+            delete free_bodies[i];
+        }
+        free_bodies.clear();
+    }
+}   // clearPools
+
 //-----------------------------------------------------------------------------
+/** Removes the body from the physics, and keeps the body and the scene node
+ *  to be reused by the next flyable of this type. The collision shape is
+ *  shared by all flyables of this type and is not freed here.
+ */
 Flyable::~Flyable()
 {
-    if(m_shape) delete m_shape;
     World::getWorld()->getPhysics()->removeBody(getBody());
+
+    m_st_free_bodies[m_type].push_back(m_body);
+    m_body         = NULL;
+    m_motion_state = NULL;
+
+    m_node->setVisible(false);
+    m_st_free_nodes[m_type].push_back(m_node);
+    m_node         = NULL;
 }   // ~Flyable
 
 //-----------------------------------------------------------------------------
@@ -214,55 +318,71 @@ void Flyable::getClosestKart(const AbstractKart **minKart,
     btTransform trans_projectile = (inFrontOf != NULL ? inFrontOf->getTrans()
                                                       : getTrans());
 
-    *minDistSquared = 999999.9f;
-    *minKart = NULL;
-
     World *world = World::getWorld();
-    for(unsigned int i=0 ; i<world->getNumKarts(); i++ )
+    Vec3   origin = trans_projectile.getOrigin();
+
+    // Only test the karts close to the projectile, starting with a radius
+    // of 50 (if inFrontOf is defined, karts further away are ignored
+    // anyway). The distance computed below is never smaller than the 2d
+    // distance, so if the closest kart is within the radius, no kart
+    // outside of the radius can be closer. Otherwise the radius is doubled.
+    std::vector<unsigned int> karts;
+    for(float radius=50.0f; ; radius*=2)
     {
-        AbstractKart *kart = world->getKart(i);
-        // If a kart has star effect shown, the kart is immune, so
-        // it is not considered a target anymore.
-        if(kart->isEliminated() || kart == m_owner ||
-            kart->isInvulnerable()                 ||
-            kart->getKartAnimation()                   ) continue;
-        btTransform t=kart->getTrans();
-
-        Vec3 delta      = t.getOrigin()-trans_projectile.getOrigin();
-        // the Y distance is added again because karts above or below should//
-        // not be prioritized when aiming
-        float distance2 = delta.length2() + abs(t.getOrigin().getY()
-                        - trans_projectile.getOrigin().getY())*2;
-
-        if(inFrontOf != NULL)
+        *minDistSquared = 999999.9f;
+        *minKart = NULL;
+        bool all_karts = world->getKartSpatialIndex()
+                              ->getKartsInRange(origin, radius, &karts);
+        for(unsigned int j=0; j<karts.size(); j++)
         {
-            // Ignore karts behind the current one
-            Vec3 to_target       = kart->getXYZ() - inFrontOf->getXYZ();
-            const float distance = to_target.length();
-            if(distance > 50) continue; // kart too far, don't aim at it
-
-            btTransform trans = inFrontOf->getTrans();
-            // get heading=trans.getBasis*(0,0,1) ... so save the multiplication:
-            Vec3 direction(trans.getBasis().getColumn(2));
-            // Originally it used angle = to_target.angle( backwards ? -direction : direction );
-            // but sometimes due to rounding errors we get an acos(x) with x>1, causing
-            // an assertion failure. So we remove the whole acos() test here and copy the
-            // code from to_target.angle(...)
-            Vec3  v = backwards ? -direction : direction;
-            float s = sqrt(v.length2() * to_target.length2());
-            float c = to_target.dot(v)/s;
-            // Original test was: fabsf(acos(c))>1,  which is the same as
-            // c<cos(1) (acos returns values in [0, pi] anyway)
-            if(c<0.54) continue;
-        }
+            AbstractKart *kart = world->getKart(karts[j]);
+            // If a kart has star effect shown, the kart is immune, so
+            // it is not considered a target anymore.
+            if(kart->isEliminated() || kart == m_owner ||
+                kart->isInvulnerable()                 ||
+                kart->getKartAnimation()                   ) continue;
+            btTransform t=kart->getTrans();
+
+            Vec3 delta      = t.getOrigin()-trans_projectile.getOrigin();
+            // the Y distance is added again because karts above or below
+            // should not be prioritized when aiming
+            float distance2 = delta.length2() + abs(t.getOrigin().getY()
+                            - trans_projectile.getOrigin().getY())*2;
+
+            if(inFrontOf != NULL)
+            {
+                // Ignore karts behind the current one
+                Vec3 to_target       = kart->getXYZ() - inFrontOf->getXYZ();
+                const float distance = to_target.length();
+                if(distance > 50) continue; // kart too far, don't aim at it
+
+                btTransform trans = inFrontOf->getTrans();
+                // get heading=trans.getBasis*(0,0,1) ... so save the
+                // multiplication:
+                Vec3 direction(trans.getBasis().getColumn(2));
+                // Originally it used angle = to_target.angle( backwards ?
+                // -direction : direction ); but sometimes due to rounding
+                // errors we get an acos(x) with x>1, causing an assertion
+                // failure. So we remove the whole acos() test here and copy
+                // the code from to_target.angle(...)
+                Vec3  v = backwards ? -direction : direction;
+                float s = sqrt(v.length2() * to_target.length2());
+                float c = to_target.dot(v)/s;
+                // Original test was: fabsf(acos(c))>1,  which is the same
+                // as c<cos(1) (acos returns values in [0, pi] anyway)
+                if(c<0.54) continue;
+            }
 
-        if(distance2 < *minDistSquared)
-        {
-            *minDistSquared = distance2;
-            *minKart  = kart;
-            *minDelta = delta;
-        }
-    }  // for i<getNumKarts
+            if(distance2 < *minDistSquared)
+            {
+                *minDistSquared = distance2;
+                *minKart  = kart;
+                *minDelta = delta;
+            }
+        }  // for j<karts.size()
+        if(all_karts || inFrontOf || *minDistSquared<=radius*radius)
+            break;
+    }   // for radius
 
 }   // getClosestKart
 
@@ -408,6 +528,34 @@ bool Flyable::updateAndDelete(float dt)
     return false;
 }   // updateAndDelete
 
+// ----------------------------------------------------------------------------
+/** Saves the state of this flyable: the state of its rigid body and the
+ *  timers common to all flyables. The type and owner are saved by the
+ *  ProjectileManager.
+ *  \param buffer The snapshot buffer to write to.
+ */
+void Flyable::saveState(SnapshotBuffer *buffer) const
+{
+    Moveable::saveState(buffer);
+    buffer->add(m_has_hit_something);
+    buffer->add(m_time_since_thrown);
+    buffer->add(m_max_lifespan);
+    buffer->add(m_owner_has_temporary_immunity);
+}   // saveState
+
+// ----------------------------------------------------------------------------
+/** Restores the state saved with saveState.
+ *  \param buffer The snapshot buffer to read from.
+ */
+void Flyable::restoreState(SnapshotBuffer *buffer)
+{
+    Moveable::restoreState(buffer);
+    buffer->get(&m_has_hit_something);
+    buffer->get(&m_time_since_thrown);
+    buffer->get(&m_max_lifespan);
+    buffer->get(&m_owner_has_temporary_immunity);
+}   // restoreState
+
 // ----------------------------------------------------------------------------
 /** Returns true if the item hit the kart who shot it (to avoid that an item
  *  that's too close to the shooter hits the shooter).
@@ -483,7 +631,8 @@ void Flyable::explode(AbstractKart *kart_hit, PhysicalObject *object,
  */
 HitEffect* Flyable::getHitEffect() const
 {
-    return new Explosion(getXYZ(), "explosion", "explosion_cake.xml");
+    return projectile_manager->newExplosion(getXYZ(), "explosion",
+                                            "explosion_cake.xml");
 }   // getHitEffect
 
 // ----------------------------------------------------------------------------
@@ -24,11 +24,13 @@
 
 namespace irr
 {
-    namespace scene { class IMesh; }
+    namespace scene { class IMesh; class ISceneNode; }
 }
 #include <irrString.h>
 using namespace irr;
 
+#include <vector>
+
 #include "items/powerup_manager.hpp"
 #include "karts/moveable.hpp"
 #include "tracks/terrain_info.hpp"
@@ -64,6 +66,20 @@ private:
      *  terrain yourself (e.g. order of operations is important)
      *  set this to false with a call do setDoTerrainInfo(). */
     bool              m_do_terrain_info;
+
+    /** Identifies this flyable in snapshots (see
+     *  ProjectileManager::saveState). */
+    unsigned int      m_projectile_id;
+
+    /** Scene nodes of removed flyables for each type. They are reused by
+     *  new flyables of the same type instead of creating new nodes. */
+    static std::vector<scene::ISceneNode*>
+                      m_st_free_nodes[PowerupManager::POWERUP_MAX];
+
+    /** Rigid bodies (with their motion states) of removed flyables for
+     *  each type. They are reinitialised in place for new flyables. */
+    static std::vector<btRigidBody*>
+                      m_st_free_bodies[PowerupManager::POWERUP_MAX];
 protected:
     /** Kart which shot this flyable. */
     AbstractKart*     m_owner;
@@ -72,7 +88,8 @@ protected:
     PowerupManager::PowerupType
                       m_type;
 
-    /** Collision shape of this Flyable. */
+    /** Collision shape of this Flyable, shared with all flyables of the
+     *  same type. */
     btCollisionShape *m_shape;
 
     /** Maximum height above terrain. */
@@ -119,6 +136,9 @@ protected:
     /** Size of the model. */
     static Vec3       m_st_extend[PowerupManager::POWERUP_MAX];
 
+    /** The collision shape used by all flyables of a type. */
+    static btCollisionShape *m_st_shape[PowerupManager::POWERUP_MAX];
+
     /** Time since thrown. used so a kart can't hit himself when trying
      *  something, and also to put some time limit to some collectibles */
     float             m_time_since_thrown;
@@ -144,10 +164,12 @@ protected:
                                        float *fire_angle, float *up_velocity);
 
 
+    static void       setShape(PowerupManager::PowerupType type,
+                               btCollisionShape *shape);
+
     /** init bullet for moving objects like projectiles */
     void              createPhysics(float y_offset,
                                     const Vec3 &velocity,
-                                    btCollisionShape *shape,
                                     float restitution,
                                     const float gravity=0.0f,
                                     const bool rotates=false,
@@ -161,7 +183,12 @@ public:
     virtual     ~Flyable     ();
     static void  init        (const XMLNode &node, scene::IMesh *model,
                               PowerupManager::PowerupType type);
+    static void  preWarm     (PowerupManager::PowerupType type,
+                              unsigned int n);
+    static void  clearPools  ();
     virtual bool              updateAndDelete(float);
+    virtual void              saveState(SnapshotBuffer *buffer) const;
+    virtual void              restoreState(SnapshotBuffer *buffer);
     virtual HitEffect*        getHitEffect() const;
     bool                      isOwnerImmunity(const AbstractKart *kart_hit) const;
     virtual bool              hit(AbstractKart* kart, PhysicalObject* obj=NULL);
@@ -203,6 +230,12 @@ public:
     void setDoTerrainInfo(bool d) { m_do_terrain_info = d; }
     // ------------------------------------------------------------------------
     unsigned int getOwnerId();
+    // ------------------------------------------------------------------------
+    /** Sets the id used to identify this flyable in snapshots. */
+    void setProjectileId(unsigned int id) { m_projectile_id = id; }
+    // ------------------------------------------------------------------------
+    /** Returns the id used to identify this flyable in snapshots. */
+    unsigned int getProjectileId() const { return m_projectile_id; }
 };   // Flyable
 
 #endif
@@ -30,6 +30,7 @@
 #include "modes/world.hpp"
 #include "tracks/track.hpp"
 #include "utils/constants.hpp"
+#include "utils/snapshot_buffer.hpp"
 #include "utils/vec3.hpp"
 
 Item::Item(ItemType type, const Vec3& xyz, const Vec3& normal,
@@ -41,6 +42,7 @@ Item::Item(ItemType type, const Vec3& xyz, const Vec3& normal,
     initItem(type, xyz);
     // Sets heading to 0, and sets pitch and roll depending on the normal. */
     m_original_hpr      = Vec3(0, normal);
+    m_normal            = normal;
     m_original_mesh     = mesh;
     m_original_lowmesh  = lowres_mesh;
     m_listener          = NULL;
@@ -89,6 +91,7 @@ Item::Item(const Vec3& xyz, float distance, TriggerItemListener* trigger)
     initItem(ITEM_TRIGGER, xyz);
     // Sets heading to 0, and sets pitch and roll depending on the normal. */
     m_original_hpr      = Vec3(0, 0, 0);
+    m_normal            = Vec3(0, 1, 0);
     m_original_mesh     = NULL;
     m_original_lowmesh  = NULL;
     m_node              = NULL;
@@ -223,6 +226,51 @@ void Item::switchBack()
     m_node->setRotation(m_original_hpr.toIrrHPR());
 }   // switchBack
 
+//-----------------------------------------------------------------------------
+/** Reinitialises an item that was removed (see hide) so that it can be used
+ *  as a new item, avoiding to create new scene nodes. The item keeps its
+ *  meshes.
+ *  \param type Type of the item.
+ *  \param xyz Position of the item.
+ *  \param normal The normal of the terrain to set roll and pitch.
+ */
+void Item::reuse(ItemType type, const Vec3& xyz, const Vec3& normal)
+{
+    assert(m_node);
+    for(unsigned int i=0; i<2; i++)
+    {
+        if(m_avoidance_points[i])
+            delete m_avoidance_points[i];
+    }
+    initItem(type, xyz);
+    m_original_hpr      = Vec3(0, normal);
+    m_normal            = normal;
+
+    // The item might have been removed while it was switched.
+    scene::ISceneNode* node = m_node->getAllNodes()[0];
+    ((scene::IMeshSceneNode*)node)->setMesh(m_original_mesh);
+    if (m_original_lowmesh != NULL)
+    {
+        node = m_node->getAllNodes()[1];
+        ((scene::IMeshSceneNode*)node)->setMesh(m_original_lowmesh);
+    }
+    World::getWorld()->getTrack()->adjustForFog(m_node);
+
+    m_node->setPosition(xyz.toIrrVector());
+    m_node->setRotation(m_original_hpr.toIrrHPR());
+    m_node->setScale(core::vector3df(1,1,1));
+    m_node->setVisible(true);
+}   // reuse
+
+//-----------------------------------------------------------------------------
+/** Hides a removed item, which is kept by the item manager to be reused.
+ */
+void Item::hide()
+{
+    if (m_node != NULL)
+        m_node->setVisible(false);
+}   // hide
+
 //-----------------------------------------------------------------------------
 /** Removes an item.
  */
@@ -281,6 +329,54 @@ void Item::setParent(AbstractKart* parent)
     m_deactive_time = 1.5f;
 }   // setParent
 
+//-----------------------------------------------------------------------------
+/** Saves the state of this item that changes during a race. The type of
+ *  the item (including a switched type) is saved by the ItemManager.
+ *  \param buffer The snapshot buffer to write to.
+ */
+void Item::saveState(SnapshotBuffer *buffer) const
+{
+    buffer->add(m_collected);
+    buffer->add(m_time_till_return);
+    buffer->add(m_deactive_time);
+    buffer->add(m_disappear_counter);
+    buffer->add(m_event_handler ? (int)m_event_handler->getWorldKartId() : -1);
+    buffer->add(m_emitter       ? (int)m_emitter->getWorldKartId()       : -1);
+}   // saveState
+
+//-----------------------------------------------------------------------------
+/** Restores the state saved with saveState, and updates the visibility
+ *  and size of the scene node accordingly.
+ *  \param buffer The snapshot buffer to read from.
+ */
+void Item::restoreState(SnapshotBuffer *buffer)
+{
+    buffer->get(&m_collected);
+    buffer->get(&m_time_till_return);
+    buffer->get(&m_deactive_time);
+    buffer->get(&m_disappear_counter);
+    int event_handler, emitter;
+    buffer->get(&event_handler);
+    buffer->get(&emitter);
+    World *world    = World::getWorld();
+    m_event_handler = event_handler>-1 ? world->getKart(event_handler) : NULL;
+    m_emitter       = emitter>-1       ? world->getKart(emitter)       : NULL;
+
+    if(!m_node) return;
+    if(!m_collected || m_time_till_return<0)
+    {
+        m_node->setVisible(true);
+        m_node->setScale(core::vector3df(1,1,1));
+    }
+    else if(m_time_till_return<=1.0f)
+    {
+        m_node->setVisible(true);
+        m_node->setScale(core::vector3df(1,1,1)*(1-m_time_till_return));
+    }
+    else
+        m_node->setVisible(false);
+}   // restoreState
+
 //-----------------------------------------------------------------------------
 /** Updated the item - rotates it, takes care of items coming back into
  *  the game after it has been collected.
@@ -40,6 +40,7 @@ using namespace irr;
 class AbstractKart;
 class LODNode;
 class Item;
+class SnapshotBuffer;
 
 // -----------------------------------------------------------------------------
 
@@ -103,6 +104,9 @@ private:
      *  rotation). */
     Vec3 m_original_hpr;
 
+    /** The normal of the terrain the item was placed on. */
+    Vec3          m_normal;
+
     /** True if item was collected & is not displayed. */
     bool          m_collected;
 
@@ -171,12 +175,17 @@ public:
                   Item(const Vec3& xyz, float distance,
                        TriggerItemListener* trigger);
     virtual       ~Item ();
+    void          reuse   (ItemType type, const Vec3& xyz,
+                           const Vec3& normal);
+    void          hide    ();
     void          update  (float delta);
     virtual void  collected(const AbstractKart *kart, float t=2.0f);
     void          setParent(AbstractKart* parent);
     void          reset();
     void          switchTo(ItemType type, scene::IMesh *mesh, scene::IMesh *lowmesh);
     void          switchBack();
+    void          saveState(SnapshotBuffer *buffer) const;
+    void          restoreState(SnapshotBuffer *buffer);
 
     const AbstractKart* getEmitter() const { return m_emitter; }
 
@@ -243,6 +252,17 @@ public:
     /** Returns the type of this item. */
     ItemType      getType()      const { return m_type;     }
     // ------------------------------------------------------------------------
+    /** Returns the type this item was switched from, or ITEM_NONE if the
+     *  item is not switched. */
+    ItemType      getOriginalType() const { return m_original_type; }
+    // ------------------------------------------------------------------------
+    /** Returns the mesh this item was created with. */
+    const scene::IMesh* getOriginalMesh() const { return m_original_mesh; }
+    // ------------------------------------------------------------------------
+    /** Returns the low resolution mesh this item was created with. */
+    const scene::IMesh* getOriginalLowMesh() const
+                                              { return m_original_lowmesh; }
+    // ------------------------------------------------------------------------
     /** Returns true if this item is currently collected. */
     bool          wasCollected() const { return m_collected;}
     // ------------------------------------------------------------------------
@@ -269,6 +289,12 @@ public:
     /** Returns the XYZ position of the item. */
     const Vec3&   getXYZ() const { return m_xyz; }
     // ------------------------------------------------------------------------
+    /** Returns the square of the distance at which a kart hits this item. */
+    float         getHitDistance2() const { return m_distance_2; }
+    // ------------------------------------------------------------------------
+    /** Returns the normal of the terrain this item was placed on. */
+    const Vec3&   getNormal() const { return m_normal; }
+    // ------------------------------------------------------------------------
     /** Returns the index of the graph node this item is on. */
     int           getGraphNode() const { return m_graph_node; }
     // ------------------------------------------------------------------------
@@ -18,6 +18,8 @@
 
 #include "items/item_manager.hpp"
 
+#include <algorithm>
+#include <math.h>
 #include <stdexcept>
 #include <string>
 #include <sstream>
@@ -33,6 +35,7 @@
 #include "network/network_world.hpp"
 #include "tracks/quad_graph.hpp"
 #include "tracks/track.hpp"
+#include "utils/snapshot_buffer.hpp"
 #include "utils/string_utils.hpp"
 
 #include <IMesh.h>
@@ -195,8 +198,60 @@ ItemManager::~ItemManager()
     }
 
     m_all_items.clear();
+
+    for(unsigned int i=0; i<m_free_items.size(); i++)
+        delete m_free_items[i];
+    m_free_items.clear();
 }   // ~ItemManager
 
+//-----------------------------------------------------------------------------
+/** Computes the 2d box that contains all points at which a kart hits an
+ *  item.
+ *  \param item The item.
+ *  \param min, max On return the box.
+ */
+static void getItemHitBox(const Item *item, Vec3 *min, Vec3 *max)
+{
+    const Vec3 r(sqrtf(item->getHitDistance2()));
+    *min = item->getXYZ() - r;
+    *max = item->getXYZ() + r;
+}   // getItemHitBox
+
+//-----------------------------------------------------------------------------
+/** Builds the grid of all items. The grid covers the area of all current
+ *  items plus a border, so that items dropped later (e.g. bubble gums) are
+ *  usually inside of it. Items outside of the grid are stored in the
+ *  closest cells, and since a point outside is clamped the same way, they
+ *  are still found.
+ */
+void ItemManager::buildItemGrid()
+{
+    Vec3 grid_min( 999999.9f), grid_max(-999999.9f);
+    for(unsigned int i=0; i<m_all_items.size(); i++)
+    {
+        if(!m_all_items[i]) continue;
+        Vec3 min, max;
+        getItemHitBox(m_all_items[i], &min, &max);
+        grid_min.setMin(min);
+        grid_max.setMax(max);
+    }
+    if(grid_min.getX()>grid_max.getX())
+    {
+        // No items: use a single cell, so that the grid is not empty.
+        grid_min = Vec3(0, 0, 0);
+        grid_max = Vec3(0, 0, 0);
+    }
+    const Vec3 border(50.0f);
+    m_item_grid.init(grid_min-border, grid_max+border, /*cell_size*/5.0f);
+    for(unsigned int i=0; i<m_all_items.size(); i++)
+    {
+        if(!m_all_items[i]) continue;
+        Vec3 min, max;
+        getItemHitBox(m_all_items[i], &min, &max);
+        m_item_grid.add(i, min, max);
+    }
+}   // buildItemGrid
+
 //-----------------------------------------------------------------------------
 /** Inserts the new item into the items management data structures, if possible
  *  reusing an existing, unused entry (e.g. due to a removed bubble gum). Then
@@ -231,6 +286,14 @@ void ItemManager::insertItem(Item *item)
         else  // otherwise store it in the 'outside' index
             (*m_items_in_quads)[m_items_in_quads->size()-1].push_back(item);
     }   // if m_items_in_quads
+
+    // If the grid was not built yet, the item is added when it is built.
+    if(!m_item_grid.isEmpty())
+    {
+        Vec3 min, max;
+        getItemHitBox(item, &min, &max);
+        m_item_grid.add(index, min, max);
+    }
 }   // insertItem
 
 //-----------------------------------------------------------------------------
@@ -250,8 +313,22 @@ Item* ItemManager::newItem(Item::ItemType type, const Vec3& xyz,
         mesh_type = Item::ITEM_BUBBLEGUM_NOLOK;
     }
 
-    Item* item = new Item(type, xyz, normal, m_item_mesh[mesh_type],
-                          m_item_lowres_mesh[mesh_type]);
+    // Reuse a removed item with the same meshes if possible.
+    Item* item = NULL;
+    for(unsigned int i=0; i<m_free_items.size(); i++)
+    {
+        Item *free_item = m_free_items[i];
+        if(free_item->getOriginalMesh()    != m_item_mesh[mesh_type] ||
+           free_item->getOriginalLowMesh() != m_item_lowres_mesh[mesh_type])
+            continue;
+        m_free_items.erase(m_free_items.begin()+i);
+        item = free_item;
+        item->reuse(type, xyz, normal);
+        break;
+    }
+    if(!item)
+        item = new Item(type, xyz, normal, m_item_mesh[mesh_type],
+                        m_item_lowres_mesh[mesh_type]);
 
     insertItem(item);
     if(parent != NULL) item->setParent(parent);
@@ -300,33 +377,37 @@ void ItemManager::collectedItem(Item *item, AbstractKart *kart, int add_info)
  */
 void  ItemManager::checkItemHit(AbstractKart* kart)
 {
-    // We could use m_items_in_quads to to check for item hits: take the quad
-    // of the graph node of the kart, and only check items in that quad. But
-    // then we also need to check for any adjacent quads (since an item just
-    // on the order of one quad might get hit from an adjacent quad). Then
-    // it is possible that a quad is that short that we need to test adjacent
-    // of adjacent quads. And check for items outside of the track.
-    // Since at this stace item detection is by far not a bottle neck,
-    // the original, simple and stable algorithm is left in place.
-
-    for(AllItemTypes::iterator i =m_all_items.begin();
-        i!=m_all_items.end();  i++)
+    // Only the items whose hit area overlaps the grid cell of the kart
+    // can be hit. Using the quads of the driveline instead would need
+    // adjacent quads (and adjacent of adjacent quads for short quads) to
+    // be tested, plus all items that are not on the driveline.
+    if(m_item_grid.isEmpty())
+        buildItemGrid();
+
+    // Copy the list, since collecting an item can delete it, and sort it
+    // so that the items are collected in the same order as when testing
+    // all items.
+    m_hit_candidates = m_item_grid.getObjects(kart->getXYZ());
+    std::sort(m_hit_candidates.begin(), m_hit_candidates.end());
+
+    for(unsigned int j=0; j<m_hit_candidates.size(); j++)
     {
-        if((!*i) || (*i)->wasCollected()) continue;
+        Item *item = m_all_items[m_hit_candidates[j]];
+        if(!item || item->wasCollected()) continue;
         // To allow inlining and avoid including kart.hpp in item.hpp,
         // we pass the kart and the position separately.
-        if((*i)->hitKart(kart->getXYZ(), kart))
+        if(item->hitKart(kart->getXYZ(), kart))
         {
             // if we're not playing online, pick the item.
             if (!NetworkWorld::getInstance()->isRunning())
-                collectedItem(*i, kart);
+                collectedItem(item, kart);
             else if (NetworkManager::getInstance()->isServer())
             {
-                collectedItem(*i, kart);
-                NetworkWorld::getInstance()->collectedItem(*i, kart);
+                collectedItem(item, kart);
+                NetworkWorld::getInstance()->collectedItem(item, kart);
             }
         }   // if hit
-    }   // for m_all_items
+    }   // for j<m_hit_candidates.size()
 }   // checkItemHit
 
 //-----------------------------------------------------------------------------
@@ -371,8 +452,166 @@ void ItemManager::reset()
     }  // whilem_all_items.end() i
 
     m_switch_time = -1;
+    preWarmItems();
 }   // reset
 
+//-----------------------------------------------------------------------------
+/** Makes sure that there is a removed bubble gum for each kart that can be
+ *  reused, so that dropping bubble gums during the race does not need to
+ *  create new scene nodes.
+ */
+void ItemManager::preWarmItems()
+{
+    unsigned int needed[Item::ITEM_COUNT];
+    for(unsigned int i=0; i<Item::ITEM_COUNT; i++)
+        needed[i] = 0;
+
+    World *world = World::getWorld();
+    for(unsigned int i=0; i<world->getNumKarts(); i++)
+    {
+        if(world->getKart(i)->getIdent()=="nolok")
+            needed[Item::ITEM_BUBBLEGUM_NOLOK]++;
+        else
+            needed[Item::ITEM_BUBBLEGUM]++;
+    }
+
+    for(unsigned int i=0; i<m_free_items.size(); i++)
+    {
+        for(unsigned int type=0; type<Item::ITEM_COUNT; type++)
+        {
+            if(needed[type]>0 &&
+               m_free_items[i]->getOriginalMesh()==m_item_mesh[type])
+            {
+                needed[type]--;
+                break;
+            }
+        }
+    }   // for i < m_free_items.size()
+
+    for(unsigned int type=0; type<Item::ITEM_COUNT; type++)
+    {
+        for(unsigned int i=0; i<needed[type]; i++)
+        {
+            Item *item = new Item(Item::ITEM_BUBBLEGUM, Vec3(0, 0, 0),
+                                  Vec3(0, 1, 0), m_item_mesh[type],
+                                  m_item_lowres_mesh[type]);
+            item->hide();
+            m_free_items.push_back(item);
+        }
+    }
+}   // preWarmItems
+
+//-----------------------------------------------------------------------------
+/** Saves the state of all items (see World::saveState). For each entry in
+ *  the item list the type, position and emitter are saved, so that items
+ *  which were removed in the meantime (e.g. bubble gums) can be recreated.
+ *  \param buffer The snapshot buffer to write to.
+ */
+void ItemManager::saveState(SnapshotBuffer *buffer) const
+{
+    buffer->add(m_switch_time);
+    buffer->add((unsigned int)m_all_items.size());
+    for(unsigned int i=0; i<m_all_items.size(); i++)
+    {
+        const Item *item = m_all_items[i];
+        buffer->add(item!=NULL);
+        if(!item) continue;
+        buffer->add(item->getType());
+        buffer->add(item->getOriginalType());
+        buffer->add(item->getXYZ());
+        buffer->add(item->getNormal());
+        const AbstractKart *emitter = item->getEmitter();
+        buffer->add(emitter ? (int)emitter->getWorldKartId() : -1);
+        item->saveState(buffer);
+    }   // for i < m_all_items.size()
+}   // saveState
+
+//-----------------------------------------------------------------------------
+/** Restores the state of all items saved with saveState. Items are matched
+ *  by their index in the item list: an item that does not exist anymore is
+ *  recreated (at the same index), an item that was added after the
+ *  snapshot is deleted. Items are switched or switched back as necessary.
+ *  \param buffer The snapshot buffer to read from.
+ */
+void ItemManager::restoreState(SnapshotBuffer *buffer)
+{
+    float switch_time;
+    buffer->get(&switch_time);
+    unsigned int n;
+    buffer->get(&n);
+
+    for(unsigned int i=n; i<m_all_items.size(); i++)
+    {
+        if(m_all_items[i]) deleteItem(m_all_items[i]);
+    }
+    m_all_items.resize(n, NULL);
+
+    for(unsigned int i=0; i<n; i++)
+    {
+        Item *item = m_all_items[i];
+        bool exists;
+        buffer->get(&exists);
+        if(!exists)
+        {
+            if(item) deleteItem(item);
+            continue;
+        }
+        Item::ItemType type, original_type;
+        Vec3 xyz, normal;
+        int emitter;
+        buffer->get(&type);
+        buffer->get(&original_type);
+        buffer->get(&xyz);
+        buffer->get(&normal);
+        buffer->get(&emitter);
+
+        // The type the item had when it was created
+        Item::ItemType base_type = original_type==Item::ITEM_NONE
+                                 ? type : original_type;
+        if(item)
+        {
+            Item::ItemType current = item->getOriginalType();
+            if(current==Item::ITEM_NONE) current = item->getType();
+            if(current!=base_type || item->getXYZ()!=xyz)
+            {
+                deleteItem(item);
+                item = NULL;
+            }
+        }
+
+        if(!item)
+        {
+            AbstractKart *parent = emitter>-1
+                                 ? World::getWorld()->getKart(emitter)
+                                 : NULL;
+            // Don't let newItem switch the item, this is done below.
+            float old_switch_time = m_switch_time;
+            m_switch_time = -1;
+            item = newItem(base_type, xyz, normal, parent);
+            m_switch_time = old_switch_time;
+            // Move the item to the index it had in the snapshot. Since
+            // this entry is empty, insertItem used an entry < n.
+            m_all_items[item->getItemId()] = NULL;
+            m_all_items[i] = item;
+            item->setItemId(i);
+        }
+
+        if(item->getType()!=type || item->getOriginalType()!=original_type)
+        {
+            item->switchBack();
+            if(original_type!=Item::ITEM_NONE)
+                item->switchTo(type, m_item_mesh[(int)type],
+                               m_item_lowres_mesh[(int)type]);
+        }
+        item->restoreState(buffer);
+    }   // for i < n
+
+    m_switch_time = switch_time;
+    // Items were moved to different indices, so rebuild the grid when it
+    // is needed next time.
+    m_item_grid.clear();
+}   // restoreState
+
 //-----------------------------------------------------------------------------
 /** Updates all items, and handles switching items back if the switch time
  *  is over.
@@ -431,8 +670,23 @@ void ItemManager::deleteItem(Item *item)
     }   // if m_items_in_quads
 
     int index = item->getItemId();
+    if(!m_item_grid.isEmpty())
+    {
+        Vec3 min, max;
+        getItemHitBox(item, &min, &max);
+        m_item_grid.remove(index, min, max);
+    }
     m_all_items[index] = NULL;
-    delete item;
+
+    // Keep the item to be reused by newItem. Trigger items have no scene
+    // node, so nothing is gained by keeping them.
+    if(item->getType()!=Item::ITEM_TRIGGER)
+    {
+        item->hide();
+        m_free_items.push_back(item);
+    }
+    else
+        delete item;
 }   // delete item
 
 //-----------------------------------------------------------------------------
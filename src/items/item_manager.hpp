@@ -20,6 +20,7 @@
 #define HEADER_ITEMMANAGER_HPP
 
 #include "items/item.hpp"
+#include "tracks/spatial_grid.hpp"
 #include "utils/no_copy.hpp"
 
 #include <SColor.h>
@@ -30,6 +31,7 @@
 #include <vector>
 
 class Kart;
+class SnapshotBuffer;
 
 /**
   * \ingroup items
@@ -82,6 +84,20 @@ private:
      *  field is undefined if no QuadGraph exist, e.g. in battle mode. */
     std::vector< AllItemTypes > *m_items_in_quads;
 
+    /** A grid storing the indices of all items, each item in all cells
+     *  that its hit area overlaps. This is used to find the items a kart
+     *  might hit. The grid is built when it is first needed, and cleared
+     *  if the item indices change. */
+    SpatialGrid m_item_grid;
+
+    /** The indices of the items found in the grid in checkItemHit, kept
+     *  here to avoid reallocating it for each kart and frame. */
+    std::vector<int> m_hit_candidates;
+
+    /** Items removed during a race (e.g. used up bubble gums). They are
+     *  reused by newItem instead of creating new scene nodes. */
+    AllItemTypes m_free_items;
+
     /** What item this item is switched to. */
     std::vector<Item::ItemType> m_switch_to;
 
@@ -91,6 +107,8 @@ private:
 
     void  insertItem(Item *item);
     void  deleteItem(Item *item);
+    void  buildItemGrid();
+    void  preWarmItems();
 
     // Make those private so only create/destroy functions can call them.
                    ItemManager();
@@ -106,6 +124,8 @@ public:
     void           update          (float delta);
     void           checkItemHit    (AbstractKart* kart);
     void           reset           ();
+    void           saveState       (SnapshotBuffer *buffer) const;
+    void           restoreState    (SnapshotBuffer *buffer);
     void           collectedItem   (Item *item, AbstractKart *kart,
                                     int add_info=-1);
     void           switchItems     ();
@@ -32,6 +32,7 @@
 #include "physics/physics.hpp"
 #include "tracks/track.hpp"
 #include "utils/constants.hpp"
+#include "utils/snapshot_buffer.hpp"
 #include "utils/string_utils.hpp"
 
 // -----------------------------------------------------------------------------
@@ -77,14 +78,12 @@ Plunger::Plunger(AbstractKart *kart)
         m_initial_velocity = btVector3(0.0f, up_velocity, plunger_speed);
 
         createPhysics(forward_offset, m_initial_velocity,
-                      new btCylinderShape(0.5f*m_extend),
                       0.5f /* restitution */ , gravity,
                       /* rotates */false , /*turn around*/false, &trans);
     }
     else
     {
         createPhysics(forward_offset, btVector3(pitch, 0.0f, plunger_speed),
-                      new btCylinderShape(0.5f*m_extend),
                       0.5f /* restitution */, gravity,
                       false /* rotates */, m_reverse_mode, &kart_transform);
     }
@@ -103,6 +102,25 @@ Plunger::Plunger(AbstractKart *kart)
     m_keep_alive = -1;
 }   // Plunger
 
+// ----------------------------------------------------------------------------
+/** Creates a plunger from a snapshot (see ProjectileManager::restoreState).
+ *  No target is selected, the rubber band (if any) is created and attached
+ *  by restoreState.
+ *  \param kart The kart that fired the plunger.
+ *  \param buffer The snapshot buffer to read the state from.
+ */
+Plunger::Plunger(AbstractKart *kart, SnapshotBuffer *buffer)
+       : Flyable(kart, PowerupManager::POWERUP_PLUNGER)
+{
+    m_reverse_mode = false;
+    m_rubber_band  = NULL;
+    m_keep_alive   = -1;
+    createPhysics(0.0f, btVector3(0.0f, 0.0f, 0.0f), 0.5f /* restitution */,
+                  0.0f /* gravity */, false /* rotates */);
+    setAdjustUpVelocity(false);
+    restoreState(buffer);
+}   // Plunger
+
 // ----------------------------------------------------------------------------
 Plunger::~Plunger()
 {
@@ -114,6 +132,9 @@ Plunger::~Plunger()
 void Plunger::init(const XMLNode &node, scene::IMesh *plunger_model)
 {
     Flyable::init(node, plunger_model, PowerupManager::POWERUP_PLUNGER);
+    const Vec3 &extend = m_st_extend[PowerupManager::POWERUP_PLUNGER];
+    setShape(PowerupManager::POWERUP_PLUNGER,
+             new btCylinderShape(0.5f*extend));
 }   // init
 
 // ----------------------------------------------------------------------------
@@ -218,4 +239,56 @@ void Plunger::hitTrack()
     hit(NULL, NULL);
 }   // hitTrack
 
-// -----------------------------------------------------------------------------
+
+// ----------------------------------------------------------------------------
+/** Saves the state of the plunger (see Flyable::saveState), including
+ *  what its rubber band is attached to.
+ *  \param buffer The snapshot buffer to write to.
+ */
+void Plunger::saveState(SnapshotBuffer *buffer) const
+{
+    Flyable::saveState(buffer);
+    buffer->add(m_keep_alive);
+    buffer->add(m_initial_velocity);
+    buffer->add(m_reverse_mode);
+    if(m_rubber_band)
+        m_rubber_band->saveState(buffer);
+}   // saveState
+
+// ----------------------------------------------------------------------------
+/** Restores the state saved with saveState.
+ *  \param buffer The snapshot buffer to read from.
+ */
+void Plunger::restoreState(SnapshotBuffer *buffer)
+{
+    const bool was_hit = m_keep_alive >= 0;
+    Flyable::restoreState(buffer);
+    buffer->get(&m_keep_alive);
+    buffer->get(&m_initial_velocity);
+    buffer->get(&m_reverse_mode);
+
+    // A plunger that has hit something is hidden and removed from the
+    // physics while it is kept alive (see hit()).
+    const bool is_hit = m_keep_alive >= 0;
+    if(is_hit != was_hit)
+    {
+        getNode()->setVisible(!is_hit);
+        if(is_hit)
+            World::getWorld()->getPhysics()->removeBody(getBody());
+        else
+            World::getWorld()->getPhysics()->addBody(getBody());
+    }
+
+    // Same condition as in the constructor for firing a plunger
+    if(m_reverse_mode || race_manager->isBattleMode())
+    {
+        delete m_rubber_band;
+        m_rubber_band = NULL;
+    }
+    else
+    {
+        if(!m_rubber_band)
+            m_rubber_band = new RubberBand(this, m_owner);
+        m_rubber_band->restoreState(buffer);
+    }
+}   // restoreState
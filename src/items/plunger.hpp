@@ -47,11 +47,14 @@ private:
     bool m_reverse_mode;
 public:
                  Plunger(AbstractKart *kart);
+                 Plunger(AbstractKart *kart, SnapshotBuffer *buffer);
                 ~Plunger();
     static  void init(const XMLNode &node, scene::IMesh* missile);
     virtual bool updateAndDelete(float dt);
     virtual void hitTrack ();
     virtual bool hit      (AbstractKart *kart, PhysicalObject *obj=NULL);
+    virtual void saveState(SnapshotBuffer *buffer) const;
+    virtual void restoreState(SnapshotBuffer *buffer);
 
     // ------------------------------------------------------------------------
     /** Sets the keep-alive value. Setting it to 0 will remove the plunger
@@ -31,6 +31,7 @@
 #include "modes/world.hpp"
 #include "physics/triangle_mesh.hpp"
 #include "tracks/track.hpp"
+#include "utils/snapshot_buffer.hpp"
 #include "utils/string_utils.hpp"
 #include "utils/log.hpp" //TODO: remove after debugging is done
 
@@ -66,6 +67,32 @@ void Powerup::reset()
     set( (PowerupManager::PowerupType)type, number );
 }   // reset
 
+//-----------------------------------------------------------------------------
+/** Saves the type and number of the collected powerups.
+ *  \param buffer The snapshot buffer to write to.
+ */
+void Powerup::saveState(SnapshotBuffer *buffer) const
+{
+    buffer->add(m_type);
+    buffer->add(m_number);
+}   // saveState
+
+//-----------------------------------------------------------------------------
+/** Restores the type and number of the collected powerups. The sound of
+ *  the powerup is only changed if the type changes.
+ *  \param buffer The snapshot buffer to read from.
+ */
+void Powerup::restoreState(SnapshotBuffer *buffer)
+{
+    PowerupManager::PowerupType type;
+    int number;
+    buffer->get(&type);
+    buffer->get(&number);
+    if(type!=m_type)
+        set(type, number);
+    m_number = number;
+}   // restoreState
+
 //-----------------------------------------------------------------------------
 /** Sets the collected items. The number of items is increased if the same
  *  item is currently collected, otherwise replaces the existing item. It also
@@ -28,6 +28,7 @@
 class AbstractKart;
 class Item;
 class SFXBase;
+class SnapshotBuffer;
 
 /**
   * \ingroup items
@@ -55,6 +56,8 @@ public:
                    ~Powerup      ();
     void            set          (PowerupManager::PowerupType _type, int n=1);
     void            reset        ();
+    void            saveState    (SnapshotBuffer *buffer) const;
+    void            restoreState (SnapshotBuffer *buffer);
     Material*       getIcon      () const;
     void            adjustSound ();
     void            use          ();
@@ -27,6 +27,11 @@
 #include "items/powerup.hpp"
 #include "items/rubber_ball.hpp"
 #include "karts/abstract_kart.hpp"
+#include "modes/world.hpp"
+#include "race/race_manager.hpp"
+#include "utils/snapshot_buffer.hpp"
+
+#include <assert.h>
 
 ProjectileManager *projectile_manager=0;
 
@@ -43,6 +48,9 @@ void ProjectileManager::removeTextures()
 }   // removeTextures
 
 //-----------------------------------------------------------------------------
+/** Removes all projectiles and hit effects, and frees all objects kept
+ *  for reuse. This is called at the end of a race.
+ */
 void ProjectileManager::cleanup()
 {
     for(Projectiles::iterator i = m_active_projectiles.begin();
@@ -59,8 +67,75 @@ void ProjectileManager::cleanup()
     }
 
     m_active_hit_effects.clear();
+
+    for(unsigned int i=0; i<m_free_explosions.size(); i++)
+        delete m_free_explosions[i];
+    m_free_explosions.clear();
+    Flyable::clearPools();
 }   // cleanup
 
+//-----------------------------------------------------------------------------
+/** Removes all projectiles and hit effects when a race is (re)started, and
+ *  prepares enough flyables and explosions so that (usually) none have to
+ *  be created during the race.
+ */
+void ProjectileManager::reset()
+{
+    for(Projectiles::iterator i = m_active_projectiles.begin();
+        i != m_active_projectiles.end(); ++i)
+    {
+        delete *i;
+    }
+    m_active_projectiles.clear();
+    m_next_projectile_id = 0;
+
+    for(HitEffects::iterator i  = m_active_hit_effects.begin();
+        i != m_active_hit_effects.end(); ++i)
+    {
+        freeHitEffect(*i);
+    }
+    m_active_hit_effects.clear();
+
+    const unsigned int n = race_manager->getNumberOfKarts();
+    Flyable::preWarm(PowerupManager::POWERUP_BOWLING,    n);
+    Flyable::preWarm(PowerupManager::POWERUP_CAKE,       n);
+    Flyable::preWarm(PowerupManager::POWERUP_PLUNGER,    n);
+    Flyable::preWarm(PowerupManager::POWERUP_RUBBERBALL, n);
+    m_active_projectiles.reserve(4*n);
+    m_old_projectiles.reserve(4*n);
+
+    // The explosion used by Flyable::getHitEffect.
+    unsigned int num_explosions = 0;
+    for(unsigned int i=0; i<m_free_explosions.size(); i++)
+    {
+        if(m_free_explosions[i]->matches("explosion", "explosion_cake.xml"))
+            num_explosions++;
+    }
+    for(; num_explosions<n; num_explosions++)
+    {
+        m_free_explosions.push_back(new Explosion(Vec3(0, 0, 0), "explosion",
+                                                  "explosion_cake.xml",
+                                                  /*start*/false));
+    }
+}   // reset
+
+//-----------------------------------------------------------------------------
+/** Removes a hit effect that is not needed anymore. Explosions are kept to
+ *  be reused by newExplosion, all other hit effects are deleted.
+ *  \param hit_effect The hit effect to remove.
+ */
+void ProjectileManager::freeHitEffect(HitEffect *hit_effect)
+{
+    Explosion *explosion = dynamic_cast<Explosion*>(hit_effect);
+    if(explosion)
+    {
+        explosion->stop();
+        m_free_explosions.push_back(explosion);
+    }
+    else
+        delete hit_effect;
+}   // freeHitEffect
+
 // -----------------------------------------------------------------------------
 /** General projectile update call. */
 void ProjectileManager::update(float dt)
@@ -79,7 +154,7 @@ void ProjectileManager::update(float dt)
         // Update this hit effect. If it can be removed, remove it.
         else if((*he)->updateAndDelete(dt))
         {
-            delete *he;
+            freeHitEffect(*he);
             HitEffects::iterator next = m_active_hit_effects.erase(he);
             he = next;
         }   // if hit effect finished
@@ -112,6 +187,20 @@ void ProjectileManager::updateServer(float dt)
     
 }   // updateServer
 
+// -----------------------------------------------------------------------------
+/** Positions the models of all projectiles between the last two simulation
+ *  steps (see World::updateGraphics).
+ *  \param alpha Position between the previous (0) and last (1) step.
+ */
+void ProjectileManager::interpolateGraphics(float alpha)
+{
+    for(Projectiles::iterator i  = m_active_projectiles.begin();
+                              i != m_active_projectiles.end();   i++)
+    {
+        (*i)->interpolateGraphics(alpha);
+    }
+}   // interpolateGraphics
+
 // -----------------------------------------------------------------------------
 /** Creates a new projectile of the given type.
  *  \param kart The kart which shoots the projectile.
@@ -130,10 +219,62 @@ Flyable *ProjectileManager::newProjectile(AbstractKart *kart,
                                                                          break;
         default:              return NULL;
     }
+    f->setProjectileId(m_next_projectile_id++);
     m_active_projectiles.push_back(f);
     return f;
 }   // newProjectile
 
+// -----------------------------------------------------------------------------
+/** Creates a projectile that was removed after a snapshot was taken (see
+ *  restoreState). This uses the restore constructors of the projectiles,
+ *  which do not select targets, play firing sfx or otherwise affect the
+ *  game the way firing a projectile does.
+ *  \param kart The kart which shot the projectile.
+ *  \param type Type of projectile.
+ *  \param buffer The snapshot buffer to read the state from.
+ */
+Flyable *ProjectileManager::restoreProjectile(AbstractKart *kart,
+                                              PowerupManager::PowerupType type,
+                                              SnapshotBuffer *buffer)
+{
+    switch(type)
+    {
+        case PowerupManager::POWERUP_BOWLING:
+            return new Bowling(kart, buffer);
+        case PowerupManager::POWERUP_PLUNGER:
+            return new Plunger(kart, buffer);
+        case PowerupManager::POWERUP_CAKE:
+            return new Cake(kart, buffer);
+        case PowerupManager::POWERUP_RUBBERBALL:
+            return new RubberBall(kart, buffer);
+        default:
+            assert(false);
+            return NULL;
+    }
+}   // restoreProjectile
+
+// -----------------------------------------------------------------------------
+/** Returns an explosion at the given position, reusing a finished explosion
+ *  with the same sfx and particles if possible. The explosion must be added
+ *  with addHitEffect, which also makes sure that it is reused later.
+ *  \param xyz Position of the explosion.
+ *  \param sound Name of the sfx to play.
+ *  \param particle_file The particles to use.
+ */
+Explosion *ProjectileManager::newExplosion(const Vec3 &xyz, const char *sound,
+                                           const char *particle_file)
+{
+    for(unsigned int i=0; i<m_free_explosions.size(); i++)
+    {
+        Explosion *explosion = m_free_explosions[i];
+        if(!explosion->matches(sound, particle_file)) continue;
+        m_free_explosions.erase(m_free_explosions.begin()+i);
+        explosion->reset(xyz);
+        return explosion;
+    }
+    return new Explosion(xyz, sound, particle_file);
+}   // newExplosion
+
 // -----------------------------------------------------------------------------
 /** Returns true if a projectile is within the given distance of the specified
  *  kart.
@@ -153,3 +294,77 @@ bool ProjectileManager::projectileIsClose(const AbstractKart * const kart,
     }
     return false;
 }   // projectileIsClose
+
+// -----------------------------------------------------------------------------
+/** Saves the state of all active projectiles (see World::saveState). Hit
+ *  effects are only graphical and are not saved.
+ *  \param buffer The snapshot buffer to write to.
+ */
+void ProjectileManager::saveState(SnapshotBuffer *buffer)
+{
+    buffer->add((unsigned int)m_active_projectiles.size());
+    for(Projectiles::iterator i  = m_active_projectiles.begin();
+                              i != m_active_projectiles.end();   i++)
+    {
+        buffer->add((*i)->getProjectileId());
+        buffer->add((*i)->getType());
+        buffer->add((*i)->getOwnerId());
+        (*i)->saveState(buffer);
+    }
+}   // saveState
+
+// -----------------------------------------------------------------------------
+/** Restores the projectiles saved with saveState. Projectiles are
+ *  identified by their projectile id. Projectiles that still exist are
+ *  restored in place, projectiles that were removed in the meantime are
+ *  created again with restoreProjectile, and projectiles fired after the
+ *  snapshot was taken are deleted.
+ *  \param buffer The snapshot buffer to read from.
+ */
+void ProjectileManager::restoreState(SnapshotBuffer *buffer)
+{
+    // Copy instead of swap so that both vectors keep their capacity
+    m_old_projectiles.assign(m_active_projectiles.begin(),
+                             m_active_projectiles.end());
+    m_active_projectiles.clear();
+
+    unsigned int n;
+    buffer->get(&n);
+    for(unsigned int j=0; j<n; j++)
+    {
+        unsigned int id;
+        PowerupManager::PowerupType type;
+        unsigned int owner;
+        buffer->get(&id);
+        buffer->get(&type);
+        buffer->get(&owner);
+
+        Flyable *f = NULL;
+        for(Projectiles::iterator i  = m_old_projectiles.begin();
+                                  i != m_old_projectiles.end();   i++)
+        {
+            if(*i && (*i)->getProjectileId()==id && (*i)->getType()==type)
+            {
+                f  = *i;
+                *i = NULL;
+                break;
+            }
+        }
+        if(f)
+            f->restoreState(buffer);
+        else
+        {
+            f = restoreProjectile(World::getWorld()->getKart(owner), type,
+                                  buffer);
+            f->setProjectileId(id);
+        }
+        m_active_projectiles.push_back(f);
+    }   // for j < n
+
+    for(Projectiles::iterator i  = m_old_projectiles.begin();
+                              i != m_old_projectiles.end();   i++)
+    {
+        if(*i) delete *i;
+    }
+    m_old_projectiles.clear();
+}   // restoreState
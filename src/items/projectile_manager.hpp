@@ -31,8 +31,10 @@ namespace irr
 #include "utils/no_copy.hpp"
 
 class AbstractKart;
+class Explosion;
 class Flyable;
 class HitEffect;
+class SnapshotBuffer;
 class Track;
 class Vec3;
 
@@ -49,28 +51,54 @@ private:
      *  currently moving on the track. */
     Projectiles      m_active_projectiles;
 
+    /** Used by restoreState to hold the projectiles that existed before
+     *  the restore. It is a member so that its capacity is kept. */
+    Projectiles      m_old_projectiles;
+
+    /** The id given to the next projectile (see Flyable::getProjectileId).
+     *  It is not reset by restoreState, so ids are never reused. */
+    unsigned int     m_next_projectile_id;
+
     /** All active hit effects, i.e. hit effects which are currently
      *  being shown or have a sfx playing. */
     HitEffects       m_active_hit_effects;
 
+    /** Finished explosions, which are reused by newExplosion instead of
+     *  creating new particle systems and sfx. */
+    std::vector<Explosion*> m_free_explosions;
+
     void             updateServer(float dt);
+    void             freeHitEffect(HitEffect *hit_effect);
+    Flyable*         restoreProjectile(AbstractKart *kart,
+                                       PowerupManager::PowerupType type,
+                                       SnapshotBuffer *buffer);
 public:
-                     ProjectileManager() {}
+                     ProjectileManager() : m_next_projectile_id(0) {}
                     ~ProjectileManager() {}
     void             loadData         ();
     void             cleanup          ();
+    void             reset            ();
     void             update           (float dt);
+    void             interpolateGraphics(float alpha);
     Flyable*         newProjectile    (AbstractKart *kart,
                                        PowerupManager::PowerupType type);
+    Explosion*       newExplosion     (const Vec3 &xyz, const char *sound,
+                                       const char *particle_file);
     void             Deactivate       (Flyable *p) {}
     void             removeTextures   ();
     bool             projectileIsClose(const AbstractKart * const kart,
                                        float radius);
+    void             saveState        (SnapshotBuffer *buffer);
+    void             restoreState     (SnapshotBuffer *buffer);
     // ------------------------------------------------------------------------
     /** Adds a special hit effect to be shown.
      *  \param hit_effect The hit effect to be added. */
     void             addHitEffect(HitEffect *hit_effect)
                                 { m_active_hit_effects.push_back(hit_effect); }
+    // ------------------------------------------------------------------------
+    /** Returns the number of projectiles currently moving on the track. */
+    unsigned int     getNumActiveProjectiles() const
+                                        { return m_active_projectiles.size(); }
 };
 
 extern ProjectileManager *projectile_manager;
@@ -30,6 +30,7 @@
 #include "physics/btKart.hpp"
 #include "physics/triangle_mesh.hpp"
 #include "tracks/track.hpp"
+#include "utils/snapshot_buffer.hpp"
 
 #include "utils/log.hpp" //TODO: remove after debugging is done
 
@@ -66,7 +67,6 @@ RubberBall::RubberBall(AbstractKart *kart)
     float forw_offset = 0.5f*kart->getKartLength() + m_extend.getZ()*0.5f+5.0f;
 
     createPhysics(forw_offset, btVector3(0.0f, 0.0f, m_speed*2),
-                  new btSphereShape(0.5f*m_extend.getY()),
                   -70.0f /*gravity*/,
                   true /*rotates*/);
 
@@ -102,6 +102,28 @@ RubberBall::RubberBall(AbstractKart *kart)
 
 }   // RubberBall
 
+// ----------------------------------------------------------------------------
+/** Creates a rubber ball from a snapshot (see
+ *  ProjectileManager::restoreState). The target and the control points
+ *  are not computed again, they are all taken from the snapshot.
+ *  \param kart The kart that fired the ball.
+ *  \param buffer The snapshot buffer to read the state from.
+ */
+RubberBall::RubberBall(AbstractKart *kart, SnapshotBuffer *buffer)
+          : Flyable(kart, PowerupManager::POWERUP_RUBBERBALL, 0.0f /* mass */),
+            TrackSector()
+{
+    m_next_id++;
+    m_id = m_next_id;
+    setDoTerrainInfo(false);
+    // Same physics settings as the constructor above.
+    createPhysics(0.0f, btVector3(0.0f, 0.0f, 0.0f), -70.0f /*gravity*/,
+                  true /*rotates*/);
+    setAdjustUpVelocity(false);
+    m_ping_sfx = sfx_manager->createSoundSource("ball_bounce");
+    restoreState(buffer);
+}   // RubberBall
+
 // ----------------------------------------------------------------------------
 /** Destructor, removes any playing sfx.
  */
@@ -293,6 +315,9 @@ void RubberBall::init(const XMLNode &node, scene::IMesh *rubberball)
         Log::warn("powerup",
                   "No time-between-balls specified for rubber ball.");
     Flyable::init(node, rubberball, PowerupManager::POWERUP_RUBBERBALL);
+    const Vec3 &extend = m_st_extend[PowerupManager::POWERUP_RUBBERBALL];
+    setShape(PowerupManager::POWERUP_RUBBERBALL,
+             new btSphereShape(0.5f*extend.getY()));
 }   // init
 
 // ----------------------------------------------------------------------------
@@ -717,3 +742,61 @@ bool RubberBall::hit(AbstractKart* kart, PhysicalObject* object)
     }
     return was_real_hit;
 }   // hit
+
+// ----------------------------------------------------------------------------
+/** Saves the state of the rubber ball (see Flyable::saveState): its
+ *  target, the interpolation along the control points, the height
+ *  timers and the track sector it is on.
+ *  \param buffer The snapshot buffer to write to.
+ */
+void RubberBall::saveState(SnapshotBuffer *buffer) const
+{
+    Flyable::saveState(buffer);
+    buffer->add((const TrackSector&)*this);
+    buffer->add(m_target ? (int)m_target->getWorldKartId() : -1);
+    buffer->add(m_last_aimed_graph_node);
+    buffer->addArray(m_control_points, 4);
+    buffer->add(m_previous_xyz);
+    buffer->add(m_previous_height);
+    buffer->add(m_length_cp_1_2);
+    buffer->add(m_length_cp_2_3);
+    buffer->add(m_t);
+    buffer->add(m_t_increase);
+    buffer->add(m_interval);
+    buffer->add(m_fast_ping);
+    buffer->add(m_distance_to_target);
+    buffer->add(m_height_timer);
+    buffer->add(m_delete_timer);
+    buffer->add(m_current_max_height);
+    buffer->add(m_aiming_at_target);
+    buffer->add(m_tunnel_count);
+}   // saveState
+
+// ----------------------------------------------------------------------------
+/** Restores the state saved with saveState.
+ *  \param buffer The snapshot buffer to read from.
+ */
+void RubberBall::restoreState(SnapshotBuffer *buffer)
+{
+    Flyable::restoreState(buffer);
+    buffer->get((TrackSector*)this);
+    int target;
+    buffer->get(&target);
+    m_target = target>=0 ? World::getWorld()->getKart(target) : NULL;
+    buffer->get(&m_last_aimed_graph_node);
+    buffer->getArray(m_control_points, 4);
+    buffer->get(&m_previous_xyz);
+    buffer->get(&m_previous_height);
+    buffer->get(&m_length_cp_1_2);
+    buffer->get(&m_length_cp_2_3);
+    buffer->get(&m_t);
+    buffer->get(&m_t_increase);
+    buffer->get(&m_interval);
+    buffer->get(&m_fast_ping);
+    buffer->get(&m_distance_to_target);
+    buffer->get(&m_height_timer);
+    buffer->get(&m_delete_timer);
+    buffer->get(&m_current_max_height);
+    buffer->get(&m_aiming_at_target);
+    buffer->get(&m_tunnel_count);
+}   // restoreState
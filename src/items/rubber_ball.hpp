@@ -200,10 +200,13 @@ private:
     bool         checkTunneling();
 public:
                  RubberBall  (AbstractKart* kart);
+                 RubberBall  (AbstractKart* kart, SnapshotBuffer *buffer);
     virtual     ~RubberBall();
     static  void init(const XMLNode &node, scene::IMesh *rubberball);
     virtual bool updateAndDelete(float dt);
     virtual bool hit(AbstractKart* kart, PhysicalObject* obj=NULL);
+    virtual void saveState(SnapshotBuffer *buffer) const;
+    virtual void restoreState(SnapshotBuffer *buffer);
     static float getTimeBetweenRubberBalls()    {return m_time_between_balls;}
     // ------------------------------------------------------------------------
     /** This object does not create an explosion, all affects on
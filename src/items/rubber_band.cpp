@@ -30,6 +30,7 @@
 #include "modes/world.hpp"
 #include "physics/physics.hpp"
 #include "race/race_manager.hpp"
+#include "utils/snapshot_buffer.hpp"
 #include "utils/string_utils.hpp"
 
 #include "utils/log.hpp" //TODO: remove after debugging is done
@@ -100,8 +101,7 @@ void RubberBand::updatePosition()
     {
     case RB_TO_KART:    m_end_position = m_hit_kart->getXYZ(); break;
     case RB_TO_TRACK:   m_end_position = m_hit_position;       break;
-    case RB_TO_PLUNGER: m_end_position = m_plunger->getXYZ();
-                        checkForHit(k, m_end_position);        break;
+    case RB_TO_PLUNGER: m_end_position = m_plunger->getXYZ();   break;
     }   // switch(m_attached_state);
 
     // Update the rubber band positions
@@ -139,6 +139,8 @@ void RubberBand::update(float dt)
 
     updatePosition();
     const Vec3 &k = m_owner->getXYZ();
+    if(m_attached_state==RB_TO_PLUNGER)
+        checkForHit(k, m_end_position);
 
     // Check for rubber band snapping
     // ------------------------------
@@ -256,3 +258,27 @@ void RubberBand::hit(AbstractKart *kart_hit, const Vec3 *track_xyz)
 }   // hit
 
 // ----------------------------------------------------------------------------
+/** Saves what the rubber band is attached to (see Plunger::saveState).
+ *  \param buffer The snapshot buffer to write to.
+ */
+void RubberBand::saveState(SnapshotBuffer *buffer) const
+{
+    buffer->add(m_attached_state);
+    buffer->add(m_hit_position);
+    buffer->add(m_attached_state==RB_TO_KART
+                ? (int)m_hit_kart->getWorldKartId() : -1);
+}   // saveState
+
+// ----------------------------------------------------------------------------
+/** Restores the state saved with saveState.
+ *  \param buffer The snapshot buffer to read from.
+ */
+void RubberBand::restoreState(SnapshotBuffer *buffer)
+{
+    buffer->get(&m_attached_state);
+    buffer->get(&m_hit_position);
+    int hit_kart;
+    buffer->get(&hit_kart);
+    m_hit_kart = hit_kart>=0 ? World::getWorld()->getKart(hit_kart) : NULL;
+    updatePosition();
+}   // restoreState
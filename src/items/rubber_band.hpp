@@ -30,6 +30,7 @@ using namespace irr;
 
 class AbstractKart;
 class Plunger;
+class SnapshotBuffer;
 
 /** This class is used together with the pluger to display a rubber band from
  *  the shooting kart to the plunger.
@@ -38,7 +39,8 @@ class Plunger;
 class RubberBand : public NoCopy
 {
 private:
-    enum {RB_TO_PLUNGER,         /**< Rubber band is attached to plunger.    */
+    enum AttachedState
+         {RB_TO_PLUNGER,         /**< Rubber band is attached to plunger.    */
           RB_TO_KART,            /**< Rubber band is attached to a kart hit. */
           RB_TO_TRACK}           /**< Rubber band is attached to track.      */
                         m_attached_state;
@@ -71,5 +73,7 @@ public:
         ~RubberBand();
     void update(float dt);
     void hit(AbstractKart *kart_hit, const Vec3 *track_xyz=NULL);
+    void saveState(SnapshotBuffer *buffer) const;
+    void restoreState(SnapshotBuffer *buffer);
 };   // RubberBand
 #endif
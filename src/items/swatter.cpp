@@ -212,27 +212,40 @@ void Swatter::onAnimationEnd()
 void Swatter::chooseTarget()
 {
     // TODO: for the moment, only handle karts...
-    const World*  world         = World::getWorld();
+    World*        world         = World::getWorld();
     AbstractKart* closest_kart  = NULL;
     float         min_dist2     = FLT_MAX;
 
-    for(unsigned int i=0; i<world->getNumKarts(); i++)
+    // Only test the karts close to this kart. The 3d distance is never
+    // smaller than the 2d distance, so if the closest kart is within the
+    // radius, it is the closest of all karts. Otherwise double the radius.
+    std::vector<unsigned int> karts;
+    for(float radius=50.0f; ; radius*=2)
     {
-        AbstractKart *kart = world->getKart(i);
-        // TODO: isSwatterReady(), isSquashable()?
-        if(kart->isEliminated() || kart==m_kart)
-            continue;
-        // don't squash an already hurt kart
-        if (kart->isInvulnerable() || kart->isSquashed())
-            continue;
-
-        float dist2 = (kart->getXYZ()-m_kart->getXYZ()).length2();
-        if(dist2<min_dist2)
+        closest_kart = NULL;
+        min_dist2    = FLT_MAX;
+        bool all_karts = world->getKartSpatialIndex()
+                              ->getKartsInRange(m_kart->getXYZ(), radius,
+                                                &karts);
+        for(unsigned int i=0; i<karts.size(); i++)
         {
-            min_dist2 = dist2;
-            closest_kart = kart;
+            AbstractKart *kart = world->getKart(karts[i]);
+            // TODO: isSwatterReady(), isSquashable()?
+            if(kart->isEliminated() || kart==m_kart)
+                continue;
+            // don't squash an already hurt kart
+            if (kart->isInvulnerable() || kart->isSquashed())
+                continue;
+
+            float dist2 = (kart->getXYZ()-m_kart->getXYZ()).length2();
+            if(dist2<min_dist2)
+            {
+                min_dist2 = dist2;
+                closest_kart = kart;
+            }
         }
-    }
+        if(all_karts || min_dist2<=radius*radius) break;
+    }   // for radius
     m_target = closest_kart;    // may be NULL
 }
 
@@ -267,7 +280,7 @@ void Swatter::squashThingsAround()
     const KartProperties*  kp           = m_kart->getKartProperties();
     // Square of the minimum distance
     float                  min_dist2    = kp->getSwatterDistance2();
-    const World*           world        = World::getWorld();
+    World*                 world        = World::getWorld();
 
     // Get the node corresponding to the joint at the center of the swatter
     // (by swatter, I mean the thing hold in the hand, not the whole thing)
@@ -279,9 +292,12 @@ void Swatter::squashThingsAround()
     m_swat_sound->play();
 
     // Squash karts around
-    for(unsigned int i=0; i<world->getNumKarts(); i++)
+    std::vector<unsigned int> karts;
+    world->getKartSpatialIndex()->getKartsInRange(swatter_pos,
+                                                  sqrtf(min_dist2), &karts);
+    for(unsigned int i=0; i<karts.size(); i++)
     {
-        AbstractKart *kart = world->getKart(i);
+        AbstractKart *kart = world->getKart(karts[i]);
         // TODO: isSwatterReady()
         if(kart->isEliminated() || kart==m_kart)
             continue;
@@ -298,7 +314,8 @@ void Swatter::squashThingsAround()
         if (kart->getAttachment()->getType()==Attachment::ATTACH_BOMB)
         {   // make bomb explode
             kart->getAttachment()->update(10000);
-            HitEffect *he = new Explosion(m_kart->getXYZ(),  "explosion", "explosion.xml");
+            HitEffect *he = projectile_manager->newExplosion(m_kart->getXYZ(),
+                                                  "explosion", "explosion.xml");
             if(m_kart->getController()->isPlayerController())
                 he->setPlayerKartHit();
             projectile_manager->addHitEffect(he);
@@ -89,3 +89,15 @@ void AbstractKartAnimation::update(float dt)
         delete this;
     }
 }   // update
+
+// ----------------------------------------------------------------------------
+/** Ends the animation immediately, as if its time was over: the kart is
+ *  added back to the physics, and this object is deleted.
+ *  NOTE: no members can be accessed after calling this function.
+ */
+void AbstractKartAnimation::stop()
+{
+    m_timer = -1;
+    m_kart->setKartAnimation(NULL);
+    delete this;
+}   // stop
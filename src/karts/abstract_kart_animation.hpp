@@ -52,6 +52,7 @@ public:
                                        const std::string &name);
     virtual     ~AbstractKartAnimation();
     virtual void update(float dt);
+    void         stop();
     // ------------------------------------------------------------------------
     /** Returns the current animation timer. */
     virtual float getAnimationTimer() const { return m_timer; }
@@ -0,0 +1,127 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2014 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+
+#include "karts/controller/ai_scheduler.hpp"
+
+#include "config/user_config.hpp"
+
+#include <algorithm>
+
+AIScheduler::AIScheduler()
+{
+    reset(0);
+}   // AIScheduler
+
+// ----------------------------------------------------------------------------
+/** Resets the scheduler at the start of a race: all karts plan in the first
+ *  step, and all statistics are cleared.
+ *  \param num_karts Number of karts in the race.
+ */
+void AIScheduler::reset(unsigned int num_karts)
+{
+    m_plan.assign(num_karts, true);
+    m_steps_since_plan.assign(num_karts, 0);
+    m_cost.assign(num_karts, 0.0f);
+    m_is_scheduled.assign(num_karts, false);
+    m_has_reported.assign(num_karts, false);
+    m_order.clear();
+    m_order.reserve(num_karts);
+    m_num_planned     = 0;
+    m_num_deferred    = 0;
+    m_num_over_budget = 0;
+}   // reset
+
+// ----------------------------------------------------------------------------
+/** Decides which karts plan in this time step. Karts are considered in the
+ *  order of the number of steps since they planned last, so that deferred
+ *  karts get the next chance. A kart plans if the estimated time of its
+ *  planning still fits into the budget, or if it has not planned for the
+ *  maximum number of steps. Karts that did not report a planning time the
+ *  last time they were allowed to plan are not scheduled.
+ */
+void AIScheduler::update()
+{
+    for(unsigned int i=0; i<m_plan.size(); i++)
+    {
+        if(m_plan[i])
+        {
+            m_steps_since_plan[i] = 0;
+            m_is_scheduled[i]     = m_has_reported[i];
+            m_has_reported[i]     = false;
+        }
+        else
+            m_steps_since_plan[i]++;
+    }
+
+    const int budget = UserConfigParams::m_ai_budget;
+    if(budget<=0)
+    {
+        m_plan.assign(m_plan.size(), true);
+        return;
+    }
+
+    m_order.clear();
+    for(unsigned int i=0; i<m_plan.size(); i++)
+    {
+        if(m_is_scheduled[i])
+            m_order.push_back(std::make_pair(-(int)m_steps_since_plan[i], i));
+        else
+            m_plan[i] = true;
+    }
+    std::sort(m_order.begin(), m_order.end());
+
+    int max_interval = UserConfigParams::m_ai_max_interval;
+    if(max_interval<1) max_interval = 1;
+    float used = 0;
+    for(unsigned int i=0; i<m_order.size(); i++)
+    {
+        const unsigned int kart_id = m_order[i].second;
+        const bool fits = used + m_cost[kart_id] <= budget;
+        const bool overdue =
+            (int)m_steps_since_plan[kart_id]+1 >= max_interval;
+        m_plan[kart_id] = fits || overdue;
+        if(m_plan[kart_id])
+        {
+            used += m_cost[kart_id];
+            if(!fits) m_num_over_budget++;
+        }
+        else
+            m_num_deferred++;
+    }   // for i < m_order.size()
+}   // update
+
+// ----------------------------------------------------------------------------
+/** Called by the AI of a kart with the time its planning took in this step.
+ *  This is used to estimate the time of the next planning step, and makes
+ *  the kart scheduled from the next step on.
+ *  \param kart_id World kart id of the kart.
+ *  \param ns Time in nanoseconds.
+ */
+void AIScheduler::addPlanningTime(unsigned int kart_id, uint64_t ns)
+{
+    if(kart_id>=m_cost.size()) return;
+    m_has_reported[kart_id] = true;
+    m_num_planned++;
+    const float us = ns*0.001f;
+    // A kart that never planned before uses the measured time directly.
+    if(m_cost[kart_id]==0)
+        m_cost[kart_id] = us;
+    else
+        m_cost[kart_id] = 0.9f*m_cost[kart_id] + 0.1f*us;
+}   // addPlanningTime
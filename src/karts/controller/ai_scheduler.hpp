@@ -0,0 +1,106 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2014 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+
+#ifndef HEADER_AI_SCHEDULER_HPP
+#define HEADER_AI_SCHEDULER_HPP
+
+#include "utils/no_copy.hpp"
+
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+/**
+ * \brief Decides which AI karts update their slowly changing decisions in
+ *  a time step.
+ *  The AI splits its work into decisions that must be done every time step
+ *  (steering towards the current aim point, acceleration, braking), and
+ *  decisions that change slowly (item usage, crash lookahead, selecting
+ *  the aim point, nearest karts), called planning here. If a time budget
+ *  is set (UserConfigParams::m_ai_budget), only as many karts plan in a
+ *  step as fit into this budget, preferring karts that have not planned
+ *  for the longest time. A kart still plans at least every
+ *  UserConfigParams::m_ai_max_interval steps, even if this exceeds the
+ *  budget. The time planning takes is measured by the AI and reported
+ *  with addPlanningTime.
+ *  Only karts that reported a planning time in the last step in which they
+ *  were allowed to plan are scheduled. All other karts (players, eliminated
+ *  or finished karts, AI karts in a rescue) are always allowed to plan and
+ *  are not counted in the statistics.
+ *  The scheduler is updated by the world once per time step before the
+ *  karts are updated. Karts are identified by their world kart id.
+ * \ingroup controller
+ */
+class AIScheduler : public NoCopy
+{
+private:
+    /** For each kart true if it plans in the current step. */
+    std::vector<bool>         m_plan;
+
+    /** For each kart the number of steps since it planned last. */
+    std::vector<unsigned int> m_steps_since_plan;
+
+    /** For each kart the smoothed time planning takes, in microseconds. */
+    std::vector<float>        m_cost;
+
+    /** For each kart true if it is scheduled, i.e. if it reported a
+     *  planning time the last time it was allowed to plan. */
+    std::vector<bool>         m_is_scheduled;
+
+    /** For each kart true if it reported a planning time since the last
+     *  step in which it was allowed to plan. */
+    std::vector<bool>         m_has_reported;
+
+    /** The karts sorted by the order in which they are considered: the
+     *  negated number of steps since planning and the world kart id.
+     *  Kept here to avoid reallocating it each step. */
+    std::vector<std::pair<int, unsigned int> > m_order;
+
+    /** Number of planning steps done, deferred because of the budget,
+     *  and done although they exceeded the budget. */
+    unsigned int m_num_planned;
+    unsigned int m_num_deferred;
+    unsigned int m_num_over_budget;
+
+public:
+                 AIScheduler();
+    void         reset(unsigned int num_karts);
+    void         update();
+    void         addPlanningTime(unsigned int kart_id, uint64_t ns);
+    // ------------------------------------------------------------------------
+    /** Returns true if the specified kart should plan in this step. */
+    bool         isPlanningStep(unsigned int kart_id) const
+    {
+        return kart_id>=m_plan.size() || m_plan[kart_id];
+    }   // isPlanningStep
+    // ------------------------------------------------------------------------
+    /** Returns how often scheduled karts planned. */
+    unsigned int getNumPlanned() const { return m_num_planned; }
+    // ------------------------------------------------------------------------
+    /** Returns how often planning was deferred to stay within the budget. */
+    unsigned int getNumDeferred() const { return m_num_deferred; }
+    // ------------------------------------------------------------------------
+    /** Returns how often a kart planned although this exceeded the budget,
+     *  since it had not planned for the maximum number of steps. */
+    unsigned int getNumOverBudget() const { return m_num_over_budget; }
+};   // AIScheduler
+
+#endif
+
+/* EOF */
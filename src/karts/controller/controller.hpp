@@ -104,6 +104,13 @@ public:
     /** Get a pointer on the kart controls. */
     virtual KartControl* getControls() { return m_controls; }
     // ------------------------------------------------------------------------
+    /** Called once per time step before the karts are updated to compute
+     *  decisions that only depend on the current state of the world. This
+     *  can be called from a worker thread at the same time as for other
+     *  controllers, so it must not change anything except data of this
+     *  controller. The default implementation does nothing. */
+    virtual void computeDecisions() {}
+    // ------------------------------------------------------------------------
 };   // Controller
 
 #endif
@@ -60,6 +60,7 @@
 #include "tracks/track.hpp"
 #include "utils/constants.hpp"
 #include "utils/log.hpp"
+#include "utils/time.hpp"
 #include "utils/vs.hpp"
 
 #ifdef AI_DEBUG
@@ -190,6 +191,10 @@ void SkiddingAI::reset()
     m_avoid_item_close           = false;
     m_skid_probability_state     = SKID_PROBAB_NOT_YET;
     m_last_item_random           = NULL;
+    m_is_planning_step           = true;
+    m_planning_dt                = 0.0f;
+    m_has_aim_point              = false;
+    m_has_decisions              = false;
 
     AIBaseController::reset();
     m_track_node               = QuadGraph::UNKNOWN_SECTOR;
@@ -240,8 +245,13 @@ void SkiddingAI::update(float dt)
     m_controls->m_nitro     = false;
 
     // Don't do anything if there is currently a kart animations shown.
+    // The kart might be somewhere else afterwards, so select a new aim
+    // point then.
     if(m_kart->getKartAnimation())
+    {
+        m_has_aim_point = false;
         return;
+    }
 
     if (m_superpower == RaceManager::SUPERPOWER_NOLOK_BOSS)
     {
@@ -308,14 +318,28 @@ void SkiddingAI::update(float dt)
         return;
     }
 
-    // Get information that is needed by more than 1 of the handling funcs
-    computeNearestKarts();
+    // The slowly changing decisions are only updated if the AI scheduler
+    // allows it, otherwise the results of the last update are used.
+    AIScheduler *scheduler = m_world->getAIScheduler();
+    m_is_planning_step = scheduler->isPlanningStep(m_kart->getWorldKartId());
+    m_planning_dt     += dt;
+    const uint64_t planning_start = m_is_planning_step
+                                  ? StkTime::getMonoTimeNs() : 0;
+
+    // The nearest karts and crashes might have already been computed in
+    // computeDecisions.
+    if(m_is_planning_step && !m_has_decisions)
+    {
+        // Get information that is needed by more than 1 of the handling
+        // funcs
+        computeNearestKarts();
+        //Detect if we are going to crash with the track and/or kart
+        checkCrashes(m_kart->getXYZ());
+    }
 
     m_kart->setSlowdown(MaxSpeed::MS_DECREASE_AI,
                         m_ai_properties->getSpeedCap(m_distance_to_player),
                         /*fade_in_time*/0.0f);
-    //Detect if we are going to crash with the track and/or kart
-    checkCrashes(m_kart->getXYZ());
     determineTrackDirection();
 
     // Special behaviour if we have a bomb attach: try to hit the kart ahead
@@ -352,7 +376,10 @@ void SkiddingAI::update(float dt)
         /*Response handling functions*/
         handleAcceleration(dt);
         handleSteering(dt);
-        handleItems(dt);
+        if(m_is_planning_step)
+            handleItems(m_planning_dt);
+        else
+            m_controls->m_fire = false;
         handleRescue(dt);
         handleBraking();
         // If a bomb is attached, nitro might already be set.
@@ -378,10 +405,44 @@ void SkiddingAI::update(float dt)
         }
     }
 
+    if(m_is_planning_step)
+    {
+        uint64_t planning_time = StkTime::getMonoTimeNs()-planning_start;
+        if(m_has_decisions)
+            planning_time += m_decision_time;
+        m_planning_dt   = 0.0f;
+        m_has_decisions = false;
+        scheduler->addPlanningTime(m_kart->getWorldKartId(), planning_time);
+    }
+
     /*And obviously general kart stuff*/
     AIBaseController::update(dt);
 }   // update
 
+//-----------------------------------------------------------------------------
+/** Computes the expensive part of the slowly changing decisions in planning
+ *  steps: the nearest karts, crashes ahead and the aim point. This is called
+ *  by the world before any kart is updated, in parallel for all AI karts if
+ *  enabled, so it only reads the state of the world. Everything that has
+ *  side effects or uses random numbers (items, rescue, skidding) is still
+ *  done in update(), which then uses these results.
+ */
+void SkiddingAI::computeDecisions()
+{
+    m_has_decisions = false;
+    if(m_kart->getKartAnimation() || m_world->isStartPhase() ||
+       !m_world->getAIScheduler()->isPlanningStep(m_kart->getWorldKartId()))
+        return;
+
+    const uint64_t start = StkTime::getMonoTimeNs();
+    computeNearestKarts();
+    checkCrashes(m_kart->getXYZ());
+    m_planned_last_node = QuadGraph::UNKNOWN_SECTOR;
+    findAimPoint(&m_planned_aim_point, &m_planned_last_node);
+    m_decision_time = StkTime::getMonoTimeNs() - start;
+    m_has_decisions = true;
+}   // computeDecisions
+
 //-----------------------------------------------------------------------------
 /** This function decides if the AI should brake.
  *  The decision can be based on race mode (e.g. in follow the leader the AI
@@ -482,6 +543,7 @@ void SkiddingAI::handleSteering(float dt)
     {
         steer_angle = steerToPoint(QuadGraph::get()->getQuadOfNode(next)
                                                     .getCenter());
+        m_has_aim_point = false;
 
 #ifdef AI_DEBUG
         m_debug_sphere[0]->setPosition(QuadGraph::get()->getQuadOfNode(next)
@@ -493,6 +555,7 @@ void SkiddingAI::handleSteering(float dt)
     //drives the kart out of the road
     else if( m_crashes.m_kart != -1 && !m_crashes.m_road )
     {
+        m_has_aim_point = false;
         //-1 = left, 1 = right, 0 = no crash.
         if( m_start_kart_crash_direction == 1 )
         {
@@ -529,39 +592,65 @@ void SkiddingAI::handleSteering(float dt)
     else
     {
         m_start_kart_crash_direction = 0;
-        Vec3 aim_point;
-        int last_node = QuadGraph::UNKNOWN_SECTOR;
-
-        switch(m_point_selection_algorithm)
+        // The aim point is only selected in planning steps, otherwise
+        // the kart keeps on steering to the last aim point.
+        if(m_is_planning_step || !m_has_aim_point)
         {
-        case PSA_FIXED : findNonCrashingPointFixed(&aim_point, &last_node);
-                         break;
-        case PSA_NEW:    findNonCrashingPointNew(&aim_point, &last_node);
-                         break;
-        case PSA_DEFAULT:findNonCrashingPoint(&aim_point, &last_node);
-                         break;
-        }
+            Vec3 aim_point;
+            int last_node = QuadGraph::UNKNOWN_SECTOR;
+
+            if(m_has_decisions)
+            {
+                aim_point = m_planned_aim_point;
+                last_node = m_planned_last_node;
+            }
+            else
+                findAimPoint(&aim_point, &last_node);
 #ifdef AI_DEBUG
-        m_debug_sphere[m_point_selection_algorithm]->setPosition(aim_point.toIrrVector());
+            m_debug_sphere[m_point_selection_algorithm]->setPosition(aim_point.toIrrVector());
 #endif
 #ifdef AI_DEBUG_KART_AIM
-        const Vec3 eps(0,0.5f,0);
-        m_curve[CURVE_AIM]->clear();
-        m_curve[CURVE_AIM]->addPoint(m_kart->getXYZ()+eps);
-        m_curve[CURVE_AIM]->addPoint(aim_point);
+            const Vec3 eps(0,0.5f,0);
+            m_curve[CURVE_AIM]->clear();
+            m_curve[CURVE_AIM]->addPoint(m_kart->getXYZ()+eps);
+            m_curve[CURVE_AIM]->addPoint(aim_point);
 #endif
 
-        // Potentially adjust the point to aim for in order to either
-        // aim to collect item, or steer to avoid a bad item.
-        if(m_ai_properties->m_collect_avoid_items)
-            handleItemCollectionAndAvoidance(&aim_point, last_node);
+            // Potentially adjust the point to aim for in order to either
+            // aim to collect item, or steer to avoid a bad item.
+            if(m_ai_properties->m_collect_avoid_items)
+                handleItemCollectionAndAvoidance(&aim_point, last_node);
 
-        steer_angle = steerToPoint(aim_point);
+            m_aim_point     = aim_point;
+            m_has_aim_point = true;
+        }
+
+        steer_angle = steerToPoint(m_aim_point);
     }  // if m_current_track_direction!=LEFT/RIGHT
 
     setSteering(steer_angle, dt);
 }   // handleSteering
 
+//-----------------------------------------------------------------------------
+/** Selects the point to aim at using the configured point selection
+ *  algorithm, ignoring any items.
+ *  \param aim_point On return contains the point to aim at.
+ *  \param last_node On return contains the last graph node on the straight
+ *         line to the aim point.
+ */
+void SkiddingAI::findAimPoint(Vec3 *aim_point, int *last_node)
+{
+    switch(m_point_selection_algorithm)
+    {
+    case PSA_FIXED : findNonCrashingPointFixed(aim_point, last_node);
+                     break;
+    case PSA_NEW:    findNonCrashingPointNew(aim_point, last_node);
+                     break;
+    case PSA_DEFAULT:findNonCrashingPoint(aim_point, last_node);
+                     break;
+    }
+}   // findAimPoint
+
 //-----------------------------------------------------------------------------
 /** Decides if the currently selected aim at point (as determined by
  *  handleSteering) should be changed in order to collect/avoid an item.
@@ -27,6 +27,8 @@
 #include "tracks/graph_node.hpp"
 #include "utils/random_generator.hpp"
 
+#include <stdint.h>
+
 class LinearWorld;
 class QuadGraph;
 class ShowCurve;
@@ -159,6 +161,31 @@ private:
     /** Distance to the player, used for rubber-banding. */
     float m_distance_to_player;
 
+    /** True if the slowly changing decisions (item usage, crash lookahead,
+     *  aim point, nearest karts) are updated in this step, see
+     *  AIScheduler. Otherwise the results of the last update are used. */
+    bool  m_is_planning_step;
+
+    /** Time since the slowly changing decisions were updated last. */
+    float m_planning_dt;
+
+    /** The point the kart steers to, which is only selected in planning
+     *  steps. Only valid if m_has_aim_point is true. */
+    Vec3  m_aim_point;
+    bool  m_has_aim_point;
+
+    /** True if computeDecisions was called for this step, in which case
+     *  the following values are used instead of computing them in
+     *  update(). */
+    bool  m_has_decisions;
+
+    /** The aim point and last node computed in computeDecisions. */
+    Vec3  m_planned_aim_point;
+    int   m_planned_last_node;
+
+    /** Time in nanoseconds spent in computeDecisions. */
+    uint64_t m_decision_time;
+
     /** A random number generator to decide if the AI should skid or not. */
     RandomGenerator m_random_skid;
 
@@ -242,6 +269,7 @@ private:
     void  findNonCrashingPointFixed(Vec3 *result, int *last_node);
     void  findNonCrashingPointNew(Vec3 *result, int *last_node);
     void  findNonCrashingPoint(Vec3 *result, int *last_node);
+    void  findAimPoint(Vec3 *aim_point, int *last_node);
 
     void  determineTrackDirection();
     void  determineTurnRadius(const Vec3 &start,
@@ -260,6 +288,7 @@ public:
                  SkiddingAI(AbstractKart *kart);
                 ~SkiddingAI();
     virtual void update      (float delta) ;
+    virtual void computeDecisions();
     virtual void reset       ();
     virtual const irr::core::stringw& getNamePostfix() const;
 };
@@ -65,6 +65,7 @@
 #include "tracks/track_manager.hpp"
 #include "utils/constants.hpp"
 #include "utils/log.hpp" //TODO: remove after debugging is done
+#include "utils/snapshot_buffer.hpp"
 #include "utils/vs.hpp"
 
 #include <ICameraSceneNode.h>
@@ -427,6 +428,119 @@ void Kart::reset()
 
 }   // reset
 
+// -----------------------------------------------------------------------------
+/** Saves the state of the kart: its rigid body, the vehicle (wheels and
+ *  suspension), the speed modifiers, skidding, slipstream, attachment,
+ *  powerup and the timers of the kart. Ghost karts have no physics body,
+ *  their position only depends on the race time, so nothing is saved.
+ *  \param buffer The snapshot buffer to write to.
+ */
+void Kart::saveState(SnapshotBuffer *buffer) const
+{
+    if(!m_body) return;
+
+    AbstractKart::saveState(buffer);
+    buffer->add(m_controls);
+    buffer->add(m_race_position);
+    buffer->add(m_finished_race);
+    buffer->add(m_finish_time);
+    buffer->add(m_eliminated);
+    buffer->add(m_flying);
+    buffer->add(m_has_started);
+    buffer->add(m_has_caught_nolok_bubblegum);
+    buffer->add(m_bounce_back_time);
+    buffer->add(m_invulnerable_time);
+    buffer->add(m_squash_time);
+    buffer->add(m_current_lean);
+    buffer->add(m_bubblegum_time);
+    buffer->add(m_bubblegum_torque);
+    buffer->add(m_fire_clicked);
+    buffer->add(m_collected_energy);
+    buffer->add(m_jump_time);
+    buffer->add(m_is_jumping);
+    buffer->add(m_wheel_rotation);
+    buffer->add(m_view_blocked_by_plunger);
+    buffer->add(m_speed);
+    buffer->add(m_time_last_crash);
+    buffer->add(m_min_nitro_time);
+    m_vehicle->saveState(buffer);
+    m_max_speed->saveState(buffer);
+    m_skidding->saveState(buffer);
+    m_slipstream->saveState(buffer);
+    m_attachment->saveState(buffer);
+    m_powerup->saveState(buffer);
+}   // saveState
+
+// -----------------------------------------------------------------------------
+/** Restores the state saved with saveState. A running kart animation
+ *  (rescue, explosion, cannon) is stopped first, since animations are not
+ *  part of a snapshot. The controller of the kart is not changed, and
+ *  neither are the cameras that were moved to another kart when this kart
+ *  was eliminated.
+ *  \param buffer The snapshot buffer to read from.
+ */
+void Kart::restoreState(SnapshotBuffer *buffer)
+{
+    if(!m_body) return;
+
+    if(m_kart_animation)
+        m_kart_animation->stop();
+
+    AbstractKart::restoreState(buffer);
+    buffer->get(&m_controls);
+    buffer->get(&m_race_position);
+    buffer->get(&m_finished_race);
+    buffer->get(&m_finish_time);
+    bool eliminated;
+    buffer->get(&eliminated);
+    if(eliminated!=m_eliminated)
+    {
+        // E.g. a kart that was eliminated in a battle after the state
+        // was saved is added to the physics and shown again.
+        if(eliminated)
+            eliminate();
+        else
+        {
+            m_eliminated = false;
+            World::getWorld()->getPhysics()->addKart(this);
+            m_node->setVisible(true);
+        }
+    }
+    bool flying;
+    buffer->get(&flying);
+    if(flying!=m_flying)
+    {
+        m_flying = flying;
+        if(m_flying) flyUp(); else stopFlying();
+    }
+    buffer->get(&m_has_started);
+    buffer->get(&m_has_caught_nolok_bubblegum);
+    buffer->get(&m_bounce_back_time);
+    buffer->get(&m_invulnerable_time);
+    buffer->get(&m_squash_time);
+    buffer->get(&m_current_lean);
+    buffer->get(&m_bubblegum_time);
+    buffer->get(&m_bubblegum_torque);
+    buffer->get(&m_fire_clicked);
+    buffer->get(&m_collected_energy);
+    buffer->get(&m_jump_time);
+    buffer->get(&m_is_jumping);
+    buffer->get(&m_wheel_rotation);
+    buffer->get(&m_view_blocked_by_plunger);
+    buffer->get(&m_speed);
+    buffer->get(&m_time_last_crash);
+    buffer->get(&m_min_nitro_time);
+    m_vehicle->restoreState(buffer);
+    m_max_speed->restoreState(buffer);
+    m_skidding->restoreState(buffer);
+    m_slipstream->restoreState(buffer);
+    m_attachment->restoreState(buffer);
+    m_powerup->restoreState(buffer);
+
+    m_node->setScale(isSquashed() ? core::vector3df(1.0f, 0.5f, 1.0f)
+                                  : core::vector3df(1.0f, 1.0f, 1.0f));
+}   // restoreState
+
 // -----------------------------------------------------------------------------
 void Kart::increaseMaxSpeed(unsigned int category, float add_speed,
                             float engine_force, float duration,
@@ -1339,8 +1453,8 @@ void Kart::update(float dt)
     {
         // Kart touched ground again
         m_is_jumping = false;
-        HitEffect *effect =  new Explosion(getXYZ(), "jump", 
-                                          "jump_explosion.xml");
+        HitEffect *effect = projectile_manager->newExplosion(getXYZ(), "jump",
+                                                  "jump_explosion.xml");
         projectile_manager->addHitEffect(effect);
         m_kart_model->setAnimation(KartModel::AF_DEFAULT);
         m_jump_time = 0;
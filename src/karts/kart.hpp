@@ -35,6 +35,7 @@
 #include "utils/no_copy.hpp"
 
 class btKart;
+class btKartRaycaster;
 class btUprightConstraint;
 
 class Attachment;
@@ -144,7 +145,7 @@ private:
     // Bullet physics parameters
     // -------------------------
     btCompoundShape          m_kart_chassis;
-    btVehicleRaycaster      *m_vehicle_raycaster;
+    btKartRaycaster         *m_vehicle_raycaster;
     btKart                  *m_vehicle;
     btUprightConstraint     *m_uprightConstraint;
 
@@ -253,6 +254,8 @@ public:
     virtual float getTerrainPitch(float heading) const;
 
     virtual void   reset            ();
+    virtual void   saveState        (SnapshotBuffer *buffer) const;
+    virtual void   restoreState     (SnapshotBuffer *buffer);
     virtual void   handleZipper     (const Material *m=NULL,
                                      bool play_sound=false);
     virtual void   setSquash        (float time, float slowdown);
@@ -0,0 +1,171 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2014 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+
+#include "karts/kart_spatial_index.hpp"
+
+#include "karts/abstract_kart.hpp"
+#include "karts/kart_properties.hpp"
+#include "karts/moveable.hpp"
+#include "modes/world.hpp"
+
+#include <algorithm>
+#include <math.h>
+
+KartSpatialIndex::KartSpatialIndex()
+{
+    m_num_placements        = 0;
+    m_is_valid              = false;
+    m_max_kart_length       = 0;
+    m_max_slipstream_length = 0;
+}   // KartSpatialIndex
+
+// ----------------------------------------------------------------------------
+/** Rebuilds the index if it is outdated, i.e. if it was never built or
+ *  invalidated, or if any moveable was placed explicitly since it was
+ *  built.
+ */
+void KartSpatialIndex::checkValid()
+{
+    if(!m_is_valid || m_num_placements!=Moveable::getNumPlacements())
+        update();
+}   // checkValid
+
+// ----------------------------------------------------------------------------
+/** Rebuilds the index from the current positions of all karts, and the
+ *  positions they have in the physics (which they will copy when they are
+ *  updated).
+ */
+void KartSpatialIndex::update()
+{
+    World *world           = World::getWorld();
+    unsigned int num_karts = world->getNumKarts();
+    m_min.resize(num_karts);
+    m_max.resize(num_karts);
+    m_max_kart_length       = 0;
+    m_max_slipstream_length = 0;
+
+    Vec3 grid_min( 999999.9f), grid_max(-999999.9f);
+    for(unsigned int i=0; i<num_karts; i++)
+    {
+        const AbstractKart *kart = world->getKart(i);
+        m_min[i] = kart->getXYZ();
+        m_max[i] = kart->getXYZ();
+        const btRigidBody *body = kart->getBody();
+        if(body && body->getMotionState())
+        {
+            btTransform t;
+            body->getMotionState()->getWorldTransform(t);
+            m_min[i].setMin(t.getOrigin());
+            m_max[i].setMax(t.getOrigin());
+        }
+        grid_min.setMin(m_min[i]);
+        grid_max.setMax(m_max[i]);
+
+        m_max_kart_length = std::max(m_max_kart_length,
+                                     kart->getKartLength());
+        m_max_slipstream_length =
+            std::max(m_max_slipstream_length,
+                     kart->getKartProperties()->getSlipstreamLength());
+    }
+
+    // The grid covers exactly the area of all karts, so no kart is clamped
+    // into a cell it is not in.
+    m_grid_min = grid_min;
+    m_grid_max = grid_max;
+    if(num_karts>0)
+    {
+        m_grid.init(grid_min, grid_max, /*cell_size*/20.0f,
+                    /*max_cells_per_axis*/32);
+        for(unsigned int i=0; i<num_karts; i++)
+            m_grid.add(i, m_min[i], m_max[i]);
+    }
+    else
+        m_grid.clear();
+
+    m_num_placements = Moveable::getNumPlacements();
+    m_is_valid       = true;
+}   // update
+
+// ----------------------------------------------------------------------------
+/** Returns all karts that might be within the given 2d distance (i.e.
+ *  ignoring the height) of a point. The caller must do the exact test,
+ *  the list can contain karts which are further away.
+ *  \param xyz The point.
+ *  \param radius The maximum distance (in the X/Z plane).
+ *  \param karts On return the sorted list of world kart ids.
+ *  \return True if the list contains all karts. This is always the case
+ *          if the radius covers the whole grid, so that callers which
+ *          double the radius till they find a kart terminate even if a
+ *          kart has an invalid (NaN) position and is never found.
+ */
+bool KartSpatialIndex::getKartsInRange(const Vec3 &xyz, float radius,
+                                       std::vector<unsigned int> *karts)
+{
+    checkValid();
+    karts->clear();
+    if(m_grid.isEmpty()) return true;
+
+    // Add a small epsilon, so that rounding errors can not remove a kart
+    // that the exact test of the caller would accept.
+    radius += 0.01f;
+    const float r2 = radius*radius;
+    const float x  = xyz.getX(), z = xyz.getZ();
+
+    // If the circle contains the whole grid (or the point is invalid),
+    // return all karts, including karts that are not in the grid.
+    const float fx = std::max(fabsf(x-m_grid_min.getX()),
+                              fabsf(x-m_grid_max.getX()));
+    const float fz = std::max(fabsf(z-m_grid_min.getZ()),
+                              fabsf(z-m_grid_max.getZ()));
+    if(!(fx*fx+fz*fz > r2))
+    {
+        for(unsigned int i=0; i<m_min.size(); i++)
+            karts->push_back(i);
+        return true;
+    }
+    int x0, z0, x1, z1;
+    m_grid.getCell(x-radius, z-radius, &x0, &z0);
+    m_grid.getCell(x+radius, z+radius, &x1, &z1);
+    for(int cz=z0; cz<=z1; cz++)
+    {
+        for(int cx=x0; cx<=x1; cx++)
+        {
+            if(m_grid.getDistance2ToCell(x, z, cx, cz) > r2)
+                continue;
+            const std::vector<int> &objects = m_grid.getObjects(cx, cz);
+            for(unsigned int i=0; i<objects.size(); i++)
+            {
+                // 2d distance of the point to the box of the kart
+                const Vec3 &min = m_min[objects[i]];
+                const Vec3 &max = m_max[objects[i]];
+                float dx = std::max(std::max(min.getX()-x, x-max.getX()),
+                                    0.0f);
+                float dz = std::max(std::max(min.getZ()-z, z-max.getZ()),
+                                    0.0f);
+                if(dx*dx+dz*dz <= r2)
+                    karts->push_back(objects[i]);
+            }
+        }   // for cx
+    }   // for cz
+
+    // A kart overlapping more than one cell is found more than once.
+    std::sort(karts->begin(), karts->end());
+    karts->erase(std::unique(karts->begin(), karts->end()), karts->end());
+    return karts->size()==m_min.size();
+}   // getKartsInRange
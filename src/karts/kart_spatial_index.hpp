@@ -0,0 +1,90 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2014 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+
+#ifndef HEADER_KART_SPATIAL_INDEX_HPP
+#define HEADER_KART_SPATIAL_INDEX_HPP
+
+#include "tracks/spatial_grid.hpp"
+#include "utils/no_copy.hpp"
+#include "utils/vec3.hpp"
+
+#include <vector>
+
+/**
+ * \brief A spatial index of all karts, used to find the karts close to a
+ *  point without testing every kart.
+ *  It is rebuilt by the world once per time step after the physics was
+ *  updated. At that time the karts have not yet copied their new position
+ *  from the physics, and this happens one kart after the other while the
+ *  karts are updated. Therefore each kart is stored with the box enclosing
+ *  both its current and its new position, so that the index is valid at
+ *  any time during the update. If any kart is placed explicitly (e.g.
+ *  after a rescue), the index is rebuilt before the next query.
+ *  Queries return a superset of the karts in range, sorted by world kart
+ *  id, so callers can do their exact tests in the same order as a loop
+ *  over all karts.
+ * \ingroup karts
+ */
+class KartSpatialIndex : public NoCopy
+{
+private:
+    /** The grid storing the world kart ids. */
+    SpatialGrid       m_grid;
+
+    /** For each kart the minimum and maximum of the box enclosing its
+     *  current and its new position. */
+    std::vector<Vec3> m_min, m_max;
+
+    /** Minimum and maximum of the area covered by the grid. */
+    Vec3              m_grid_min, m_grid_max;
+
+    /** The value of Moveable::getNumPlacements() when the index was
+     *  built. */
+    unsigned int      m_num_placements;
+
+    /** False if the index must be rebuilt before it can be used. */
+    bool              m_is_valid;
+
+    /** Maximum kart length and slipstream length of all karts. */
+    float             m_max_kart_length;
+    float             m_max_slipstream_length;
+
+    void              checkValid();
+public:
+          KartSpatialIndex();
+    void  update();
+    bool  getKartsInRange(const Vec3 &xyz, float radius,
+                          std::vector<unsigned int> *karts);
+    // ------------------------------------------------------------------------
+    /** Forces the index to be rebuilt before it is used next time, e.g.
+     *  when karts are added or removed. */
+    void  invalidate() { m_is_valid = false; }
+    // ------------------------------------------------------------------------
+    /** Returns the length of the longest kart. */
+    float getMaxKartLength()       { checkValid(); return m_max_kart_length; }
+    // ------------------------------------------------------------------------
+    /** Returns the longest slipstream length of all karts. */
+    float getMaxSlipstreamLength()
+    {
+        checkValid();
+        return m_max_slipstream_length;
+    }   // getMaxSlipstreamLength
+};   // KartSpatialIndex
+
+#endif
@@ -24,6 +24,7 @@
 #include "karts/abstract_kart.hpp"
 #include "karts/kart_properties.hpp"
 #include "physics/btKart.hpp"
+#include "utils/snapshot_buffer.hpp"
 
 /** This class handles maximum speed for karts. Several factors can influence
  *  the maximum speed a kart can drive, some will decrease the maximum speed,
@@ -78,6 +79,32 @@ void MaxSpeed::reset()
     }
 }   // reset
 
+// ----------------------------------------------------------------------------
+/** Saves the current maximum speed and all speed increases and decreases.
+ *  \param buffer The snapshot buffer to write to.
+ */
+void MaxSpeed::saveState(SnapshotBuffer *buffer) const
+{
+    buffer->add(m_current_max_speed);
+    buffer->add(m_add_engine_force);
+    buffer->add(m_min_speed);
+    buffer->addArray(m_speed_increase, MS_INCREASE_MAX);
+    buffer->addArray(m_speed_decrease, MS_DECREASE_MAX);
+}   // saveState
+
+// ----------------------------------------------------------------------------
+/** Restores the state saved with saveState.
+ *  \param buffer The snapshot buffer to read from.
+ */
+void MaxSpeed::restoreState(SnapshotBuffer *buffer)
+{
+    buffer->get(&m_current_max_speed);
+    buffer->get(&m_add_engine_force);
+    buffer->get(&m_min_speed);
+    buffer->getArray(m_speed_increase, MS_INCREASE_MAX);
+    buffer->getArray(m_speed_decrease, MS_DECREASE_MAX);
+}   // restoreState
+
 // ----------------------------------------------------------------------------
 /** Sets an increased maximum speed for a category.
  *  \param category The category for which to set the higher maximum speed.
@@ -22,6 +22,7 @@
 /** \defgroup karts */
 
 class AbstractKart;
+class SnapshotBuffer;
 
 class MaxSpeed
 {
@@ -164,6 +165,8 @@ public:
     float getSpeedIncreaseTimeLeft(unsigned int category);
     void  update(float dt);
     void  reset();
+    void  saveState(SnapshotBuffer *buffer) const;
+    void  restoreState(SnapshotBuffer *buffer);
     // ------------------------------------------------------------------------
     /** Sets the minimum speed a kart should have. This is used to guarantee
      *  that e.g. zippers on ramps will always fast enough for the karts to 
@@ -25,9 +25,12 @@
 #include "graphics/material_manager.hpp"
 #include "modes/world.hpp"
 #include "tracks/track.hpp"
+#include "utils/snapshot_buffer.hpp"
 
 #include "ISceneNode.h"
 
+unsigned int Moveable::m_num_placements = 0;
+
 Moveable::Moveable()
 {
     m_body            = 0;
@@ -35,6 +38,10 @@ Moveable::Moveable()
     m_mesh            = NULL;
     m_node            = NULL;
     m_heading         = 0;
+    m_previous_gfx_transform.setIdentity();
+    m_last_gfx_transform.setIdentity();
+    m_smoothed_transform.setIdentity();
+    m_gfx_rotation    = btQuaternion(0, 0, 0, 1);
 }   // Moveable
 
 //-----------------------------------------------------------------------------
@@ -60,22 +67,57 @@ void Moveable::setNode(scene::ISceneNode *n)
 /** Updates the graphics model. Mainly set the graphical position to be the
  *  same as the physics position, but uses offsets to position and rotation
  *  for special gfx effects (e.g. skidding will turn the karts more).
+ *  This is called once per simulation step, and also stores the current
+ *  transform for interpolateGraphics.
  *  \param offset_xyz Offset to be added to the position.
  *  \param rotation Additional rotation.
  */
 void Moveable::updateGraphics(float dt, const Vec3& offset_xyz,
                               const btQuaternion& rotation)
 {
-    Vec3 xyz=getXYZ()+offset_xyz;
+    m_previous_gfx_transform = m_last_gfx_transform;
+    m_last_gfx_transform     = m_transform;
+    m_smoothed_transform     = m_transform;
+    m_gfx_offset_xyz         = offset_xyz;
+    m_gfx_rotation           = rotation;
+    placeNode();
+}   // updateGraphics
+
+//-----------------------------------------------------------------------------
+/** Positions the graphics model between the last two simulation steps.
+ *  If the object moved too far in the last step (e.g. it was rescued or
+ *  just created), it is shown at its current position.
+ *  \param alpha 0 for the previous, 1 for the last simulation step.
+ */
+void Moveable::interpolateGraphics(float alpha)
+{
+    const btVector3 &from = m_previous_gfx_transform.getOrigin();
+    const btVector3 &to   = m_last_gfx_transform.getOrigin();
+    if(from.distance2(to) > 25.0f)
+        alpha = 1.0f;
+    m_smoothed_transform.setOrigin(from.lerp(to, alpha));
+    m_smoothed_transform.setRotation(
+                        m_previous_gfx_transform.getRotation()
+                        .slerp(m_last_gfx_transform.getRotation(), alpha));
+    placeNode();
+}   // interpolateGraphics
+
+//-----------------------------------------------------------------------------
+/** Sets the position and rotation of the scene node from the smoothed
+ *  transform and the graphical offsets.
+ */
+void Moveable::placeNode()
+{
+    Vec3 xyz = getSmoothedXYZ()+m_gfx_offset_xyz;
     m_node->setPosition(xyz.toIrrVector());
-    btQuaternion r_all = getRotation()*rotation;
+    btQuaternion r_all = m_smoothed_transform.getRotation()*m_gfx_rotation;
     if(btFuzzyZero(r_all.getX()) && btFuzzyZero(r_all.getY()-0.70710677f) &&
        btFuzzyZero(r_all.getZ()) && btFuzzyZero(r_all.getW()-0.70710677f)   )
         r_all.setX(0.000001f);
     Vec3 hpr;
     hpr.setHPR(r_all);
     m_node->setRotation(hpr.toIrrHPR());
-}   // updateGraphics
+}   // placeNode
 
 //-----------------------------------------------------------------------------
 /** The reset position must be set before calling reset
@@ -97,6 +139,9 @@ void Moveable::reset()
     Vec3 forw_vec = m_transform.getBasis().getColumn(0);
     m_heading     = -atan2f(forw_vec.getZ(), forw_vec.getX());
 
+    m_previous_gfx_transform = m_transform;
+    m_last_gfx_transform     = m_transform;
+    m_smoothed_transform     = m_transform;
 }   // reset
 
 //-----------------------------------------------------------------------------
@@ -125,6 +170,18 @@ void Moveable::stopFlying()
  *  \param float dt Time step size.
  */
 void Moveable::update(float dt)
+{
+    updateFromPhysics();
+    updateGraphics(dt, Vec3(0,0,0), btQuaternion(0, 0, 0, 1));
+}   // update
+
+//-----------------------------------------------------------------------------
+/** Copies the position, rotation and velocity from the physics body. This
+ *  is done by update(), but the world also calls it for all karts before
+ *  any kart is updated, so that the AI can use the current state of all
+ *  karts (see World::update).
+ */
+void Moveable::updateFromPhysics()
 {
     if(m_body->getInvMass()!=0)
         m_motion_state->getWorldTransform(m_transform);
@@ -138,9 +195,57 @@ void Moveable::update(float dt)
     Vec3 up       = getTrans().getBasis().getColumn(1);
     m_pitch       = atan2(up.getZ(), fabsf(up.getY()));
     m_roll        = atan2(up.getX(), up.getY());
+}   // updateFromPhysics
 
-    updateGraphics(dt, Vec3(0,0,0), btQuaternion(0, 0, 0, 1));
-}   // update
+//-----------------------------------------------------------------------------
+/** Saves the position, rotation and velocities of this moveable.
+ *  \param buffer The snapshot buffer to write to.
+ */
+void Moveable::saveState(SnapshotBuffer *buffer) const
+{
+    buffer->add(m_transform);
+    buffer->add(m_velocityLC);
+    buffer->add(m_heading);
+    buffer->add(m_pitch);
+    buffer->add(m_roll);
+    buffer->add(m_body->getWorldTransform());
+    buffer->add(m_body->getLinearVelocity());
+    buffer->add(m_body->getAngularVelocity());
+}   // saveState
+
+//-----------------------------------------------------------------------------
+/** Restores the position, rotation and velocities of this moveable, and
+ *  removes all forces that were applied since the last physics step.
+ *  \param buffer The snapshot buffer to read from.
+ */
+void Moveable::restoreState(SnapshotBuffer *buffer)
+{
+    m_num_placements++;
+    buffer->get(&m_transform);
+    buffer->get(&m_velocityLC);
+    buffer->get(&m_heading);
+    buffer->get(&m_pitch);
+    buffer->get(&m_roll);
+    btTransform body_transform;
+    btVector3   linear_velocity, angular_velocity;
+    buffer->get(&body_transform);
+    buffer->get(&linear_velocity);
+    buffer->get(&angular_velocity);
+
+    m_body->setCenterOfMassTransform(body_transform);
+    m_body->setLinearVelocity(linear_velocity);
+    m_body->setAngularVelocity(angular_velocity);
+    m_body->clearForces();
+    if(m_body->getInvMass()!=0)
+        m_body->activate();
+    if(m_motion_state)
+        m_motion_state->setWorldTransform(m_transform);
+
+    // Don't interpolate from the position before the restore
+    m_previous_gfx_transform = m_transform;
+    m_last_gfx_transform     = m_transform;
+    m_smoothed_transform     = m_transform;
+}   // restoreState
 
 //-----------------------------------------------------------------------------
 /** Creates the bullet rigid body for this moveable.
@@ -155,7 +260,12 @@ void Moveable::createBody(float mass, btTransform& trans,
     btVector3 inertia;
     shape->calculateLocalInertia(mass, inertia);
     m_transform = trans;
-    m_motion_state = new KartMotionState(trans);
+    // A body and motion state can already exist if they are reused (see
+    // Flyable), in which case they are reinitialised in place.
+    if(m_motion_state)
+        m_motion_state->setWorldTransform(trans);
+    else
+        m_motion_state = new KartMotionState(trans);
 
     btRigidBody::btRigidBodyConstructionInfo info(mass, m_motion_state,
                                                   shape, inertia);
@@ -163,7 +273,13 @@ void Moveable::createBody(float mass, btTransform& trans,
 
     // Then create a rigid body
     // ------------------------
-    m_body = new btRigidBody(info);
+    if(m_body)
+    {
+        m_body->~btRigidBody();
+        new(m_body) btRigidBody(info);
+    }
+    else
+        m_body = new btRigidBody(info);
     if(mass==0)
     {
         // Create a kinematic object
@@ -186,6 +302,7 @@ void Moveable::createBody(float mass, btTransform& trans,
  */
 void Moveable::setTrans(const btTransform &t)
 {
+    m_num_placements++;
     m_transform=t;
     if(m_motion_state)
         m_motion_state->setWorldTransform(t);
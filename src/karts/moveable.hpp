@@ -34,6 +34,7 @@ using namespace irr;
 #include "network/types.hpp"
 
 class Material;
+class SnapshotBuffer;
 
 /**
   * \ingroup karts
@@ -50,6 +51,26 @@ private:
     /** The roll between -180 and 180 degrees. */
     float                  m_roll;
 
+    /** The transform at the previous and at the last call of
+     *  updateGraphics, i.e. of the last two simulation steps. The graphics
+     *  are interpolated between these two when a fixed time step is used. */
+    btTransform            m_previous_gfx_transform;
+    btTransform            m_last_gfx_transform;
+
+    /** The transform used for the graphics (and the camera). */
+    btTransform            m_smoothed_transform;
+
+    /** The graphical offset and rotation of the last updateGraphics call. */
+    Vec3                   m_gfx_offset_xyz;
+    btQuaternion           m_gfx_rotation;
+
+    /** Counts how often any moveable was placed explicitly (i.e. not
+     *  moved by the physics). The kart spatial index uses this to detect
+     *  that it is outdated. */
+    static unsigned int    m_num_placements;
+
+    void          placeNode();
+
 protected:
     UserPointer            m_user_pointer;
     scene::IMesh          *m_mesh;
@@ -78,6 +99,13 @@ public:
     float         getRoll()       const        {return m_roll;                     }
     const btQuaternion
                   getRotation()   const        {return m_transform.getRotation();  }
+    /** Returns the transform at which the model is shown. With a fixed
+     *  time step it is interpolated between the last simulation steps. */
+    const btTransform
+                 &getSmoothedTrans() const     {return m_smoothed_transform;       }
+    /** Returns the position at which the model is shown. */
+    const Vec3&   getSmoothedXYZ() const
+                              {return (Vec3&)m_smoothed_transform.getOrigin();}
 
     /** Enter flying mode */
     virtual void flyUp();
@@ -87,6 +115,7 @@ public:
     /** Sets the XYZ coordinates of the moveable. */
     void setXYZ(const Vec3& a)
     {
+        m_num_placements++;
         m_transform.setOrigin(a);
         if(m_motion_state)
             m_motion_state->setWorldTransform(m_transform);
@@ -102,8 +131,12 @@ public:
     // ------------------------------------------------------------------------
     virtual void  updateGraphics(float dt, const Vec3& off_xyz,
                                  const btQuaternion& off_rotation);
+    void          interpolateGraphics(float alpha);
     virtual void  reset();
     virtual void  update(float dt) ;
+    void          updateFromPhysics();
+    virtual void  saveState(SnapshotBuffer *buffer) const;
+    virtual void  restoreState(SnapshotBuffer *buffer);
     btRigidBody  *getBody() const {return m_body; }
     void          createBody(float mass, btTransform& trans,
                              btCollisionShape *shape,
@@ -111,6 +144,10 @@ public:
     const btTransform
                  &getTrans() const {return m_transform;}
     void          setTrans(const btTransform& t);
+    // ------------------------------------------------------------------------
+    /** Returns how often a moveable was placed with setXYZ, setTrans or
+     *  restoreState (see KartSpatialIndex). */
+    static unsigned int getNumPlacements() { return m_num_placements; }
 }
 ;   // class Moveable
 
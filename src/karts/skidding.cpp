@@ -30,6 +30,7 @@
 #include "physics/btKart.hpp"
 #include "tracks/track.hpp"
 #include "utils/log.hpp"
+#include "utils/snapshot_buffer.hpp"
 
 /** Constructor of the skidding object.
  */
@@ -77,6 +78,41 @@ void Skidding::reset()
     m_kart->getControls().m_skid = KartControl::SC_NONE;
 }   // reset
 
+// ----------------------------------------------------------------------------
+/** Saves the skidding state.
+ *  \param buffer The snapshot buffer to write to.
+ */
+void Skidding::saveState(SnapshotBuffer *buffer) const
+{
+    buffer->add(m_skid_state);
+    buffer->add(m_skid_time);
+    buffer->add(m_skid_factor);
+    buffer->add(m_real_steering);
+    buffer->add(m_visual_rotation);
+    buffer->add(m_skid_bonus_ready);
+    buffer->add(m_gfx_jump_offset);
+    buffer->add(m_remaining_jump_time);
+    buffer->add(m_jump_speed);
+}   // saveState
+
+// ----------------------------------------------------------------------------
+/** Restores the skidding state. Graphical effects like the skid particles
+ *  are not changed.
+ *  \param buffer The snapshot buffer to read from.
+ */
+void Skidding::restoreState(SnapshotBuffer *buffer)
+{
+    buffer->get(&m_skid_state);
+    buffer->get(&m_skid_time);
+    buffer->get(&m_skid_factor);
+    buffer->get(&m_real_steering);
+    buffer->get(&m_visual_rotation);
+    buffer->get(&m_skid_bonus_ready);
+    buffer->get(&m_gfx_jump_offset);
+    buffer->get(&m_remaining_jump_time);
+    buffer->get(&m_jump_speed);
+}   // restoreState
+
 // ----------------------------------------------------------------------------
 /** Computes the actual steering fraction to be used in the physics, and
  *  stores it in m_real_skidding. This is later used by kart to set the
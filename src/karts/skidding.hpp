@@ -26,6 +26,7 @@
 
 class Kart;
 class ShowCurve;
+class SnapshotBuffer;
 
 #include <vector>
 
@@ -106,6 +107,8 @@ public:
          Skidding(Kart *kart, const SkiddingProperties *sp);
         ~Skidding();
     void reset();
+    void saveState(SnapshotBuffer *buffer) const;
+    void restoreState(SnapshotBuffer *buffer);
     void update(float dt, bool is_on_ground, float steer,
                 KartControl::SkidControl skidding);
     // ------------------------------------------------------------------------
@@ -171,8 +171,11 @@
 #include "modes/demo_world.hpp"
 #include "modes/profile_world.hpp"
 #include "network/client_network_manager.hpp"
+#include "network/network_bot.hpp"
 #include "network/network_manager.hpp"
+#include "network/network_statistics.hpp"
 #include "network/protocol_manager.hpp"
+#include "network/protocols/connect_to_server.hpp"
 #include "network/protocols/server_lobby_room_protocol.hpp"
 #include "network/server_network_manager.hpp"
 #include "network/client_network_manager.hpp"
@@ -423,6 +426,28 @@ void cmdLineHelp()
     "       --profile-time=n   Enable automatic driven profile mode for n "
                               "seconds.\n"
     "       --no-graphics      Do not display the actual race.\n"
+    "       --profile-projectiles=n\n"
+    "                          Keep n projectiles on the track in profile "
+                              "mode.\n"
+    "       --broadphase=NAME  Use the physics broadphase NAME (axis-sweep "
+                              "or dbvt).\n"
+    "       --simulation-fps=n Simulate n steps per second (0: one step per "
+                              "frame).\n"
+    "       --ai-budget=n      Limit the slowly changing AI decisions to n "
+                              "microseconds\n"
+    "                          per step (0: no limit).\n"
+    "       --ai-threads=n     Compute the AI decisions with n additional "
+                              "threads\n"
+    "                          (0: off, -1: one per additional core).\n"
+    "       --benchmark-bvh=n  Compare the track BVH with and without "
+                              "quantization\n"
+    "                          using n raycasts.\n"
+    "       --benchmark-physics=n\n"
+    "                          Benchmark the kart physics for n steps and "
+                              "exit.\n"
+    "       --benchmark-output=FILE\n"
+    "                          Write the physics benchmark results (JSON) "
+                              "to FILE.\n"
     "       --with-profile     Enables the profile mode.\n"
     "       --demo-mode=t      Enables demo mode after t seconds idle time in "
                                "main menu.\n"
@@ -440,6 +465,14 @@ void cmdLineHelp()
     "       --password=s       Automatically sign in (set the password).\n"
     "       --port=n           Port number to use.\n"
     "       --max-players=n    Maximum number of clients (server only).\n"
+    "       --lan-server       Do not register the server online, clients\n"
+    "                          must use --connect-to (server only).\n"
+    "       --connect-to=ip:port Connect directly to a (LAN) server.\n"
+    "       --network-bot=n    Play as bot with player id n, without user\n"
+    "                          input (for load tests, see\n"
+    "                          tools/network_load_test.sh).\n"
+    "       --network-stats=n  Log tick time, event queue size and\n"
+    "                          bandwidth per peer every n seconds.\n"
     "       --no-console       Does not write messages in the console but to\n"
     "                          stdout.log.\n"
     "       --console          Write messages in the console and files\n"
@@ -645,9 +678,24 @@ int handleCmdLine()
         Log::info("main", "Creating a server network manager.");
     }   // -server
 
+    if(CommandLine::has("--lan-server"))
+    {
+        if (NetworkManager::getInstance() &&
+            NetworkManager::getInstance()->isServer())
+            ServerNetworkManager::getInstance()->setLanServer(true);
+        else
+            Log::warn("main", "--lan-server requires --server.");
+    }   // --lan-server
+
     if(CommandLine::has("--max-players", &n))
         UserConfigParams::m_server_max_players=n;
 
+    if(CommandLine::has("--network-bot", &n))
+        NetworkBot::enable(n);
+
+    if(CommandLine::has("--network-stats", &n) && n > 0)
+        NetworkStatistics::enable((float)n);
+
     if(CommandLine::has("--login", &s) )
     {
         login = s.c_str();
@@ -869,6 +917,45 @@ int handleCmdLine()
         race_manager->setNumLaps(999999); // profile end depends on time
     }   // --profile-time
 
+    if(CommandLine::has("--profile-projectiles", &n))
+        ProfileWorld::setNumProjectiles(n);
+
+    if(CommandLine::has("--broadphase", &s))
+    {
+        if(!stk_config->setBroadphase(s))
+        {
+            Log::error("main", "Invalid broadphase: %s.", s.c_str());
+            return 0;
+        }
+    }   // --broadphase
+
+    if(CommandLine::has("--simulation-fps", &n))
+        UserConfigParams::m_simulation_fps = n;
+
+    if(CommandLine::has("--ai-budget", &n))
+        UserConfigParams::m_ai_budget = n;
+
+    if(CommandLine::has("--ai-threads", &n))
+        UserConfigParams::m_ai_threads = n;
+
+    if(CommandLine::has("--benchmark-bvh", &n))
+        UserConfigParams::m_bvh_benchmark = n;
+
+    if(CommandLine::has("--benchmark-physics", &n))
+    {
+        UserConfigParams::m_physics_benchmark = n;
+        // The benchmark is run in profile mode, and exits afterwards.
+        if (!ProfileWorld::isProfileMode())
+        {
+            UserConfigParams::m_no_start_screen = true;
+            ProfileWorld::setProfileModeLaps(1);
+            race_manager->setNumLaps(1);
+        }
+    }   // --benchmark-physics
+
+    if(CommandLine::has("--benchmark-output", &s))
+        UserConfigParams::m_physics_benchmark_file = s;
+
     if(CommandLine::has("--with-profile") )
     {
         // Set default profile mode of 1 lap if we haven't already set one
@@ -1184,6 +1271,26 @@ int main(int argc, char *argv[] )
         {
             ProtocolManager::getInstance()->requestStart(new ServerLobbyRoomProtocol());
         }
+        else
+        {
+            std::string server;
+            if (CommandLine::has("--connect-to", &server))
+            {
+                TransportAddress address;
+                unsigned int a, b, c, d, port = 7321;
+                if (sscanf(server.c_str(), "%u.%u.%u.%u:%u",
+                           &a, &b, &c, &d, &port) >= 4)
+                {
+                    address.ip   = (a << 24) | (b << 16) | (c << 8) | d;
+                    address.port = port;
+                    ProtocolManager::getInstance()->requestStart(
+                                                new ConnectToServer(address));
+                }
+                else
+                    Log::error("main", "Invalid server address '%s'.",
+                               server.c_str());
+            }
+        }
 
         addons_manager->checkInstalledAddons();
 
@@ -1410,6 +1517,7 @@ static void cleanSuperTuxKart()
     NewsManager::deallocate();
     if(addons_manager)          delete addons_manager;
     NetworkManager::kill();
+    NetworkBot::destroy();
 
     if(grand_prix_manager)      delete grand_prix_manager;
     if(highscore_manager)       delete highscore_manager;
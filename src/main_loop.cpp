@@ -30,12 +30,15 @@
 #include "input/wiimote_manager.hpp"
 #include "modes/profile_world.hpp"
 #include "modes/world.hpp"
+#include "network/network_bot.hpp"
+#include "network/network_statistics.hpp"
 #include "network/protocol_manager.hpp"
 #include "network/network_world.hpp"
 #include "online/request_manager.hpp"
 #include "race/race_manager.hpp"
 #include "states_screens/state_manager.hpp"
 #include "utils/profiler.hpp"
+#include "utils/time.hpp"
 
 MainLoop* main_loop = 0;
 
@@ -46,6 +49,8 @@ m_frame_count(0)
     m_curr_time = 0;
     m_prev_time = 0;
     m_throttle_fps = true;
+    m_fixed_time_step  = 0;
+    m_time_accumulator = 0;
 }  // MainLoop
 
 //-----------------------------------------------------------------------------
@@ -95,17 +100,64 @@ float MainLoop::getLimitedDt()
 }   // getLimitedDt
 
 //-----------------------------------------------------------------------------
-/** Updates all race related objects.
+/** Does one simulation step of the race.
  *  \param dt Time step size.
  */
-void MainLoop::updateRace(float dt)
+void MainLoop::simulate(float dt)
 {
-    if(ProfileWorld::isProfileMode()) dt=1.0f/60.0f;
-
     if (NetworkWorld::getInstance<NetworkWorld>()->isRunning())
         NetworkWorld::getInstance<NetworkWorld>()->update(dt);
     else
         World::getWorld()->updateWorld(dt);
+}   // simulate
+
+//-----------------------------------------------------------------------------
+/** Updates all race related objects. If a simulation rate is set (see
+ *  UserConfigParams::m_simulation_fps), the race is simulated with this
+ *  fixed time step: the frame time is accumulated, and as many steps are
+ *  done as fit into the accumulated time. The graphics are then
+ *  interpolated between the last two steps using the remaining time, so
+ *  the simulation cost and results are independent of the frame rate.
+ *  Otherwise one step with the frame time is done.
+ *  \param dt Time since the last frame.
+ */
+void MainLoop::updateRace(float dt)
+{
+    int simulation_fps = UserConfigParams::m_simulation_fps;
+    m_fixed_time_step  = simulation_fps > 0 ? 1.0f/simulation_fps : 0.0f;
+
+    // In profile mode do exactly one step per frame (as fast as possible)
+    if(ProfileWorld::isProfileMode())
+    {
+        dt = isFixedTimeStep() ? m_fixed_time_step : 1.0f/60.0f;
+        simulate(dt);
+        if(isFixedTimeStep() && World::getWorld())
+            World::getWorld()->updateGraphics(dt, 1.0f);
+        return;
+    }
+
+    if(!isFixedTimeStep())
+    {
+        simulate(dt);
+        return;
+    }
+
+    // dt is limited in getLimitedDt, so this loop is limited as well.
+    m_time_accumulator += dt;
+    while(m_time_accumulator >= m_fixed_time_step)
+    {
+        // The world can be deleted in a step (e.g. when exiting the race)
+        if(!World::getWorld())
+        {
+            m_time_accumulator = 0;
+            return;
+        }
+        simulate(m_fixed_time_step);
+        m_time_accumulator -= m_fixed_time_step;
+    }
+    if(World::getWorld())
+        World::getWorld()->updateGraphics(dt,
+                                     m_time_accumulator/m_fixed_time_step);
 }   // updateRace
 
 //-----------------------------------------------------------------------------
@@ -122,6 +174,8 @@ void MainLoop::run()
 
         m_prev_time = m_curr_time;
         float dt   = getLimitedDt();
+        // start of the work of this frame (without throttling)
+        uint64_t tick_start = StkTime::getMicrosecondsSinceEpoch();
 
         if (World::getWorld())  // race is active if world exists
         {
@@ -130,6 +184,9 @@ void MainLoop::run()
             PROFILER_POP_CPU_MARKER();
         }   // if race is active
 
+        if (NetworkBot::isEnabled())
+            NetworkBot::update(dt);
+
         // We need to check again because update_race may have requested
         // the main loop to abort; and it's not a good idea to continue
         // since the GUI engine is no more to be called then.
@@ -174,6 +231,10 @@ void MainLoop::run()
             PROFILER_POP_CPU_MARKER();
         }
 
+        if (NetworkStatistics::isEnabled())
+            NetworkStatistics::addTick(StkTime::getMicrosecondsSinceEpoch()
+                                       - tick_start);
+
         PROFILER_SYNC_FRAME();
         PROFILER_POP_CPU_MARKER();
     }  // while !m_exit
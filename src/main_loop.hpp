@@ -34,8 +34,17 @@ private:
     int      m_frame_count;
     Uint32   m_curr_time;
     Uint32   m_prev_time;
+
+    /** Time step of the simulation, or 0 if the simulation does one step
+     *  per frame with the frame time as time step. */
+    float    m_fixed_time_step;
+
+    /** In fixed time step mode the frame time that was not simulated yet. */
+    float    m_time_accumulator;
+
     float    getLimitedDt();
     void     updateRace(float dt);
+    void     simulate(float dt);
 public:
          MainLoop();
         ~MainLoop();
@@ -45,6 +54,10 @@ public:
     // ------------------------------------------------------------------------
     /** Returns true if STK is to be stoppe. */
     bool isAborted() const { return m_abort; }
+    // ------------------------------------------------------------------------
+    /** Returns true if the simulation runs with a fixed time step (and the
+     *  graphics are interpolated between the last two simulation steps). */
+    bool isFixedTimeStep() const { return m_fixed_time_step > 0; }
 };   // MainLoop
 
 extern MainLoop* main_loop;
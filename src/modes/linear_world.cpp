@@ -30,6 +30,7 @@
 #include "tracks/track_sector.hpp"
 #include "tracks/track.hpp"
 #include "utils/constants.hpp"
+#include "utils/snapshot_buffer.hpp"
 #include "utils/string_utils.hpp"
 #include "utils/translation.hpp"
 
@@ -140,6 +141,32 @@ void LinearWorld::reset()
 
 }   // reset
 
+//-----------------------------------------------------------------------------
+/** Saves the state of the world including the lap counting information.
+ *  \param buffer The snapshot buffer to write to.
+ */
+void LinearWorld::saveState(SnapshotBuffer *buffer) const
+{
+    WorldWithRank::saveState(buffer);
+    buffer->add(m_fastest_lap);
+    buffer->add(m_last_lap_sfx_played);
+    buffer->addVector(m_race_order);
+    buffer->addArray(&m_kart_info[0], m_kart_info.size());
+}   // saveState
+
+//-----------------------------------------------------------------------------
+/** Restores the state of the world including the lap counting information.
+ *  \param buffer The snapshot buffer to read from.
+ */
+void LinearWorld::restoreState(SnapshotBuffer *buffer)
+{
+    WorldWithRank::restoreState(buffer);
+    buffer->get(&m_fastest_lap);
+    buffer->get(&m_last_lap_sfx_played);
+    buffer->getVector(&m_race_order);
+    buffer->getArray(&m_kart_info[0], m_kart_info.size());
+}   // restoreState
+
 //-----------------------------------------------------------------------------
 /** General update function called once per frame. This updates the kart
  *  sectors, which are then used to determine the kart positions.
@@ -632,9 +659,9 @@ btTransform LinearWorld::getRescueTransform(unsigned int index) const
 }   // getRescueTransform
 
 //-----------------------------------------------------------------------------
-/** Find the position (rank) of every kart. ATM it uses a stable O(n^2)
- *  algorithm by counting for each kart how many other karts are ahead of
- *  it.
+/** Find the position (rank) of every kart. The karts are sorted with an
+ *  insertion sort that starts with the order of the previous call, which
+ *  is linear if no (or only few) ranks change.
  */
 void LinearWorld::updateRacePosition()
 {
@@ -646,6 +673,49 @@ void LinearWorld::updateRacePosition()
     bool rank_changed = false;
 #endif
 
+    if(m_race_order.size()!=kart_amount)
+    {
+        m_race_order.resize(kart_amount);
+        for(unsigned int i=0; i<kart_amount; i++)
+            m_race_order[i] = i;
+    }
+
+    // Sort the karts by race position. Ranks rarely change from one frame
+    // to the next, so an insertion sort starting with the order of the
+    // previous frame is linear in most cases. Insertion sort is stable,
+    // and isAheadInRace defines a total order, so the result is identical
+    // to comparing every kart with every other kart.
+    for(unsigned int i=1; i<kart_amount; i++)
+    {
+        const unsigned int kart_id = m_race_order[i];
+        int j = i-1;
+        while(j>=0 && isAheadInRace(kart_id, m_race_order[j]))
+        {
+            m_race_order[j+1] = m_race_order[j];
+            j--;
+        }
+        m_race_order[j+1] = kart_id;
+    }   // for i<kart_amount
+
+    // All karts that have finished (but are not eliminated) are ahead
+    // of every kart that is still racing.
+    unsigned int num_finished = 0;
+    for(unsigned int i=0; i<kart_amount; i++)
+    {
+        if(!m_karts[i]->isEliminated() && m_karts[i]->hasFinishedRace())
+            num_finished++;
+    }
+
+    // Store the race position of all karts that are still racing.
+    m_race_position.resize(kart_amount);
+    for(unsigned int i=0; i<kart_amount; i++)
+    {
+        const AbstractKart *kart = m_karts[m_race_order[i]];
+        if(kart->isEliminated() || kart->hasFinishedRace())
+            break;
+        m_race_position[m_race_order[i]] = num_finished + i + 1;
+    }
+
     // NOTE: if you do any changes to this loop, the next loop (see
     // DEBUG_KART_RANK below) needs to have the same changes applied
     // so that debug output is still correct!!!!!!!!!!!
@@ -666,33 +736,10 @@ void LinearWorld::updateRacePosition()
         }
         KartInfo& kart_info = m_kart_info[i];
 
-        int p = 1 ;
-
-        const unsigned int my_id = kart->getWorldKartId();
-        const float my_distance  = m_kart_info[my_id].m_overall_distance;
-
-        // Count karts ahead of the current kart, i.e. kart that are
-        // already finished or have covered a larger overall distance.
-        for (unsigned int j = 0 ; j < kart_amount ; j++)
-        {
-            // don't compare a kart with itself and ignore eliminated karts
-            if(j == my_id || m_karts[j]->isEliminated())
-                continue;
-
-            // If the other kart has:
-            // - finished the race (but this kart hasn't)
-            // - or is ahead
-            // - or has the same distance (very unlikely) but started earlier
-            // it is ahead --> increase position
-            if((!kart->hasFinishedRace() && m_karts[j]->hasFinishedRace()) ||
-                m_kart_info[j].m_overall_distance > my_distance            ||
-               (m_kart_info[j].m_overall_distance == my_distance &&
-                m_karts[j]->getInitialPosition()<kart->getInitialPosition() ) )
-            {
-                p++;
-            }
-
-        } //next kart
+        // A kart is behind all karts that have already finished, and
+        // all karts that have a larger overall distance (or the same
+        // distance, but started earlier).
+        int p = m_race_position[i];
 
 #ifndef DEBUG
         setKartPosition(i, p);
@@ -815,6 +862,33 @@ void LinearWorld::updateRacePosition()
     endSetKartPositions();
 }   // updateRacePosition
 
+//-----------------------------------------------------------------------------
+/** Defines the order used in updateRacePosition. All karts that are still
+ *  racing (i.e. neither finished nor eliminated) are before all other karts.
+ *  Racing karts are sorted by overall distance, or by their initial position
+ *  if they have the same distance (very unlikely). All other karts are
+ *  sorted by their world kart id, their position is not changed anymore.
+ *  \param a, b World kart ids of the two karts to compare.
+ *  \return True if kart a is before kart b.
+ */
+bool LinearWorld::isAheadInRace(unsigned int a, unsigned int b) const
+{
+    const AbstractKart *kart_a = m_karts[a];
+    const AbstractKart *kart_b = m_karts[b];
+    const bool racing_a = !kart_a->isEliminated() && !kart_a->hasFinishedRace();
+    const bool racing_b = !kart_b->isEliminated() && !kart_b->hasFinishedRace();
+    if(racing_a != racing_b)
+        return racing_a;
+    if(!racing_a)
+        return a < b;
+
+    const float distance_a = m_kart_info[a].m_overall_distance;
+    const float distance_b = m_kart_info[b].m_overall_distance;
+    if(distance_a != distance_b)
+        return distance_a > distance_b;
+    return kart_a->getInitialPosition() < kart_b->getInitialPosition();
+}   // isAheadInRace
+
 //-----------------------------------------------------------------------------
 /** Checks if a kart is going in the wrong direction. This is done only for
  *  player karts to display a message to the player.
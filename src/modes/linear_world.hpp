@@ -55,6 +55,17 @@ private:
      *  get valid finish times estimates. */
     float       m_distance_increase;
 
+    /** The world kart ids of all karts, sorted so that all karts that are
+     *  still racing (i.e. neither finished nor eliminated) come first, in
+     *  the order of their race position. This order is kept from frame to
+     *  frame, so that updateRacePosition only needs to do an insertion sort,
+     *  which is linear if no kart has overtaken another kart. */
+    std::vector<unsigned int> m_race_order;
+
+    /** Temporary storage for the new race position of each kart, indexed
+     *  by world kart id. Only used in updateRacePosition. */
+    std::vector<int> m_race_position;
+
     // ------------------------------------------------------------------------
     /** Some additional info that needs to be kept for each kart
      * in this kind of race.
@@ -112,6 +123,7 @@ protected:
     AlignedArray<KartInfo> m_kart_info;
 
     virtual void  checkForWrongDirection(unsigned int i);
+    bool          isAheadInRace(unsigned int a, unsigned int b) const;
     void          updateRacePosition();
     virtual float estimateFinishTimeForKart(AbstractKart* kart) OVERRIDE;
 
@@ -124,6 +136,8 @@ public:
     virtual      ~LinearWorld();
 
     virtual void  update(float delta) OVERRIDE;
+    virtual void  saveState(SnapshotBuffer *buffer) const OVERRIDE;
+    virtual void  restoreState(SnapshotBuffer *buffer) OVERRIDE;
     int           getSectorForKart(const AbstractKart *kart) const;
     float         getDistanceDownTrackForKart(const int kart_id) const;
     float         getDistanceToCenterForKart(const int kart_id) const;
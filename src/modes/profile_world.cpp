@@ -20,9 +20,15 @@
 
 #include "main_loop.hpp"
 #include "graphics/camera.hpp"
+#include "config/stk_config.hpp"
+#include "config/user_config.hpp"
 #include "graphics/irr_driver.hpp"
+#include "items/projectile_manager.hpp"
 #include "karts/kart_with_stats.hpp"
 #include "karts/controller/controller.hpp"
+#include "physics/physics.hpp"
+#include "physics/physics_benchmark.hpp"
+#include "physics/stk_dynamics_world.hpp"
 #include "tracks/track.hpp"
 
 #include <ISceneManager.h>
@@ -31,6 +37,7 @@ ProfileWorld::ProfileType ProfileWorld::m_profile_mode=PROFILE_NONE;
 int   ProfileWorld::m_num_laps    = 0;
 float ProfileWorld::m_time        = 0.0f;
 bool  ProfileWorld::m_no_graphics = false;
+int   ProfileWorld::m_num_projectiles = 0;
 
 //-----------------------------------------------------------------------------
 /** The constructor sets the number of (local) players to 0, since only AI
@@ -144,12 +151,38 @@ bool ProfileWorld::isRaceOver()
 }   // isRaceOver
 
 //-----------------------------------------------------------------------------
-/** Counts the number of frames.
+/** Counts the number of frames. If requested, it also fires projectiles
+ *  from random karts so that the number of projectiles on the track stays
+ *  constant, which is used to profile the physics broadphase.
  */
 void ProfileWorld::update(float dt)
 {
+    // The physics benchmark replaces the race, and STK exits afterwards.
+    if(UserConfigParams::m_physics_benchmark>0)
+    {
+        PhysicsBenchmark::run(UserConfigParams::m_physics_benchmark,
+                              UserConfigParams::m_physics_benchmark_file);
+        UserConfigParams::m_physics_benchmark = 0;
+        main_loop->abort();
+        return;
+    }
+
     StandardRace::update(dt);
 
+    for(int i=projectile_manager->getNumActiveProjectiles();
+        i<m_num_projectiles; i++)
+    {
+        AbstractKart *kart = m_karts[m_random.get(m_karts.size())];
+        if(kart->isEliminated() || kart->hasFinishedRace())
+            continue;
+        static const PowerupManager::PowerupType types[] =
+        {
+            PowerupManager::POWERUP_CAKE, PowerupManager::POWERUP_BOWLING,
+            PowerupManager::POWERUP_RUBBERBALL
+        };
+        projectile_manager->newProjectile(kart, types[m_random.get(3)]);
+    }
+
     m_frame_count++;
     video::IVideoDriver *driver = irr_driver->getVideoDriver();
     io::IAttributes   *attr = irr_driver->getSceneManager()->getParameters();
@@ -200,6 +233,39 @@ void ProfileWorld::enterRaceOverState()
     printf("Number of frames: %d time %f, Average FPS: %f\n",
            m_frame_count, runtime, (float)m_frame_count/runtime);
 
+    // Print broadphase statistics
+    const STKDynamicsWorld *world = m_physics->getPhysicsWorld();
+    unsigned int steps = std::max(world->getNumBroadphaseSteps(), 1u);
+    printf("Broadphase: %s, steps: %u, average time: %f us, "
+           "average # pairs: %f\n",
+           stk_config->m_broadphase==STKConfig::BROADPHASE_DBVT
+                                   ? "dbvt" : "axis-sweep",
+           world->getNumBroadphaseSteps(),
+           (float)world->getBroadphaseTime()/steps,
+           (float)world->getNumBroadphasePairs()/steps);
+
+    // Print the number of handled collisions for each pair of object types
+    const char *type_names[UserPointer::UP_COUNT] =
+        {"undefined", "kart", "flyable", "track", "physical object",
+         "animation"};
+    for(unsigned int i=0; i<UserPointer::UP_COUNT; i++)
+    {
+        for(unsigned int j=0; j<UserPointer::UP_COUNT; j++)
+        {
+            unsigned int n = m_physics->getNumCollisions(
+                                          (UserPointer::UserPointerType)i,
+                                          (UserPointer::UserPointerType)j);
+            if(n>0)
+                printf("Collisions %s - %s: %u\n", type_names[i],
+                       type_names[j], n);
+        }
+    }
+
+    // Print how often the AI planning was deferred because of the budget
+    printf("AI planning: %u updates, %u deferred, %u over budget\n",
+           m_ai_scheduler.getNumPlanned(), m_ai_scheduler.getNumDeferred(),
+           m_ai_scheduler.getNumOverBudget());
+
     // Print geometry statistics if we're not in no-graphics mode
     if(!m_no_graphics)
     {
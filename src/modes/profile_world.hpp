@@ -43,6 +43,10 @@ private:
     /** In time based profiling only: time to run. */
     static float m_time;
 
+    /** Number of projectiles which are kept on the track at all times,
+     *  used to profile the physics broadphase. */
+    static int   m_num_projectiles;
+
     /** Return value of real time at start of race. */
     unsigned int m_start_time;
 
@@ -88,6 +92,9 @@ public:
     static   void setProfileModeTime(float time);
     static   void setProfileModeLaps(int laps);
     // ------------------------------------------------------------------------
+    /** Sets the number of projectiles that are kept on the track. */
+    static   void setNumProjectiles(int n) { m_num_projectiles = n; }
+    // ------------------------------------------------------------------------
     /** Returns true if profile mode was selected. */
     static   bool isProfileMode() {return m_profile_mode!=PROFILE_NONE; }
     // ------------------------------------------------------------------------
@@ -159,6 +159,43 @@ void SoccerWorld::update(float dt)
     }
 }   // update
 
+//-----------------------------------------------------------------------------
+/** Saves the state of the world including the score. The ball is a
+ *  physical track object, so it is saved by World::saveState.
+ *  \param buffer The snapshot buffer to write to.
+ */
+void SoccerWorld::saveState(SnapshotBuffer *buffer) const
+{
+    WorldWithRank::saveState(buffer);
+    buffer->addArray(m_team_goals, NB_SOCCER_TEAMS);
+    buffer->add(countDownReachedZero);
+    buffer->add(m_can_score_points);
+    buffer->add(m_goal_timer);
+    buffer->add(m_lastKartToHitBall);
+    buffer->addVector(m_redScorers);
+    buffer->addVector(m_redScoreTimes);
+    buffer->addVector(m_blueScorers);
+    buffer->addVector(m_blueScoreTimes);
+}   // saveState
+
+//-----------------------------------------------------------------------------
+/** Restores the state of the world including the score.
+ *  \param buffer The snapshot buffer to read from.
+ */
+void SoccerWorld::restoreState(SnapshotBuffer *buffer)
+{
+    WorldWithRank::restoreState(buffer);
+    buffer->getArray(m_team_goals, NB_SOCCER_TEAMS);
+    buffer->get(&countDownReachedZero);
+    buffer->get(&m_can_score_points);
+    buffer->get(&m_goal_timer);
+    buffer->get(&m_lastKartToHitBall);
+    buffer->getVector(&m_redScorers);
+    buffer->getVector(&m_redScoreTimes);
+    buffer->getVector(&m_blueScorers);
+    buffer->getVector(&m_blueScoreTimes);
+}   // restoreState
+
 //-----------------------------------------------------------------------------
 void SoccerWorld::onCheckGoalTriggered(bool first_goal)
 {
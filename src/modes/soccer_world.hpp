@@ -82,6 +82,8 @@ public:
     virtual const std::string& getIdent() const;
 
     virtual void update(float dt);
+    virtual void saveState(SnapshotBuffer *buffer) const OVERRIDE;
+    virtual void restoreState(SnapshotBuffer *buffer) OVERRIDE;
 
     void onCheckGoalTriggered(bool first_goal);
     int getTeamLeader(unsigned int i);
@@ -233,25 +233,7 @@ void ThreeStrikesBattle::kartHit(const unsigned int kart_id)
     }
 
     scene::ISceneNode* kart_node = m_karts[kart_id]->getNode();
-
-    // FIXME: sorry for this ugly const_cast, irrlicht doesn't seem to allow
-    // getting a writable list of children, wtf??
-    core::list<scene::ISceneNode*>& children =
-        const_cast<core::list<scene::ISceneNode*>&>(kart_node->getChildren());
-    for (core::list<scene::ISceneNode*>::Iterator it = children.begin();
-                                                  it != children.end(); it++)
-    {
-        scene::ISceneNode* curr = *it;
-
-        if (core::stringc(curr->getName()) == "tire1")
-        {
-            curr->setVisible(m_kart_info[kart_id].m_lives >= 3);
-        }
-        else if (core::stringc(curr->getName()) == "tire2")
-        {
-            curr->setVisible(m_kart_info[kart_id].m_lives >= 2);
-        }
-    }
+    updateKartTires(kart_id);
 
     // schedule a tire to be thrown away (but can't do it in this callback
     // because the caller is currently iterating the list of track objects)
@@ -281,6 +263,84 @@ void ThreeStrikesBattle::kartHit(const unsigned int kart_id)
 
 }   // kartHit
 
+//-----------------------------------------------------------------------------
+/** Shows the spare tires of a kart that correspond to its lives, and its
+ *  wheels as long as it has any lives left.
+ *  \param kart_id World id of the kart.
+ */
+void ThreeStrikesBattle::updateKartTires(unsigned int kart_id)
+{
+    const int lives = m_kart_info[kart_id].m_lives;
+    scene::ISceneNode* kart_node = m_karts[kart_id]->getNode();
+
+    // FIXME: sorry for this ugly const_cast, irrlicht doesn't seem to allow
+    // getting a writable list of children, wtf??
+    core::list<scene::ISceneNode*>& children =
+        const_cast<core::list<scene::ISceneNode*>&>(kart_node->getChildren());
+    for (core::list<scene::ISceneNode*>::Iterator it = children.begin();
+                                                  it != children.end(); it++)
+    {
+        scene::ISceneNode* curr = *it;
+
+        if (core::stringc(curr->getName()) == "tire1")
+        {
+            curr->setVisible(lives >= 3);
+        }
+        else if (core::stringc(curr->getName()) == "tire2")
+        {
+            curr->setVisible(lives >= 2);
+        }
+    }
+
+    scene::ISceneNode** wheels = m_karts[kart_id]->getKartModel()
+                                                 ->getWheelNodes();
+    for(unsigned int i=0; i<4; i++)
+    {
+        if(wheels[i]) wheels[i]->setVisible(lives >= 1);
+    }
+}   // updateKartTires
+
+//-----------------------------------------------------------------------------
+/** Saves the state of the world including the lives of all karts and the
+ *  number of tires thrown away.
+ *  \param buffer The snapshot buffer to write to.
+ */
+void ThreeStrikesBattle::saveState(SnapshotBuffer *buffer) const
+{
+    WorldWithRank::saveState(buffer);
+    buffer->addVector(m_kart_info);
+    buffer->add(m_tires.size());
+    buffer->add((unsigned int)m_battle_events.size());
+}   // saveState
+
+//-----------------------------------------------------------------------------
+/** Restores the state of the world including the lives of all karts. Tires
+ *  that were thrown away after the state was saved are removed, and so are
+ *  the battle events recorded since then.
+ *  \param buffer The snapshot buffer to read from.
+ */
+void ThreeStrikesBattle::restoreState(SnapshotBuffer *buffer)
+{
+    WorldWithRank::restoreState(buffer);
+    buffer->getVector(&m_kart_info);
+    unsigned int num_tires;
+    buffer->get(&num_tires);
+    while(m_tires.size() > num_tires)
+    {
+        TrackObject *tire = m_tires.get(m_tires.size()-1);
+        m_tires.remove(tire);
+        m_track->getTrackObjectManager()->removeObject(tire);
+    }
+    unsigned int num_events;
+    buffer->get(&num_events);
+    if(m_battle_events.size() > num_events)
+        m_battle_events.erase(m_battle_events.begin()+num_events,
+                              m_battle_events.end());
+
+    for(unsigned int i=0; i<m_karts.size(); i++)
+        updateKartTires(i);
+}   // restoreState
+
 //-----------------------------------------------------------------------------
 /** Returns the internal identifier for this race.
  */
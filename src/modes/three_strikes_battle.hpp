@@ -70,6 +70,8 @@ private:
 
     PtrVector<TrackObject, REF> m_tires;
 
+    void updateKartTires(unsigned int kart_id);
+
 public:
 
     /** Used to show a nice graph when battle is over */
@@ -105,6 +107,8 @@ public:
     virtual void update(float dt);
 
     virtual void kartAdded(AbstractKart* kart, scene::ISceneNode* node);
+    virtual void saveState(SnapshotBuffer *buffer) const OVERRIDE;
+    virtual void restoreState(SnapshotBuffer *buffer) OVERRIDE;
 
 
     void updateKartRanks();
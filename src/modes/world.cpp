@@ -30,6 +30,7 @@
 #include "graphics/hardware_skinning.hpp"
 #include "io/file_manager.hpp"
 #include "input/device_manager.hpp"
+#include "items/item_manager.hpp"
 #include "items/projectile_manager.hpp"
 #include "karts/controller/player_controller.hpp"
 #include "karts/controller/end_controller.hpp"
@@ -37,6 +38,7 @@
 #include "karts/controller/network_player_controller.hpp"
 #include "karts/kart.hpp"
 #include "karts/kart_properties_manager.hpp"
+#include "main_loop.hpp"
 #include "modes/overworld.hpp"
 #include "modes/profile_world.hpp"
 #include "physics/btKart.hpp"
@@ -55,10 +57,12 @@
 #include "states_screens/state_manager.hpp"
 #include "tracks/track.hpp"
 #include "tracks/track_manager.hpp"
+#include "tracks/track_object_manager.hpp"
 #include "utils/constants.hpp"
 #include "utils/profiler.hpp"
 #include "utils/translation.hpp"
 #include "utils/string_utils.hpp"
+#include "utils/worker_pool.hpp"
 
 #include <algorithm>
 #include <assert.h>
@@ -69,6 +73,23 @@
 
 World* World::m_world = NULL;
 
+namespace
+{
+    /** Computes the AI decisions of one kart per task. */
+    class AIDecisionJob : public WorkerPool::Job
+    {
+    public:
+        const World::KartList *m_karts;
+        // --------------------------------------------------------------------
+        virtual void runTask(unsigned int i)
+        {
+            AbstractKart *kart = (*m_karts)[i];
+            if(!kart->isEliminated())
+                kart->getController()->computeDecisions();
+        }   // runTask
+    };   // AIDecisionJob
+}   // namespace
+
 /** The main world class is used to handle the track and the karts.
  *  The end of the race is detected in two phases: first the (abstract)
  *  function isRaceOver, which must be implemented by all game modes,
@@ -103,7 +124,8 @@ World* World::m_world = NULL;
  *  after the constructor. Those functions must be called in the init()
  *  function, which is called immediately after the constructor.
  */
-World::World() : WorldStatus(), m_clear_color(255,100,101,140)
+World::World() : WorldStatus(), m_clear_color(255,100,101,140),
+                 m_snapshots(NUM_SNAPSHOTS)
 {
 
 #ifdef DEBUG
@@ -111,6 +133,7 @@ World::World() : WorldStatus(), m_clear_color(255,100,101,140)
 #endif
 
     m_physics            = NULL;
+    m_ai_worker_pool     = NULL;
     m_race_gui           = NULL;
     m_saved_race_gui     = NULL;
     m_use_highscores     = true;
@@ -185,6 +208,12 @@ void World::init()
 
     }  // for i
 
+    int num_ai_threads = UserConfigParams::m_ai_threads;
+    if(num_ai_threads<0)
+        num_ai_threads = WorkerPool::getNumberOfCores()-1;
+    if(num_ai_threads>0)
+        m_ai_worker_pool = new WorkerPool(num_ai_threads);
+
     // Now that all models are loaded, apply the overrides
     irr_driver->applyObjectPassShader();
 
@@ -218,6 +247,7 @@ void World::reset()
     m_schedule_unpause = false;
 
     WorldStatus::reset();
+    m_snapshots.clear();
     m_faster_music_active = false;
     m_eliminated_karts    = 0;
     m_eliminated_players  = 0;
@@ -237,6 +267,10 @@ void World::reset()
         ReplayPlay::get()->reset();
 
     resetAllKarts();
+    // The karts were moved to their start positions (and in a new race
+    // the number of karts might have changed).
+    m_kart_spatial_index.invalidate();
+    m_ai_scheduler.reset(m_karts.size());
     // Note: track reset must be called after all karts exist, since check
     // objects need to allocate data structures depending on the number
     // of karts.
@@ -251,7 +285,7 @@ void World::reset()
     // Enable SFX again
     sfx_manager->resumeAll();
 
-    projectile_manager->cleanup();
+    projectile_manager->reset();
     race_manager->reset();
     // Make sure to overwrite the data from the previous race.
     if(!history->replayHistory()) history->initRecording();
@@ -382,6 +416,7 @@ World::~World()
     Camera::removeAllCameras();
 
     projectile_manager->cleanup();
+    delete m_ai_worker_pool;
     // In case that the track is not found, m_physics is still undefined.
     if(m_physics)
         delete m_physics;
@@ -618,6 +653,83 @@ void World::resetAllKarts()
     }
 }   // resetAllKarts
 
+//-----------------------------------------------------------------------------
+/** Saves the state of the simulation: the race clock, all rigid bodies
+ *  (karts, projectiles and physical objects of the track), the state of
+ *  the karts (vehicle, speed modifiers, skidding, attachment, powerup),
+ *  the items and the projectiles. Game modes with additional state extend
+ *  this function.
+ *  \param buffer The snapshot buffer to write to.
+ */
+void World::saveState(SnapshotBuffer *buffer) const
+{
+    WorldStatus::saveState(buffer);
+    buffer->add(m_eliminated_karts);
+    buffer->add(m_eliminated_players);
+    buffer->add(race_manager->getFinishedKarts());
+    buffer->add(race_manager->getFinishedPlayers());
+    m_physics->saveState(buffer);
+    for(unsigned int i=0; i<m_karts.size(); i++)
+        m_karts[i]->saveState(buffer);
+    m_track->getTrackObjectManager()->saveState(buffer);
+    ItemManager::get()->saveState(buffer);
+    projectile_manager->saveState(buffer);
+}   // saveState
+
+//-----------------------------------------------------------------------------
+/** Restores the state of the simulation saved with saveState.
+ *  \param buffer The snapshot buffer to read from.
+ */
+void World::restoreState(SnapshotBuffer *buffer)
+{
+    WorldStatus::restoreState(buffer);
+    buffer->get(&m_eliminated_karts);
+    buffer->get(&m_eliminated_players);
+    unsigned int finished_karts, finished_players;
+    buffer->get(&finished_karts);
+    buffer->get(&finished_players);
+    race_manager->setFinishedKarts(finished_karts, finished_players);
+    m_physics->restoreState(buffer);
+    for(unsigned int i=0; i<m_karts.size(); i++)
+        m_karts[i]->restoreState(buffer);
+    m_track->getTrackObjectManager()->restoreState(buffer);
+    ItemManager::get()->restoreState(buffer);
+    projectile_manager->restoreState(buffer);
+}   // restoreState
+
+//-----------------------------------------------------------------------------
+/** Saves the state of the simulation as a new snapshot. Only the last
+ *  NUM_SNAPSHOTS snapshots are kept. The snapshot buffers are enlarged
+ *  when the first snapshot is taken (with room for additional items and
+ *  projectiles), so that later snapshots do not allocate memory.
+ *  \return The id of the snapshot, used to restore it.
+ */
+int World::takeSnapshot()
+{
+    int id;
+    SnapshotBuffer *buffer = m_snapshots.newSnapshot(&id);
+    saveState(buffer);
+    m_snapshots.reserve(2*buffer->getSize());
+    return id;
+}   // takeSnapshot
+
+//-----------------------------------------------------------------------------
+/** Restores the simulation to the state of a snapshot.
+ *  \param id The id of the snapshot as returned by takeSnapshot().
+ *  \return False if the snapshot does not exist anymore.
+ */
+bool World::restoreSnapshot(int id)
+{
+    SnapshotBuffer *buffer = m_snapshots.getSnapshot(id);
+    if(!buffer)
+    {
+        Log::warn("World", "Snapshot %d does not exist anymore.", id);
+        return false;
+    }
+    restoreState(buffer);
+    return true;
+}   // restoreSnapshot
+
 // ----------------------------------------------------------------------------
 /** Places a kart that is rescued. It calls getRescuePositionIndex to find
  *  to which rescue position the kart should be moved, then getRescueTransform
@@ -830,6 +942,37 @@ void World::update(float dt)
         m_physics->update(dt);
     }
 
+    // Copy the new physics state into all karts before any kart is
+    // updated, so that the AI decisions below see the current state of
+    // all karts.
+    for (unsigned int i = 0; i < m_karts.size(); i++)
+    {
+        if(!m_karts[i]->isEliminated())
+            m_karts[i]->updateFromPhysics();
+    }
+
+    // The karts query the index while they are updated
+    m_kart_spatial_index.update();
+    m_ai_scheduler.update();
+
+    // The AI decisions only read the world, so they can be computed for
+    // all karts at the same time. They are computed here even without
+    // threads, so that the result does not depend on the number of
+    // threads. Anything with side effects is done when the karts are
+    // updated, in the same order as before.
+    if(!history->replayHistory())
+    {
+        AIDecisionJob job;
+        job.m_karts = &m_karts;
+        if(m_ai_worker_pool)
+            m_ai_worker_pool->run(&job, m_karts.size());
+        else
+        {
+            for (unsigned int i = 0; i < m_karts.size(); i++)
+                job.runTask(i);
+        }
+    }
+
     const int kart_amount = m_karts.size();
     for (int i = 0 ; i < kart_amount; ++i)
     {
@@ -837,9 +980,14 @@ void World::update(float dt)
         if(!m_karts[i]->isEliminated()) m_karts[i]->update(dt) ;
     }
 
-    for(unsigned int i=0; i<Camera::getNumCameras(); i++)
+    // With a fixed time step the cameras are updated once per frame in
+    // updateGraphics, using the interpolated kart positions.
+    if(!main_loop || !main_loop->isFixedTimeStep())
     {
-        Camera::getCamera(i)->update(dt);
+        for(unsigned int i=0; i<Camera::getNumCameras(); i++)
+        {
+            Camera::getCamera(i)->update(dt);
+        }
     }
 
     projectile_manager->update(dt);
@@ -851,6 +999,30 @@ void World::update(float dt)
 #endif
 }   // update
 
+// ----------------------------------------------------------------------------
+/** Called once per frame when the simulation uses a fixed time step (see
+ *  MainLoop::updateRace). It positions the models of all karts and
+ *  projectiles between the last two simulation steps, and then updates
+ *  the cameras.
+ *  \param dt Time since the last frame.
+ *  \param alpha Position between the previous (0) and the last (1)
+ *         simulation step.
+ */
+void World::updateGraphics(float dt, float alpha)
+{
+    for(unsigned int i=0; i<m_karts.size(); i++)
+    {
+        if(!m_karts[i]->isEliminated())
+            m_karts[i]->interpolateGraphics(alpha);
+    }
+    projectile_manager->interpolateGraphics(alpha);
+
+    for(unsigned int i=0; i<Camera::getNumCameras(); i++)
+    {
+        Camera::getCamera(i)->update(dt);
+    }
+}   // updateGraphics
+
 // ----------------------------------------------------------------------------
 /** Only updates the track. The order in which the various parts of STK are
  *  updated is quite important (i.e. the track can't be updated as part of
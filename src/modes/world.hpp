@@ -27,11 +27,14 @@
 
 #include <vector>
 
+#include "karts/kart_spatial_index.hpp"
+#include "karts/controller/ai_scheduler.hpp"
 #include "modes/world_status.hpp"
 #include "race/highscores.hpp"
 #include "states_screens/race_gui_base.hpp"
 #include "states_screens/state_manager.hpp"
 #include "utils/random_generator.hpp"
+#include "utils/snapshot_buffer.hpp"
 
 #include "LinearMath/btTransform.h"
 
@@ -41,6 +44,7 @@ class Controller;
 class PhysicalObject;
 class Physics;
 class Track;
+class WorkerPool;
 
 namespace irr
 {
@@ -84,6 +88,18 @@ protected:
     RandomGenerator           m_random;
 
     Physics*      m_physics;
+
+    /** Spatial index of all karts, rebuilt once per time step. */
+    KartSpatialIndex m_kart_spatial_index;
+
+    /** Decides which AI karts update their slowly changing decisions in
+     *  a time step. */
+    AIScheduler   m_ai_scheduler;
+
+    /** The threads used to compute the AI decisions in parallel, NULL if
+     *  the decisions are computed in the main thread. */
+    WorkerPool   *m_ai_worker_pool;
+
     AbstractKart* m_fastest_kart;
     /** Number of eliminated karts. */
     int         m_eliminated_karts;
@@ -155,6 +171,12 @@ protected:
     /** Set when the world is online and counts network players. */
     bool m_is_network_world;
 
+    /** Number of snapshots that are kept, see takeSnapshot(). */
+    static const unsigned int NUM_SNAPSHOTS = 32;
+
+    /** The most recent snapshots of the simulation state. */
+    SnapshotRing m_snapshots;
+
     virtual void  onGo();
     /** Returns true if the race is over. Must be defined by all modes. */
     virtual bool  isRaceOver() = 0;
@@ -239,6 +261,8 @@ public:
     virtual void    getDefaultCollectibles(int *collectible_type,
                                            int *amount );
     virtual void    endRaceEarly() { return; }
+    virtual void    saveState(SnapshotBuffer *buffer) const OVERRIDE;
+    virtual void    restoreState(SnapshotBuffer *buffer) OVERRIDE;
 
     // ------------------------------------------------------------------------
     /** Called to determine whether this race mode uses bonus boxes. */
@@ -269,6 +293,9 @@ public:
     void            scheduleExitRace() { m_schedule_exit_race = true; }
     void            scheduleTutorial();
     void            updateWorld(float dt);
+    void            updateGraphics(float dt, float alpha);
+    int             takeSnapshot();
+    bool            restoreSnapshot(int id);
     void            handleExplosion(const Vec3 &xyz, AbstractKart *kart_hit,
                                     PhysicalObject *object);
     AbstractKart*   getPlayerKart(unsigned int player) const;
@@ -299,6 +326,13 @@ public:
     /** Returns a pointer to the physics. */
     Physics        *getPhysics() const { return m_physics; }
     // ------------------------------------------------------------------------
+    /** Returns the spatial index of all karts, which is used to find the
+     *  karts close to a point. */
+    KartSpatialIndex *getKartSpatialIndex() { return &m_kart_spatial_index; }
+    // ------------------------------------------------------------------------
+    /** Returns the scheduler for the slowly changing AI decisions. */
+    AIScheduler    *getAIScheduler() { return &m_ai_scheduler; }
+    // ------------------------------------------------------------------------
     /** Returns a pointer to the track. */
     Track          *getTrack() const { return m_track; }
     // ------------------------------------------------------------------------
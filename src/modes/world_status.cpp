@@ -27,6 +27,7 @@
 #include "karts/abstract_kart.hpp"
 #include "modes/world.hpp"
 #include "tracks/track.hpp"
+#include "utils/snapshot_buffer.hpp"
 
 #include <irrlicht.h>
 
@@ -303,3 +304,34 @@ void WorldStatus::unpause()
     IrrlichtDevice *device = irr_driver->getDevice();
     if (device->getTimer()->isStopped()) device->getTimer()->start();
 }   // unpause
+
+//-----------------------------------------------------------------------------
+/** Saves the race clock and phase in a snapshot.
+ *  \param buffer The snapshot buffer to write to.
+ */
+void WorldStatus::saveState(SnapshotBuffer *buffer) const
+{
+    // While the game is paused the actual phase is the previous phase
+    buffer->add(m_previous_phase==UNDEFINED_PHASE ? m_phase
+                                                  : m_previous_phase);
+    buffer->add(m_time);
+    buffer->add(m_auxiliary_timer);
+}   // saveState
+
+//-----------------------------------------------------------------------------
+/** Restores the race clock and phase from a snapshot. If the game is
+ *  paused, it stays paused, and the restored phase is used when it is
+ *  unpaused.
+ *  \param buffer The snapshot buffer to read from.
+ */
+void WorldStatus::restoreState(SnapshotBuffer *buffer)
+{
+    Phase phase;
+    buffer->get(&phase);
+    if(m_previous_phase==UNDEFINED_PHASE)
+        m_phase = phase;
+    else
+        m_previous_phase = phase;
+    buffer->get(&m_time);
+    buffer->get(&m_auxiliary_timer);
+}   // restoreState
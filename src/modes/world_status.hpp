@@ -21,6 +21,7 @@
 #include "utils/cpp2011.h"
 
 class SFXBase;
+class SnapshotBuffer;
 
 /**
  * \brief A class that manages the clock (countdown, chrono, etc.)
@@ -124,6 +125,8 @@ public:
     virtual void unpause();
     virtual void enterRaceOverState();
     virtual void terminateRace();
+    virtual void saveState(SnapshotBuffer *buffer) const;
+    virtual void restoreState(SnapshotBuffer *buffer);
 
     // ------------------------------------------------------------------------
     // Note: GO_PHASE is both: start phase and race phase
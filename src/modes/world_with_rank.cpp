@@ -22,6 +22,7 @@
 #include "race/history.hpp"
 #include "tracks/track.hpp"
 #include "utils/log.hpp"
+#include "utils/snapshot_buffer.hpp"
 
 #include <iostream>
 
@@ -51,6 +52,26 @@ AbstractKart* WorldWithRank::getKartAtPosition(unsigned int p) const
     return m_karts[m_position_index[p-1]];
 }   // getKartAtPosition
 
+//-----------------------------------------------------------------------------
+/** Saves the state of the world including the kart positions.
+ *  \param buffer The snapshot buffer to write to.
+ */
+void WorldWithRank::saveState(SnapshotBuffer *buffer) const
+{
+    World::saveState(buffer);
+    buffer->addVector(m_position_index);
+}   // saveState
+
+//-----------------------------------------------------------------------------
+/** Restores the state of the world including the kart positions.
+ *  \param buffer The snapshot buffer to read from.
+ */
+void WorldWithRank::restoreState(SnapshotBuffer *buffer)
+{
+    World::restoreState(buffer);
+    buffer->getVector(&m_position_index);
+}   // restoreState
+
 //-----------------------------------------------------------------------------
 /** This function must be called before starting to set all kart positions
  *  again. It's mainly used to add some debug support, i.e. detect if the
@@ -70,6 +70,8 @@ public:
                                  unsigned int position);
     void          endSetKartPositions();
     AbstractKart* getKartAtPosition(unsigned int p) const;
+    virtual void  saveState(SnapshotBuffer *buffer) const OVERRIDE;
+    virtual void  restoreState(SnapshotBuffer *buffer) OVERRIDE;
 
     virtual unsigned int getNumberOfRescuePositions() const OVERRIDE;
     virtual unsigned int getRescuePositionIndex(AbstractKart *kart) OVERRIDE;
@@ -0,0 +1,157 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2014 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+/*! \file bit_stream.hpp
+ *  \brief Defines classes to write and read values with an arbitrary number
+ *  of bits to and from network strings.
+ */
+
+#ifndef BIT_STREAM_HPP
+#define BIT_STREAM_HPP
+
+#include "network/network_string.hpp"
+#include "network/network_string_view.hpp"
+#include "utils/types.hpp"
+
+#include <assert.h>
+
+/** \class BitWriter
+ *  \brief Appends values with an arbitrary number of bits (up to 32) to a
+ *  network string. The most significant bit is written first. Bits are
+ *  collected until a full byte is available, so flush() must be called
+ *  after the last value was written to add any remaining bits.
+ */
+class BitWriter
+{
+private:
+    /** The string to which the bytes are appended. */
+    NetworkString *m_string;
+
+    /** Bits that have not yet been added to the string. */
+    uint32_t m_buffer;
+
+    /** Number of valid bits in m_buffer (always less than 8). */
+    int m_num_bits;
+
+public:
+    BitWriter(NetworkString *ns) : m_string(ns), m_buffer(0), m_num_bits(0) {}
+    // ------------------------------------------------------------------------
+    /** Writes the lowest num_bits bits of value. */
+    void write(uint32_t value, int num_bits)
+    {
+        assert(num_bits > 0 && num_bits <= 32);
+        while (num_bits > 0)
+        {
+            // Never put more than 8 new bits into the buffer, so it
+            // can not overflow.
+            int n = num_bits > 8 ? 8 : num_bits;
+            num_bits -= n;
+            m_buffer = (m_buffer << n) | ((value >> num_bits) & ((1u << n) - 1));
+            m_num_bits += n;
+            if (m_num_bits >= 8)
+            {
+                m_num_bits -= 8;
+                m_string->addUInt8((m_buffer >> m_num_bits) & 0xff);
+            }
+        }
+    }   // write
+    // ------------------------------------------------------------------------
+    /** Writes a single bit. */
+    void writeBool(bool b) { write(b ? 1 : 0, 1); }
+    // ------------------------------------------------------------------------
+    /** Writes a signed value using num_bits bits (two's complement). */
+    void writeSigned(int value, int num_bits) { write((uint32_t)value, num_bits); }
+    // ------------------------------------------------------------------------
+    /** Adds the remaining bits (padded with 0) to the string. */
+    void flush()
+    {
+        if (m_num_bits > 0)
+            m_string->addUInt8((m_buffer << (8 - m_num_bits)) & 0xff);
+        m_buffer   = 0;
+        m_num_bits = 0;
+    }   // flush
+};   // BitWriter
+
+// ============================================================================
+/** \class BitReader
+ *  \brief Reads values written by a BitWriter from a network string view.
+ *  Reading past the end of the data returns 0 and marks the reader as
+ *  invalid (see isValid()).
+ */
+class BitReader
+{
+private:
+    /** The view from which the bytes are read. */
+    NetworkStringView *m_view;
+
+    /** Bits read from the view that have not yet been returned. */
+    uint32_t m_buffer;
+
+    /** Number of valid bits in m_buffer. */
+    int m_num_bits;
+
+    /** False if an attempt was made to read past the end. */
+    bool m_valid;
+
+public:
+    BitReader(NetworkStringView *view)
+        : m_view(view), m_buffer(0), m_num_bits(0), m_valid(true) {}
+    // ------------------------------------------------------------------------
+    /** Reads num_bits bits and returns them as unsigned value. */
+    uint32_t read(int num_bits)
+    {
+        assert(num_bits > 0 && num_bits <= 32);
+        uint32_t result = 0;
+        while (num_bits > 0)
+        {
+            if (m_num_bits == 0)
+            {
+                if (m_view->size() == 0)
+                {
+                    m_valid = false;
+                    return 0;
+                }
+                m_buffer   = m_view->getUInt8();
+                m_num_bits = 8;
+            }
+            int n = num_bits < m_num_bits ? num_bits : m_num_bits;
+            m_num_bits -= n;
+            num_bits   -= n;
+            result = (result << n) | ((m_buffer >> m_num_bits) & ((1u << n) - 1));
+        }
+        return result;
+    }   // read
+    // ------------------------------------------------------------------------
+    /** Reads a single bit. */
+    bool readBool() { return read(1) != 0; }
+    // ------------------------------------------------------------------------
+    /** Reads a signed value that was written with num_bits bits. */
+    int readSigned(int num_bits)
+    {
+        uint32_t value = read(num_bits);
+        // Sign extension
+        if (num_bits < 32 && (value & (1u << (num_bits - 1))))
+            value |= ~((1u << num_bits) - 1);
+        return (int)value;
+    }   // readSigned
+    // ------------------------------------------------------------------------
+    /** Returns false if a read past the end of the data was attempted. */
+    bool isValid() const { return m_valid; }
+};   // BitReader
+
+#endif // BIT_STREAM_HPP
@@ -18,6 +18,7 @@
 
 #include "network/client_network_manager.hpp"
 
+#include "network/network_bot.hpp"
 #include "network/protocols/get_public_address.hpp"
 #include "network/protocols/hide_public_address.hpp"
 #include "network/protocols/show_public_address.hpp"
@@ -117,7 +118,8 @@ ClientNetworkManager::ClientNetworkManager()
 
 ClientNetworkManager::~ClientNetworkManager()
 {
-    pthread_cancel(*m_thread_keyboard);
+    if (m_thread_keyboard)
+        pthread_cancel(*m_thread_keyboard);
 }
 
 void ClientNetworkManager::run()
@@ -133,9 +135,12 @@ void ClientNetworkManager::run()
 
     Log::info("ClientNetworkManager", "Host initialized.");
 
-    // listen keyboard console input
-    m_thread_keyboard = (pthread_t*)(malloc(sizeof(pthread_t)));
-    pthread_create(m_thread_keyboard, NULL, waitInput, NULL);
+    // listen keyboard console input (bots have no user)
+    if (!NetworkBot::isEnabled())
+    {
+        m_thread_keyboard = (pthread_t*)(malloc(sizeof(pthread_t)));
+        pthread_create(m_thread_keyboard, NULL, waitInput, NULL);
+    }
 
     NetworkManager::run();
 
@@ -155,12 +160,17 @@ void ClientNetworkManager::reset()
 
 void ClientNetworkManager::sendPacket(const NetworkString& data, bool reliable)
 {
+    pthread_mutex_lock(&m_peers_mutex);
     if (m_peers.size() > 1)
         Log::warn("ClientNetworkManager", "Ambiguous send of data.\n");
     m_peers[0]->sendPacket(data, reliable);
+    pthread_mutex_unlock(&m_peers_mutex);
 }
 
 STKPeer* ClientNetworkManager::getPeer()
 {
-    return m_peers[0];
+    pthread_mutex_lock(&m_peers_mutex);
+    STKPeer *peer = m_peers[0];
+    pthread_mutex_unlock(&m_peers_mutex);
+    return peer;
 }
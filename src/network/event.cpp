@@ -25,6 +25,9 @@
 
 Event::Event(ENetEvent* event)
 {
+    m_packet      = NULL;
+    m_data_size   = 0;
+    m_data_offset = 0;
     switch (event->type)
     {
     case ENET_EVENT_TYPE_CONNECT:
@@ -40,18 +43,18 @@ Event::Event(ENetEvent* event)
         return;
         break;
     }
-    if (type == EVENT_TYPE_MESSAGE)
+    // Keep the packet (instead of copying its data), it is destroyed
+    // together with this event. The last byte is not part of the message
+    // (see STKPeer::sendPacket).
+    if (type == EVENT_TYPE_MESSAGE && event->packet)
     {
-        m_data = NetworkString(std::string((char*)(event->packet->data), event->packet->dataLength-1));
+        m_packet    = event->packet;
+        m_data_size = (int)(event->packet->dataLength) - 1;
+        if (m_data_size < 0)
+            m_data_size = 0;
     }
-
-    m_packet = NULL;
-    if (event->packet)
-        m_packet = event->packet;
-
-    if (m_packet)
-        enet_packet_destroy(m_packet); // we got all we need, just remove the data.
-    m_packet = NULL;
+    else if (event->packet)
+        enet_packet_destroy(event->packet);
 
     std::vector<STKPeer*> peers = NetworkManager::getInstance()->getPeers();
     peer = new STKPeer*;
@@ -76,22 +79,49 @@ Event::Event(ENetEvent* event)
 
 Event::Event(const Event& event)
 {
-    m_packet = NULL;
-    m_data = event.m_data;
+    m_packet      = NULL;
+    m_data_size   = 0;
+    m_data_offset = 0;
+    if (event.m_packet)
+    {
+        NetworkStringView data = event.getDataView();
+        // Keep the trailing byte, so the copy has the same layout.
+        m_packet = enet_packet_create(data.getBytes(), data.size() + 1, 0);
+        m_data_size = data.size();
+    }
     // copy the peer
     peer = event.peer;
     type = event.type;
 }
 
+Event::Event(const Event& event, const NetworkStringView& data)
+{
+    type          = EVENT_TYPE_MESSAGE;
+    m_data_offset = 0;
+    m_data_size   = data.size();
+    // Keep the trailing byte, so the packet has the same layout as a
+    // received one.
+    m_packet = enet_packet_create(NULL, m_data_size + 1, 0);
+    if (m_data_size > 0)
+        memcpy(m_packet->data, data.getBytes(), m_data_size);
+    m_packet->data[m_data_size] = 0;
+    // each event owns its pointer to the peer
+    peer  = new STKPeer*;
+    *peer = *event.peer;
+}
+
 Event::~Event()
 {
     delete peer;
     peer = NULL;
+    if (m_packet)
+        enet_packet_destroy(m_packet);
     m_packet = NULL;
 }
 
 void Event::removeFront(int size)
 {
-    m_data.removeFront(size);
+    m_data_offset += size;
+    if (m_data_offset > m_data_size)
+        m_data_offset = m_data_size;
 }
-
@@ -26,6 +26,7 @@
 
 #include "network/stk_peer.hpp"
 #include "network/network_string.hpp"
+#include "network/network_string_view.hpp"
 #include "utils/types.hpp"
 
 /*!
@@ -57,15 +58,24 @@ class Event
          */
         Event(ENetEvent* event);
         /*! \brief Constructor
-         *  \param event : The event to copy.
+         *  \param event : The event to copy. The copy gets its own copy of
+         *  the data.
          */
         Event(const Event& event);
+        /*! \brief Constructor
+         *  Creates a message event for one message of a framed packet
+         *  (see PacketBatch), with its own copy of the data.
+         *  \param event : The event of the framed packet.
+         *  \param data : The data of the message.
+         */
+        Event(const Event& event, const NetworkStringView& data);
         /*! \brief Destructor
          *  frees the memory of the ENetPacket.
          */
         ~Event();
 
         /*! \brief Remove bytes at the beginning of data.
+         *  This only moves the start of the data, nothing is copied.
          *  \param size : The number of bytes to remove.
          */
         void removeFront(int size);
@@ -74,14 +84,28 @@ class Event
          *  \return A copy of the message data. This is empty for events like
          *  connection or disconnections.
          */
-        NetworkString data() const { return m_data; }
+        NetworkString data() const { return getDataView().toNetworkString(); }
+
+        /*! \brief Get a read-only view on the data, which is not copied.
+         *  The view is only valid as long as this event exists.
+         *  \return A view on the message data. This is empty for events like
+         *  connection or disconnections.
+         */
+        NetworkStringView getDataView() const
+        {
+            if (!m_packet)
+                return NetworkStringView();
+            return NetworkStringView(m_packet->data + m_data_offset,
+                                     m_data_size - m_data_offset);
+        }
 
         EVENT_TYPE type;    //!< Type of the event.
         STKPeer** peer;     //!< Pointer to the peer that triggered that event.
 
     private:
-        NetworkString m_data; //!< Copy of the data passed by the event.
-        ENetPacket* m_packet; //!< A pointer on the ENetPacket to be deleted.
+        ENetPacket* m_packet; //!< The received packet, owned by this event.
+        int m_data_size;      //!< Size of the message data in the packet.
+        int m_data_offset;    //!< Number of bytes removed from the front.
 };
 
 #endif // EVENT_HPP
@@ -0,0 +1,146 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2014 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "network/kart_interpolation_buffer.hpp"
+
+#include <math.h>
+
+KartInterpolationBuffer::KartInterpolationBuffer()
+{
+    reset();
+}   // KartInterpolationBuffer
+
+// ----------------------------------------------------------------------------
+/** Removes all states and the time offset estimate. */
+void KartInterpolationBuffer::reset()
+{
+    m_samples.clear();
+    m_time_offset     = 0;
+    m_has_time_offset = false;
+    m_has_new_sample  = false;
+}   // reset
+
+// ----------------------------------------------------------------------------
+/** Adds a received state.
+ *  \param remote_time World time of the sender when the state was sent.
+ *  \param local_time Local world time when the state was received.
+ *  \param xyz Position of the kart.
+ *  \param rotation Rotation of the kart.
+ *  \return False if the state was discarded because it is not newer than
+ *          the newest state received so far.
+ */
+bool KartInterpolationBuffer::add(float remote_time, float local_time,
+                                  const Vec3 &xyz,
+                                  const btQuaternion &rotation)
+{
+    if (!m_samples.empty() && remote_time <= m_samples.back().m_time)
+        return false;
+
+    // Smooth the offset estimate to filter out network jitter. If the
+    // offset changes a lot (e.g. the world was restarted), use the new
+    // value immediately.
+    float offset = remote_time - local_time;
+    if (!m_has_time_offset || fabsf(offset - m_time_offset) > 1.0f)
+    {
+        m_time_offset     = offset;
+        m_has_time_offset = true;
+    }
+    else
+        m_time_offset += 0.1f*(offset - m_time_offset);
+
+    Sample s;
+    s.m_time     = remote_time;
+    s.m_xyz      = xyz;
+    s.m_rotation = rotation;
+    m_samples.push_back(s);
+    if (m_samples.size() > MAX_SAMPLES)
+        m_samples.pop_front();
+    m_has_new_sample = true;
+    return true;
+}   // add
+
+// ----------------------------------------------------------------------------
+/** Computes the state to show at a given local time. States that are not
+ *  needed anymore are removed.
+ *  \param local_time The current local world time.
+ *  \param delay How far behind the (estimated) remote time to show the kart.
+ *  \param max_extrapolation Maximum time to extrapolate past the newest
+ *         state.
+ *  \param xyz On return the position to show.
+ *  \param rotation On return the rotation to show.
+ *  \return False if no state is available.
+ */
+bool KartInterpolationBuffer::get(float local_time, float delay,
+                                  float max_extrapolation, Vec3 *xyz,
+                                  btQuaternion *rotation)
+{
+    if (m_samples.empty())
+        return false;
+
+    const float t = local_time + m_time_offset - delay;
+
+    // Remove all states older than the pair to interpolate between.
+    while (m_samples.size() > 2 && m_samples[1].m_time <= t)
+        m_samples.pop_front();
+
+    const Sample &first = m_samples.front();
+    if (t <= first.m_time || m_samples.size() == 1)
+    {
+        *xyz      = first.m_xyz;
+        *rotation = first.m_rotation;
+        return true;
+    }
+
+    const Sample &second = m_samples[1];
+    const float dt = second.m_time - first.m_time;
+    if (t <= second.m_time)
+    {
+        const float f = (t - first.m_time) / dt;
+        *xyz      = (1-f)*first.m_xyz + f*second.m_xyz;
+        *rotation = first.m_rotation.slerp(second.m_rotation, f);
+        return true;
+    }
+
+    // No newer state received: extrapolate with the last known velocity,
+    // but only for a limited time.
+    float extrapolate = t - second.m_time;
+    if (extrapolate > max_extrapolation)
+        extrapolate = max_extrapolation;
+    *xyz      = second.m_xyz + (second.m_xyz - first.m_xyz) * (extrapolate/dt);
+    *rotation = second.m_rotation;
+    return true;
+}   // get
+
+// ----------------------------------------------------------------------------
+/** Returns the newest state without any delay, which is used by the server
+ *  for karts controlled by clients. Older states are removed.
+ *  \param xyz On return the position of the newest state.
+ *  \param rotation On return the rotation of the newest state.
+ *  \return False if no state was added since the last call.
+ */
+bool KartInterpolationBuffer::getNewest(Vec3 *xyz, btQuaternion *rotation)
+{
+    if (!m_has_new_sample)
+        return false;
+    m_has_new_sample = false;
+    while (m_samples.size() > 1)
+        m_samples.pop_front();
+    *xyz      = m_samples.back().m_xyz;
+    *rotation = m_samples.back().m_rotation;
+    return true;
+}   // getNewest
@@ -0,0 +1,83 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2014 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+/*! \file kart_interpolation_buffer.hpp
+ *  \brief Buffer of received kart states used to smoothly show remote karts.
+ */
+
+#ifndef KART_INTERPOLATION_BUFFER_HPP
+#define KART_INTERPOLATION_BUFFER_HPP
+
+#include "utils/vec3.hpp"
+
+#include "LinearMath/btQuaternion.h"
+
+#include <deque>
+
+/** \class KartInterpolationBuffer
+ *  \brief Stores timestamped states of a remote kart, and computes the
+ *  state to show at a given time.
+ *  The states are keyed by the world time of the sender. Since the clocks
+ *  of sender and receiver are not identical, the buffer keeps an estimate
+ *  of the offset between the remote and the local time (which includes the
+ *  network latency). The kart is shown with a configurable delay, so that
+ *  in most cases two received states exist to interpolate between. If no
+ *  newer state is available (e.g. because of packet loss), the position is
+ *  extrapolated for a limited time. States that arrive out of order (older
+ *  than the newest state received) are discarded.
+ */
+class KartInterpolationBuffer
+{
+private:
+    /** One received state. */
+    struct Sample
+    {
+        float        m_time;
+        Vec3         m_xyz;
+        btQuaternion m_rotation;
+    };
+
+    /** The received states, sorted by time. */
+    std::deque<Sample> m_samples;
+
+    /** Estimated remote time minus local time. */
+    float m_time_offset;
+
+    /** True once m_time_offset was set. */
+    bool  m_has_time_offset;
+
+    /** True if a state was added since the last call of getNewest. */
+    bool  m_has_new_sample;
+
+    /** Maximum number of states to keep. */
+    static const unsigned int MAX_SAMPLES = 64;
+
+public:
+         KartInterpolationBuffer();
+    void reset();
+    bool add(float remote_time, float local_time, const Vec3 &xyz,
+             const btQuaternion &rotation);
+    bool get(float local_time, float delay, float max_extrapolation,
+             Vec3 *xyz, btQuaternion *rotation);
+    bool getNewest(Vec3 *xyz, btQuaternion *rotation);
+    // ------------------------------------------------------------------------
+    /** Returns true if no state has been received. */
+    bool isEmpty() const { return m_samples.empty(); }
+};   // KartInterpolationBuffer
+
+#endif // KART_INTERPOLATION_BUFFER_HPP
@@ -0,0 +1,247 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2014 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "network/kart_snapshot.hpp"
+
+#include "network/bit_stream.hpp"
+
+#include <math.h>
+
+namespace
+{
+    /** The three smallest components of a normalised quaternion are
+     *  in [-1/sqrt(2), 1/sqrt(2)]. */
+    const float ROTATION_RANGE = 0.70710678f;
+}
+
+KartSnapshotCodec::KartSnapshotCodec()
+{
+    m_min   = Vec3(0, 0, 0);
+    m_scale = Vec3(1, 1, 1);
+}   // KartSnapshotCodec
+
+// ----------------------------------------------------------------------------
+/** Defines the volume in which positions are quantized. Positions outside
+ *  of this volume are clamped.
+ *  \param min, max Minimum and maximum coordinates (e.g. the track AABB).
+ */
+void KartSnapshotCodec::init(const Vec3 &min, const Vec3 &max)
+{
+    m_min = min;
+    const float steps = (float)((1 << POSITION_BITS) - 1);
+    for (int i = 0; i < 3; i++)
+    {
+        float size = max[i] - min[i];
+        if (size < 1.0f) size = 1.0f;
+        m_scale[i] = steps / size;
+    }
+}   // init
+
+// ----------------------------------------------------------------------------
+/** Quantizes a position and rotation.
+ *  \param xyz The position.
+ *  \param rotation The rotation.
+ *  \param state On return the quantized state.
+ */
+void KartSnapshotCodec::quantize(const Vec3 &xyz,
+                                 const btQuaternion &rotation,
+                                 QuantizedKartState *state) const
+{
+    const float max_position = (float)((1 << POSITION_BITS) - 1);
+    for (int i = 0; i < 3; i++)
+    {
+        float f = (xyz[i] - m_min[i]) * m_scale[i] + 0.5f;
+        if (f < 0)            f = 0;
+        if (f > max_position) f = max_position;
+        state->m_position[i] = (uint32_t)f;
+    }
+
+    btQuaternion q = rotation.normalized();
+    float c[4] = { q.x(), q.y(), q.z(), q.w() };
+    unsigned int largest = 0;
+    for (unsigned int i = 1; i < 4; i++)
+    {
+        if (fabsf(c[i]) > fabsf(c[largest]))
+            largest = i;
+    }
+    // q and -q describe the same rotation, so make the largest
+    // component positive - then it does not need a sign bit.
+    const float sign = c[largest] < 0 ? -1.0f : 1.0f;
+    const float max_rotation = (float)((1 << ROTATION_BITS) - 1);
+    uint32_t packed = largest;
+    for (unsigned int i = 0; i < 4; i++)
+    {
+        if (i == largest) continue;
+        float f = (c[i]*sign + ROTATION_RANGE) / (2.0f*ROTATION_RANGE)
+                * max_rotation + 0.5f;
+        if (f < 0)            f = 0;
+        if (f > max_rotation) f = max_rotation;
+        packed = (packed << ROTATION_BITS) | (uint32_t)f;
+    }
+    state->m_rotation = packed;
+}   // quantize
+
+// ----------------------------------------------------------------------------
+/** Returns the position stored in a quantized state. */
+Vec3 KartSnapshotCodec::getPosition(const QuantizedKartState &state) const
+{
+    return Vec3(m_min.getX() + state.m_position[0] / m_scale.getX(),
+                m_min.getY() + state.m_position[1] / m_scale.getY(),
+                m_min.getZ() + state.m_position[2] / m_scale.getZ());
+}   // getPosition
+
+// ----------------------------------------------------------------------------
+/** Returns the rotation stored in a quantized state. */
+btQuaternion KartSnapshotCodec::getRotation(const QuantizedKartState &state) const
+{
+    const float max_rotation = (float)((1 << ROTATION_BITS) - 1);
+    const uint32_t mask      = (1 << ROTATION_BITS) - 1;
+    const unsigned int largest = state.m_rotation >> (3*ROTATION_BITS);
+    float c[4];
+    float sum = 0;
+    int shift = 2*ROTATION_BITS;
+    for (unsigned int i = 0; i < 4; i++)
+    {
+        if (i == largest) continue;
+        uint32_t v = (state.m_rotation >> shift) & mask;
+        shift -= ROTATION_BITS;
+        c[i] = v / max_rotation * 2.0f*ROTATION_RANGE - ROTATION_RANGE;
+        sum += c[i]*c[i];
+    }
+    c[largest] = sum < 1.0f ? sqrtf(1.0f - sum) : 0.0f;
+    btQuaternion q(c[0], c[1], c[2], c[3]);
+    return q.normalized();
+}   // getRotation
+
+// ----------------------------------------------------------------------------
+/** Writes a quantized kart state to a bit stream.
+ *  \param writer The bit stream.
+ *  \param state The state to write.
+ *  \param baseline State of the same kart in the snapshot the receiver
+ *         has acknowledged, or NULL if no baseline exists.
+ */
+void KartSnapshotCodec::write(BitWriter *writer,
+                              const QuantizedKartState &state,
+                              const QuantizedKartState *baseline)
+{
+    if (baseline && state == *baseline)
+    {
+        writer->writeBool(false);
+        return;
+    }
+    writer->writeBool(true);
+
+    const int max_delta = (1 << (DELTA_BITS - 1)) - 1;
+    int delta[3];
+    bool use_delta = baseline != NULL;
+    for (int i = 0; i < 3 && use_delta; i++)
+    {
+        delta[i] = (int)state.m_position[i] - (int)baseline->m_position[i];
+        if (delta[i] > max_delta || delta[i] < -max_delta - 1)
+            use_delta = false;
+    }
+    writer->writeBool(use_delta);
+    for (int i = 0; i < 3; i++)
+    {
+        if (use_delta)
+            writer->writeSigned(delta[i], DELTA_BITS);
+        else
+            writer->write(state.m_position[i], POSITION_BITS);
+    }
+
+    bool rotation_changed = !baseline || baseline->m_rotation != state.m_rotation;
+    writer->writeBool(rotation_changed);
+    if (rotation_changed)
+        writer->write(state.m_rotation, 2 + 3*ROTATION_BITS);
+}   // write
+
+// ----------------------------------------------------------------------------
+/** Reads a kart state written by write().
+ *  \param reader The bit stream.
+ *  \param state On return the state of the kart.
+ *  \param baseline The same baseline that was used when writing the state.
+ *  \return False if the data is incomplete, or refers to a missing baseline.
+ */
+bool KartSnapshotCodec::read(BitReader *reader, QuantizedKartState *state,
+                             const QuantizedKartState *baseline)
+{
+    bool changed = reader->readBool();
+    if (!changed)
+    {
+        if (!baseline) return false;
+        *state = *baseline;
+        return reader->isValid();
+    }
+
+    bool use_delta = reader->readBool();
+    if (use_delta && !baseline) return false;
+    for (int i = 0; i < 3; i++)
+    {
+        if (use_delta)
+            state->m_position[i] = baseline->m_position[i]
+                                 + reader->readSigned(DELTA_BITS);
+        else
+            state->m_position[i] = reader->read(POSITION_BITS);
+    }
+
+    bool rotation_changed = reader->readBool();
+    if (rotation_changed)
+        state->m_rotation = reader->read(2 + 3*ROTATION_BITS);
+    else if (baseline)
+        state->m_rotation = baseline->m_rotation;
+    else
+        return false;
+    return reader->isValid();
+}   // read
+
+// ============================================================================
+/** Removes all stored snapshots. */
+void KartSnapshotHistory::clear()
+{
+    for (unsigned int i = 0; i < HISTORY_SIZE; i++)
+    {
+        m_entries[i].m_valid = false;
+        m_entries[i].m_id    = 0;
+    }
+}   // clear
+
+// ----------------------------------------------------------------------------
+/** Stores a snapshot, replacing the oldest one.
+ *  \param id The id of the snapshot.
+ *  \param karts Quantized states of all karts.
+ */
+void KartSnapshotHistory::add(uint16_t id,
+                              const std::vector<QuantizedKartState> &karts)
+{
+    Entry &e  = m_entries[id % HISTORY_SIZE];
+    e.m_valid = true;
+    e.m_id    = id;
+    e.m_karts = karts;
+}   // add
+
+// ----------------------------------------------------------------------------
+/** Returns the kart states of the snapshot with the given id, or NULL if
+ *  this snapshot is not (or no longer) stored. */
+const std::vector<QuantizedKartState>*
+                             KartSnapshotHistory::get(uint16_t id) const
+{
+    const Entry &e = m_entries[id % HISTORY_SIZE];
+    if (!e.m_valid || e.m_id != id)
+        return NULL;
+    return &e.m_karts;
+}   // get
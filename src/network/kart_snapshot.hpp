@@ -0,0 +1,137 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2014 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+/*! \file kart_snapshot.hpp
+ *  \brief Quantization and delta compression of kart states for network
+ *  snapshots.
+ */
+
+#ifndef KART_SNAPSHOT_HPP
+#define KART_SNAPSHOT_HPP
+
+#include "utils/types.hpp"
+#include "utils/vec3.hpp"
+
+#include "LinearMath/btQuaternion.h"
+
+#include <vector>
+
+class BitReader;
+class BitWriter;
+
+/** \brief The quantized position and rotation of one kart.
+ *  The position is stored as fixed point values relative to the bounding
+ *  box of the track, the rotation using the 'smallest three' compression:
+ *  the index of the largest quaternion component (2 bits) and the other
+ *  three components (KartSnapshotCodec::ROTATION_BITS each).
+ */
+struct QuantizedKartState
+{
+    uint32_t m_position[3];
+    uint32_t m_rotation;
+
+    bool operator==(const QuantizedKartState &other) const
+    {
+        return m_position[0] == other.m_position[0] &&
+               m_position[1] == other.m_position[1] &&
+               m_position[2] == other.m_position[2] &&
+               m_rotation    == other.m_rotation;
+    }
+    bool operator!=(const QuantizedKartState &other) const
+    {
+        return !(*this == other);
+    }
+};   // QuantizedKartState
+
+// ============================================================================
+/** \class KartSnapshotCodec
+ *  \brief Converts kart states to and from their quantized representation,
+ *  and writes them to a bit stream, optionally delta-encoded against the
+ *  state of the same kart in an earlier snapshot (the baseline).
+ *  Encoding of one kart:
+ *  - 1 bit: changed. If 0 the kart has the same state as in the baseline.
+ *  - 1 bit: position is a delta. Then three signed DELTA_BITS values
+ *    follow, otherwise three POSITION_BITS values.
+ *  - 1 bit: rotation changed. If set, 32 bits of rotation follow.
+ */
+class KartSnapshotCodec
+{
+public:
+    /** Number of bits used for each coordinate of a position. */
+    static const int POSITION_BITS = 18;
+    /** Number of bits used for a delta-encoded coordinate. */
+    static const int DELTA_BITS    = 11;
+    /** Number of bits used for each of the three smallest components
+     *  of a quaternion. */
+    static const int ROTATION_BITS = 10;
+
+private:
+    /** Minimum coordinates of the quantized volume. */
+    Vec3 m_min;
+
+    /** Quantization steps per meter along each axis. */
+    Vec3 m_scale;
+
+public:
+                 KartSnapshotCodec();
+    void         init(const Vec3 &min, const Vec3 &max);
+    void         quantize(const Vec3 &xyz, const btQuaternion &rotation,
+                          QuantizedKartState *state) const;
+    Vec3         getPosition(const QuantizedKartState &state) const;
+    btQuaternion getRotation(const QuantizedKartState &state) const;
+    static void  write(BitWriter *writer, const QuantizedKartState &state,
+                       const QuantizedKartState *baseline);
+    static bool  read(BitReader *reader, QuantizedKartState *state,
+                      const QuantizedKartState *baseline);
+};   // KartSnapshotCodec
+
+// ============================================================================
+/** \class KartSnapshotHistory
+ *  \brief Stores the quantized states of all karts of the last
+ *  HISTORY_SIZE snapshots, so that they can be used as baseline for delta
+ *  encoding (on the sender) and decoding (on the receiver).
+ */
+class KartSnapshotHistory
+{
+public:
+    static const unsigned int HISTORY_SIZE = 32;
+
+private:
+    struct Entry
+    {
+        bool                            m_valid;
+        uint16_t                        m_id;
+        std::vector<QuantizedKartState> m_karts;
+    };
+    Entry m_entries[HISTORY_SIZE];
+
+public:
+         KartSnapshotHistory() { clear(); }
+    void clear();
+    void add(uint16_t id, const std::vector<QuantizedKartState> &karts);
+    const std::vector<QuantizedKartState>* get(uint16_t id) const;
+    // ------------------------------------------------------------------------
+    /** Returns true if snapshot id a is newer than b, taking the
+     *  wrap around of the 16 bit ids into account. */
+    static bool isNewer(uint16_t a, uint16_t b)
+    {
+        return a != b && (uint16_t)(a - b) < 0x8000;
+    }   // isNewer
+};   // KartSnapshotHistory
+
+#endif // KART_SNAPSHOT_HPP
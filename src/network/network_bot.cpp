@@ -0,0 +1,123 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2014 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "network/network_bot.hpp"
+
+#include "input/input.hpp"
+#include "karts/abstract_kart.hpp"
+#include "karts/controller/controller.hpp"
+#include "karts/kart_properties_manager.hpp"
+#include "modes/world.hpp"
+#include "network/network_world.hpp"
+#include "online/profile.hpp"
+#include "utils/log.hpp"
+#include "utils/string_utils.hpp"
+
+#include <stdlib.h>
+#include <vector>
+
+bool             NetworkBot::m_enabled             = false;
+Online::Profile *NetworkBot::m_profile             = NULL;
+unsigned int     NetworkBot::m_kart_attempts       = 0;
+float            NetworkBot::m_time_to_next_action = 0.0f;
+
+/** Time between two changes of the controls of the bot kart. */
+static const float BOT_ACTION_INTERVAL = 0.5f;
+
+// ----------------------------------------------------------------------------
+/** Turns this client into a bot.
+ *  \param id The global player id used by the bot, which must be different
+ *         for each client connected to a server.
+ */
+void NetworkBot::enable(uint32_t id)
+{
+    destroy();
+    m_enabled   = true;
+    m_profile   = new Online::Profile(id, irr::core::stringw(L"bot")
+                                          + StringUtils::toWString(id));
+    m_kart_attempts       = 0;
+    m_time_to_next_action = 0.0f;
+    Log::info("NetworkBot", "Running as network bot with id %u.", id);
+}   // enable
+
+// ----------------------------------------------------------------------------
+/** Frees the bot profile. */
+void NetworkBot::destroy()
+{
+    delete m_profile;
+    m_profile = NULL;
+    m_enabled = false;
+}   // destroy
+
+// ----------------------------------------------------------------------------
+/** Returns the kart the bot requests next. Each bot starts with a different
+ *  kart (depending on its id), and tries the next one each time the server
+ *  refuses the selection.
+ *  \return The kart identifier, or "" if all karts were refused.
+ */
+std::string NetworkBot::getNextKart()
+{
+    std::vector<std::string> karts =
+        kart_properties_manager->getAllAvailableKarts();
+    if (karts.empty() || m_kart_attempts >= karts.size())
+    {
+        Log::error("NetworkBot", "No kart left to select.");
+        return "";
+    }
+    unsigned int index = (m_profile->getID() + m_kart_attempts) % karts.size();
+    m_kart_attempts++;
+    return karts[index];
+}   // getNextKart
+
+// ----------------------------------------------------------------------------
+/** Drives the kart of the bot during a race: it always accelerates and
+ *  randomly changes steering, and sometimes fires, so that the controller
+ *  events are sent to the server like for a human player.
+ *  \param dt Time step size.
+ */
+void NetworkBot::update(float dt)
+{
+    World *world = World::getWorld();
+    if (!world || world->getPhase() != WorldStatus::RACE_PHASE ||
+        !NetworkWorld::getInstance<NetworkWorld>()->isRunning())
+        return;
+
+    m_time_to_next_action -= dt;
+    if (m_time_to_next_action > 0)
+        return;
+    m_time_to_next_action = BOT_ACTION_INTERVAL;
+
+    const std::string &self_kart = NetworkWorld::getInstance()->m_self_kart;
+    for (unsigned int i = 0; i < world->getNumKarts(); i++)
+    {
+        AbstractKart *kart = world->getKart(i);
+        if (kart->getIdent() != self_kart)
+            continue;
+
+        Controller *controller = kart->getController();
+        int steer = rand() % 3;
+        controller->action(PA_ACCEL, Input::MAX_VALUE);
+        controller->action(PA_STEER_LEFT,
+                           steer == 0 ? Input::MAX_VALUE : 0);
+        controller->action(PA_STEER_RIGHT,
+                           steer == 1 ? Input::MAX_VALUE : 0);
+        controller->action(PA_FIRE,
+                           rand() % 10 == 0 ? Input::MAX_VALUE : 0);
+        break;
+    }
+}   // update
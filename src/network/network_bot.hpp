@@ -0,0 +1,70 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2014 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+/*! \file network_bot.hpp
+ *  \brief Turns a client into a headless bot, used to load test servers.
+ */
+
+#ifndef NETWORK_BOT_HPP
+#define NETWORK_BOT_HPP
+
+#include "utils/types.hpp"
+
+#include <string>
+
+namespace Online { class Profile; }
+
+/** \class NetworkBot
+ *  \brief A synthetic network player (--network-bot=id).
+ *  A bot runs the normal client protocols (ConnectToServer,
+ *  ClientLobbyRoomProtocol, StartGameProtocol, ControllerEventsProtocol)
+ *  without user interaction: it uses its own player id instead of the
+ *  signed in user, selects a kart as soon as the kart selection starts,
+ *  and steers its kart randomly during the race. Together with
+ *  --connect-to and --lan-server this allows to test a server with many
+ *  clients on one computer, see tools/network_load_test.sh.
+ */
+class NetworkBot
+{
+private:
+    /** True if this client is a bot. */
+    static bool             m_enabled;
+
+    /** The profile used as local player, with the id of the bot. */
+    static Online::Profile *m_profile;
+
+    /** Number of karts tried so far in the kart selection. */
+    static unsigned int     m_kart_attempts;
+
+    /** Time left before the controls of the kart are changed. */
+    static float            m_time_to_next_action;
+
+public:
+    static void             enable(uint32_t id);
+    static void             destroy();
+    static std::string      getNextKart();
+    static void             update(float dt);
+    // ------------------------------------------------------------------------
+    /** Returns true if this client is a bot. */
+    static bool             isEnabled()  { return m_enabled; }
+    // ------------------------------------------------------------------------
+    /** Returns the profile of the bot player. */
+    static Online::Profile* getProfile() { return m_profile; }
+};   // NetworkBot
+
+#endif // NETWORK_BOT_HPP
@@ -25,7 +25,10 @@
 #include "network/protocol_manager.hpp"
 #include "network/client_network_manager.hpp"
 #include "network/server_network_manager.hpp"
+#include "network/network_bot.hpp"
 
+#include "online/current_user.hpp"
+#include "online/profile.hpp"
 #include "utils/log.hpp"
 
 #include <pthread.h>
@@ -39,6 +42,8 @@ NetworkManager::NetworkManager()
     m_public_address.port = 0;
     m_localhost = NULL;
     m_game_setup = NULL;
+    pthread_mutex_init(&m_peers_mutex, NULL);
+    STKHost::openCapture();
 }
 
 //-----------------------------------------------------------------------------
@@ -54,6 +59,9 @@ NetworkManager::~NetworkManager()
         delete m_peers.back();
         m_peers.pop_back();
     }
+    pthread_mutex_destroy(&m_peers_mutex);
+    // The protocol and receive threads are stopped now.
+    STKHost::closeCapture();
 }
 
 //-----------------------------------------------------------------------------
@@ -69,11 +77,13 @@ void NetworkManager::reset()
     if (m_localhost)
         delete m_localhost;
     m_localhost = NULL;
+    pthread_mutex_lock(&m_peers_mutex);
     while(!m_peers.empty())
     {
         delete m_peers.back();
         m_peers.pop_back();
     }
+    pthread_mutex_unlock(&m_peers_mutex);
 }
 
 void NetworkManager::abort()
@@ -111,19 +121,21 @@ void NetworkManager::notifyEvent(Event* event)
     STKPeer* peer = *event->peer;
     if (event->type == EVENT_TYPE_CONNECTED)
     {
-        Log::info("NetworkManager", "A client has just connected. There are now %lu peers.", m_peers.size() + 1);
         Log::debug("NetworkManager", "Addresses are : %lx, %lx, %lx", event->peer, *event->peer, peer);
         // create the new peer:
+        pthread_mutex_lock(&m_peers_mutex);
         m_peers.push_back(peer);
+        Log::info("NetworkManager", "A client has just connected. There are now %lu peers.", m_peers.size());
+        pthread_mutex_unlock(&m_peers_mutex);
     }
     if (event->type == EVENT_TYPE_MESSAGE)
     {
         uint32_t addr = peer->getAddress();
-        Log::verbose("NetworkManager", "Message, Sender : %i.%i.%i.%i, message = \"%s\"",
+        Log::verbose("NetworkManager", "Message, Sender : %i.%i.%i.%i, size = %d",
                   ((addr>>24)&0xff),
                   ((addr>>16)&0xff),
                   ((addr>>8)&0xff),
-                  (addr & 0xff), event->data().std_string().c_str());
+                  (addr & 0xff), event->data().size());
 
     }
 
@@ -143,6 +155,7 @@ void NetworkManager::sendPacket(STKPeer* peer, const NetworkString& data, bool r
 
 void NetworkManager::sendPacketExcept(STKPeer* peer, const NetworkString& data, bool reliable)
 {
+    pthread_mutex_lock(&m_peers_mutex);
     for (unsigned int i = 0; i < m_peers.size(); i++)
     {
         STKPeer* p = m_peers[i];
@@ -151,6 +164,42 @@ void NetworkManager::sendPacketExcept(STKPeer* peer, const NetworkString& data,
             p->sendPacket(data, reliable);
         }
     }
+    pthread_mutex_unlock(&m_peers_mutex);
+}
+
+//-----------------------------------------------------------------------------
+/** Sends the unreliable messages that were collected for each peer (see
+ *  PacketBatch). Called after each update of the protocols.
+ */
+void NetworkManager::flushPackets()
+{
+    pthread_mutex_lock(&m_peers_mutex);
+    for (unsigned int i = 0; i < m_peers.size(); i++)
+        m_peers[i]->flushPackets();
+    pthread_mutex_unlock(&m_peers_mutex);
+}
+
+//-----------------------------------------------------------------------------
+/** Returns a copy of the list of peers. Only the list is copied: a peer
+ *  can still be deleted by removePeer on another thread, so a thread that
+ *  does not handle the disconnection of peers must use lockPeers and
+ *  getLockedPeers instead (see NetworkStatistics::report). */
+std::vector<STKPeer*> NetworkManager::getPeers()
+{
+    pthread_mutex_lock(&m_peers_mutex);
+    std::vector<STKPeer*> peers = m_peers;
+    pthread_mutex_unlock(&m_peers_mutex);
+    return peers;
+}
+
+//-----------------------------------------------------------------------------
+
+unsigned int NetworkManager::getPeerCount()
+{
+    pthread_mutex_lock(&m_peers_mutex);
+    unsigned int count = m_peers.size();
+    pthread_mutex_unlock(&m_peers_mutex);
+    return count;
 }
 
 //-----------------------------------------------------------------------------
@@ -174,12 +223,14 @@ void NetworkManager::disconnected()
     m_game_setup = NULL;
 
     // remove all peers
+    pthread_mutex_lock(&m_peers_mutex);
     for (unsigned int i = 0; i < m_peers.size(); i++)
     {
         delete m_peers[i];
         m_peers[i] = NULL;
     }
     m_peers.clear();
+    pthread_mutex_unlock(&m_peers_mutex);
 }
 
 //-----------------------------------------------------------------------------
@@ -209,6 +260,7 @@ void NetworkManager::removePeer(STKPeer* peer)
                peer->getAddress()&0xff,
                peer->getPort());
     // remove the peer:
+    pthread_mutex_lock(&m_peers_mutex);
     bool removed = false;
     for (unsigned int i = 0; i < m_peers.size(); i++)
     {
@@ -228,6 +280,27 @@ void NetworkManager::removePeer(STKPeer* peer)
         Log::warn("NetworkManager", "The peer that has been disconnected was not registered by the Network Manager.");
 
     Log::info("NetworkManager", "Somebody is now disconnected. There are now %lu peers.", m_peers.size());
+    pthread_mutex_unlock(&m_peers_mutex);
+}
+
+//-----------------------------------------------------------------------------
+/** Returns the profile of the player using this computer: the signed in
+ *  user, or the bot player if this client is a NetworkBot.
+ */
+Online::Profile* NetworkManager::getLocalProfile()
+{
+    if (NetworkBot::isEnabled())
+        return NetworkBot::getProfile();
+    return Online::CurrentUser::get()->getProfile();
+}
+
+//-----------------------------------------------------------------------------
+/** Returns the global id of the player using this computer. */
+uint32_t NetworkManager::getLocalPlayerId()
+{
+    if (NetworkBot::isEnabled())
+        return NetworkBot::getProfile()->getID();
+    return Online::CurrentUser::get()->getID();
 }
 
 //-----------------------------------------------------------------------------
@@ -32,8 +32,11 @@
 #include "network/event.hpp"
 #include "network/game_setup.hpp"
 
+#include <pthread.h>
 #include <vector>
 
+namespace Online { class Profile; }
+
 /** \class NetworkManager
  *  \brief Gives the general functions to use network communication.
  *  This class is in charge of storing the peers connected to this host.
@@ -83,6 +86,7 @@ class NetworkManager : public Singleton<NetworkManager>
         virtual void sendPacketExcept(STKPeer* peer, 
                                 const NetworkString& data, 
                                 bool reliable = true);
+        virtual void flushPackets();
 
         // Game related functions
         virtual GameSetup* setupNewGame(); //!< Creates a new game setup and returns it
@@ -92,6 +96,8 @@ class NetworkManager : public Singleton<NetworkManager>
         void setLogin(std::string username, std::string password);
         void setPublicAddress(TransportAddress addr);
         void removePeer(STKPeer* peer);
+        Online::Profile* getLocalProfile();
+        uint32_t getLocalPlayerId();
 
         // getters
         virtual bool peerExists(TransportAddress peer);
@@ -101,8 +107,17 @@ class NetworkManager : public Singleton<NetworkManager>
         inline bool isClient()              { return !isServer();       }
         bool isPlayingOnline()              { return m_playing_online;  }
         STKHost* getHost()                  { return m_localhost;       }
-        std::vector<STKPeer*> getPeers()    { return m_peers;           }
-        unsigned int getPeerCount()         { return m_peers.size();    }
+        std::vector<STKPeer*> getPeers();
+        unsigned int getPeerCount();
+        /*! \brief Locks the list of peers, so that no other thread can
+         *  add or delete peers till unlockPeers is called. */
+        void lockPeers()   { pthread_mutex_lock(&m_peers_mutex);   }
+        /*! \brief Unlocks the list of peers (see lockPeers).       */
+        void unlockPeers() { pthread_mutex_unlock(&m_peers_mutex); }
+        /*! \brief Returns the list of peers. Must only be used between
+         *  lockPeers and unlockPeers.                               */
+        const std::vector<STKPeer*> &getLockedPeers() const
+                                            { return m_peers;           }
         TransportAddress getPublicAddress() { return m_public_address;  }
         GameSetup* getGameSetup()           { return m_game_setup;      }
 
@@ -112,6 +127,9 @@ class NetworkManager : public Singleton<NetworkManager>
 
         // protected members
         std::vector<STKPeer*> m_peers;
+        /** Protects m_peers, which is changed by the listening thread
+         *  while the protocol threads send messages to the peers. */
+        pthread_mutex_t m_peers_mutex;
         STKHost* m_localhost;
         bool m_playing_online;
         GameSetup* m_game_setup;
@@ -0,0 +1,176 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2014 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "network/network_statistics.hpp"
+
+#include "network/network_manager.hpp"
+#include "network/packet_batch.hpp"
+#include "network/protocol_manager.hpp"
+#include "network/stk_peer.hpp"
+#include "utils/log.hpp"
+#include "utils/time.hpp"
+
+#include <string.h>
+#include <vector>
+
+float    NetworkStatistics::m_interval    = 0.0f;
+uint64_t NetworkStatistics::m_last_report = 0;
+uint32_t NetworkStatistics::m_num_ticks   = 0;
+uint64_t NetworkStatistics::m_tick_sum    = 0;
+uint64_t NetworkStatistics::m_tick_max    = 0;
+uint64_t NetworkStatistics::m_queue_sum   = 0;
+uint32_t NetworkStatistics::m_queue_max   = 0;
+std::map<uint64_t, NetworkStatistics::PeerCounters>
+         NetworkStatistics::m_peer_counters;
+
+// ----------------------------------------------------------------------------
+/** Enables the statistics.
+ *  \param interval Time between two reports in seconds.
+ */
+void NetworkStatistics::enable(float interval)
+{
+    m_interval    = interval;
+    m_last_report = StkTime::getMicrosecondsSinceEpoch();
+    m_num_ticks   = 0;
+    m_tick_sum    = 0;
+    m_tick_max    = 0;
+    m_queue_sum   = 0;
+    m_queue_max   = 0;
+    m_peer_counters.clear();
+    Log::info("NetworkStatistics", "Reporting network statistics every "
+              "%.1f seconds.", interval);
+}   // enable
+
+// ----------------------------------------------------------------------------
+/** Called at the end of each main loop iteration. Records the duration of
+ *  the iteration and the size of the event queue, and writes a report if
+ *  the interval has elapsed.
+ *  \param duration Time used by the iteration (without the frame rate
+ *         throttling) in microseconds.
+ */
+void NetworkStatistics::addTick(uint64_t duration)
+{
+    m_num_ticks++;
+    m_tick_sum += duration;
+    if (duration > m_tick_max)
+        m_tick_max = duration;
+
+    ProtocolManager *manager = ProtocolManager::getInstance();
+    if (manager)
+    {
+        uint32_t queued = manager->getQueuedEventsCount();
+        m_queue_sum += queued;
+        if (queued > m_queue_max)
+            m_queue_max = queued;
+    }
+
+    uint64_t now = StkTime::getMicrosecondsSinceEpoch();
+    float elapsed = (now - m_last_report) * 0.000001f;
+    if (elapsed < m_interval)
+        return;
+
+    report(elapsed);
+    m_last_report = now;
+    m_num_ticks   = 0;
+    m_tick_sum    = 0;
+    m_tick_max    = 0;
+    m_queue_sum   = 0;
+    m_queue_max   = 0;
+}   // addTick
+
+// ----------------------------------------------------------------------------
+/** Logs the statistics collected since the last report.
+ *  \param elapsed Time since the last report in seconds.
+ */
+void NetworkStatistics::report(float elapsed)
+{
+    if (m_num_ticks == 0)
+        return;
+
+    ProtocolManager *manager = ProtocolManager::getInstance();
+    Log::info("NetworkStatistics", "%u ticks in %.1f s: tick avg %.2f ms, "
+              "max %.2f ms; event queue avg %.1f, max %u; %u events dropped.",
+              m_num_ticks, elapsed, m_tick_sum * 0.001f / m_num_ticks,
+              m_tick_max * 0.001f, (float)m_queue_sum / m_num_ticks,
+              m_queue_max, manager ? manager->getDroppedEventsCount() : 0);
+
+    NetworkManager *network_manager = NetworkManager::getInstance();
+    if (!network_manager)
+        return;
+
+    // Peers can be deleted by other threads (when a client disconnects),
+    // so copy their data while the list of peers is locked.
+    std::vector<PeerSample> samples;
+    network_manager->lockPeers();
+    const std::vector<STKPeer*> &peers = network_manager->getLockedPeers();
+    samples.resize(peers.size());
+    for (unsigned int i = 0; i < peers.size(); i++)
+    {
+        const STKPeer *peer = peers[i];
+        const PacketBatch *batch = peer->getPacketBatch();
+        PeerSample &sample = samples[i];
+        sample.m_address         = peer->getAddress();
+        sample.m_port            = peer->getPort();
+        sample.m_round_trip_time = peer->getRoundTripTime();
+        sample.m_counters.m_bytes_sent       = batch->getBytesSent();
+        sample.m_counters.m_bytes_received   = batch->getBytesReceived();
+        sample.m_counters.m_packets_sent     = batch->getPacketsSent();
+        sample.m_counters.m_packets_received = batch->getPacketsReceived();
+    }
+    network_manager->unlockPeers();
+
+    std::map<uint64_t, PeerCounters> counters;
+    float total_sent = 0, total_received = 0;
+    for (unsigned int i = 0; i < samples.size(); i++)
+    {
+        const PeerSample &sample = samples[i];
+        uint64_t key = ((uint64_t)sample.m_address << 16) | sample.m_port;
+        const PeerCounters &current = sample.m_counters;
+        counters[key] = current;
+
+        // A new peer is compared with zero counters.
+        PeerCounters previous;
+        memset(&previous, 0, sizeof(previous));
+        std::map<uint64_t, PeerCounters>::const_iterator it =
+            m_peer_counters.find(key);
+        if (it != m_peer_counters.end())
+            previous = it->second;
+
+        float sent     = (current.m_bytes_sent - previous.m_bytes_sent)
+                       / elapsed;
+        float received = (current.m_bytes_received - previous.m_bytes_received)
+                       / elapsed;
+        total_sent     += sent;
+        total_received += received;
+        uint32_t address = sample.m_address;
+        Log::info("NetworkStatistics", "  peer %d.%d.%d.%d:%d: sent %.1f kB/s "
+                  "(%.1f packets/s), received %.1f kB/s (%.1f packets/s), "
+                  "rtt %u ms.",
+                  (address>>24)&0xff, (address>>16)&0xff, (address>>8)&0xff,
+                  address&0xff, sample.m_port, sent / 1024.0f,
+                  (current.m_packets_sent - previous.m_packets_sent) / elapsed,
+                  received / 1024.0f,
+                  (current.m_packets_received - previous.m_packets_received)
+                  / elapsed,
+                  sample.m_round_trip_time);
+    }
+    Log::info("NetworkStatistics", "  %u peers: sent %.1f kB/s, received "
+              "%.1f kB/s.", (unsigned int)samples.size(), total_sent / 1024.0f,
+              total_received / 1024.0f);
+    m_peer_counters.swap(counters);
+}   // report
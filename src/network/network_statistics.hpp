@@ -0,0 +1,94 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2014 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+/*! \file network_statistics.hpp
+ *  \brief Periodically reports the load of a network game.
+ */
+
+#ifndef NETWORK_STATISTICS_HPP
+#define NETWORK_STATISTICS_HPP
+
+#include "utils/types.hpp"
+
+#include <map>
+
+/** \class NetworkStatistics
+ *  \brief Collects the duration of each main loop iteration (tick) and the
+ *  number of events waiting in the protocol manager, and regularly logs
+ *  them together with the bandwidth used for each peer
+ *  (--network-stats=seconds). This is mainly used to measure how a server
+ *  scales with the number of clients, see tools/network_load_test.sh.
+ *  All functions must be called from the main thread.
+ */
+class NetworkStatistics
+{
+private:
+    /** Traffic counters of a peer at the time of the last report. */
+    struct PeerCounters
+    {
+        uint32_t m_bytes_sent;
+        uint32_t m_bytes_received;
+        uint32_t m_packets_sent;
+        uint32_t m_packets_received;
+    };
+
+    /** Data of a peer that is copied while the peers are locked. */
+    struct PeerSample
+    {
+        uint32_t     m_address;
+        uint16_t     m_port;
+        uint32_t     m_round_trip_time;
+        PeerCounters m_counters;
+    };
+
+    /** Time between two reports in seconds, 0 if disabled. */
+    static float    m_interval;
+
+    /** Time of the last report in microseconds. */
+    static uint64_t m_last_report;
+
+    /** Number of ticks since the last report. */
+    static uint32_t m_num_ticks;
+
+    /** Sum of the tick durations since the last report, in microseconds. */
+    static uint64_t m_tick_sum;
+
+    /** Longest tick since the last report, in microseconds. */
+    static uint64_t m_tick_max;
+
+    /** Sum of the sampled event queue sizes since the last report. */
+    static uint64_t m_queue_sum;
+
+    /** Largest sampled event queue size since the last report. */
+    static uint32_t m_queue_max;
+
+    /** Counters of each peer at the last report, indexed by
+     *  (address << 16) | port. */
+    static std::map<uint64_t, PeerCounters> m_peer_counters;
+
+    static void report(float elapsed);
+
+public:
+    static void enable(float interval);
+    static void addTick(uint64_t duration);
+    // ------------------------------------------------------------------------
+    /** Returns true if statistics are collected. */
+    static bool isEnabled() { return m_interval > 0; }
+};   // NetworkStatistics
+
+#endif // NETWORK_STATISTICS_HPP
@@ -140,6 +140,12 @@ class NetworkString
         }
         inline NetworkString& as(const std::string& value) { return addString(value); }
 
+        NetworkString& addBytes(const uint8_t* bytes, int size)
+        {
+            m_string.insert(m_string.end(), bytes, bytes+size);
+            return *this;
+        }
+
         NetworkString& operator+=(NetworkString const& value)
         {
             m_string.insert( m_string.end(), value.m_string.begin(), value.m_string.end() );
@@ -0,0 +1,207 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2014 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+/*! \file network_string_view.hpp
+ *  \brief Defines a read-only view on received network data.
+ */
+
+#ifndef NETWORK_STRING_VIEW_HPP
+#define NETWORK_STRING_VIEW_HPP
+
+#include "network/network_string.hpp"
+#include "utils/types.hpp"
+
+#include <string>
+#include <string.h>
+
+/** \class NetworkStringView
+ *  \brief Read-only view with a moving cursor on a chain of 8-bit unsigned
+ *  integers.
+ *  The view does not copy or own the data, it only borrows it (e.g. from
+ *  the ENet packet of an event), so the data must stay valid as long as the
+ *  view is used. Reading data moves the cursor forward, which is O(1),
+ *  unlike NetworkString::removeFront. All read functions are bounds
+ *  checked: reading past the end returns 0 and marks the view as invalid
+ *  (see isValid()), so a protocol can read a whole record and check once
+ *  afterwards if the data was complete. The byte order is identical to the
+ *  one used by NetworkString.
+ */
+class NetworkStringView
+{
+private:
+    /** Pointer to the first byte of the viewed data. */
+    const uint8_t *m_bytes;
+
+    /** Total number of bytes in the viewed data. */
+    int m_size;
+
+    /** Position of the read cursor. */
+    int m_pos;
+
+    /** Set to false if an attempt was made to read past the end. */
+    bool m_valid;
+
+    // ------------------------------------------------------------------------
+    /** Checks if n bytes can be read at offset from the cursor. If not
+     *  the view is marked as invalid. */
+    bool checkAvailable(int offset, int n)
+    {
+        if (offset < 0 || m_pos + offset + n > m_size)
+        {
+            m_valid = false;
+            return false;
+        }
+        return true;
+    }   // checkAvailable
+
+public:
+    /** Creates an empty view. */
+    NetworkStringView() : m_bytes(NULL), m_size(0), m_pos(0), m_valid(true) {}
+    // ------------------------------------------------------------------------
+    /** Creates a view on the given bytes.
+     *  \param bytes Pointer to the data, which is not copied.
+     *  \param size Number of bytes. */
+    NetworkStringView(const uint8_t *bytes, int size)
+        : m_bytes(bytes), m_size(size), m_pos(0), m_valid(true) {}
+    // ------------------------------------------------------------------------
+    /** Creates a view on the content of a network string. The string must
+     *  not be modified while the view is in use. */
+    NetworkStringView(const NetworkString &ns)
+        : m_bytes(ns.size() > 0 ? ns.getBytes() : NULL), m_size(ns.size()),
+          m_pos(0), m_valid(true) {}
+    // ------------------------------------------------------------------------
+    /** Returns the number of bytes that can still be read. */
+    int size() const { return m_size - m_pos; }
+    // ------------------------------------------------------------------------
+    /** Returns false if a read past the end of the data was attempted. */
+    bool isValid() const { return m_valid; }
+    // ------------------------------------------------------------------------
+    /** Returns a pointer to the byte at the cursor position. */
+    const uint8_t* getBytes() const { return m_bytes + m_pos; }
+    // ------------------------------------------------------------------------
+    /** Moves the cursor forward by the specified number of bytes. */
+    NetworkStringView& skip(int n)
+    {
+        if (checkAvailable(0, n))
+            m_pos += n;
+        else
+            m_pos = m_size;
+        return *this;
+    }   // skip
+    // ------------------------------------------------------------------------
+    /** Returns a view on the next n bytes, and moves the cursor behind
+     *  them. This allows to hand a single record to a parsing function. */
+    NetworkStringView getView(int n)
+    {
+        if (!checkAvailable(0, n))
+        {
+            m_pos = m_size;
+            return NetworkStringView();
+        }
+        NetworkStringView result(m_bytes + m_pos, n);
+        m_pos += n;
+        return result;
+    }   // getView
+    // ------------------------------------------------------------------------
+    /** Returns a copy of the remaining data as network string. */
+    NetworkString toNetworkString() const
+    {
+        return NetworkString(std::string((const char*)getBytes(), size()));
+    }   // toNetworkString
+
+    // ------------------------------------------------------------------------
+    /** Returns a value of n bytes stored at offset from the cursor without
+     *  moving the cursor. */
+    template<typename T, size_t n>
+    T peek(int offset)
+    {
+        if (!checkAvailable(offset, n))
+            return 0;
+        T result = 0;
+        for (unsigned int i = 0; i < n; i++)
+        {
+            result <<= 8;
+            result += (m_bytes[m_pos + offset + i] & 0xff);
+        }
+        return result;
+    }   // peek
+    // ------------------------------------------------------------------------
+    /** Returns a value of n bytes and moves the cursor behind it. */
+    template<typename T, size_t n>
+    T get()
+    {
+        T result = peek<T, n>(0);
+        m_pos = m_valid ? m_pos + (int)n : m_size;
+        return result;
+    }   // get
+
+    // ------------------------------------------------------------------------
+    inline int      getInt()    { return get<int, 4>();      }
+    inline uint32_t getUInt32() { return get<uint32_t, 4>(); }
+    inline uint16_t getUInt16() { return get<uint16_t, 2>(); }
+    inline uint8_t  getUInt8()  { return get<uint8_t, 1>();  }
+    inline char     getChar()   { return get<char, 1>();     }
+
+    inline uint32_t peekUInt32(int offset = 0) { return peek<uint32_t, 4>(offset); }
+    inline uint16_t peekUInt16(int offset = 0) { return peek<uint16_t, 2>(offset); }
+    inline uint8_t  peekUInt8(int offset = 0)  { return peek<uint8_t, 1>(offset);  }
+
+    // ------------------------------------------------------------------------
+    /** Reads a float (BEWARE OF PRECISION, see NetworkString::addFloat). */
+    float getFloat()
+    {
+        float result = 0;
+        if (checkAvailable(0, 4))
+        {
+            memcpy(&result, m_bytes + m_pos, 4);
+            m_pos += 4;
+        }
+        else
+            m_pos = m_size;
+        return result;
+    }   // getFloat
+    // ------------------------------------------------------------------------
+    /** Reads a double (BEWARE OF PRECISION). */
+    double getDouble()
+    {
+        double result = 0;
+        if (checkAvailable(0, 8))
+        {
+            memcpy(&result, m_bytes + m_pos, 8);
+            m_pos += 8;
+        }
+        else
+            m_pos = m_size;
+        return result;
+    }   // getDouble
+    // ------------------------------------------------------------------------
+    /** Reads a string of the given length. */
+    std::string getString(int len)
+    {
+        if (!checkAvailable(0, len))
+        {
+            m_pos = m_size;
+            return "";
+        }
+        std::string result((const char*)(m_bytes + m_pos), len);
+        m_pos += len;
+        return result;
+    }   // getString
+};   // NetworkStringView
+
+#endif // NETWORK_STRING_VIEW_HPP
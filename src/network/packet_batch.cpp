@@ -0,0 +1,183 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2014 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "network/packet_batch.hpp"
+
+#include "network/event.hpp"
+#include "network/network_string_view.hpp"
+#include "network/stk_host.hpp"
+#include "utils/log.hpp"
+
+#include <string.h>
+
+const uint8_t PacketBatch::BATCH_MARKER;
+const int     PacketBatch::MAX_BATCH_SIZE;
+
+PacketBatch::PacketBatch()
+{
+    m_num_messages  = 0;
+    m_packets_sent  = 0;
+    m_bytes_sent    = 0;
+    m_messages_sent = 0;
+    m_packets_received = 0;
+    m_bytes_received   = 0;
+    pthread_mutex_init(&m_mutex, NULL);
+}   // PacketBatch
+
+// ----------------------------------------------------------------------------
+PacketBatch::~PacketBatch()
+{
+    pthread_mutex_destroy(&m_mutex);
+}   // ~PacketBatch
+
+// ----------------------------------------------------------------------------
+/** Creates an ENet packet with the given data and the additional trailing
+ *  byte expected by the receiver (see Event).
+ *  \param data The data to send.
+ *  \param size Number of bytes of data.
+ *  \param flags ENet packet flags.
+ */
+ENetPacket* PacketBatch::createPacket(const uint8_t *data, int size,
+                                      uint32_t flags)
+{
+    ENetPacket *packet = enet_packet_create(NULL, size + 1, flags);
+    if (!packet)
+        return NULL;
+    if (size > 0)
+        memcpy(packet->data, data, size);
+    packet->data[size] = 0;
+    return packet;
+}   // createPacket
+
+// ----------------------------------------------------------------------------
+/** Adds an unreliable message to the batch. If the batch would become too
+ *  large, the messages collected so far are sent first.
+ *  \param peer The peer to which the batch is sent.
+ *  \param message The message, starting with the protocol type.
+ */
+void PacketBatch::add(ENetPeer *peer, const NetworkString &message)
+{
+    const int frame_size = 2 + message.size();
+    pthread_mutex_lock(&m_mutex);
+    if (m_num_messages > 0 && m_data.size() + frame_size > MAX_BATCH_SIZE)
+        flushLocked(peer);
+    if (m_num_messages == 0)
+        m_data.addUInt8(BATCH_MARKER);
+    m_data.addUInt16((uint16_t)message.size());
+    m_data += message;
+    m_num_messages++;
+    pthread_mutex_unlock(&m_mutex);
+}   // add
+
+// ----------------------------------------------------------------------------
+/** Sends all collected messages.
+ *  \param peer The peer to which the batch is sent.
+ */
+void PacketBatch::flush(ENetPeer *peer)
+{
+    pthread_mutex_lock(&m_mutex);
+    flushLocked(peer);
+    pthread_mutex_unlock(&m_mutex);
+}   // flush
+
+// ----------------------------------------------------------------------------
+/** Counts a packet containing one message that was sent to the peer
+ *  without using the batch, i.e. a reliable packet.
+ *  \param size Size of the packet.
+ */
+void PacketBatch::countSent(uint32_t size)
+{
+    pthread_mutex_lock(&m_mutex);
+    m_packets_sent++;
+    m_bytes_sent += size;
+    m_messages_sent++;
+    pthread_mutex_unlock(&m_mutex);
+}   // countSent
+
+// ----------------------------------------------------------------------------
+/** Counts a packet received from the peer.
+ *  \param size Size of the packet.
+ */
+void PacketBatch::countReceived(uint32_t size)
+{
+    pthread_mutex_lock(&m_mutex);
+    m_packets_received++;
+    m_bytes_received += size;
+    pthread_mutex_unlock(&m_mutex);
+}   // countReceived
+
+// ----------------------------------------------------------------------------
+/** Sends all collected messages, the mutex must be locked. */
+void PacketBatch::flushLocked(ENetPeer *peer)
+{
+    if (m_num_messages == 0)
+        return;
+
+    ENetPacket *packet;
+    if (m_num_messages == 1)
+    {
+        // No framing needed, skip the marker and the length.
+        packet = createPacket(m_data.getBytes() + 3, m_data.size() - 3,
+                              ENET_PACKET_FLAG_UNSEQUENCED);
+    }
+    else
+    {
+        packet = createPacket(m_data.getBytes(), m_data.size(),
+                              ENET_PACKET_FLAG_UNSEQUENCED);
+    }
+    if (packet)
+    {
+        m_packets_sent++;
+        m_bytes_sent    += (uint32_t)packet->dataLength;
+        m_messages_sent += m_num_messages;
+        STKHost::logPacket(packet->data, (int)packet->dataLength - 1, false,
+                           &peer->address);
+        enet_peer_send(peer, 0, packet);
+    }
+    m_data         = NetworkString();
+    m_num_messages = 0;
+}   // flushLocked
+
+// ----------------------------------------------------------------------------
+/** Splits a received framed packet into one event per message.
+ *  \param event The event containing the framed packet.
+ *  \param events The events created for the messages are appended here.
+ *  \return False if the event is not a framed packet. If the frame is
+ *          malformed, the messages before the error are still returned.
+ */
+bool PacketBatch::split(const Event &event, std::vector<Event*> *events)
+{
+    NetworkStringView data = event.getDataView();
+    if (event.type != EVENT_TYPE_MESSAGE || data.size() == 0 ||
+        data.peekUInt8() != BATCH_MARKER)
+        return false;
+
+    data.skip(1);
+    while (data.size() > 0)
+    {
+        int size = data.getUInt16();
+        NetworkStringView message = data.getView(size);
+        if (!data.isValid())
+        {
+            Log::warn("PacketBatch", "Received a malformed batch.");
+            break;
+        }
+        events->push_back(new Event(event, message));
+    }
+    return true;
+}   // split
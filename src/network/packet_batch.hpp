@@ -0,0 +1,111 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2014 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+/*! \file packet_batch.hpp
+ *  \brief Collects unreliable messages to a peer so that they can be sent
+ *  in a single packet.
+ */
+
+#ifndef PACKET_BATCH_HPP
+#define PACKET_BATCH_HPP
+
+#include "network/network_string.hpp"
+#include "utils/types.hpp"
+
+#include <enet/enet.h>
+#include <pthread.h>
+#include <vector>
+
+class Event;
+class NetworkStringView;
+
+/** \class PacketBatch
+ *  \brief Collects the unreliable messages sent to one peer during an
+ *  update, and sends them as one framed ENet packet when flushed.
+ *  A framed packet starts with BATCH_MARKER (which is not a valid protocol
+ *  type), followed by each message as a 16 bit length and the message
+ *  bytes (including the protocol type byte). A batch containing only one
+ *  message is sent without framing. Like every packet sent by STKPeer, the
+ *  packet has one additional trailing byte.
+ *  The batch also keeps the statistics about the traffic with the peer,
+ *  including the reliable packets sent and the received packets.
+ */
+class PacketBatch
+{
+public:
+    /** First byte of a framed packet. */
+    static const uint8_t BATCH_MARKER   = 0xff;
+    /** Maximum size of a framed packet, so that it fits into one UDP
+     *  datagram. Larger batches are flushed before adding a message. */
+    static const int     MAX_BATCH_SIZE = 1200;
+
+private:
+    /** The framed messages not yet sent. */
+    NetworkString   m_data;
+
+    /** Number of messages in m_data. */
+    int             m_num_messages;
+
+    /** Protects the batch, messages can be sent from several threads. */
+    pthread_mutex_t m_mutex;
+
+    /** Number of packets sent. */
+    uint32_t        m_packets_sent;
+
+    /** Number of bytes (without ENet headers) sent. */
+    uint32_t        m_bytes_sent;
+
+    /** Number of messages sent. */
+    uint32_t        m_messages_sent;
+
+    /** Number of packets received. */
+    uint32_t        m_packets_received;
+
+    /** Number of bytes (without ENet headers) received. */
+    uint32_t        m_bytes_received;
+
+    void     flushLocked(ENetPeer *peer);
+
+public:
+             PacketBatch();
+            ~PacketBatch();
+    void     add(ENetPeer *peer, const NetworkString &message);
+    void     flush(ENetPeer *peer);
+    void     countSent(uint32_t size);
+    void     countReceived(uint32_t size);
+    static ENetPacket* createPacket(const uint8_t *data, int size,
+                                    uint32_t flags);
+    static bool split(const Event &event, std::vector<Event*> *events);
+    // ------------------------------------------------------------------------
+    /** Returns the number of packets sent. */
+    uint32_t getPacketsSent() const  { return m_packets_sent;  }
+    // ------------------------------------------------------------------------
+    /** Returns the number of bytes sent. */
+    uint32_t getBytesSent() const    { return m_bytes_sent;    }
+    // ------------------------------------------------------------------------
+    /** Returns the number of messages sent. */
+    uint32_t getMessagesSent() const { return m_messages_sent; }
+    // ------------------------------------------------------------------------
+    /** Returns the number of packets received. */
+    uint32_t getPacketsReceived() const { return m_packets_received; }
+    // ------------------------------------------------------------------------
+    /** Returns the number of bytes received. */
+    uint32_t getBytesReceived() const   { return m_bytes_received;   }
+};   // PacketBatch
+
+#endif // PACKET_BATCH_HPP
@@ -0,0 +1,252 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2014 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "network/packet_capture.hpp"
+
+#include "utils/log.hpp"
+#include "utils/time.hpp"
+
+#include <errno.h>
+#include <string.h>
+
+namespace
+{
+    /** Size of the header of a packet in the capture file. */
+    const int RECORD_HEADER_SIZE = 8 + 1 + 4 + 2 + 4 + 2;
+
+    // ------------------------------------------------------------------------
+    void memoryBarrier()
+    {
+#ifdef WIN32
+        MemoryBarrier();
+#else
+        __sync_synchronize();
+#endif
+    }   // memoryBarrier
+
+    // ------------------------------------------------------------------------
+    /** Atomically sets *value to new_value if it is equal to old_value.
+     *  \return True if the value was changed. */
+    bool compareAndSwap(volatile uint32_t *value, uint32_t old_value,
+                        uint32_t new_value)
+    {
+#ifdef WIN32
+        return InterlockedCompareExchange((volatile LONG*)value,
+                                          (LONG)new_value, (LONG)old_value)
+               == (LONG)old_value;
+#else
+        return __sync_bool_compare_and_swap(value, old_value, new_value);
+#endif
+    }   // compareAndSwap
+
+    // ------------------------------------------------------------------------
+    /** Atomically increments a value. */
+    void atomicIncrement(volatile uint32_t *value)
+    {
+#ifdef WIN32
+        InterlockedIncrement((volatile LONG*)value);
+#else
+        __sync_fetch_and_add(value, 1);
+#endif
+    }   // atomicIncrement
+
+    // ------------------------------------------------------------------------
+    /** Stores a value of n bytes in network byte order. */
+    template<typename T, int n>
+    uint8_t* put(uint8_t *buffer, T value)
+    {
+        for (int i = n - 1; i >= 0; i--)
+        {
+            buffer[i] = (uint8_t)(value & 0xff);
+            value >>= 8;
+        }
+        return buffer + n;
+    }   // put
+}   // namespace
+
+// ----------------------------------------------------------------------------
+PacketCapture::PacketCapture()
+{
+    m_cells            = NULL;
+    m_file             = NULL;
+    m_enqueue_position = 0;
+    m_dequeue_position = 0;
+    m_dropped          = 0;
+    pthread_mutex_init(&m_exit_mutex, NULL);
+}   // PacketCapture
+
+// ----------------------------------------------------------------------------
+PacketCapture::~PacketCapture()
+{
+    close();
+    pthread_mutex_destroy(&m_exit_mutex);
+}   // ~PacketCapture
+
+// ----------------------------------------------------------------------------
+/** Opens the capture file and starts the writer thread.
+ *  \param filename Name of the capture file, which is overwritten.
+ *  \return False if the file could not be opened.
+ */
+bool PacketCapture::open(const std::string &filename)
+{
+    close();
+    m_file = fopen(filename.c_str(), "wb");
+    if (!m_file)
+    {
+        Log::warn("PacketCapture", "Can not open '%s', packets won't be "
+                  "captured.", filename.c_str());
+        return false;
+    }
+    fwrite("STKCAP01", 1, 8, m_file);
+
+    m_cells = new Cell[NUM_CELLS];
+    for (uint32_t i = 0; i < NUM_CELLS; i++)
+        m_cells[i].m_sequence = i;
+    m_enqueue_position = 0;
+    m_dequeue_position = 0;
+    m_dropped          = 0;
+
+    pthread_mutex_lock(&m_exit_mutex); // will let the writer thread run
+    pthread_create(&m_writer_thread, NULL, &PacketCapture::writerThread, this);
+    Log::info("PacketCapture", "Capturing packets to '%s'.", filename.c_str());
+    return true;
+}   // open
+
+// ----------------------------------------------------------------------------
+/** Stops the writer thread after all captured packets were written, and
+ *  closes the file. No other thread must capture packets at that time. */
+void PacketCapture::close()
+{
+    if (!m_file)
+        return;
+    pthread_mutex_unlock(&m_exit_mutex); // will stop the writer thread
+    pthread_join(m_writer_thread, NULL);
+    fclose(m_file);
+    m_file = NULL;
+    delete [] m_cells;
+    m_cells = NULL;
+    if (m_dropped > 0)
+        Log::warn("PacketCapture", "%u packets were not captured.", m_dropped);
+}   // close
+
+// ----------------------------------------------------------------------------
+/** Copies a packet into the ring buffer. This is lock-free and never
+ *  blocks, so it can be called from any thread.
+ *  \param data The packet data.
+ *  \param size Size of the packet.
+ *  \param flags Combination of CaptureFlags.
+ *  \param address IPv4 address of the peer, 0 for broadcasts.
+ *  \param port Port of the peer.
+ */
+void PacketCapture::capture(const uint8_t *data, int size, uint8_t flags,
+                            uint32_t address, uint16_t port)
+{
+    if (!m_cells)
+        return;
+
+    // Reserve a cell: the cell at the enqueue position is free if its
+    // sequence number is equal to this position.
+    Cell *cell;
+    uint32_t position = m_enqueue_position;
+    while (true)
+    {
+        cell = &m_cells[position & (NUM_CELLS - 1)];
+        uint32_t sequence = cell->m_sequence;
+        memoryBarrier();
+        int32_t diff = (int32_t)(sequence - position);
+        if (diff == 0)
+        {
+            if (compareAndSwap(&m_enqueue_position, position, position + 1))
+                break;
+            position = m_enqueue_position;
+        }
+        else if (diff < 0)
+        {
+            // The writer thread did not write this cell yet: ring is full.
+            atomicIncrement(&m_dropped);
+            return;
+        }
+        else
+            position = m_enqueue_position;
+    }
+
+    cell->m_time          = StkTime::getMicrosecondsSinceEpoch();
+    cell->m_flags         = flags;
+    cell->m_address       = address;
+    cell->m_port          = port;
+    cell->m_size          = size;
+    cell->m_captured_size = size < MAX_CAPTURED_BYTES ? size
+                                                      : MAX_CAPTURED_BYTES;
+    memcpy(cell->m_data, data, cell->m_captured_size);
+    // Make the content visible before handing the cell to the writer.
+    memoryBarrier();
+    cell->m_sequence = position + 1;
+}   // capture
+
+// ----------------------------------------------------------------------------
+/** Writes all packets in the ring to the file.
+ *  \return False if there was nothing to write.
+ */
+bool PacketCapture::writePackets()
+{
+    bool written = false;
+    uint8_t header[RECORD_HEADER_SIZE];
+    while (true)
+    {
+        Cell *cell = &m_cells[m_dequeue_position & (NUM_CELLS - 1)];
+        if (cell->m_sequence != m_dequeue_position + 1)
+            break;
+        memoryBarrier();
+
+        uint8_t *p = header;
+        p = put<uint64_t, 8>(p, cell->m_time);
+        p = put<uint8_t,  1>(p, cell->m_flags);
+        p = put<uint32_t, 4>(p, cell->m_address);
+        p = put<uint16_t, 2>(p, cell->m_port);
+        p = put<uint32_t, 4>(p, cell->m_size);
+        p = put<uint16_t, 2>(p, cell->m_captured_size);
+        fwrite(header, 1, RECORD_HEADER_SIZE, m_file);
+        fwrite(cell->m_data, 1, cell->m_captured_size, m_file);
+
+        // Hand the cell back to the producers for the next round.
+        memoryBarrier();
+        cell->m_sequence = m_dequeue_position + NUM_CELLS;
+        m_dequeue_position++;
+        written = true;
+    }
+    if (written)
+        fflush(m_file);
+    return written;
+}   // writePackets
+
+// ----------------------------------------------------------------------------
+/** The writer thread: writes captured packets until the capture is
+ *  closed. */
+void* PacketCapture::writerThread(void *data)
+{
+    PacketCapture *capture = (PacketCapture*)data;
+    while (pthread_mutex_trylock(&capture->m_exit_mutex) == EBUSY)
+    {
+        if (!capture->writePackets())
+            StkTime::sleep(5);
+    }
+    pthread_mutex_unlock(&capture->m_exit_mutex);
+    // write the packets captured in the meantime
+    capture->writePackets();
+    return NULL;
+}   // writerThread
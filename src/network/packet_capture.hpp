@@ -0,0 +1,115 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2014 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+/*! \file packet_capture.hpp
+ *  \brief Captures sent and received packets into a binary file.
+ */
+
+#ifndef PACKET_CAPTURE_HPP
+#define PACKET_CAPTURE_HPP
+
+#include "utils/no_copy.hpp"
+#include "utils/types.hpp"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string>
+
+/** \class PacketCapture
+ *  \brief Writes all sent and received packets to a binary capture file
+ *  without slowing down the threads that send or receive them.
+ *  capture() only copies the packet into a fixed size, lock-free ring
+ *  buffer (a bounded multi-producer queue), which never blocks: if the ring
+ *  is full, the packet is dropped and counted. A writer thread empties the
+ *  ring and writes the packets to the file.
+ *  File format (all values in network byte order): the 8 bytes "STKCAP01",
+ *  then for each packet: u64 timestamp (microseconds since 1.1.1970), u8
+ *  flags (see CaptureFlags), u32 IPv4 address and u16 port of the peer (0
+ *  for broadcasts), u32 size of the packet, u16 number of captured bytes,
+ *  followed by the captured bytes. tools/decode_packet_capture.py prints
+ *  the content of a capture file.
+ */
+class PacketCapture : public NoCopy
+{
+public:
+    enum CaptureFlags
+    {
+        CAPTURE_INCOMING = 1,   //!< Packet was received (else sent).
+        CAPTURE_RAW      = 2    //!< Packet was sent without ENet.
+    };
+    /** Maximum number of bytes captured per packet. */
+    static const int MAX_CAPTURED_BYTES = 1500;
+    /** Number of packets the ring can store, must be a power of 2. */
+    static const uint32_t NUM_CELLS     = 1024;
+
+private:
+    /** One captured packet in the ring. */
+    struct Cell
+    {
+        /** Used to synchronise producers and the writer thread. */
+        volatile uint32_t m_sequence;
+        uint64_t m_time;
+        uint32_t m_address;
+        uint32_t m_size;
+        uint16_t m_port;
+        uint16_t m_captured_size;
+        uint8_t  m_flags;
+        uint8_t  m_data[MAX_CAPTURED_BYTES];
+    };
+
+    /** The ring buffer. */
+    Cell             *m_cells;
+
+    /** Position at which the next packet is added, used by producers. */
+    volatile uint32_t m_enqueue_position;
+
+    /** Position of the next packet to write, only used by the writer. */
+    uint32_t          m_dequeue_position;
+
+    /** Number of packets dropped because the ring was full. */
+    volatile uint32_t m_dropped;
+
+    /** The capture file. */
+    FILE             *m_file;
+
+    /** The writer thread. */
+    pthread_t         m_writer_thread;
+
+    /** Locked while the writer thread must keep running. */
+    pthread_mutex_t   m_exit_mutex;
+
+    static void* writerThread(void *data);
+    bool         writePackets();
+
+public:
+             PacketCapture();
+            ~PacketCapture();
+    bool     open(const std::string &filename);
+    void     close();
+    void     capture(const uint8_t *data, int size, uint8_t flags,
+                     uint32_t address, uint16_t port);
+    // ------------------------------------------------------------------------
+    /** Returns true if packets are written to a file. */
+    bool     isOpen() const { return m_file != NULL; }
+    // ------------------------------------------------------------------------
+    /** Returns the number of packets that were not captured because the
+     *  writer thread could not keep up. */
+    uint32_t getDroppedCount() const { return m_dropped; }
+};   // PacketCapture
+
+#endif // PACKET_CAPTURE_HPP
@@ -56,16 +56,16 @@ PROTOCOL_TYPE Protocol::getProtocolType()
 
 bool Protocol::checkDataSizeAndToken(Event* event, int minimum_size)
 {
-    NetworkString data = event->data();
-    if (data.size() < minimum_size || data[0] != 4)
+    NetworkStringView data = event->getDataView();
+    if (data.size() < minimum_size || data.peekUInt8(0) != 4)
     {
         Log::warn("Protocol", "Receiving a badly "
                   "formated message. Size is %d and first byte %d",
-                  data.size(), data[0]);
+                  data.size(), data.size() > 0 ? data.peekUInt8(0) : -1);
         return false;
     }
     STKPeer* peer = *(event->peer);
-    uint32_t token = data.gui32(1);
+    uint32_t token = data.peekUInt32(1);
     if (token != peer->getClientServerToken())
     {
         Log::warn("Protocol", "Peer sending bad token. Request "
@@ -77,11 +77,11 @@ bool Protocol::checkDataSizeAndToken(Event* event, int minimum_size)
 
 bool Protocol::isByteCorrect(Event* event, int byte_nb, int value)
 {
-    NetworkString data = event->data();
-    if (data[byte_nb] != value)
+    NetworkStringView data = event->getDataView();
+    if (data.peekUInt8(byte_nb) != value)
     {
         Log::info("Protocol", "Bad byte at pos %d. %d "
-                "should be %d", byte_nb, data[byte_nb], value);
+                "should be %d", byte_nb, data.peekUInt8(byte_nb), value);
         return false;
     }
     return true;
@@ -23,11 +23,21 @@
 #include "utils/log.hpp"
 #include "utils/time.hpp"
 
+#include <algorithm>
 #include <assert.h>
 #include <cstdlib>
 #include <errno.h>
 #include <typeinfo>
 
+/** Computes the absolute time that is a given number of milliseconds in the
+ *  future, as needed by pthread_cond_timedwait. */
+static void getTimeout(struct timespec *timeout, int ms)
+{
+    uint64_t us = StkTime::getMicrosecondsSinceEpoch() + (uint64_t)ms*1000;
+    timeout->tv_sec  = (time_t)(us / 1000000);
+    timeout->tv_nsec = (long)(us % 1000000) * 1000;
+}   // getTimeout
+
 void* protocolManagerUpdate(void* data)
 {
     ProtocolManager* manager = static_cast<ProtocolManager*>(data);
@@ -45,7 +55,7 @@ void* protocolManagerAsynchronousUpdate(void* data)
     while(manager && !manager->exit())
     {
         manager->asynchronousUpdate();
-        StkTime::sleep(2);
+        manager->waitForWork();
     }
     manager->m_asynchronous_thread_running = false;
     return NULL;
@@ -59,7 +69,11 @@ ProtocolManager::ProtocolManager()
     pthread_mutex_init(&m_requests_mutex, NULL);
     pthread_mutex_init(&m_id_mutex, NULL);
     pthread_mutex_init(&m_exit_mutex, NULL);
+    pthread_mutex_init(&m_wakeup_mutex, NULL);
+    pthread_cond_init(&m_wakeup_cond, NULL);
+    m_wakeup_pending = false;
     m_next_protocol_id = 0;
+    m_events_dropped = 0;
 
 
     pthread_mutex_lock(&m_exit_mutex); // will let the update function run
@@ -82,6 +96,7 @@ ProtocolManager::~ProtocolManager()
 void ProtocolManager::abort()
 {
     pthread_mutex_unlock(&m_exit_mutex); // will stop the update function
+    wakeUp();
     pthread_join(*m_asynchronous_update_thread, NULL); // wait the thread to finish
     pthread_mutex_lock(&m_events_mutex);
     pthread_mutex_lock(&m_protocols_mutex);
@@ -90,9 +105,14 @@ void ProtocolManager::abort()
     pthread_mutex_lock(&m_id_mutex);
     for (unsigned int i = 0; i < m_protocols.size() ; i++)
         delete m_protocols[i].protocol;
-    for (unsigned int i = 0; i < m_events_to_process.size() ; i++)
-        delete m_events_to_process[i].event;
+    for (std::list<EventProcessingInfo>::iterator i = m_events_to_process.begin();
+         i != m_events_to_process.end(); i++)
+        delete i->event;
+    while (Event *event = m_incoming_events.pop())
+        delete event;
     m_protocols.clear();
+    m_protocols_by_type.clear();
+    m_protocols_by_id.clear();
     m_requests.clear();
     m_events_to_process.clear();
     pthread_mutex_unlock(&m_events_mutex);
@@ -107,57 +127,128 @@ void ProtocolManager::abort()
     pthread_mutex_destroy(&m_requests_mutex);
     pthread_mutex_destroy(&m_id_mutex);
     pthread_mutex_destroy(&m_exit_mutex);
+    pthread_mutex_destroy(&m_wakeup_mutex);
+    pthread_cond_destroy(&m_wakeup_cond);
 }
 
 void ProtocolManager::notifyEvent(Event* event)
 {
-    pthread_mutex_lock(&m_events_mutex);
-    Event* event2 = new Event(*event);
-    // register protocols that will receive this event
-    std::vector<unsigned int> protocols_ids;
-    PROTOCOL_TYPE searchedProtocol = PROTOCOL_NONE;
-    if (event2->type == EVENT_TYPE_MESSAGE)
+    // Only queue the event here: this is called by the network thread, which
+    // should not wait for the protocols. The asynchronous thread assigns the
+    // event to the protocols (see routeIncomingEvents).
+    m_incoming_events.push(event);
+    wakeUp();
+}
+
+/** Assigns all events received since the last call to the protocols that
+ *  need them, and adds them to the events to process (in arrival order).
+ *  Must only be called from the asynchronous thread.
+ */
+void ProtocolManager::routeIncomingEvents()
+{
+    while (Event *event2 = m_incoming_events.pop())
     {
-        if (event2->data().size() > 0)
+        // register protocols that will receive this event
+        std::vector<uint32_t> protocols_ids;
+        PROTOCOL_TYPE searchedProtocol = PROTOCOL_NONE;
+        if (event2->type == EVENT_TYPE_MESSAGE)
+        {
+            if (event2->getDataView().size() > 0)
+            {
+                searchedProtocol = (PROTOCOL_TYPE)(event2->getDataView().peekUInt8());
+                event2->removeFront(1);
+            }
+            else
+            {
+                Log::warn("ProtocolManager", "Not enough data.");
+            }
+        }
+        if (event2->type == EVENT_TYPE_CONNECTED)
         {
-            searchedProtocol = (PROTOCOL_TYPE)(event2->data()[0]);
-            event2->removeFront(1);
+            searchedProtocol = PROTOCOL_CONNECTION;
+        }
+        Log::verbose("ProtocolManager", "Received event for protocols of type %d", searchedProtocol);
+        pthread_mutex_lock(&m_protocols_mutex);
+        // pass data to protocols even when paused
+        if (event2->type == EVENT_TYPE_DISCONNECTED)
+        {
+            // all protocols are told about disconnections
+            for (unsigned int i = 0; i < m_protocols.size() ; i++)
+                protocols_ids.push_back(m_protocols[i].id);
         }
         else
         {
-            Log::warn("ProtocolManager", "Not enough data.");
+            std::map<PROTOCOL_TYPE, std::vector<uint32_t> >::const_iterator
+                protocols = m_protocols_by_type.find(searchedProtocol);
+            if (protocols != m_protocols_by_type.end())
+                protocols_ids = protocols->second;
         }
-    }
-    if (event2->type == EVENT_TYPE_CONNECTED)
-    {
-        searchedProtocol = PROTOCOL_CONNECTION;
-    }
-    Log::verbose("ProtocolManager", "Received event for protocols of type %d", searchedProtocol);
-    pthread_mutex_lock(&m_protocols_mutex);
-    for (unsigned int i = 0; i < m_protocols.size() ; i++)
-    {
-        if (m_protocols[i].protocol->getProtocolType() == searchedProtocol || event2->type == EVENT_TYPE_DISCONNECTED) // pass data to protocols even when paused
+        if (protocols_ids.size() != 0)
+            m_events_routed[searchedProtocol]++;
+        else
+            m_events_dropped++;
+        pthread_mutex_unlock(&m_protocols_mutex);
+        // no protocol was aimed, show the msg to debug. The message is
+        // only copied into a string if it is actually printed.
+        if (searchedProtocol == PROTOCOL_NONE &&
+            Log::getLogLevel() <= Log::LL_DEBUG)
         {
-            protocols_ids.push_back(m_protocols[i].id);
+            Log::debug("ProtocolManager", "NO PROTOCOL : Message is \"%s\"", event2->data().std_string().c_str());
+        }
+
+        if (protocols_ids.size() != 0)
+        {
+            EventProcessingInfo epi;
+            epi.arrival_time = (double)StkTime::getTimeSinceEpoch();
+            epi.event = event2;
+            epi.protocols_ids = protocols_ids;
+            pthread_mutex_lock(&m_events_mutex);
+            m_events_to_process.push_back(epi); // add the event to the queue
+            pthread_mutex_unlock(&m_events_mutex);
+        }
+        else
+        {
+            Log::warn("ProtocolManager", "Received an event for %d that has no destination protocol.", searchedProtocol);
+            delete event2;
         }
     }
-    pthread_mutex_unlock(&m_protocols_mutex);
-    if (searchedProtocol == PROTOCOL_NONE) // no protocol was aimed, show the msg to debug
-    {
-        Log::debug("ProtocolManager", "NO PROTOCOL : Message is \"%s\"", event2->data().std_string().c_str());
-    }
+}
 
-    if (protocols_ids.size() != 0)
+/** Wakes up the asynchronous thread, e.g. because an event or a request
+ *  was added. Can be called from any thread.
+ */
+void ProtocolManager::wakeUp()
+{
+    pthread_mutex_lock(&m_wakeup_mutex);
+    m_wakeup_pending = true;
+    pthread_cond_signal(&m_wakeup_cond);
+    pthread_mutex_unlock(&m_wakeup_mutex);
+}
+
+/** Called by the asynchronous thread after each update: waits until there
+ *  is new work. If no protocol is running, the thread sleeps until an event
+ *  or request arrives, otherwise at most ASYNCHRONOUS_UPDATE_INTERVAL ms so
+ *  that the protocols are still updated regularly.
+ */
+void ProtocolManager::waitForWork()
+{
+    pthread_mutex_lock(&m_wakeup_mutex);
+    if (!m_wakeup_pending)
     {
-        EventProcessingInfo epi;
-        epi.arrival_time = (double)StkTime::getTimeSinceEpoch();
-        epi.event = event2;
-        epi.protocols_ids = protocols_ids;
-        m_events_to_process.push_back(epi); // add the event to the queue
+        // m_protocols is only modified by this thread, so no lock is needed
+        if (m_protocols.size() == 0)
+        {
+            pthread_cond_wait(&m_wakeup_cond, &m_wakeup_mutex);
+        }
+        else
+        {
+            struct timespec timeout;
+            getTimeout(&timeout, ASYNCHRONOUS_UPDATE_INTERVAL);
+            pthread_cond_timedwait(&m_wakeup_cond, &m_wakeup_mutex, &timeout);
+        }
     }
-    else
-        Log::warn("ProtocolManager", "Received an event for %d that has no destination protocol.", searchedProtocol);
-    pthread_mutex_unlock(&m_events_mutex);
+    m_wakeup_pending = false;
+    pthread_mutex_unlock(&m_wakeup_mutex);
 }
 
 void ProtocolManager::sendMessage(Protocol* sender, const NetworkString& message, bool reliable)
@@ -197,6 +288,7 @@ uint32_t ProtocolManager::requestStart(Protocol* protocol)
     pthread_mutex_lock(&m_requests_mutex);
     m_requests.push_back(req);
     pthread_mutex_unlock(&m_requests_mutex);
+    wakeUp();
 
     return info.id;
 }
@@ -213,6 +305,7 @@ void ProtocolManager::requestStop(Protocol* protocol)
     pthread_mutex_lock(&m_requests_mutex);
     m_requests.push_back(req);
     pthread_mutex_unlock(&m_requests_mutex);
+    wakeUp();
 }
 
 void ProtocolManager::requestPause(Protocol* protocol)
@@ -227,6 +320,7 @@ void ProtocolManager::requestPause(Protocol* protocol)
     pthread_mutex_lock(&m_requests_mutex);
     m_requests.push_back(req);
     pthread_mutex_unlock(&m_requests_mutex);
+    wakeUp();
 }
 
 void ProtocolManager::requestUnpause(Protocol* protocol)
@@ -241,6 +335,7 @@ void ProtocolManager::requestUnpause(Protocol* protocol)
     pthread_mutex_lock(&m_requests_mutex);
     m_requests.push_back(req);
     pthread_mutex_unlock(&m_requests_mutex);
+    wakeUp();
 }
 
 void ProtocolManager::requestTerminate(Protocol* protocol)
@@ -264,6 +359,7 @@ void ProtocolManager::requestTerminate(Protocol* protocol)
     }
     m_requests.push_back(req);
     pthread_mutex_unlock(&m_requests_mutex);
+    wakeUp();
 }
 
 void ProtocolManager::startProtocol(ProtocolInfo protocol)
@@ -273,6 +369,8 @@ void ProtocolManager::startProtocol(ProtocolInfo protocol)
     pthread_mutex_lock(&m_asynchronous_protocols_mutex);
     Log::info("ProtocolManager", "A %s protocol with id=%u has been started. There are %ld protocols running.", typeid(*protocol.protocol).name(), protocol.id, m_protocols.size()+1);
     m_protocols.push_back(protocol);
+    m_protocols_by_type[protocol.protocol->getProtocolType()].push_back(protocol.id);
+    m_protocols_by_id[protocol.id] = protocol.protocol;
     // setup the protocol and notify it that it's started
     protocol.protocol->setListener(this);
     protocol.protocol->setup();
@@ -309,16 +407,23 @@ void ProtocolManager::protocolTerminated(ProtocolInfo protocol)
 {
     pthread_mutex_lock(&m_protocols_mutex); // be sure that noone accesses the protocols vector while we erase a protocol
     pthread_mutex_lock(&m_asynchronous_protocols_mutex);
-    int offset = 0;
     std::string protocol_type = typeid(*protocol.protocol).name();
-    for (unsigned int i = 0; i < m_protocols.size(); i++)
+    unsigned int i = 0;
+    while (i < m_protocols.size())
     {
-        if (m_protocols[i-offset].protocol == protocol.protocol)
+        if (m_protocols[i].protocol == protocol.protocol)
         {
+            // remove the protocol from the routing tables
+            std::vector<uint32_t> &ids =
+                m_protocols_by_type[m_protocols[i].protocol->getProtocolType()];
+            ids.erase(std::remove(ids.begin(), ids.end(), m_protocols[i].id),
+                      ids.end());
+            m_protocols_by_id.erase(m_protocols[i].id);
             delete m_protocols[i].protocol;
-            m_protocols.erase(m_protocols.begin()+(i-offset), m_protocols.begin()+(i-offset)+1);
-            offset++;
+            m_protocols.erase(m_protocols.begin()+i);
         }
+        else
+            i++;
     }
     Log::info("ProtocolManager", "A %s protocol has been terminated. There are %ld protocols running.", protocol_type.c_str(), m_protocols.size());
     pthread_mutex_unlock(&m_asynchronous_protocols_mutex);
@@ -327,26 +432,28 @@ void ProtocolManager::protocolTerminated(ProtocolInfo protocol)
 
 bool ProtocolManager::propagateEvent(EventProcessingInfo* event, bool synchronous)
 {
-    int index = 0;
-    for (unsigned int i = 0; i < m_protocols.size(); i++)
+    // keep the ids of the protocols that did not consume the event yet,
+    // protocols that have been terminated are dropped
+    unsigned int remaining = 0;
+    for (unsigned int i = 0; i < event->protocols_ids.size(); i++)
     {
-        if (event->protocols_ids[index] == m_protocols[i].id)
-        {
-            bool result = false;
-            if (synchronous)
-                result = m_protocols[i].protocol->notifyEvent(event->event);
-            else
-                result = m_protocols[i].protocol->notifyEventAsynchronous(event->event);
-            if (result)
-                event->protocols_ids.pop_back();
-            else
-                index++;
-        }
+        std::map<uint32_t, Protocol*>::iterator protocol =
+            m_protocols_by_id.find(event->protocols_ids[i]);
+        if (protocol == m_protocols_by_id.end())
+            continue;
+        bool result = false;
+        if (synchronous)
+            result = protocol->second->notifyEvent(event->event);
+        else
+            result = protocol->second->notifyEventAsynchronous(event->event);
+        if (!result)
+            event->protocols_ids[remaining++] = event->protocols_ids[i];
     }
+    event->protocols_ids.resize(remaining);
     if (event->protocols_ids.size() == 0 || (StkTime::getTimeSinceEpoch()-event->arrival_time) >= TIME_TO_KEEP_EVENTS)
     {
-        // because we made a copy of the event
-        delete event->event->peer; // no more need of that
+        // the event is owned by the protocol manager (this also frees
+        // the peer pointer and the packet data)
         delete event->event;
         return true;
     }
@@ -357,17 +464,17 @@ void ProtocolManager::update()
 {
     // before updating, notice protocols that they have received events
     pthread_mutex_lock(&m_events_mutex); // secure threads
-    int size = m_events_to_process.size();
-    int offset = 0;
-    for (int i = 0; i < size; i++)
+    // the protocols can be terminated by the asynchronous thread
+    pthread_mutex_lock(&m_protocols_mutex);
+    std::list<EventProcessingInfo>::iterator i = m_events_to_process.begin();
+    while (i != m_events_to_process.end())
     {
-        bool result = propagateEvent(&m_events_to_process[i+offset], true);
-        if (result)
-        {
-            m_events_to_process.erase(m_events_to_process.begin()+i+offset,m_events_to_process.begin()+i+offset+1);
-            offset --;
-        }
+        if (propagateEvent(&(*i), true))
+            i = m_events_to_process.erase(i);
+        else
+            i++;
     }
+    pthread_mutex_unlock(&m_protocols_mutex);
     pthread_mutex_unlock(&m_events_mutex); // release the mutex
     // now update all protocols
     pthread_mutex_lock(&m_protocols_mutex);
@@ -377,22 +484,23 @@ void ProtocolManager::update()
             m_protocols[i].protocol->update();
     }
     pthread_mutex_unlock(&m_protocols_mutex);
+    // send the unreliable messages of this update together
+    NetworkManager::getInstance()->flushPackets();
 }
 
 void ProtocolManager::asynchronousUpdate()
 {
+    routeIncomingEvents();
+
     // before updating, notice protocols that they have received information
     pthread_mutex_lock(&m_events_mutex); // secure threads
-    int size = m_events_to_process.size();
-    int offset = 0;
-    for (int i = 0; i < size; i++)
+    std::list<EventProcessingInfo>::iterator i = m_events_to_process.begin();
+    while (i != m_events_to_process.end())
     {
-        bool result = propagateEvent(&m_events_to_process[i+offset], false);
-        if (result)
-        {
-            m_events_to_process.erase(m_events_to_process.begin()+i+offset,m_events_to_process.begin()+i+offset+1);
-            offset --;
-        }
+        if (propagateEvent(&(*i), false))
+            i = m_events_to_process.erase(i);
+        else
+            i++;
     }
     pthread_mutex_unlock(&m_events_mutex); // release the mutex
 
@@ -404,6 +512,8 @@ void ProtocolManager::asynchronousUpdate()
             m_protocols[i].protocol->asynchronousUpdate();
     }
     pthread_mutex_unlock(&m_asynchronous_protocols_mutex);
+    // send the unreliable messages of this update together
+    NetworkManager::getInstance()->flushPackets();
 
     // process queued events for protocols
     // these requests are asynchronous
@@ -491,12 +601,37 @@ Protocol* ProtocolManager::getProtocol(uint32_t id)
 
 Protocol* ProtocolManager::getProtocol(PROTOCOL_TYPE type)
 {
-    for (unsigned int i = 0; i < m_protocols.size(); i++)
-    {
-        if (m_protocols[i].protocol->getProtocolType() == type)
-            return m_protocols[i].protocol;
-    }
-    return NULL;
+    std::map<PROTOCOL_TYPE, std::vector<uint32_t> >::const_iterator
+        protocols = m_protocols_by_type.find(type);
+    if (protocols == m_protocols_by_type.end() || protocols->second.empty())
+        return NULL;
+    std::map<uint32_t, Protocol*>::const_iterator protocol =
+        m_protocols_by_id.find(protocols->second[0]);
+    return protocol == m_protocols_by_id.end() ? NULL : protocol->second;
+}
+
+uint32_t ProtocolManager::getRoutedEventsCount(PROTOCOL_TYPE type)
+{
+    pthread_mutex_lock(&m_protocols_mutex);
+    uint32_t count = m_events_routed[type];
+    pthread_mutex_unlock(&m_protocols_mutex);
+    return count;
+}
+
+uint32_t ProtocolManager::getDroppedEventsCount()
+{
+    pthread_mutex_lock(&m_protocols_mutex);
+    uint32_t count = m_events_dropped;
+    pthread_mutex_unlock(&m_protocols_mutex);
+    return count;
+}
+
+uint32_t ProtocolManager::getQueuedEventsCount()
+{
+    pthread_mutex_lock(&m_events_mutex);
+    uint32_t count = (uint32_t)m_events_to_process.size();
+    pthread_mutex_unlock(&m_events_mutex);
+    return count;
 }
 
 bool ProtocolManager::isServer()
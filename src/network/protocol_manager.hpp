@@ -27,11 +27,18 @@
 #include "network/event.hpp"
 #include "network/network_string.hpp"
 #include "network/protocol.hpp"
+#include "utils/mpsc_queue.hpp"
 #include "utils/types.hpp"
 
+#include <list>
+#include <map>
 #include <vector>
 
 #define TIME_TO_KEEP_EVENTS 1.0
+/** Maximum time (in ms) the asynchronous thread sleeps when no event or
+ *  request arrives while protocols are running, so that protocols can
+ *  still do time based work in asynchronousUpdate(). */
+#define ASYNCHRONOUS_UPDATE_INTERVAL 10
 
 /*!
  * \enum PROTOCOL_STATE
@@ -87,7 +94,7 @@ typedef struct EventProcessingInfo
 {
     Event* event;
     double arrival_time;
-    std::vector<unsigned int> protocols_ids;
+    std::vector<uint32_t> protocols_ids;
 } EventProcessingInfo;
 
 /*!
@@ -113,7 +120,10 @@ class ProtocolManager : public Singleton<ProtocolManager>
         /*!
          * \brief Function that processes incoming events.
          * This function is called by the network manager each time there is an
-         * incoming packet.
+         * incoming packet. The protocol manager takes ownership of the event
+         * (it is not copied), and deletes it once it has been processed.
+         * The event is only added to a lock-free queue and the asynchronous
+         * thread is woken up, so this never waits for the protocols.
          */
         virtual void            notifyEvent(Event* event);
         /*!
@@ -226,6 +236,26 @@ class ProtocolManager : public Singleton<ProtocolManager>
          */
         virtual Protocol*       getProtocol(PROTOCOL_TYPE type);
 
+        /*!
+         * \brief Get the number of events that were routed to protocols.
+         * \param type : The type of the protocols.
+         * \return The number of events that were passed to protocols of the
+         * given type.
+         */
+        uint32_t                getRoutedEventsCount(PROTOCOL_TYPE type);
+        /*!
+         * \brief Get the number of events that were dropped.
+         * \return The number of events that were deleted because no running
+         * protocol was interested in them.
+         */
+        uint32_t                getDroppedEventsCount();
+        /*!
+         * \brief Get the number of events waiting to be processed.
+         * \return The number of routed events that were not yet passed to
+         * all of their protocols.
+         */
+        uint32_t                getQueuedEventsCount();
+
         /*! \brief Know whether the app is a server.
          *  \return True if this application is in server mode, false elseway.
          */
@@ -285,6 +315,9 @@ class ProtocolManager : public Singleton<ProtocolManager>
         virtual void            protocolTerminated(ProtocolInfo protocol);
 
         bool                    propagateEvent(EventProcessingInfo* event, bool synchronous);
+        void                    routeIncomingEvents();
+        void                    wakeUp();
+        void                    waitForWork();
 
         // protected members
         /*!
@@ -294,9 +327,29 @@ class ProtocolManager : public Singleton<ProtocolManager>
          */
         std::vector<ProtocolInfo>       m_protocols;
         /*!
-         * \brief Contains the network events to pass to protocols.
+         * \brief Ids of the running protocols, by protocol type.
+         * Used to find the protocols that receive an event without
+         * looking at every running protocol. Modified together with
+         * m_protocols.
+         */
+        std::map<PROTOCOL_TYPE, std::vector<uint32_t> > m_protocols_by_type;
+        /*! \brief The running protocols, by id. */
+        std::map<uint32_t, Protocol*>   m_protocols_by_id;
+        /*! \brief Number of events routed to protocols, by protocol type. */
+        std::map<PROTOCOL_TYPE, uint32_t> m_events_routed;
+        /*! \brief Number of events dropped because no protocol wanted them. */
+        uint32_t                        m_events_dropped;
+        /*!
+         * \brief Events received by the network thread that have not yet
+         * been assigned to protocols. Filled by notifyEvent, emptied by the
+         * asynchronous thread.
+         */
+        MPSCQueue<Event>                m_incoming_events;
+        /*!
+         * \brief Contains the network events to pass to protocols, in the
+         * order in which they arrived.
          */
-        std::vector<EventProcessingInfo>             m_events_to_process;
+        std::list<EventProcessingInfo>  m_events_to_process;
         /*!
          * \brief Contains the requests to start/stop etc... protocols.
          */
@@ -321,6 +374,14 @@ class ProtocolManager : public Singleton<ProtocolManager>
         pthread_mutex_t                 m_id_mutex;
         /*! Used when need to quit.*/
         pthread_mutex_t                 m_exit_mutex;
+        /*! Protects m_wakeup_pending, used with m_wakeup_cond.            */
+        pthread_mutex_t                 m_wakeup_mutex;
+        /*! Signaled when there is new work for the asynchronous thread.    */
+        pthread_cond_t                  m_wakeup_cond;
+        /*! True if work was added since the asynchronous thread last
+         *  checked. Avoids losing a wakeup that happens while the thread
+         *  is not waiting. */
+        bool                            m_wakeup_pending;
 
         /*! Update thread.*/
         pthread_t* m_update_thread;
@@ -18,6 +18,7 @@
 
 #include "network/protocols/client_lobby_room_protocol.hpp"
 
+#include "network/network_bot.hpp"
 #include "network/network_manager.hpp"
 #include "network/protocols/start_game_protocol.hpp"
 #include "network/network_world.hpp"
@@ -233,7 +234,7 @@ void ClientLobbyRoomProtocol::update()
     {
         NetworkString ns;
         // 1 (connection request), 4 (size of id), global id
-        ns.ai8(1).ai8(4).ai32(Online::CurrentUser::get()->getID());
+        ns.ai8(1).ai8(4).ai32(NetworkManager::getInstance()->getLocalPlayerId());
         m_listener->sendMessage(this, ns);
         m_state = REQUESTING_CONNECTION;
     }
@@ -244,8 +245,17 @@ void ClientLobbyRoomProtocol::update()
         break;
     case KART_SELECTION:
     {
-        NetworkKartSelectionScreen* screen = NetworkKartSelectionScreen::getInstance();
-        StateManager::get()->pushScreen(screen);
+        if (NetworkBot::isEnabled()) // bots select a kart without a screen
+        {
+            std::string kart = NetworkBot::getNextKart();
+            if (kart != "")
+                requestKartSelection(kart);
+        }
+        else
+        {
+            NetworkKartSelectionScreen* screen = NetworkKartSelectionScreen::getInstance();
+            StateManager::get()->pushScreen(screen);
+        }
         m_state = SELECTING_KARTS;
     }
     break;
@@ -295,7 +305,7 @@ void ClientLobbyRoomProtocol::newPlayer(Event* event)
     uint32_t global_id = data.gui32(1);
     uint8_t race_id = data.gui8(6);
 
-    if (global_id == Online::CurrentUser::get()->getID())
+    if (global_id == NetworkManager::getInstance()->getLocalPlayerId())
     {
         Log::error("ClientLobbyRoomProtocol", "The server notified me that i'm a new player in the room (not normal).");
     }
@@ -368,7 +378,7 @@ void ClientLobbyRoomProtocol::connectionAccepted(Event* event)
     STKPeer* peer = *(event->peer);
 
     uint32_t global_id = data.gui32(8);
-    if (global_id == Online::CurrentUser::get()->getID())
+    if (global_id == NetworkManager::getInstance()->getLocalPlayerId())
     {
         Log::info("ClientLobbyRoomProtocol", "The server accepted the connection.");
 
@@ -376,7 +386,7 @@ void ClientLobbyRoomProtocol::connectionAccepted(Event* event)
         NetworkPlayerProfile* profile = new NetworkPlayerProfile();
         profile->kart_name = "";
         profile->race_id = data.gui8(1);
-        profile->user_profile = Online::CurrentUser::get()->getProfile();
+        profile->user_profile = NetworkManager::getInstance()->getLocalProfile();
         m_setup->addPlayer(profile);
         // connection token
         uint32_t token = data.gui32(3);
@@ -482,6 +492,13 @@ void ClientLobbyRoomProtocol::kartSelectionRefused(Event* event)
         Log::info("ClientLobbyRoomProtocol", "Kart selection refused.");
         break;
     }
+    // bots try the next kart if this one is taken or not available
+    if (NetworkBot::isEnabled() && data[1] != 2)
+    {
+        std::string kart = NetworkBot::getNextKart();
+        if (kart != "")
+            requestKartSelection(kart);
+    }
 }
 
 //-----------------------------------------------------------------------------
@@ -517,7 +534,8 @@ void ClientLobbyRoomProtocol::kartSelectionUpdate(Event* event)
         Log::error("ClientLobbyRoomProtocol", "The updated kart is taken already.");
     }
     m_setup->setPlayerKart(player_id, kart_name);
-    NetworkKartSelectionScreen::getInstance()->playerSelected(player_id, kart_name);
+    if (!NetworkBot::isEnabled())
+        NetworkKartSelectionScreen::getInstance()->playerSelected(player_id, kart_name);
 }
 
 //-----------------------------------------------------------------------------
@@ -44,6 +44,7 @@ ConnectToServer::ConnectToServer() :
 {
     m_server_id = 0;
     m_quick_join = true;
+    m_direct = false;
     m_state = NONE;
 }
 
@@ -55,6 +56,23 @@ ConnectToServer::ConnectToServer(uint32_t server_id, uint32_t host_id) :
     m_server_id = server_id;
     m_host_id = host_id;
     m_quick_join = false;
+    m_direct = false;
+    m_state = NONE;
+}
+
+// ----------------------------------------------------------------------------
+/** Connects to a server with a known address, without using the online
+ *  database to get it (and without publishing our own address). This is
+ *  used for LAN servers started with --lan-server.
+ */
+ConnectToServer::ConnectToServer(const TransportAddress& server_address) :
+    Protocol(NULL, PROTOCOL_CONNECTION)
+{
+    m_server_id = 0;
+    m_host_id = 0;
+    m_quick_join = false;
+    m_direct = true;
+    m_server_address = server_address;
     m_state = NONE;
 }
 
@@ -85,8 +103,11 @@ void ConnectToServer::setup()
     m_state = NONE;
     m_public_address.ip = 0;
     m_public_address.port = 0;
-    m_server_address.ip = 0;
-    m_server_address.port = 0;
+    if (!m_direct)
+    {
+        m_server_address.ip = 0;
+        m_server_address.port = 0;
+    }
     m_current_protocol_id = 0;
 }
 
@@ -99,6 +120,11 @@ void ConnectToServer::asynchronousUpdate()
         case NONE:
         {
             Log::info("ConnectToServer", "Protocol starting");
+            if (m_direct) // the server address is known
+            {
+                m_state = CONNECTING;
+                break;
+            }
             m_current_protocol_id = m_listener->requestStart(new GetPublicAddress(&m_public_address));
             m_state = GETTING_SELF_ADDRESS;
             break;
@@ -254,6 +280,13 @@ void ConnectToServer::asynchronousUpdate()
         case CONNECTED:
         {
             Log::info("ConnectToServer", "Connected");
+            if (m_direct) // no ping protocol and no address to hide
+            {
+                ClientNetworkManager::getInstance()->setConnected(true);
+                m_listener->requestStart(new ClientLobbyRoomProtocol(m_server_address));
+                m_state = DONE;
+                break;
+            }
             m_listener->requestTerminate( m_listener->getProtocol(m_current_protocol_id)); // kill the ping protocol because we're connected
             m_current_protocol_id = m_listener->requestStart(new HidePublicAddress());
             ClientNetworkManager::getInstance()->setConnected(true);
@@ -28,6 +28,7 @@ class ConnectToServer : public Protocol, public CallbackObject
     public:
         ConnectToServer(); //!< Quick join
         ConnectToServer(uint32_t server_id, uint32_t host_id); //!< Specify server id
+        ConnectToServer(const TransportAddress& server_address); //!< Direct (LAN) connection
         virtual ~ConnectToServer();
 
         virtual bool notifyEventAsynchronous(Event* event);
@@ -42,6 +43,9 @@ class ConnectToServer : public Protocol, public CallbackObject
         uint32_t m_host_id;
         uint32_t m_current_protocol_id;
         bool m_quick_join;
+        /** True if the server address is known, which skips the address
+         *  lookup in the online database. */
+        bool m_direct;
 
         enum STATE
         {
@@ -63,31 +63,32 @@ void ControllerEventsProtocol::setup()
 
 bool ControllerEventsProtocol::notifyEventAsynchronous(Event* event)
 {
-    NetworkString data = event->data();
+    NetworkStringView data = event->getDataView();
     if (data.size() < 17)
     {
         Log::error("ControllerEventsProtocol", "The data supplied was not complete. Size was %d.", data.size());
         return true;
     }
-    uint32_t token = data.gui32();
-    NetworkString pure_message = data;
-    pure_message.removeFront(4);
+    uint32_t token = data.getUInt32();
+    // The message without the token, which is forwarded to other clients.
+    NetworkStringView pure_message = data;
     if (token != (*event->peer)->getClientServerToken())
     {
         Log::error("ControllerEventsProtocol", "Bad token from peer.");
         return true;
     }
-    NetworkString ns = pure_message;
+    NetworkStringView ns = pure_message;
 
-    ns.removeFront(4);
+    ns.skip(4);
     uint8_t client_index = -1;
     while (ns.size() >= 9)
     {
-        uint8_t controller_index = ns.gui8();
+        NetworkStringView record = ns.getView(9);
+        uint8_t controller_index = record.peekUInt8(0);
         client_index = controller_index;
-        uint8_t serialized_1 = ns.gui8(1);
-        PlayerAction action  = (PlayerAction)(ns.gui8(4));
-        int action_value = ns.gui32(5);
+        uint8_t serialized_1 = record.peekUInt8(1);
+        PlayerAction action  = (PlayerAction)(record.peekUInt8(4));
+        int action_value = record.peekUInt32(5);
 
         KartControl* controls   = m_controllers[controller_index].first->getControls();
         controls->m_brake       = (serialized_1 & 0x40)!=0;
@@ -98,7 +99,6 @@ bool ControllerEventsProtocol::notifyEventAsynchronous(Event* event)
         controls->m_skid        = KartControl::SkidControl(serialized_1 & 0x03);
 
         m_controllers[controller_index].first->action(action, action_value);
-        ns.removeFront(9);
         //Log::info("ControllerEventProtocol", "Registered one action.");
     }
     if (ns.size() > 0 && ns.size() != 9)
@@ -120,7 +120,7 @@ bool ControllerEventsProtocol::notifyEventAsynchronous(Event* event)
                 continue;
             NetworkString ns2;
             ns2.ai32(m_controllers[i].second->getClientServerToken());
-            ns2 += pure_message;
+            ns2.addBytes(pure_message.getBytes(), pure_message.size());
             m_listener->sendMessage(this, m_controllers[i].second, ns2, false);
             //Log::info("ControllerEventsProtocol", "Sizes are %d and %d", ns2.size(), pure_message.size());
         }
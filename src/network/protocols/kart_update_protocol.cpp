@@ -1,9 +1,13 @@
 #include "network/protocols/kart_update_protocol.hpp"
 
+#include "config/user_config.hpp"
 #include "karts/abstract_kart.hpp"
 #include "modes/world.hpp"
+#include "network/bit_stream.hpp"
+#include "network/network_manager.hpp"
 #include "network/protocol_manager.hpp"
 #include "network/network_world.hpp"
+#include "tracks/track.hpp"
 
 KartUpdateProtocol::KartUpdateProtocol()
     : Protocol(NULL, PROTOCOL_KART_UPDATE)
@@ -22,6 +26,18 @@ KartUpdateProtocol::KartUpdateProtocol()
         }
     }
     pthread_mutex_init(&m_positions_updates_mutex, NULL);
+    pthread_mutex_init(&m_snapshots_mutex, NULL);
+    m_kart_buffers.resize(m_karts.size());
+
+    // Positions are quantized relative to the track bounding box. Add
+    // some space for karts that jump or fall off the track.
+    const Vec3 *min, *max;
+    World::getWorld()->getTrack()->getAABB(&min, &max);
+    const Vec3 margin(20.0f, 20.0f, 20.0f);
+    m_codec.init(*min - margin, *max + margin);
+    m_next_snapshot_id       = 0;
+    m_last_received_snapshot = 0;
+    m_snapshot_received      = false;
 }
 
 KartUpdateProtocol::~KartUpdateProtocol()
@@ -30,42 +46,222 @@ KartUpdateProtocol::~KartUpdateProtocol()
 
 bool KartUpdateProtocol::notifyEventAsynchronous(Event* event)
 {
+    if (event->type == EVENT_TYPE_DISCONNECTED)
+    {
+        // A new peer might later be allocated at the same address, which
+        // must not use the snapshots acknowledged by this peer.
+        pthread_mutex_lock(&m_snapshots_mutex);
+        m_acked_snapshots.erase(*(event->peer));
+        pthread_mutex_unlock(&m_snapshots_mutex);
+        return true;
+    }
     if (event->type != EVENT_TYPE_MESSAGE)
         return true;
-    NetworkString ns = event->data();
-    if (ns.size() < 36)
+    NetworkStringView ns = event->getDataView();
+    if (ns.size() < 9)
     {
         Log::info("KartUpdateProtocol", "Message too short.");
         return true;
     }
-    ns.removeFront(4);
-    while(ns.size() >= 16)
+    float remote_time = ns.getFloat();
+    uint8_t flags = ns.getUInt8();
+
+    if (m_listener->isServer())
     {
-        uint32_t kart_id = ns.getUInt32(0);
-
-        float a,b,c;
-        a = ns.getFloat(4);
-        b = ns.getFloat(8);
-        c = ns.getFloat(12);
-        float d,e,f,g;
-        d = ns.getFloat(16);
-        e = ns.getFloat(20);
-        f = ns.getFloat(24);
-        g = ns.getFloat(28);
-        pthread_mutex_trylock(&m_positions_updates_mutex);
-        m_next_positions.push_back(Vec3(a,b,c));
-        m_next_quaternions.push_back(btQuaternion(d,e,f,g));
-        m_karts_ids.push_back(kart_id);
+        // A client sends the state of its kart, and the id of the
+        // newest snapshot it has received.
+        uint16_t acked_id = ns.getUInt16();
+        uint32_t kart_id  = ns.getUInt8();
+        QuantizedKartState state;
+        BitReader reader(&ns);
+        if (!KartSnapshotCodec::read(&reader, &state, NULL) ||
+            kart_id >= m_karts.size())
+        {
+            Log::warn("KartUpdateProtocol", "Invalid kart state received.");
+            return true;
+        }
+        if (flags & 1)
+        {
+            STKPeer *peer = *(event->peer);
+            pthread_mutex_lock(&m_snapshots_mutex);
+            std::map<STKPeer*, uint16_t>::iterator i =
+                m_acked_snapshots.find(peer);
+            if (i == m_acked_snapshots.end() ||
+                KartSnapshotHistory::isNewer(acked_id, i->second))
+                m_acked_snapshots[peer] = acked_id;
+            pthread_mutex_unlock(&m_snapshots_mutex);
+        }
+        pthread_mutex_lock(&m_positions_updates_mutex);
+        addKartState(kart_id, remote_time, state);
         pthread_mutex_unlock(&m_positions_updates_mutex);
-        ns.removeFront(32);
+        return true;
+    }
+
+    // A client receives a snapshot of all karts, which might be
+    // delta-encoded against a snapshot received earlier.
+    uint16_t snapshot_id = ns.getUInt16();
+    pthread_mutex_lock(&m_snapshots_mutex);
+    const std::vector<QuantizedKartState> *baseline = NULL;
+    if (flags & 1)
+    {
+        baseline = m_snapshots.get(ns.getUInt16());
+        if (!baseline)
+        {
+            pthread_mutex_unlock(&m_snapshots_mutex);
+            Log::warn("KartUpdateProtocol", "Baseline of snapshot %d is "
+                      "not available.", snapshot_id);
+            return true;
+        }
     }
+    unsigned int num_karts = ns.getUInt8();
+    if (num_karts != m_karts.size() ||
+        (baseline && baseline->size() != num_karts))
+    {
+        pthread_mutex_unlock(&m_snapshots_mutex);
+        Log::warn("KartUpdateProtocol", "Snapshot has incorrect number "
+                  "of karts %d.", num_karts);
+        return true;
+    }
+    std::vector<QuantizedKartState> karts(num_karts);
+    BitReader reader(&ns);
+    for (unsigned int i = 0; i < num_karts; i++)
+    {
+        if (!KartSnapshotCodec::read(&reader, &karts[i],
+                                     baseline ? &(*baseline)[i] : NULL))
+        {
+            pthread_mutex_unlock(&m_snapshots_mutex);
+            Log::warn("KartUpdateProtocol", "Snapshot %d is corrupted.",
+                      snapshot_id);
+            return true;
+        }
+    }
+    m_snapshots.add(snapshot_id, karts);
+    if (!m_snapshot_received ||
+        KartSnapshotHistory::isNewer(snapshot_id, m_last_received_snapshot))
+    {
+        m_last_received_snapshot = snapshot_id;
+        m_snapshot_received      = true;
+    }
+    pthread_mutex_unlock(&m_snapshots_mutex);
+
+    pthread_mutex_lock(&m_positions_updates_mutex);
+    for (unsigned int i = 0; i < num_karts; i++)
+    {
+        if (i != m_self_kart_index)
+            addKartState(i, remote_time, karts[i]);
+    }
+    pthread_mutex_unlock(&m_positions_updates_mutex);
     return true;
 }
 
+/** Converts a world time into a time that always increases, which is
+ *  used as key in the interpolation buffers (the world time counts down
+ *  in some race modes).
+ */
+float KartUpdateProtocol::getMonotonicWorldTime(float world_time)
+{
+    if (World::getWorld()->getClockMode() == WorldStatus::CLOCK_COUNTDOWN)
+        return -world_time;
+    return world_time;
+}   // getMonotonicWorldTime
+
+/** Adds a received kart state to the interpolation buffer of the kart.
+ *  States that arrive out of order are discarded. The caller must hold
+ *  m_positions_updates_mutex.
+ *  \param kart_id World id of the kart.
+ *  \param remote_time World time of the sender when sending the state.
+ *  \param state The quantized state.
+ */
+void KartUpdateProtocol::addKartState(unsigned int kart_id,
+                                      float remote_time,
+                                      const QuantizedKartState &state)
+{
+    float local_time = World::getWorld()->getTime();
+    if (!m_kart_buffers[kart_id].add(getMonotonicWorldTime(remote_time),
+                                     getMonotonicWorldTime(local_time),
+                                     m_codec.getPosition(state),
+                                     m_codec.getRotation(state)))
+    {
+        Log::verbose("KartUpdateProtocol", "Discarding old state of kart %d.",
+                     kart_id);
+    }
+}   // addKartState
+
 void KartUpdateProtocol::setup()
 {
 }
 
+/** Server only: quantizes the state of all karts, stores it as new snapshot,
+ *  and sends it to each client, delta-encoded against the last snapshot
+ *  this client has acknowledged.
+ */
+void KartUpdateProtocol::sendSnapshotsToClients()
+{
+    std::vector<QuantizedKartState> karts(m_karts.size());
+    for (unsigned int i = 0; i < m_karts.size(); i++)
+    {
+        m_codec.quantize(m_karts[i]->getXYZ(), m_karts[i]->getRotation(),
+                         &karts[i]);
+    }
+
+    std::vector<STKPeer*> peers = NetworkManager::getInstance()->getPeers();
+    pthread_mutex_lock(&m_snapshots_mutex);
+    uint16_t snapshot_id = m_next_snapshot_id++;
+    m_snapshots.add(snapshot_id, karts);
+    for (unsigned int i = 0; i < peers.size(); i++)
+    {
+        const std::vector<QuantizedKartState> *baseline = NULL;
+        uint16_t baseline_id = 0;
+        std::map<STKPeer*, uint16_t>::iterator acked =
+            m_acked_snapshots.find(peers[i]);
+        if (acked != m_acked_snapshots.end())
+        {
+            baseline_id = acked->second;
+            baseline    = m_snapshots.get(baseline_id);
+        }
+
+        NetworkString ns;
+        ns.af( World::getWorld()->getTime());
+        ns.ai8(baseline ? 1 : 0);
+        ns.ai16(snapshot_id);
+        if (baseline)
+            ns.ai16(baseline_id);
+        ns.ai8(karts.size());
+        BitWriter writer(&ns);
+        for (unsigned int j = 0; j < karts.size(); j++)
+        {
+            KartSnapshotCodec::write(&writer, karts[j],
+                                     baseline ? &(*baseline)[j] : NULL);
+        }
+        writer.flush();
+        m_listener->sendMessage(this, peers[i], ns, false);
+    }
+    pthread_mutex_unlock(&m_snapshots_mutex);
+}   // sendSnapshotsToClients
+
+/** Client only: sends the state of the local kart to the server, together
+ *  with the id of the newest snapshot received (the acknowledgement).
+ */
+void KartUpdateProtocol::sendStateToServer()
+{
+    AbstractKart* kart = m_karts[m_self_kart_index];
+    QuantizedKartState state;
+    m_codec.quantize(kart->getXYZ(), kart->getRotation(), &state);
+
+    NetworkString ns;
+    ns.af( World::getWorld()->getTime());
+    pthread_mutex_lock(&m_snapshots_mutex);
+    ns.ai8(m_snapshot_received ? 1 : 0);
+    ns.ai16(m_last_received_snapshot);
+    pthread_mutex_unlock(&m_snapshots_mutex);
+    ns.ai8(kart->getWorldKartId());
+    BitWriter writer(&ns);
+    KartSnapshotCodec::write(&writer, state, NULL);
+    writer.flush();
+    Log::verbose("KartUpdateProtocol", "Sending %d's state", kart->getWorldKartId());
+    m_listener->sendMessage(this, ns, false);
+}   // sendStateToServer
+
 void KartUpdateProtocol::update()
 {
     if (!World::getWorld())
@@ -76,54 +272,39 @@ void KartUpdateProtocol::update()
     {
         time = current_time;
         if (m_listener->isServer())
-        {
-            NetworkString ns;
-            ns.af( World::getWorld()->getTime());
-            for (unsigned int i = 0; i < m_karts.size(); i++)
-            {
-                AbstractKart* kart = m_karts[i];
-                Vec3 v = kart->getXYZ();
-                btQuaternion quat = kart->getRotation();
-                ns.ai32( kart->getWorldKartId());
-                ns.af(v[0]).af(v[1]).af(v[2]); // add position
-                ns.af(quat.x()).af(quat.y()).af(quat.z()).af(quat.w()); // add rotation
-                Log::verbose("KartUpdateProtocol", "Sending %d's positions %f %f %f", kart->getWorldKartId(), v[0], v[1], v[2]);
-            }
-            m_listener->sendMessage(this, ns, false);
-        }
+            sendSnapshotsToClients();
         else
-        {
-            AbstractKart* kart = m_karts[m_self_kart_index];
-            Vec3 v = kart->getXYZ();
-            btQuaternion quat = kart->getRotation();
-            NetworkString ns;
-            ns.af( World::getWorld()->getTime());
-            ns.ai32( kart->getWorldKartId());
-            ns.af(v[0]).af(v[1]).af(v[2]); // add position
-            ns.af(quat.x()).af(quat.y()).af(quat.z()).af(quat.w()); // add rotation
-            Log::verbose("KartUpdateProtocol", "Sending %d's positions %f %f %f", kart->getWorldKartId(), v[0], v[1], v[2]);
-            m_listener->sendMessage(this, ns, false);
-        }
+            sendStateToServer();
     }
+
+    // Clients show all remote karts at the interpolated position. The
+    // server applies the newest state received for each client kart
+    // without delay, since it sends these states on to the other clients,
+    // which interpolate them again.
+    const float local_time = getMonotonicWorldTime(World::getWorld()->getTime());
+    const bool is_server = m_listener->isServer();
     switch(pthread_mutex_trylock(&m_positions_updates_mutex))
     {
         case 0: /* if we got the lock */
-            while (!m_next_positions.empty())
+            for (unsigned int id = 0; id < m_kart_buffers.size(); id++)
             {
-                uint32_t id = m_karts_ids.back();
-                if (id != m_self_kart_index || m_listener->isServer()) // server takes all updates
-                {
-                    Vec3 pos = m_next_positions.back();
-                    btTransform transform = m_karts[id]->getBody()->getInterpolationWorldTransform();
-                    transform.setOrigin(pos);
-                    transform.setRotation(m_next_quaternions.back());
-                    m_karts[id]->getBody()->setCenterOfMassTransform(transform);
-                    //m_karts[id]->getBody()->setLinearVelocity(Vec3(0,0,0));
-                    Log::verbose("KartUpdateProtocol", "Update kart %i pos to %f %f %f", id, pos[0], pos[1], pos[2]);
-                }
-                m_next_positions.pop_back();
-                m_next_quaternions.pop_back();
-                m_karts_ids.pop_back();
+                if (id == m_self_kart_index && !is_server)
+                    continue;
+                Vec3 pos;
+                btQuaternion rotation;
+                bool has_state = is_server
+                    ? m_kart_buffers[id].getNewest(&pos, &rotation)
+                    : m_kart_buffers[id].get(local_time,
+                               UserConfigParams::m_network_interpolation_delay,
+                               UserConfigParams::m_network_max_extrapolation,
+                               &pos, &rotation);
+                if (!has_state)
+                    continue;
+                btTransform transform = m_karts[id]->getBody()->getInterpolationWorldTransform();
+                transform.setOrigin(pos);
+                transform.setRotation(rotation);
+                m_karts[id]->getBody()->setCenterOfMassTransform(transform);
+                Log::verbose("KartUpdateProtocol", "Update kart %i pos to %f %f %f", id, pos[0], pos[1], pos[2]);
             }
             pthread_mutex_unlock(&m_positions_updates_mutex);
             break;
@@ -131,7 +312,3 @@ void KartUpdateProtocol::update()
             break;
     }
 }
-
-
-
-
@@ -1,12 +1,25 @@
 #ifndef KART_UPDATE_PROTOCOL_HPP
 #define KART_UPDATE_PROTOCOL_HPP
 
+#include "network/kart_interpolation_buffer.hpp"
+#include "network/kart_snapshot.hpp"
 #include "network/protocol.hpp"
 #include "utils/vec3.hpp"
 #include "LinearMath/btQuaternion.h"
-#include <list>
+#include <map>
 
 class AbstractKart;
+class STKPeer;
+
+/*! \class KartUpdateProtocol
+ *  \brief Synchronises the kart positions and rotations between the server
+ *  and the clients.
+ *  The server sends snapshots with the quantized state of all karts (see
+ *  KartSnapshotCodec). Each snapshot sent to a client is delta-encoded
+ *  against the last snapshot this client has acknowledged, so karts that
+ *  have not moved only need one bit. Clients send the state of their own
+ *  kart together with the id of the last snapshot they received.
+ */
 
 class KartUpdateProtocol : public Protocol
 {
@@ -20,13 +33,43 @@ class KartUpdateProtocol : public Protocol
         virtual void asynchronousUpdate() {};
 
     protected:
+        void sendSnapshotsToClients();
+        void sendStateToServer();
+        void addKartState(unsigned int kart_id, float remote_time,
+                          const QuantizedKartState &state);
+        static float getMonotonicWorldTime(float world_time);
+
         std::vector<AbstractKart*> m_karts;
         uint32_t m_self_kart_index;
 
-        std::list<Vec3> m_next_positions;
-        std::list<btQuaternion> m_next_quaternions;
-        std::list<uint32_t> m_karts_ids;
+        /** Quantizes the kart states relative to the track bounding box. */
+        KartSnapshotCodec m_codec;
+
+        /** On the server the snapshots sent, on a client the snapshots
+         *  received. Used as baselines for the delta encoding. */
+        KartSnapshotHistory m_snapshots;
+
+        /** Server only: id of the next snapshot to send. */
+        uint16_t m_next_snapshot_id;
+
+        /** Server only: the newest snapshot acknowledged by each peer. */
+        std::map<STKPeer*, uint16_t> m_acked_snapshots;
+
+        /** Client only: id of the newest snapshot received. */
+        uint16_t m_last_received_snapshot;
+
+        /** Client only: true once any snapshot was received. */
+        bool m_snapshot_received;
+
+        /** Protects the snapshot history and the acknowledgement data,
+         *  which are accessed from the asynchronous protocol thread. */
+        pthread_mutex_t m_snapshots_mutex;
+
+        /** For each kart the received states, used to interpolate
+         *  the position of remote karts. */
+        std::vector<KartInterpolationBuffer> m_kart_buffers;
 
+        /** Protects m_kart_buffers. */
         pthread_mutex_t m_positions_updates_mutex;
 };
 
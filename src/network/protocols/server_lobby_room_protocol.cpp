@@ -107,6 +107,13 @@ void ServerLobbyRoomProtocol::update()
     switch (m_state)
     {
     case NONE:
+        if (ServerNetworkManager::getInstance()->isLanServer())
+        {
+            // clients connect directly to our address
+            m_state = WORKING;
+            Log::info("ServerLobbyRoomProtocol", "LAN server setup");
+            break;
+        }
         m_current_protocol_id = m_listener->requestStart(new GetPublicAddress(&m_public_address));
         m_state = GETTING_PUBLIC_ADDRESS;
         break;
@@ -128,7 +135,8 @@ void ServerLobbyRoomProtocol::update()
         break;
     case WORKING:
     {
-        checkIncomingConnectionRequests();
+        if (!ServerNetworkManager::getInstance()->isLanServer())
+            checkIncomingConnectionRequests();
         if (m_in_race && World::getWorld() && NetworkWorld::getInstance<NetworkWorld>()->isRunning())
             checkRaceFinished();
 
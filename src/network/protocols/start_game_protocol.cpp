@@ -105,7 +105,7 @@ void StartGameProtocol::update()
         // have to add self first
         for (unsigned int i = 0; i < players.size(); i++)
         {
-            bool is_me = (players[i]->user_profile == Online::CurrentUser::get()->getProfile());
+            bool is_me = (players[i]->user_profile == NetworkManager::getInstance()->getLocalProfile());
             if (is_me)
             {
                 NetworkPlayerProfile* profile = players[i];
@@ -133,7 +133,7 @@ void StartGameProtocol::update()
         }
         for (unsigned int i = 0; i < players.size(); i++)
         {
-            bool is_me = (players[i]->user_profile == Online::CurrentUser::get()->getProfile());
+            bool is_me = (players[i]->user_profile == NetworkManager::getInstance()->getLocalProfile());
             NetworkPlayerProfile* profile = players[i];
             RemoteKartInfo rki(profile->race_id, profile->kart_name,
                 profile->user_profile->getUserName(), profile->race_id, !is_me);
@@ -74,10 +74,14 @@ void* waitInput2(void* data)
         }
     }
 
-    uint32_t id = ProtocolManager::getInstance()->requestStart(new StopServer());
-    while(ProtocolManager::getInstance()->getProtocolState(id) != PROTOCOL_STATE_TERMINATED)
+    // a LAN server was not registered in the online database
+    if (!ServerNetworkManager::getInstance()->isLanServer())
     {
-        StkTime::sleep(1);
+        uint32_t id = ProtocolManager::getInstance()->requestStart(new StopServer());
+        while(ProtocolManager::getInstance()->getProtocolState(id) != PROTOCOL_STATE_TERMINATED)
+        {
+            StkTime::sleep(1);
+        }
     }
 
     main_loop->abort();
@@ -89,6 +93,8 @@ ServerNetworkManager::ServerNetworkManager()
 {
     m_localhost = NULL;
     m_thread_keyboard = NULL;
+    m_max_players = 16;
+    m_lan_server = false;
 }
 
 ServerNetworkManager::~ServerNetworkManager()
@@ -105,7 +111,7 @@ void ServerNetworkManager::run()
         return;
     }
     m_localhost = new STKHost();
-    m_localhost->setupServer(STKHost::HOST_ANY, 7321, 16, 2, 0, 0);
+    m_localhost->setupServer(STKHost::HOST_ANY, 7321, m_max_players, 2, 0, 0);
     m_localhost->startListening();
 
     Log::info("ServerNetworkManager", "Host initialized.");
@@ -120,13 +126,29 @@ void ServerNetworkManager::run()
 
 void ServerNetworkManager::kickAllPlayers()
 {
+    pthread_mutex_lock(&m_peers_mutex);
     for (unsigned int i = 0; i < m_peers.size(); i++)
     {
         m_peers[i]->disconnect();
     }
+    pthread_mutex_unlock(&m_peers_mutex);
 }
 
 void ServerNetworkManager::sendPacket(const NetworkString& data, bool reliable)
 {
-    m_localhost->broadcastPacket(data, reliable);
+    if (reliable)
+    {
+        m_localhost->broadcastPacket(data, reliable);
+        // the packet (with its trailing byte) is sent to each peer
+        pthread_mutex_lock(&m_peers_mutex);
+        for (unsigned int i = 0; i < m_peers.size(); i++)
+            m_peers[i]->getPacketBatch()->countSent(data.size() + 1);
+        pthread_mutex_unlock(&m_peers_mutex);
+        return;
+    }
+    // unreliable messages are added to the batch of each peer
+    pthread_mutex_lock(&m_peers_mutex);
+    for (unsigned int i = 0; i < m_peers.size(); i++)
+        m_peers[i]->sendPacket(data, reliable);
+    pthread_mutex_unlock(&m_peers_mutex);
 }
@@ -39,6 +39,11 @@ class ServerNetworkManager : public NetworkManager
         void setMaxPlayers(uint8_t count) { m_max_players = count; }
         uint8_t getMaxPlayers() {return m_max_players;}
 
+        /** Sets if the server is only reachable by its address (in a LAN),
+         *  i.e. it is not registered in the online database. */
+        void setLanServer(bool lan) { m_lan_server = lan; }
+        bool isLanServer() { return m_lan_server; }
+
         void kickAllPlayers();
 
         virtual void sendPacket(const NetworkString& data, bool reliable = true);
@@ -51,6 +56,7 @@ class ServerNetworkManager : public NetworkManager
 
         pthread_t* m_thread_keyboard;
         uint8_t m_max_players;
+        bool m_lan_server;
 
 };
 
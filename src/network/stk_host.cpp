@@ -20,6 +20,8 @@
 
 #include "config/user_config.hpp"
 #include "network/network_manager.hpp"
+#include "network/packet_batch.hpp"
+#include "network/packet_capture.hpp"
 #include "utils/log.hpp"
 #include "utils/time.hpp"
 
@@ -34,24 +36,60 @@
 #include <pthread.h>
 #include <signal.h>
 
-FILE* STKHost::m_log_file = NULL;
-pthread_mutex_t STKHost::m_log_mutex;
+PacketCapture* STKHost::m_capture = NULL;
 
-void STKHost::logPacket(const NetworkString ns, bool incoming)
+void STKHost::openCapture()
 {
-    if (m_log_file == NULL)
+    if (m_capture)
         return;
-    pthread_mutex_lock(&m_log_mutex);
-    if (incoming)
-        fprintf(m_log_file, "[%d\t]  <--  ", (int)(StkTime::getRealTime()));
-    else
-        fprintf(m_log_file, "[%d\t]  -->  ", (int)(StkTime::getRealTime()));
-    for (int i = 0; i < ns.size(); i++)
+    if (UserConfigParams::m_packet_capture_filename.toString() == "")
+    {
+        Log::warn("STKHost", "Network packets won't be captured: no file.");
+        return;
+    }
+    m_capture = new PacketCapture();
+    if (!m_capture->open(UserConfigParams::m_packet_capture_filename))
     {
-        fprintf(m_log_file, "%d.", ns[i]);
+        delete m_capture;
+        m_capture = NULL;
     }
-    fprintf(m_log_file, "\n");
-    pthread_mutex_unlock(&m_log_mutex);
+}
+
+// ----------------------------------------------------------------------------
+
+void STKHost::closeCapture()
+{
+    if (!m_capture)
+        return;
+    delete m_capture;
+    m_capture = NULL;
+    Log::info("STKHost", "Packet capture file has been closed.");
+}
+
+// ----------------------------------------------------------------------------
+
+void STKHost::logPacket(const uint8_t* data, int size, bool incoming,
+                        const ENetAddress* address)
+{
+    if (m_capture == NULL)
+        return;
+    m_capture->capture(data, size,
+                       incoming ? PacketCapture::CAPTURE_INCOMING : 0,
+                       address ? ntohl(address->host) : 0,
+                       address ? address->port : 0);
+}
+
+// ----------------------------------------------------------------------------
+
+void STKHost::logRawPacket(const uint8_t* data, int size, bool incoming,
+                           const TransportAddress& address)
+{
+    if (m_capture == NULL)
+        return;
+    m_capture->capture(data, size,
+                       PacketCapture::CAPTURE_RAW |
+                       (incoming ? PacketCapture::CAPTURE_INCOMING : 0),
+                       address.ip, address.port);
 }
 
 // ----------------------------------------------------------------------------
@@ -64,12 +102,31 @@ void* STKHost::receive_data(void* self)
     while (!myself->mustStopListening())
     {
         while (enet_host_service(host, &event, 20) != 0) {
+            if (event.type == ENET_EVENT_TYPE_NONE)
+                continue;
             Event* evt = new Event(&event);
+            if (evt->type == EVENT_TYPE_MESSAGE && m_capture)
+            {
+                NetworkStringView data = evt->getDataView();
+                logPacket(data.getBytes(), data.size(), true,
+                          &event.peer->address);
+            }
             if (evt->type == EVENT_TYPE_MESSAGE)
-                logPacket(evt->data(), true);
-            if (event.type != ENET_EVENT_TYPE_NONE)
-                NetworkManager::getInstance()->notifyEvent(evt);
-            delete evt;
+            {
+                (*evt->peer)->getPacketBatch()->countReceived(
+                                       (uint32_t)event.packet->dataLength);
+            }
+            // Split framed packets into one event per message.
+            std::vector<Event*> events;
+            if (PacketBatch::split(*evt, &events))
+            {
+                delete evt;
+                for (unsigned int i = 0; i < events.size(); i++)
+                    NetworkManager::getInstance()->notifyEvent(events[i]);
+                continue;
+            }
+            // The protocol manager takes ownership of the event.
+            NetworkManager::getInstance()->notifyEvent(evt);
         }
     }
     myself->m_listening = false;
@@ -85,13 +142,7 @@ STKHost::STKHost()
 {
     m_host = NULL;
     m_listening_thread = NULL;
-    m_log_file = NULL;
     pthread_mutex_init(&m_exit_mutex, NULL);
-    pthread_mutex_init(&m_log_mutex, NULL);
-    if (UserConfigParams::m_packets_log_filename.toString() != "")
-        m_log_file = fopen(UserConfigParams::m_packets_log_filename.c_str(), "w+");
-    if (!m_log_file)
-        Log::warn("STKHost", "Network packets won't be logged: no file.");
 }
 
 // ----------------------------------------------------------------------------
@@ -99,11 +150,6 @@ STKHost::STKHost()
 STKHost::~STKHost()
 {
     stopListening();
-    if (m_log_file)
-    {
-        fclose(m_log_file);
-        Log::warn("STKHost", "Packet logging file has been closed.");
-    }
     if (m_host)
     {
         enet_host_destroy(m_host);
@@ -189,7 +235,7 @@ void STKHost::sendRawPacket(uint8_t* data, int length, TransportAddress dst)
     sendto(m_host->socket, (char*)data, length, 0,(sockaddr*)&to, to_len);
     Log::verbose("STKHost", "Raw packet sent to %i.%i.%i.%i:%u", ((dst.ip>>24)&0xff)
     , ((dst.ip>>16)&0xff), ((dst.ip>>8)&0xff), ((dst.ip>>0)&0xff), dst.port);
-    STKHost::logPacket(NetworkString(std::string((char*)(data), length)), false);
+    STKHost::logRawPacket(data, length, false, dst);
 }
 
 // ----------------------------------------------------------------------------
@@ -209,7 +255,7 @@ uint8_t* STKHost::receiveRawPacket()
         len = recv(m_host->socket,(char*)buffer,2048, 0);
         StkTime::sleep(1);
     }
-    STKHost::logPacket(NetworkString(std::string((char*)(buffer), len)), true);
+    STKHost::logRawPacket(buffer, len, true, TransportAddress());
     return buffer;
 }
 
@@ -249,7 +295,7 @@ uint8_t* STKHost::receiveRawPacket(TransportAddress* sender)
         inet_ntop(AF_INET, &(addr.sin_addr), s, 20);
         Log::info("STKHost", "IPv4 Address of the sender was %s", s);
     }
-    STKHost::logPacket(NetworkString(std::string((char*)(buffer), len)), true);
+    STKHost::logRawPacket(buffer, len, true, *sender);
     return buffer;
 }
 
@@ -294,7 +340,9 @@ uint8_t* STKHost::receiveRawPacket(TransportAddress sender, int max_tries)
         inet_ntop(AF_INET, &(addr.sin_addr), s, 20);
         Log::info("STKHost", "IPv4 Address of the sender was %s", s);
     }
-    STKHost::logPacket(NetworkString(std::string((char*)(buffer), len)), true);
+    STKHost::logRawPacket(buffer, len, true,
+                          TransportAddress(ntohl(addr.sin_addr.s_addr),
+                                           ntohs(addr.sin_port)));
     return buffer;
 }
 
@@ -302,10 +350,12 @@ uint8_t* STKHost::receiveRawPacket(TransportAddress sender, int max_tries)
 
 void STKHost::broadcastPacket(const NetworkString& data, bool reliable)
 {
-    ENetPacket* packet = enet_packet_create(data.getBytes(), data.size() + 1,
+    ENetPacket* packet = PacketBatch::createPacket(data.getBytes(), data.size(),
                (reliable ? ENET_PACKET_FLAG_RELIABLE : ENET_PACKET_FLAG_UNSEQUENCED));
+    // Capture the packet before sending it: enet_host_broadcast destroys
+    // the packet right away if there is no peer.
+    STKHost::logPacket(packet->data, data.size(), false, NULL);
     enet_host_broadcast(m_host, 0, packet);
-    STKHost::logPacket(data, false);
 }
 
 // ----------------------------------------------------------------------------
@@ -34,6 +34,8 @@
 
 #include <pthread.h>
 
+class PacketCapture;
+
 /*! \class STKHost
  *  \brief Represents the local host.
  *  This host is either a server host or a client host. A client host is in
@@ -64,12 +66,33 @@ class STKHost
         /*! \brief Destructor                                               */
         virtual ~STKHost();
         
-        /*! \brief Log packets into a file
-         *  \param ns : The data in the packet
+        /*! \brief Opens the packet capture file (if enabled). The capture
+         *  is shared by all hosts and used by the receive and protocol
+         *  threads, so it is opened once by the NetworkManager.     */
+        static void openCapture();
+        /*! \brief Closes the packet capture file. No thread must send or
+         *  receive packets anymore (see NetworkManager::~NetworkManager). */
+        static void closeCapture();
+        /*! \brief Captures a packet into the capture file (if enabled).
+         *  This only copies the packet, the file is written by another
+         *  thread (see PacketCapture).
+         *  \param data : The data in the packet.
+         *  \param size : The size of the packet.
          *  \param incoming : True if the packet comes from a peer.
          *  False if it's sent to a peer.
+         *  \param address : The ENet address of the peer, or NULL for
+         *  broadcasts.
+         */
+        static void logPacket(const uint8_t* data, int size, bool incoming,
+                              const ENetAddress* address);
+        /*! \brief Captures a packet sent or received without ENet.
+         *  \param data : The data in the packet.
+         *  \param size : The size of the packet.
+         *  \param incoming : True if the packet comes from a peer.
+         *  \param address : The address of the peer.
          */
-        static void logPacket(const NetworkString ns, bool incoming);
+        static void logRawPacket(const uint8_t* data, int size, bool incoming,
+                                 const TransportAddress& address);
 
         /*! \brief Thread function checking if data is received.
          *  This function tries to get data from network low-level functions as
@@ -165,8 +188,7 @@ class STKHost
         pthread_t*  m_listening_thread; //!< Thread listening network events.
         pthread_mutex_t m_exit_mutex;   //!< Mutex to kill properly the thread
         bool        m_listening;
-        static FILE*       m_log_file;         //!< Where to log packets
-        static pthread_mutex_t m_log_mutex;    //!< To write in the log only once at a time
+        static PacketCapture* m_capture;  //!< Captures the packets, or NULL
 
 };
 
@@ -31,16 +31,7 @@ STKPeer::STKPeer()
     *m_client_server_token = 0;
     m_token_set = new bool;
     *m_token_set = false;
-}
-
-//-----------------------------------------------------------------------------
-
-STKPeer::STKPeer(const STKPeer& peer)
-{
-    m_peer = peer.m_peer;
-    m_player_profile = peer.m_player_profile;
-    m_client_server_token = peer.m_client_server_token;
-    m_token_set = peer.m_token_set;
+    m_batch = new PacketBatch();
 }
 
 //-----------------------------------------------------------------------------
@@ -58,6 +49,9 @@ STKPeer::~STKPeer()
     if (m_token_set)
         delete m_token_set;
     m_token_set = NULL;
+    if (m_batch)
+        delete m_batch;
+    m_batch = NULL;
 }
 
 //-----------------------------------------------------------------------------
@@ -101,8 +95,16 @@ void STKPeer::sendPacket(NetworkString const& data, bool reliable)
                 data.size(), (m_peer->address.host>>0)&0xff,
                 (m_peer->address.host>>8)&0xff,(m_peer->address.host>>16)&0xff,
                 (m_peer->address.host>>24)&0xff,m_peer->address.port);
-    ENetPacket* packet = enet_packet_create(data.getBytes(), data.size() + 1,
-                (reliable ? ENET_PACKET_FLAG_RELIABLE : ENET_PACKET_FLAG_UNSEQUENCED));
+    // unreliable messages are collected and sent together by flushPackets
+    if (!reliable)
+    {
+        m_batch->add(m_peer, data);
+        return;
+    }
+    ENetPacket* packet = PacketBatch::createPacket(data.getBytes(), data.size(),
+                                                   ENET_PACKET_FLAG_RELIABLE);
+    STKHost::logPacket(packet->data, data.size(), false, &m_peer->address);
+    m_batch->countSent((uint32_t)packet->dataLength);
     /* to debug the packet output
     printf("STKPeer: ");
     for (unsigned int i = 0; i < data.size(); i++)
@@ -116,6 +118,14 @@ void STKPeer::sendPacket(NetworkString const& data, bool reliable)
 
 //-----------------------------------------------------------------------------
 
+/** Sends the unreliable messages collected since the last flush. */
+void STKPeer::flushPackets()
+{
+    m_batch->flush(m_peer);
+}
+
+//-----------------------------------------------------------------------------
+
 uint32_t STKPeer::getAddress() const
 {
     return ntohl(m_peer->address.host);
@@ -26,21 +26,24 @@
 #include "network/stk_host.hpp"
 #include "network/network_string.hpp"
 #include "network/game_setup.hpp"
+#include "network/packet_batch.hpp"
+#include "utils/no_copy.hpp"
+
 #include <enet/enet.h>
 
 /*! \class STKPeer
  *  \brief Represents a peer.
  *  This class is used to interface the ENetPeer structure.
  */
-class STKPeer
+class STKPeer : public NoCopy
 {
     friend class Event;
     public:
         STKPeer();
-        STKPeer(const STKPeer& peer);
         virtual ~STKPeer();
 
         virtual void sendPacket(const NetworkString& data, bool reliable = true);
+        void flushPackets();
         static bool connectToHost(STKHost* localhost, TransportAddress host, uint32_t channel_count, uint32_t data);
         void disconnect();
 
@@ -58,12 +61,21 @@ class STKPeer
         bool     isClientServerTokenSet() const { return *m_token_set; }
 
         bool isSamePeer(const STKPeer* peer) const;
+        /** Returns the batch of unreliable messages, which also stores
+         *  the statistics about the sent packets. */
+        const PacketBatch* getPacketBatch() const { return m_batch; }
+        PacketBatch* getPacketBatch()             { return m_batch; }
+        /** Returns the mean round trip time to the peer in ms, as
+         *  measured by ENet. */
+        uint32_t getRoundTripTime() const { return m_peer->roundTripTime; }
 
     protected:
         ENetPeer* m_peer;
         NetworkPlayerProfile** m_player_profile;
         uint32_t *m_client_server_token;
         bool *m_token_set;
+        /** Collects the unreliable messages sent during an update. */
+        PacketBatch *m_batch;
 };
 
 #endif // STK_PEER_HPP
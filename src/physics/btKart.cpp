@@ -23,9 +23,41 @@
 #include "BulletDynamics/ConstraintSolver/btContactConstraint.h"
 
 #include "karts/kart.hpp"
+#include "utils/snapshot_buffer.hpp"
+#include "utils/time.hpp"
 
 #define ROLLING_INFLUENCE_FIX
 
+bool     btKart::m_collect_timings = false;
+uint64_t btKart::m_timing_ns[btKart::TIMING_COUNT];
+uint64_t btKart::m_timing_calls[btKart::TIMING_COUNT];
+
+// ============================================================================
+/** Measures the time from its creation till it goes out of scope, and adds
+ *  it to the timing statistics of one btKart function. Nothing is measured
+ *  unless timings are enabled.
+ */
+class btKart::ScopedTiming
+{
+private:
+    TimingType m_type;
+    bool       m_active;
+    uint64_t   m_start;
+public:
+    ScopedTiming(TimingType type) : m_type(type)
+    {
+        m_active = m_collect_timings;
+        m_start  = m_active ? StkTime::getMonoTimeNs() : 0;
+    }   // ScopedTiming
+    // ------------------------------------------------------------------------
+    ~ScopedTiming()
+    {
+        if(!m_active) return;
+        m_timing_ns[m_type] += StkTime::getMonoTimeNs() - m_start;
+        m_timing_calls[m_type]++;
+    }   // ~ScopedTiming
+};   // ScopedTiming
+
 
 btRigidBody& btKart::getFixedBody()
 {
@@ -36,7 +68,7 @@ btRigidBody& btKart::getFixedBody()
 }
 
 // ============================================================================
-btKart::btKart(btRigidBody* chassis, btVehicleRaycaster* raycaster,
+btKart::btKart(btRigidBody* chassis, btKartRaycaster* raycaster,
                Kart *kart)
       : m_vehicleRaycaster(raycaster)
 {
@@ -95,6 +127,8 @@ btWheelInfo& btKart::addWheel(const btVector3& connectionPointCS,
     m_axle.resize(m_wheelInfo.size());
     m_forwardImpulse.resize(m_wheelInfo.size());
     m_sideImpulse.resize(m_wheelInfo.size());
+    m_ray_results.resize(m_wheelInfo.size());
+    m_ray_objects.resize(m_wheelInfo.size());
 
     return wheel;
 }   // addWheel
@@ -130,6 +164,53 @@ void btKart::reset()
 
 }   // reset
 
+// ----------------------------------------------------------------------------
+/** Saves the state of the wheels (suspension, rotation, contact
+ *  information) and of the additional impulses and rotations.
+ *  \param buffer The snapshot buffer to write to.
+ */
+void btKart::saveState(SnapshotBuffer *buffer) const
+{
+    buffer->addArray(&m_wheelInfo[0], m_wheelInfo.size());
+    buffer->addArray(&m_visual_contact_point[0],
+                     m_visual_contact_point.size());
+    buffer->add(m_zipper_active);
+    buffer->add(m_zipper_velocity);
+    buffer->add(m_skid_angular_velocity);
+    buffer->add(m_is_skidding);
+    buffer->add(m_allow_sliding);
+    buffer->add(m_additional_impulse);
+    buffer->add(m_time_additional_impulse);
+    buffer->add(m_additional_rotation);
+    buffer->add(m_time_additional_rotation);
+    buffer->add(m_num_wheels_on_ground);
+    buffer->add(m_visual_rotation);
+    buffer->add(m_visual_wheels_touch_ground);
+}   // saveState
+
+// ----------------------------------------------------------------------------
+/** Restores the state saved with saveState.
+ *  \param buffer The snapshot buffer to read from.
+ */
+void btKart::restoreState(SnapshotBuffer *buffer)
+{
+    buffer->getArray(&m_wheelInfo[0], m_wheelInfo.size());
+    buffer->getArray(&m_visual_contact_point[0],
+                     m_visual_contact_point.size());
+    buffer->get(&m_zipper_active);
+    buffer->get(&m_zipper_velocity);
+    buffer->get(&m_skid_angular_velocity);
+    buffer->get(&m_is_skidding);
+    buffer->get(&m_allow_sliding);
+    buffer->get(&m_additional_impulse);
+    buffer->get(&m_time_additional_impulse);
+    buffer->get(&m_additional_rotation);
+    buffer->get(&m_time_additional_rotation);
+    buffer->get(&m_num_wheels_on_ground);
+    buffer->get(&m_visual_rotation);
+    buffer->get(&m_visual_wheels_touch_ground);
+}   // restoreState
+
 // ----------------------------------------------------------------------------
 const btTransform& btKart::getWheelTransformWS( int wheelIndex ) const
 {
@@ -212,43 +293,57 @@ void btKart::updateWheelTransformsWS(btWheelInfo& wheel,
 }   // updateWheelTransformsWS
 
 // ----------------------------------------------------------------------------
-/** 
- */
-btScalar btKart::rayCast(unsigned int index)
+/** Returns the length of the suspension ray of a wheel. */
+static btScalar getRayLength(const btWheelInfo &wheel)
 {
-    btWheelInfo &wheel = m_wheelInfo[index];
+    return wheel.getSuspensionRestLength()+wheel.m_wheelsRadius
+         + wheel.m_maxSuspensionTravelCm*0.01f;
+}   // getRayLength
 
-    // Work around a bullet problem: when using a convex hull the raycast
-    // would sometimes hit the chassis (which does not happen when using a
-    // box shape). Therefore set the collision mask in the chassis body so
-    // that it is not hit anymore.
-    short int old_group=0;
-    if(m_chassisBody->getBroadphaseHandle())
+// ----------------------------------------------------------------------------
+/** Casts the suspension rays of all wheels. This must be called before
+ *  rayCast(index) is called for each wheel, which uses the results.
+ */
+void btKart::castWheelRays()
+{
+    ScopedTiming timing(TIMING_CAST_WHEEL_RAYS);
+    for(int i=0; i<getNumWheels(); i++)
     {
-        old_group = m_chassisBody->getBroadphaseHandle()
-                                 ->m_collisionFilterGroup;
-        m_chassisBody->getBroadphaseHandle()->m_collisionFilterGroup = 0;
+        btWheelInfo &wheel = m_wheelInfo[i];
+        updateWheelTransformsWS( wheel,false);
+        btVector3 rayvector = wheel.m_raycastInfo.m_wheelDirectionWS
+                            * getRayLength(wheel);
+        wheel.m_raycastInfo.m_contactPointWS =
+            wheel.m_raycastInfo.m_hardPointWS + rayvector;
     }
 
-    updateWheelTransformsWS( wheel,false);
+    btAssert(m_vehicleRaycaster);
+    m_vehicleRaycaster->castWheelRays(m_wheelInfo, m_chassisBody,
+                                      &m_ray_results[0], &m_ray_objects[0]);
+}   // castWheelRays
+
+// ----------------------------------------------------------------------------
+/** Updates the suspension of a wheel depending on the result of its
+ *  raycast, which must have been done by castWheelRays before.
+ */
+btScalar btKart::rayCast(unsigned int index)
+{
+    ScopedTiming timing(TIMING_RAYCAST);
+    btWheelInfo &wheel = m_wheelInfo[index];
 
     btScalar depth = -1;
 
-    btScalar raylen = wheel.getSuspensionRestLength()+wheel.m_wheelsRadius
-                    + wheel.m_maxSuspensionTravelCm*0.01f;
+    btScalar raylen = getRayLength(wheel);
 
     btVector3 rayvector = wheel.m_raycastInfo.m_wheelDirectionWS * (raylen);
     const btVector3& source = wheel.m_raycastInfo.m_hardPointWS;
-    wheel.m_raycastInfo.m_contactPointWS = source + rayvector;
-    const btVector3& target = wheel.m_raycastInfo.m_contactPointWS;
 
     btScalar param = btScalar(0.);
 
-    btVehicleRaycaster::btVehicleRaycasterResult rayResults;
+    const btVehicleRaycaster::btVehicleRaycasterResult &rayResults =
+        m_ray_results[index];
 
-    btAssert(m_vehicleRaycaster);
-
-    void* object = m_vehicleRaycaster->castRay(source,target,rayResults);
+    void* object = m_ray_objects[index];
 
     wheel.m_raycastInfo.m_groundObject = 0;
 
@@ -355,13 +450,6 @@ btScalar btKart::rayCast(unsigned int index)
     }
 #endif
 
-    if(m_chassisBody->getBroadphaseHandle())
-    {
-        m_chassisBody->getBroadphaseHandle()->m_collisionFilterGroup
-            = old_group;
-    }
-
-
     return depth;
 
 }   // rayCast
@@ -375,6 +463,7 @@ const btTransform& btKart::getChassisWorldTransform() const
 // ----------------------------------------------------------------------------
 void btKart::updateVehicle( btScalar step )
 {
+    ScopedTiming timing(TIMING_UPDATE_VEHICLE);
     for (int i=0;i<getNumWheels();i++)
     {
         updateWheelTransform(i,false);
@@ -389,8 +478,21 @@ void btKart::updateVehicle( btScalar step )
     // Simulate suspension
     // -------------------
 
+    // Work around a bullet problem: when using a convex hull the raycast
+    // would sometimes hit the chassis (which does not happen when using a
+    // box shape). Therefore set the collision mask in the chassis body so
+    // that it is not hit anymore.
+    short int old_group=0;
+    if(m_chassisBody->getBroadphaseHandle())
+    {
+        old_group = m_chassisBody->getBroadphaseHandle()
+                                 ->m_collisionFilterGroup;
+        m_chassisBody->getBroadphaseHandle()->m_collisionFilterGroup = 0;
+    }
+
     m_num_wheels_on_ground       = 0;
     m_visual_wheels_touch_ground = true;
+    castWheelRays();
     for (int i=0;i<m_wheelInfo.size();i++)
     {
         btScalar depth;
@@ -398,6 +500,12 @@ void btKart::updateVehicle( btScalar step )
         if(m_wheelInfo[i].m_raycastInfo.m_isInContact)
             m_num_wheels_on_ground++;
     }
+
+    if(m_chassisBody->getBroadphaseHandle())
+    {
+        m_chassisBody->getBroadphaseHandle()->m_collisionFilterGroup
+            = old_group;
+    }
     // Work around: make sure that either both wheels on one axis
     // are on ground, or none of them. This avoids the problem of
     // the kart suddenly getting additional angular velocity because
@@ -572,6 +680,7 @@ void btKart::setAllBrakes(btScalar brake)
 // ----------------------------------------------------------------------------
 void btKart::updateSuspension(btScalar deltaTime)
 {
+    ScopedTiming timing(TIMING_UPDATE_SUSPENSION);
     (void)deltaTime;
 
     btScalar chassisMass = btScalar(1.) / m_chassisBody->getInvMass();
@@ -688,6 +797,7 @@ btScalar btKart::calcRollingFriction(btWheelContactPoint& contactPoint)
 
 void btKart::updateFriction(btScalar timeStep)
 {
+    ScopedTiming timing(TIMING_UPDATE_FRICTION);
     //calculate the impulse, so that the wheels don't move sidewards
     for (int i=0;i<getNumWheels();i++)
     {
@@ -979,6 +1089,23 @@ void btKart::capSpeed(float max_speed)
     m_chassisBody->setLinearVelocity( velocity * velocity_ratio);
 }   // capSpeed
 
+// ----------------------------------------------------------------------------
+/** Enables or disables measuring the time spent in updateVehicle and the
+ *  functions called from it. Enabling resets all statistics. This is used
+ *  by the physics benchmark, and should not be enabled otherwise.
+ *  \param enable True if timings should be collected.
+ */
+void btKart::enableTimings(bool enable)
+{
+    m_collect_timings = enable;
+    if(!enable) return;
+    for(unsigned int i=0; i<TIMING_COUNT; i++)
+    {
+        m_timing_ns[i]    = 0;
+        m_timing_calls[i] = 0;
+    }
+}   // enableTimings
+
 // ----------------------------------------------------------------------------
 //Shorter version of above raycast function. This is used when projecting
 //vehicles towards the ground at the start of a race
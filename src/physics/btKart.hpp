@@ -14,6 +14,7 @@
 #include "BulletDynamics/Dynamics/btRigidBody.h"
 #include "BulletDynamics/ConstraintSolver/btTypedConstraint.h"
 #include "physics/btKartRaycast.hpp"
+#include "utils/types.hpp"
 class btDynamicsWorld;
 #include "LinearMath/btAlignedObjectArray.h"
 #include "BulletDynamics/Vehicle/btWheelInfo.h"
@@ -21,6 +22,7 @@ class btDynamicsWorld;
 
 class btVehicleTuning;
 class Kart;
+class SnapshotBuffer;
 struct btWheelContactPoint;
 
 /** rayCast vehicle, very special constraint that turn a rigidbody into a
@@ -29,6 +31,11 @@ struct btWheelContactPoint;
 class btKart : public btActionInterface
 {
 public:
+    /** The functions for which the physics benchmark collects timings. */
+    enum TimingType {TIMING_UPDATE_VEHICLE, TIMING_CAST_WHEEL_RAYS,
+                     TIMING_RAYCAST, TIMING_UPDATE_SUSPENSION,
+                     TIMING_UPDATE_FRICTION, TIMING_COUNT};
+
     class btVehicleTuning
     {
     public:
@@ -67,7 +74,14 @@ private:
     btScalar calcRollingFriction(btWheelContactPoint& contactPoint);
 
     btScalar            m_damping;
-    btVehicleRaycaster *m_vehicleRaycaster;
+    btKartRaycaster    *m_vehicleRaycaster;
+
+    /** The results of the wheel raycasts in the current physics step. */
+    btAlignedObjectArray<btVehicleRaycaster::btVehicleRaycasterResult>
+                        m_ray_results;
+
+    /** The object hit by each wheel raycast in the current physics step. */
+    btAlignedObjectArray<void*> m_ray_objects;
 
     /** True if a zipper is active for that kart. */
     bool                m_zipper_active;
@@ -138,6 +152,19 @@ private:
     void     defaultInit();
     btScalar rayCast(btWheelInfo& wheel, const btVector3& ray);
 
+    /** Adds the time spent in a function to the timing statistics. */
+    class ScopedTiming;
+
+    /** True if the time spent in the main functions is measured (which
+     *  is only done by the physics benchmark). */
+    static bool     m_collect_timings;
+
+    /** Accumulated time in nanoseconds spent in each timed function. */
+    static uint64_t m_timing_ns[TIMING_COUNT];
+
+    /** Number of calls of each timed function. */
+    static uint64_t m_timing_calls[TIMING_COUNT];
+
 public:
 
     /** Constructor to create a car from an existing rigidbody.
@@ -147,12 +174,15 @@ public:
      *         (this is used to get access to the kart properties).
      */
                        btKart(btRigidBody* chassis,
-                              btVehicleRaycaster* raycaster,
+                              btKartRaycaster* raycaster,
                               Kart *kart);
      virtual          ~btKart();
     void               reset();
+    void               saveState(SnapshotBuffer *buffer) const;
+    void               restoreState(SnapshotBuffer *buffer);
     void               debugDraw(btIDebugDraw* debugDrawer);
     const btTransform& getChassisWorldTransform() const;
+    void               castWheelRays();
     btScalar           rayCast(unsigned int index);
     virtual void       updateVehicle(btScalar step);
     void               resetSuspension();
@@ -180,6 +210,18 @@ public:
     void               setSliding(bool active);
     void               instantSpeedIncreaseTo(float speed);
     void               capSpeed(float max_speed);
+    static void        enableTimings(bool enable);
+    // ------------------------------------------------------------------------
+    /** Returns the accumulated time in nanoseconds spent in a function
+     *  since timings were enabled. */
+    static uint64_t    getTimingNs(TimingType t) { return m_timing_ns[t]; }
+    // ------------------------------------------------------------------------
+    /** Returns the number of calls of a function since timings were
+     *  enabled. */
+    static uint64_t    getTimingCalls(TimingType t)
+    {
+        return m_timing_calls[t];
+    }   // getTimingCalls
     // ------------------------------------------------------------------------
     /** Returns true if both rear visual wheels touch the ground. */
     bool visualWheelsTouchGround() const
@@ -13,6 +13,8 @@
 #include "btKartRaycast.hpp"
 
 #include "BulletCollision/CollisionDispatch/btCollisionWorld.h"
+#include "BulletCollision/CollisionShapes/btOptimizedBvh.h"
+#include "BulletCollision/NarrowPhaseCollision/btRaycastCallback.h"
 #include "BulletDynamics/Dynamics/btDynamicsWorld.h"
 
 #include "modes/world.hpp"
@@ -61,36 +63,193 @@ void* btKartRaycaster::castRay(const btVector3& from, const btVector3& to,
 
     m_dynamicsWorld->rayTest(from, to, rayCallback);
 
-    if (rayCallback.hasHit())
+    if (!rayCallback.hasHit())
+        return 0;
+    return setResult(rayCallback.m_collisionObject, from, to,
+                     rayCallback.m_closestHitFraction,
+                     rayCallback.m_hitNormalWorld,
+                     rayCallback.getTriangleIndex(), result);
+}   // castRay
+
+// ----------------------------------------------------------------------------
+/** Fills in the result of a raycast that hit an object.
+ *  \param object The object hit.
+ *  \param from, to The ray.
+ *  \param fraction Position of the hit along the ray.
+ *  \param normal Normal of the hit (not necessarily normalised).
+ *  \param triangle_index Index of the track triangle hit, or -1.
+ *  \param result On return the result of the raycast.
+ *  \return The body hit, or 0 if the object hit has no contact response
+ *          (in which case result is not modified).
+ */
+void* btKartRaycaster::setResult(const btCollisionObject *object,
+                                 const btVector3 &from, const btVector3 &to,
+                                 btScalar fraction, const btVector3 &normal,
+                                 int triangle_index,
+                                 btVehicleRaycasterResult& result) const
+{
+    const btRigidBody* body = btRigidBody::upcast(object);
+    if (!body || !body->hasContactResponse())
+        return 0;
+
+    result.m_hitPointInWorld.setInterpolate3(from, to, fraction);
+    result.m_hitNormalInWorld = normal;
+    result.m_hitNormalInWorld.normalize();
+    result.m_distFraction = fraction;
+    if(m_smooth_normals && triangle_index>-1)
     {
-        btRigidBody* body = btRigidBody::upcast(rayCallback.m_collisionObject);
-        if (body && body->hasContactResponse())
-        {
-            result.m_hitPointInWorld = rayCallback.m_hitPointWorld;
-            result.m_hitNormalInWorld = rayCallback.m_hitNormalWorld;
-            result.m_hitNormalInWorld.normalize();
-            result.m_distFraction = rayCallback.m_closestHitFraction;
-            const TriangleMesh &tm =
-                World::getWorld()->getTrack()->getTriangleMesh();
-            if(m_smooth_normals &&
-                rayCallback.getTriangleIndex()>-1)
-            {
-                btVector3 n=result.m_hitNormalInWorld;
-                result.m_hitNormalInWorld =
-                    tm.getInterpolatedNormal(rayCallback.getTriangleIndex(),
-                                             result.m_hitPointInWorld);
+        const TriangleMesh &tm =
+            World::getWorld()->getTrack()->getTriangleMesh();
+        btVector3 n=result.m_hitNormalInWorld;
+        result.m_hitNormalInWorld =
+            tm.getInterpolatedNormal(triangle_index,
+                                     result.m_hitPointInWorld);
 #undef DEBUG_NORMALS
 #ifdef DEBUG_NORMALS
-                printf("old %f %f %f new %f %f %f\n",
-                    n.getX(), n.getY(), n.getZ(),
-                    result.m_hitNormalInWorld.getX(),
-                    result.m_hitNormalInWorld.getY(),
-                    result.m_hitNormalInWorld.getZ());
+        printf("old %f %f %f new %f %f %f\n",
+            n.getX(), n.getY(), n.getZ(),
+            result.m_hitNormalInWorld.getX(),
+            result.m_hitNormalInWorld.getY(),
+            result.m_hitNormalInWorld.getZ());
 #endif
-            }
-            return body;
+    }
+    return (void*)body;
+}   // setResult
+
+// ----------------------------------------------------------------------------
+/** Casts the suspension rays of all wheels of a kart (from the hard point
+ *  to the contact point of each wheel). The rays of a kart are close to
+ *  each other, so if nothing except the track and the kart itself is close
+ *  to the rays, the track BVH is only traversed once to collect the
+ *  triangles in the bounding box of all rays, and each ray is then tested
+ *  against these triangles only. Otherwise (e.g. another kart or a physical
+ *  object is close) each ray is cast separately with castRay.
+ *  The results are the same as calling castRay for each wheel.
+ *  \param wheels The wheels of the kart.
+ *  \param chassis The chassis of the kart, which is ignored.
+ *  \param results On return the results for each wheel.
+ *  \param objects On return the object hit by each ray (or 0), like the
+ *         return value of castRay.
+ */
+void btKartRaycaster::castWheelRays(
+                           const btAlignedObjectArray<btWheelInfo> &wheels,
+                           const btCollisionObject *chassis,
+                           btVehicleRaycasterResult *results, void **objects)
+{
+    // ========================================================================
+    /** Checks if any object except the track and the chassis overlaps. */
+    class OtherObjectCallback : public btBroadphaseAabbCallback
+    {
+    public:
+        const btCollisionObject *m_track;
+        const btCollisionObject *m_chassis;
+        bool m_found;
+        // --------------------------------------------------------------------
+        OtherObjectCallback(const btCollisionObject *track,
+                            const btCollisionObject *chassis)
+        {
+            m_track   = track;
+            m_chassis = chassis;
+            m_found   = false;
+        }   // OtherObjectCallback
+        // --------------------------------------------------------------------
+        virtual bool process(const btBroadphaseProxy *proxy)
+        {
+            const btCollisionObject *object =
+                (const btCollisionObject*)proxy->m_clientObject;
+            if(object!=m_track && object!=m_chassis)
+                m_found = true;
+            return !m_found;
+        }   // process
+    };   // OtherObjectCallback
+    // ========================================================================
+    /** Collects the triangles of the BVH nodes that overlap. */
+    class TriangleCollector : public btNodeOverlapCallback
+    {
+    public:
+        btAlignedObjectArray<int> *m_triangles;
+        // --------------------------------------------------------------------
+        virtual void processNode(int sub_part, int triangle_index)
+        {
+            m_triangles->push_back(triangle_index);
+        }   // processNode
+    };   // TriangleCollector
+    // ========================================================================
+    /** Keeps the closest triangle hit. */
+    class ClosestTriangle : public btTriangleRaycastCallback
+    {
+    public:
+        btVector3 m_normal;
+        int       m_triangle_index;
+        // --------------------------------------------------------------------
+        ClosestTriangle(const btVector3 &from, const btVector3 &to)
+                      : btTriangleRaycastCallback(from, to)
+        {
+            m_triangle_index = -1;
+        }   // ClosestTriangle
+        // --------------------------------------------------------------------
+        virtual btScalar reportHit(const btVector3 &normal,
+                                   btScalar fraction, int part_id,
+                                   int triangle_index)
+        {
+            m_normal         = normal;
+            m_triangle_index = triangle_index;
+            return fraction;
+        }   // reportHit
+    };   // ClosestTriangle
+    // ========================================================================
+
+    const int num_wheels = wheels.size();
+    const TriangleMesh &tm = World::getWorld()->getTrack()->getTriangleMesh();
+    const btCollisionObject *track = tm.getCollisionObject();
+    const btOptimizedBvh *bvh = tm.getBvh();
+
+    btVector3 aabb_min = wheels[0].m_raycastInfo.m_hardPointWS;
+    btVector3 aabb_max = aabb_min;
+    for(int i=0; i<num_wheels; i++)
+    {
+        aabb_min.setMin(wheels[i].m_raycastInfo.m_hardPointWS);
+        aabb_max.setMax(wheels[i].m_raycastInfo.m_hardPointWS);
+        aabb_min.setMin(wheels[i].m_raycastInfo.m_contactPointWS);
+        aabb_max.setMax(wheels[i].m_raycastInfo.m_contactPointWS);
+    }
+
+    OtherObjectCallback other(track, chassis);
+    if(bvh)
+        m_dynamicsWorld->getBroadphase()->aabbTest(aabb_min, aabb_max, other);
+
+    if(!bvh || other.m_found)
+    {
+        for(int i=0; i<num_wheels; i++)
+        {
+            objects[i] = castRay(wheels[i].m_raycastInfo.m_hardPointWS,
+                                 wheels[i].m_raycastInfo.m_contactPointWS,
+                                 results[i]);
         }
+        return;
     }
-    return 0;
-}
 
+    m_triangles.resize(0);
+    TriangleCollector collector;
+    collector.m_triangles = &m_triangles;
+    bvh->reportAabbOverlappingNodex(&collector, aabb_min, aabb_max);
+
+    for(int i=0; i<num_wheels; i++)
+    {
+        const btVector3 &from = wheels[i].m_raycastInfo.m_hardPointWS;
+        const btVector3 &to   = wheels[i].m_raycastInfo.m_contactPointWS;
+        ClosestTriangle closest(from, to);
+        for(int j=0; j<m_triangles.size(); j++)
+        {
+            btVector3 triangle[3];
+            tm.getTriangle(m_triangles[j], &triangle[0], &triangle[1],
+                           &triangle[2]);
+            closest.processTriangle(triangle, 0, m_triangles[j]);
+        }
+        objects[i] = closest.m_triangle_index<0
+                   ? 0
+                   : setResult(track, from, to, closest.m_hitFraction,
+                               closest.m_normal, closest.m_triangle_index,
+                               results[i]);
+    }
+}   // castWheelRays
@@ -27,6 +27,15 @@ private:
     /** True if the normals should be smoothed. Not all tracks support this,
     *  so this flag is set depending on track when constructing this object. */
     bool                m_smooth_normals;
+
+    /** Indices of the track triangles close to the wheel rays, only used
+     *  in castWheelRays (but kept to avoid frequent memory allocations). */
+    btAlignedObjectArray<int> m_triangles;
+
+    void* setResult(const btCollisionObject *object, const btVector3 &from,
+                    const btVector3 &to, btScalar fraction,
+                    const btVector3 &normal, int triangle_index,
+                    btVehicleRaycasterResult& result) const;
 public:
     btKartRaycaster(btDynamicsWorld* world, bool smooth_normals=false)
         :m_dynamicsWorld(world), m_smooth_normals(smooth_normals)
@@ -35,6 +44,10 @@ public:
 
     virtual void* castRay(const btVector3& from,const btVector3& to,
                           btVehicleRaycasterResult& result);
+    void          castWheelRays(const btAlignedObjectArray<btWheelInfo> &wheels,
+                                const btCollisionObject *chassis,
+                                btVehicleRaycasterResult *results,
+                                void **objects);
 
 };
 
@@ -0,0 +1,295 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2014 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "physics/bvh_cache.hpp"
+
+#include "btBulletDynamicsCommon.h"
+#include "BulletCollision/CollisionShapes/btOptimizedBvh.h"
+
+#include "io/file_manager.hpp"
+#include "physics/triangle_mesh.hpp"
+#include "utils/log.hpp"
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef WIN32
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace
+{
+    /** Must be increased whenever the file format changes. */
+    const uint32_t BVH_CACHE_VERSION = 1;
+
+    /** Header of a cache file. Its size is a multiple of 16, so that the
+     *  serialized BVH following it is 16 byte aligned (as required by
+     *  bullet) in the mapped file. The values are stored in the byte order
+     *  of this machine, a cache from another machine is rejected because
+     *  of the version. */
+    struct BvhCacheHeader
+    {
+        char     m_magic[8];
+        uint32_t m_version;
+        uint32_t m_bullet_version;
+        uint32_t m_scalar_size;
+        uint32_t m_quantized;
+        uint32_t m_num_triangles;
+        uint32_t m_bvh_size;
+        uint64_t m_hash;
+        uint8_t  m_padding[24];
+    };   // BvhCacheHeader
+
+    const char BVH_CACHE_MAGIC[8] = {'S', 'T', 'K', 'B', 'V', 'H', 0, 0};
+
+    // ------------------------------------------------------------------------
+    /** Fills the header for the given mesh. */
+    void fillHeader(BvhCacheHeader *header, const TriangleMesh &mesh,
+                    bool quantized)
+    {
+        memset(header, 0, sizeof(BvhCacheHeader));
+        memcpy(header->m_magic, BVH_CACHE_MAGIC, sizeof(BVH_CACHE_MAGIC));
+        header->m_version        = BVH_CACHE_VERSION;
+        header->m_bullet_version = BT_BULLET_VERSION;
+        header->m_scalar_size    = sizeof(btScalar);
+        header->m_quantized      = quantized ? 1 : 0;
+        header->m_num_triangles  = mesh.getNumTriangles();
+        header->m_hash           = BvhCache::computeHash(mesh);
+    }   // fillHeader
+}   // namespace
+
+// ----------------------------------------------------------------------------
+BvhCache::BvhCache()
+{
+    m_data = NULL;
+    m_size = 0;
+#ifdef WIN32
+    m_file_handle    = NULL;
+    m_mapping_handle = NULL;
+#endif
+}   // BvhCache
+
+// ----------------------------------------------------------------------------
+/** Unmaps the file. The BVH loaded from it must not be used anymore. */
+BvhCache::~BvhCache()
+{
+    unmap();
+}   // ~BvhCache
+
+// ----------------------------------------------------------------------------
+/** Unmaps the file if one is mapped. */
+void BvhCache::unmap()
+{
+#ifdef WIN32
+    if (m_data)
+        UnmapViewOfFile(m_data);
+    if (m_mapping_handle)
+        CloseHandle(m_mapping_handle);
+    if (m_file_handle)
+        CloseHandle(m_file_handle);
+    m_mapping_handle = NULL;
+    m_file_handle    = NULL;
+#else
+    if (m_data)
+        munmap(m_data, m_size);
+#endif
+    m_data = NULL;
+    m_size = 0;
+}   // unmap
+
+// ----------------------------------------------------------------------------
+/** Returns the name of the cache file for a track.
+ *  \param track_ident Identifier of the track.
+ *  \param reverse True if the track is driven in reverse.
+ *  \param quantized True if the BVH uses quantized AABB compression.
+ */
+std::string BvhCache::getFilename(const std::string &track_ident,
+                                  bool reverse, bool quantized)
+{
+    return file_manager->getCachedTrackFile(track_ident
+                                            + (reverse   ? "-reverse"   : "")
+                                            + (quantized ? "-quantized" : "")
+                                            + ".bvh");
+}   // getFilename
+
+// ----------------------------------------------------------------------------
+/** Computes a hash (64 bit FNV-1a) of all vertices of the mesh, which is
+ *  used to detect if a cached BVH belongs to a modified track.
+ *  \param mesh The triangle mesh.
+ */
+uint64_t BvhCache::computeHash(const TriangleMesh &mesh)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned int i = 0; i < mesh.getNumTriangles(); i++)
+    {
+        btVector3 p[3];
+        mesh.getTriangle(i, &p[0], &p[1], &p[2]);
+        for (unsigned int j = 0; j < 3; j++)
+        {
+            // Only hash x, y, z: the 4th component is undefined
+            const uint8_t *bytes = (const uint8_t*)p[j].m_floats;
+            for (unsigned int k = 0; k < 3 * sizeof(btScalar); k++)
+            {
+                hash ^= bytes[k];
+                hash *= 1099511628211ULL;
+            }
+        }
+    }
+    return hash;
+}   // computeHash
+
+// ----------------------------------------------------------------------------
+/** Maps a cache file and deserializes the BVH stored in it.
+ *  \param filename Name of the cache file.
+ *  \param mesh The mesh for which the BVH is loaded.
+ *  \param quantized If the BVH should use quantized AABB compression.
+ *  \return The BVH, which uses the mapped data, or NULL if the file does
+ *          not exist or does not match the mesh.
+ */
+btOptimizedBvh* BvhCache::load(const std::string &filename,
+                               const TriangleMesh &mesh, bool quantized)
+{
+    unmap();
+#ifdef WIN32
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                              NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                              NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return NULL;
+    m_file_handle = file;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        unmap();
+        return NULL;
+    }
+    // Copy on write, bullet modifies the data when deserializing.
+    m_mapping_handle = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0,
+                                         NULL);
+    if (m_mapping_handle)
+        m_data = MapViewOfFile(m_mapping_handle, FILE_MAP_COPY, 0, 0, 0);
+    m_size = (size_t)size.QuadPart;
+#else
+    int file = open(filename.c_str(), O_RDONLY);
+    if (file < 0)
+        return NULL;
+    struct stat st;
+    if (fstat(file, &st) == 0 && st.st_size > 0)
+    {
+        // Copy on write, bullet modifies the data when deserializing.
+        m_size = (size_t)st.st_size;
+        m_data = mmap(NULL, m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                      file, 0);
+        if (m_data == MAP_FAILED)
+            m_data = NULL;
+    }
+    close(file);
+#endif
+    if (!m_data)
+    {
+        Log::warn("BvhCache", "Can not map '%s'.", filename.c_str());
+        unmap();
+        return NULL;
+    }
+
+    BvhCacheHeader expected;
+    fillHeader(&expected, mesh, quantized);
+    const BvhCacheHeader *header = (const BvhCacheHeader*)m_data;
+    if (m_size < sizeof(BvhCacheHeader) ||
+        memcmp(header->m_magic, expected.m_magic, sizeof(header->m_magic)) ||
+        header->m_version        != expected.m_version        ||
+        header->m_bullet_version != expected.m_bullet_version ||
+        header->m_scalar_size    != expected.m_scalar_size    ||
+        header->m_quantized      != expected.m_quantized      ||
+        header->m_num_triangles  != expected.m_num_triangles  ||
+        header->m_hash           != expected.m_hash           ||
+        header->m_bvh_size > m_size - sizeof(BvhCacheHeader)     )
+    {
+        Log::info("BvhCache", "'%s' does not match the track.",
+                  filename.c_str());
+        unmap();
+        return NULL;
+    }
+
+    btOptimizedBvh *bvh = btOptimizedBvh::deSerializeInPlace(
+                              (char*)m_data + sizeof(BvhCacheHeader),
+                              header->m_bvh_size, /*swap endian*/false);
+    if (!bvh)
+    {
+        Log::warn("BvhCache", "Can not deserialize '%s'.", filename.c_str());
+        unmap();
+        return NULL;
+    }
+    Log::info("BvhCache", "Loaded the BVH from '%s'.", filename.c_str());
+    return bvh;
+}   // load
+
+// ----------------------------------------------------------------------------
+/** Saves a BVH to a cache file. The file is written under a temporary name
+ *  first, so that an interrupted write does not leave a broken cache.
+ *  \param filename Name of the cache file.
+ *  \param mesh The mesh the BVH was built for.
+ *  \param quantized If the BVH uses quantized AABB compression.
+ *  \param bvh The BVH to save.
+ *  \return True if the cache file was written.
+ */
+bool BvhCache::save(const std::string &filename, const TriangleMesh &mesh,
+                    bool quantized, const btOptimizedBvh &bvh)
+{
+    BvhCacheHeader header;
+    fillHeader(&header, mesh, quantized);
+    header.m_bvh_size = bvh.calculateSerializeBufferSize();
+
+    void *buffer = btAlignedAlloc(header.m_bvh_size, 16);
+    if (!bvh.serializeInPlace(buffer, header.m_bvh_size,
+                              /*swap endian*/false))
+    {
+        Log::warn("BvhCache", "Can not serialize the BVH.");
+        btAlignedFree(buffer);
+        return false;
+    }
+
+    std::string tmp_filename = filename + ".tmp";
+    FILE *file = fopen(tmp_filename.c_str(), "wb");
+    bool ok = file != NULL;
+    if (file)
+    {
+        ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+             fwrite(buffer, header.m_bvh_size, 1, file) == 1;
+        ok = fclose(file) == 0 && ok;
+    }
+    btAlignedFree(buffer);
+
+    // rename does not overwrite existing files on windows
+    remove(filename.c_str());
+    if (!ok || rename(tmp_filename.c_str(), filename.c_str()) != 0)
+    {
+        Log::warn("BvhCache", "Can not write '%s'.", filename.c_str());
+        remove(tmp_filename.c_str());
+        return false;
+    }
+    Log::info("BvhCache", "Saved the BVH to '%s'.", filename.c_str());
+    return true;
+}   // save
+
+/* EOF */
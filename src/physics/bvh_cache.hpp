@@ -0,0 +1,76 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2014 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef HEADER_BVH_CACHE_HPP
+#define HEADER_BVH_CACHE_HPP
+
+#include "utils/no_copy.hpp"
+#include "utils/types.hpp"
+
+#include <string>
+
+class btOptimizedBvh;
+class TriangleMesh;
+
+/**
+ * \brief Stores the bounding volume hierarchy of a track's collision mesh
+ *  on disk, so that it does not need to be rebuilt each time the track is
+ *  loaded.
+ *  The file starts with a header containing a version (which includes the
+ *  bullet version and the size of btScalar), the number of triangles and a
+ *  hash of all triangle vertices, and the compression mode of the BVH. It
+ *  is followed by the BVH as serialized by bullet. The file is memory
+ *  mapped (copy on write) when loaded, and bullet uses the mapped data in
+ *  place, so the BvhCache object must exist as long as the BVH is used.
+ *  If the header does not match the mesh, the BVH must be rebuilt and
+ *  saved again. Quantized and unquantized BVHs are stored in different
+ *  files, since their serialized formats differ.
+ * \ingroup physics
+ */
+class BvhCache : public NoCopy
+{
+private:
+    /** Start of the mapped file, NULL if nothing is mapped. */
+    void   *m_data;
+
+    /** Size of the mapped file. */
+    size_t  m_size;
+
+#ifdef WIN32
+    /** Windows handles of the file and of its mapping. */
+    void   *m_file_handle;
+    void   *m_mapping_handle;
+#endif
+
+    void    unmap();
+
+public:
+             BvhCache();
+            ~BvhCache();
+    btOptimizedBvh* load(const std::string &filename,
+                         const TriangleMesh &mesh, bool quantized);
+    static bool     save(const std::string &filename,
+                         const TriangleMesh &mesh, bool quantized,
+                         const btOptimizedBvh &bvh);
+    static std::string getFilename(const std::string &track_ident,
+                                   bool reverse, bool quantized);
+    static uint64_t computeHash(const TriangleMesh &mesh);
+};   // BvhCache
+
+#endif
+/* EOF */
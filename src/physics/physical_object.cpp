@@ -33,6 +33,7 @@ using namespace irr;
 #include "tracks/track.hpp"
 #include "tracks/track_object.hpp"
 #include "utils/constants.hpp"
+#include "utils/snapshot_buffer.hpp"
 #include "utils/string_utils.hpp"
 
 #include <ISceneManager.h>
@@ -518,6 +519,39 @@ void PhysicalObject::reset()
     m_body->activate();
 }   // reset
 
+// ----------------------------------------------------------------------------
+/** Saves the transform and velocities of a dynamic object. Static and
+ *  kinematic objects are not moved by the physics, so nothing is saved.
+ *  \param buffer The snapshot buffer to write to.
+ */
+void PhysicalObject::saveState(SnapshotBuffer *buffer) const
+{
+    if(!m_is_dynamic) return;
+    buffer->add(m_body->getWorldTransform());
+    buffer->add(m_body->getLinearVelocity());
+    buffer->add(m_body->getAngularVelocity());
+}   // saveState
+
+// ----------------------------------------------------------------------------
+/** Restores the state saved with saveState.
+ *  \param buffer The snapshot buffer to read from.
+ */
+void PhysicalObject::restoreState(SnapshotBuffer *buffer)
+{
+    if(!m_is_dynamic) return;
+    btTransform t;
+    btVector3 linear_velocity, angular_velocity;
+    buffer->get(&t);
+    buffer->get(&linear_velocity);
+    buffer->get(&angular_velocity);
+    m_body->setCenterOfMassTransform(t);
+    m_body->setLinearVelocity(linear_velocity);
+    m_body->setAngularVelocity(angular_velocity);
+    m_body->clearForces();
+    m_motion_state->setWorldTransform(t);
+    m_body->activate();
+}   // restoreState
+
 // ----------------------------------------------------------------------------
 void PhysicalObject::handleExplosion(const Vec3& pos, bool direct_hit)
 {
@@ -29,6 +29,7 @@
 
 
 class Material;
+class SnapshotBuffer;
 class TrackObject;
 class XMLNode;
 
@@ -154,6 +155,8 @@ public:
     virtual     ~PhysicalObject ();
     virtual void reset          ();
     virtual void handleExplosion(const Vec3& pos, bool directHit);
+    void         saveState      (SnapshotBuffer *buffer) const;
+    void         restoreState   (SnapshotBuffer *buffer);
     void         update         (float dt);
     void         init           ();
     void         move           (const Vec3& xyz, const core::vector3df& hpr);
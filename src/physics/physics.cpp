@@ -22,6 +22,7 @@
 #include "animations/three_d_animation.hpp"
 #include "config/player_manager.hpp"
 #include "config/player_profile.hpp"
+#include "config/stk_config.hpp"
 #include "karts/abstract_kart.hpp"
 #include "graphics/irr_driver.hpp"
 #include "graphics/stars.hpp"
@@ -29,6 +30,7 @@
 #include "karts/kart_properties.hpp"
 #include "karts/rescue_animation.hpp"
 #include "karts/controller/player_controller.hpp"
+#include "main_loop.hpp"
 #include "modes/soccer_world.hpp"
 #include "modes/world.hpp"
 #include "karts/explosion_animation.hpp"
@@ -40,6 +42,7 @@
 #include "physics/triangle_mesh.hpp"
 #include "tracks/track.hpp"
 #include "utils/profiler.hpp"
+#include "utils/snapshot_buffer.hpp"
 
 // ----------------------------------------------------------------------------
 /** Initialise physics.
@@ -49,19 +52,88 @@ Physics::Physics() : btSequentialImpulseConstraintSolver()
 {
     m_collision_conf      = new btDefaultCollisionConfiguration();
     m_dispatcher          = new btCollisionDispatcher(m_collision_conf);
+
+    for(unsigned int i=0; i<UserPointer::UP_COUNT; i++)
+    {
+        for(unsigned int j=0; j<UserPointer::UP_COUNT; j++)
+        {
+            m_manifold_handler[i][j]  = NULL;
+            m_collision_handler[i][j] = NULL;
+            m_num_collisions[i][j]    = 0;
+        }
+    }
+
+    // Contact manifolds reported by bullet, indexed by the types of
+    // object A and B. Either the collision is handled immediately (e.g.
+    // kart hits track), or a collision pair is stored for update. The
+    // pairs are sorted so that a projectile is always first, then a
+    // physical object or animation, and then a kart.
+    m_manifold_handler[UserPointer::UP_TRACK][UserPointer::UP_FLYABLE]
+        = &Physics::addCollisionBA;
+    m_manifold_handler[UserPointer::UP_TRACK][UserPointer::UP_KART]
+        = &Physics::trackHitsKart;
+    m_manifold_handler[UserPointer::UP_TRACK][UserPointer::UP_PHYSICAL_OBJECT]
+        = &Physics::trackHitsObject;
+    m_manifold_handler[UserPointer::UP_KART][UserPointer::UP_TRACK]
+        = &Physics::kartHitsTrack;
+    m_manifold_handler[UserPointer::UP_KART][UserPointer::UP_FLYABLE]
+        = &Physics::addCollisionBA;
+    m_manifold_handler[UserPointer::UP_KART][UserPointer::UP_KART]
+        = &Physics::addCollisionAB;
+    m_manifold_handler[UserPointer::UP_KART][UserPointer::UP_PHYSICAL_OBJECT]
+        = &Physics::addCollisionBA;
+    m_manifold_handler[UserPointer::UP_KART][UserPointer::UP_ANIMATION]
+        = &Physics::addCollisionBA;
+    m_manifold_handler[UserPointer::UP_FLYABLE][UserPointer::UP_TRACK]
+        = &Physics::addCollisionAB;
+    m_manifold_handler[UserPointer::UP_FLYABLE][UserPointer::UP_FLYABLE]
+        = &Physics::addCollisionAB;
+    m_manifold_handler[UserPointer::UP_FLYABLE][UserPointer::UP_PHYSICAL_OBJECT]
+        = &Physics::addCollisionAB;
+    m_manifold_handler[UserPointer::UP_FLYABLE][UserPointer::UP_KART]
+        = &Physics::addCollisionAB;
+    m_manifold_handler[UserPointer::UP_PHYSICAL_OBJECT][UserPointer::UP_FLYABLE]
+        = &Physics::addCollisionBA;
+    m_manifold_handler[UserPointer::UP_PHYSICAL_OBJECT][UserPointer::UP_KART]
+        = &Physics::addCollisionAB;
+    m_manifold_handler[UserPointer::UP_PHYSICAL_OBJECT][UserPointer::UP_TRACK]
+        = &Physics::objectHitsTrack;
+    m_manifold_handler[UserPointer::UP_ANIMATION][UserPointer::UP_KART]
+        = &Physics::addCollisionAB;
+
+    // The stored collision pairs, indexed by the types of the first and
+    // second object of the pair.
+    m_collision_handler[UserPointer::UP_KART][UserPointer::UP_KART]
+        = &Physics::handleKartKart;
+    m_collision_handler[UserPointer::UP_PHYSICAL_OBJECT][UserPointer::UP_KART]
+        = &Physics::handleObjectKart;
+    m_collision_handler[UserPointer::UP_ANIMATION][UserPointer::UP_KART]
+        = &Physics::handleAnimationKart;
+    m_collision_handler[UserPointer::UP_FLYABLE][UserPointer::UP_TRACK]
+        = &Physics::handleFlyableTrack;
+    m_collision_handler[UserPointer::UP_FLYABLE]
+                       [UserPointer::UP_PHYSICAL_OBJECT]
+        = &Physics::handleFlyableObject;
+    m_collision_handler[UserPointer::UP_FLYABLE][UserPointer::UP_KART]
+        = &Physics::handleFlyableKart;
+    m_collision_handler[UserPointer::UP_FLYABLE][UserPointer::UP_FLYABLE]
+        = &Physics::handleFlyableFlyable;
 }   // Physics
 
 //-----------------------------------------------------------------------------
 /** The actual initialisation of the physics, which is called after the track
  *  model is loaded. This allows the physics to use the actual track dimension
- *  for the axis sweep.
+ *  for the axis sweep. The broadphase is selected in stk_config.
  */
 void Physics::init(const Vec3 &world_min, const Vec3 &world_max)
 {
     m_physics_loop_active = false;
-    m_axis_sweep          = new btAxisSweep3(world_min, world_max);
+    if(stk_config->m_broadphase==STKConfig::BROADPHASE_DBVT)
+        m_broadphase = new btDbvtBroadphase();
+    else
+        m_broadphase = new btAxisSweep3(world_min, world_max);
     m_dynamics_world      = new STKDynamicsWorld(m_dispatcher,
-                                                 m_axis_sweep,
+                                                 m_broadphase,
                                                  this,
                                                  m_collision_conf);
     m_karts_to_delete.clear();
@@ -78,11 +150,38 @@ Physics::~Physics()
 {
     delete m_debug_drawer;
     delete m_dynamics_world;
-    delete m_axis_sweep;
+    delete m_broadphase;
     delete m_dispatcher;
     delete m_collision_conf;
 }   // ~Physics
 
+// ----------------------------------------------------------------------------
+/** Saves the state of the physics world itself. The state of the rigid
+ *  bodies is saved by the objects that own them.
+ *  \param buffer The snapshot buffer to write to.
+ */
+void Physics::saveState(SnapshotBuffer *buffer) const
+{
+    buffer->add(m_dynamics_world->getLocalTime());
+}   // saveState
+
+// ----------------------------------------------------------------------------
+/** Restores the state of the physics world. The cached contact points
+ *  refer to the positions before the restore, so they are removed and
+ *  will be recomputed in the next step.
+ *  \param buffer The snapshot buffer to read from.
+ */
+void Physics::restoreState(SnapshotBuffer *buffer)
+{
+    btScalar local_time;
+    buffer->get(&local_time);
+    m_dynamics_world->setLocalTime(local_time);
+
+    for(int i=0; i<m_dispatcher->getNumManifolds(); i++)
+        m_dispatcher->getManifoldByIndexInternal(i)->clearManifold();
+    m_all_collisions.clear();
+}   // restoreState
+
 // ----------------------------------------------------------------------------
 /** Adds a kart to the physics engine.
  *  This adds the rigid body, the vehicle, and the upright constraint, but only
@@ -150,148 +249,32 @@ void Physics::update(float dt)
     // of objects.
     m_all_collisions.clear();
 
-    // Maximum of three substeps. This will work for framerate down to
-    // 20 FPS (bullet default frequency is 60 HZ).
-    m_dynamics_world->stepSimulation(dt, 3);
+    // With a fixed time step (see MainLoop::updateRace) do exactly one
+    // bullet step of that size. Otherwise use a maximum of three substeps.
+    // This will work for framerate down to 20 FPS (bullet default
+    // frequency is 60 HZ).
+    if(main_loop && main_loop->isFixedTimeStep())
+        m_dynamics_world->stepSimulation(dt, 1, dt);
+    else
+        m_dynamics_world->stepSimulation(dt, 3);
 
     // Now handle the actual collision. Note: flyables can not be removed
     // inside of this loop, since the same flyables might hit more than one
     // other object. So only a flag is set in the flyables, the actual
     // clean up is then done later in the projectile manager.
+    PROFILER_PUSH_CPU_MARKER("Collisions", 0x7F, 0x7F, 0x00);
     std::vector<CollisionPair>::iterator p;
     for(p=m_all_collisions.begin(); p!=m_all_collisions.end(); ++p)
     {
-        // Kart-kart collision
-        // --------------------
-        if(p->getUserPointer(0)->is(UserPointer::UP_KART))
-        {
-            KartKartCollision(p->getUserPointer(0)->getPointerKart(),
-                              p->getContactPointCS(0),
-                              p->getUserPointer(1)->getPointerKart(),
-                              p->getContactPointCS(1)                );
-            continue;
-        }  // if kart-kart collision
-
-        if(p->getUserPointer(0)->is(UserPointer::UP_PHYSICAL_OBJECT))
-        {
-            // Kart hits physical object
-            // -------------------------
-            PhysicalObject *obj = p->getUserPointer(0)
-                                   ->getPointerPhysicalObject();
-            if(obj->isCrashReset())
-            {
-                AbstractKart *kart = p->getUserPointer(1)->getPointerKart();
-                new RescueAnimation(kart);
-            }
-            else if (obj->isExplodeKartObject())
-            {
-                AbstractKart *kart = p->getUserPointer(1)->getPointerKart();
-                ExplosionAnimation::create(kart);
-            }
-            else if (obj->isFlattenKartObject())
-            {
-                AbstractKart *kart = p->getUserPointer(1)->getPointerKart();
-                const KartProperties* kp = kart->getKartProperties();
-                kart->setSquash(kp->getSquashDuration(), kp->getSquashSlowdown());
-            }
-            else if(obj->isSoccerBall())
-            {
-                int kartId = p->getUserPointer(1)->getPointerKart()->getWorldKartId();
-                SoccerWorld* soccerWorld = (SoccerWorld*)World::getWorld();
-                soccerWorld->setLastKartTohitBall(kartId);
-            }
-            continue;
-        }
-
-        if(p->getUserPointer(0)->is(UserPointer::UP_ANIMATION))
-        {
-            // Kart hits animation
-            ThreeDAnimation *anim=p->getUserPointer(0)->getPointerAnimation();
-            if(anim->isCrashReset())
-            {
-                AbstractKart *kart = p->getUserPointer(1)->getPointerKart();
-                new RescueAnimation(kart);
-            }
-            else if (anim->isExplodeKartObject())
-            {
-                AbstractKart *kart = p->getUserPointer(1)->getPointerKart();
-                ExplosionAnimation::create(kart);
-            }
-            else if (anim->isFlattenKartObject())
-            {
-                AbstractKart *kart = p->getUserPointer(1)->getPointerKart();
-                const KartProperties* kp = kart->getKartProperties();
-                kart->setSquash(kp->getSquashDuration(), kp->getSquashSlowdown());
-            }
-            continue;
-
-        }
-        // now the first object must be a projectile
-        // =========================================
-        if(p->getUserPointer(1)->is(UserPointer::UP_TRACK))
-        {
-            // Projectile hits track
-            // ---------------------
-            p->getUserPointer(0)->getPointerFlyable()->hitTrack();
-        }
-        else if(p->getUserPointer(1)->is(UserPointer::UP_PHYSICAL_OBJECT))
-        {
-            // Projectile hits physical object
-            // -------------------------------
-            p->getUserPointer(0)->getPointerFlyable()
-                ->hit(NULL, p->getUserPointer(1)->getPointerPhysicalObject());
-            PhysicalObject* obj = p->getUserPointer(1)->getPointerPhysicalObject();
-            if(obj->isSoccerBall())
-            {
-                int kartId = p->getUserPointer(0)->getPointerFlyable()->getOwnerId();
-                SoccerWorld* soccerWorld = (SoccerWorld*)World::getWorld();
-                soccerWorld->setLastKartTohitBall(kartId);
-            }
-
-        }
-        else if(p->getUserPointer(1)->is(UserPointer::UP_KART))
-        {
-            // Projectile hits kart
-            // --------------------
-            // Only explode a bowling ball if the target is
-            // not invulnerable
-            AbstractKart* target_kart = p->getUserPointer(1)->getPointerKart();
-            PowerupManager::PowerupType type = p->getUserPointer(0)->getPointerFlyable()->getType();
-            if(type != PowerupManager::POWERUP_BOWLING || !target_kart->isInvulnerable())
-            {
-                Flyable *f = p->getUserPointer(0)->getPointerFlyable();
-                f->hit(target_kart);
-
-                // Check for achievements
-                AbstractKart * kart = World::getWorld()->getKart(f->getOwnerId());
-                PlayerController *c = dynamic_cast<PlayerController*>(kart->getController());
-
-                // Check that it's not a kart hitting itself (this can
-                // happen at the time a flyable is shot - release too close
-                // to the kart, and it's the current player. At this stage
-                // only the current player can get achievements.
-                if (target_kart != kart && c &&
-                    c->getPlayer()->getConstProfile() == PlayerManager::get()->getCurrentPlayer())
-                {
-                    PlayerManager::increaseAchievement(AchievementInfo::ACHIEVE_ARCH_ENEMY,
-                                                       target_kart->getIdent(), 1);
-                    if (type == PowerupManager::POWERUP_BOWLING)
-                    {
-                        PlayerManager::increaseAchievement(AchievementInfo::ACHIEVE_STRIKE, 
-                                                          "ball", 1);
-                    }   // is bowling ball
-                }   // if target_kart != kart && is a player kart and is current player
-            }
-
-        }
-        else
-        {
-            // Projectile hits projectile
-            // --------------------------
-            p->getUserPointer(0)->getPointerFlyable()->hit(NULL);
-            p->getUserPointer(1)->getPointerFlyable()->hit(NULL);
-        }
+        UserPointer::UserPointerType a = p->getUserPointer(0)->getType();
+        UserPointer::UserPointerType b = p->getUserPointer(1)->getType();
+        CollisionHandler handler = m_collision_handler[a][b];
+        assert(handler);
+        if(!handler) continue;
+        m_num_collisions[a][b]++;
+        (this->*handler)(*p);
     }  // for all p in m_all_collisions
+    PROFILER_POP_CPU_MARKER();
 
     m_physics_loop_active = false;
     // Now remove the karts that were removed while the above loop
@@ -304,6 +287,148 @@ void Physics::update(float dt)
     PROFILER_POP_CPU_MARKER();
 }   // update
 
+//-----------------------------------------------------------------------------
+/** Kart-kart collision: passes on bombs and pushes the karts apart.
+ *  \param p The collision pair, both objects are karts.
+ */
+void Physics::handleKartKart(const CollisionPair &p)
+{
+    KartKartCollision(p.getUserPointer(0)->getPointerKart(),
+                      p.getContactPointCS(0),
+                      p.getUserPointer(1)->getPointerKart(),
+                      p.getContactPointCS(1)                );
+}   // handleKartKart
+
+//-----------------------------------------------------------------------------
+/** Kart hits physical object.
+ *  \param p The collision pair, the first object is the physical object,
+ *         the second one the kart.
+ */
+void Physics::handleObjectKart(const CollisionPair &p)
+{
+    PhysicalObject *obj = p.getUserPointer(0)->getPointerPhysicalObject();
+    AbstractKart  *kart = p.getUserPointer(1)->getPointerKart();
+    if(obj->isCrashReset())
+    {
+        new RescueAnimation(kart);
+    }
+    else if (obj->isExplodeKartObject())
+    {
+        ExplosionAnimation::create(kart);
+    }
+    else if (obj->isFlattenKartObject())
+    {
+        const KartProperties* kp = kart->getKartProperties();
+        kart->setSquash(kp->getSquashDuration(), kp->getSquashSlowdown());
+    }
+    else if(obj->isSoccerBall())
+    {
+        SoccerWorld* soccerWorld = (SoccerWorld*)World::getWorld();
+        soccerWorld->setLastKartTohitBall(kart->getWorldKartId());
+    }
+}   // handleObjectKart
+
+//-----------------------------------------------------------------------------
+/** Kart hits animation.
+ *  \param p The collision pair, the first object is the animation, the
+ *         second one the kart.
+ */
+void Physics::handleAnimationKart(const CollisionPair &p)
+{
+    ThreeDAnimation *anim = p.getUserPointer(0)->getPointerAnimation();
+    AbstractKart    *kart = p.getUserPointer(1)->getPointerKart();
+    if(anim->isCrashReset())
+    {
+        new RescueAnimation(kart);
+    }
+    else if (anim->isExplodeKartObject())
+    {
+        ExplosionAnimation::create(kart);
+    }
+    else if (anim->isFlattenKartObject())
+    {
+        const KartProperties* kp = kart->getKartProperties();
+        kart->setSquash(kp->getSquashDuration(), kp->getSquashSlowdown());
+    }
+}   // handleAnimationKart
+
+//-----------------------------------------------------------------------------
+/** Projectile hits track.
+ *  \param p The collision pair, the first object is the projectile.
+ */
+void Physics::handleFlyableTrack(const CollisionPair &p)
+{
+    p.getUserPointer(0)->getPointerFlyable()->hitTrack();
+}   // handleFlyableTrack
+
+//-----------------------------------------------------------------------------
+/** Projectile hits physical object.
+ *  \param p The collision pair, the first object is the projectile, the
+ *         second one the physical object.
+ */
+void Physics::handleFlyableObject(const CollisionPair &p)
+{
+    Flyable        *flyable = p.getUserPointer(0)->getPointerFlyable();
+    PhysicalObject *obj     = p.getUserPointer(1)->getPointerPhysicalObject();
+    flyable->hit(NULL, obj);
+    if(obj->isSoccerBall())
+    {
+        SoccerWorld* soccerWorld = (SoccerWorld*)World::getWorld();
+        soccerWorld->setLastKartTohitBall(flyable->getOwnerId());
+    }
+}   // handleFlyableObject
+
+//-----------------------------------------------------------------------------
+/** Projectile hits kart. A bowling ball only explodes if the target is
+ *  not invulnerable. This also checks for achievements.
+ *  \param p The collision pair, the first object is the projectile, the
+ *         second one the kart.
+ */
+void Physics::handleFlyableKart(const CollisionPair &p)
+{
+    Flyable      *f           = p.getUserPointer(0)->getPointerFlyable();
+    AbstractKart *target_kart = p.getUserPointer(1)->getPointerKart();
+    PowerupManager::PowerupType type = f->getType();
+    if(type == PowerupManager::POWERUP_BOWLING &&
+       target_kart->isInvulnerable())
+        return;
+
+    f->hit(target_kart);
+
+    // Check for achievements
+    AbstractKart *kart = World::getWorld()->getKart(f->getOwnerId());
+
+    // Check that it's not a kart hitting itself (this can happen at the
+    // time a flyable is shot - release too close to the kart), and that
+    // the owner is a player that is still racing (a finished player uses
+    // an EndController), and it's the current player. At this stage
+    // only the current player can get achievements.
+    if(target_kart == kart || kart->hasFinishedRace()) return;
+    Controller *c = kart->getController();
+    if(!c->isPlayerController() || !c->getPlayer() ||
+       c->getPlayer()->getConstProfile()
+                                   != PlayerManager::get()->getCurrentPlayer())
+        return;
+
+    PlayerManager::increaseAchievement(AchievementInfo::ACHIEVE_ARCH_ENEMY,
+                                       target_kart->getIdent(), 1);
+    if (type == PowerupManager::POWERUP_BOWLING)
+    {
+        PlayerManager::increaseAchievement(AchievementInfo::ACHIEVE_STRIKE,
+                                           "ball", 1);
+    }   // is bowling ball
+}   // handleFlyableKart
+
+//-----------------------------------------------------------------------------
+/** Projectile hits projectile.
+ *  \param p The collision pair, both objects are projectiles.
+ */
+void Physics::handleFlyableFlyable(const CollisionPair &p)
+{
+    p.getUserPointer(0)->getPointerFlyable()->hit(NULL);
+    p.getUserPointer(1)->getPointerFlyable()->hit(NULL);
+}   // handleFlyableFlyable
+
 //-----------------------------------------------------------------------------
 /** Handles the special case of two karts colliding with each other, which
  *  means that bombs must be passed on. If both karts have a bomb, they'll
@@ -489,129 +614,112 @@ btScalar Physics::solveGroup(btCollisionObject** bodies, int numBodies,
 
         if(!upA || !upB) continue;
 
-        // 1) object A is a track
-        // =======================
-        if(upA->is(UserPointer::UP_TRACK))
-        {
-            if(upB->is(UserPointer::UP_FLYABLE))   // 1.1 projectile hits track
-                m_all_collisions.push_back(
-                    upB, contact_manifold->getContactPoint(0).m_localPointB,
-                    upA, contact_manifold->getContactPoint(0).m_localPointA);
-            else if(upB->is(UserPointer::UP_KART))
-            {
-                AbstractKart *kart=upB->getPointerKart();
-                int n = contact_manifold->getContactPoint(0).m_index0;
-                const Material *m
-                    = n>=0 ? upA->getPointerTriangleMesh()->getMaterial(n)
-                           : NULL;
-                // I assume that the normal needs to be flipped in this case,
-                // but  I can't verify this since it appears that bullet
-                // always has the kart as object A, not B.
-                const btVector3 &normal = -contact_manifold->getContactPoint(0)
-                                                            .m_normalWorldOnB;
-                kart->crashed(m, normal);
-            }
-            else if(upB->is(UserPointer::UP_PHYSICAL_OBJECT))
-            {
-                int n = contact_manifold->getContactPoint(0).m_index1;
-                const Material *m
-                    = n>=0 ? upA->getPointerTriangleMesh()->getMaterial(n)
-                           : NULL;
-                const btVector3 &normal = contact_manifold->getContactPoint(0)
-                                                           .m_normalWorldOnB;
-                upB->getPointerPhysicalObject()->hit(m, normal);
-            }
-        }
-        // 2) object a is a kart
-        // =====================
-        else if(upA->is(UserPointer::UP_KART))
-        {
-            if(upB->is(UserPointer::UP_TRACK))
-            {
-                AbstractKart *kart = upA->getPointerKart();
-                int n = contact_manifold->getContactPoint(0).m_index1;
-                const Material *m
-                    = n>=0 ? upB->getPointerTriangleMesh()->getMaterial(n)
-                           : NULL;
-                const btVector3 &normal = contact_manifold->getContactPoint(0)
-                                                           .m_normalWorldOnB;
-                kart->crashed(m, normal);   // Kart hit track
-            }
-            else if(upB->is(UserPointer::UP_FLYABLE))
-                // 2.1 projectile hits kart
-                m_all_collisions.push_back(
-                    upB, contact_manifold->getContactPoint(0).m_localPointB,
-                    upA, contact_manifold->getContactPoint(0).m_localPointA);
-            else if(upB->is(UserPointer::UP_KART))
-                // 2.2 kart hits kart
-                m_all_collisions.push_back(
-                    upA, contact_manifold->getContactPoint(0).m_localPointA,
-                    upB, contact_manifold->getContactPoint(0).m_localPointB);
-            else if(upB->is(UserPointer::UP_PHYSICAL_OBJECT))
-                // 2.3 kart hits physical object
-                m_all_collisions.push_back(
-                    upB, contact_manifold->getContactPoint(0).m_localPointB,
-                    upA, contact_manifold->getContactPoint(0).m_localPointA);
-            else if(upB->is(UserPointer::UP_ANIMATION))
-                m_all_collisions.push_back(
-                    upB, contact_manifold->getContactPoint(0).m_localPointB,
-                    upA, contact_manifold->getContactPoint(0).m_localPointA);
-        }
-        // 3) object is a projectile
-        // =========================
-        else if(upA->is(UserPointer::UP_FLYABLE))
-        {
-            // 3.1) projectile hits track
-            // 3.2) projectile hits projectile
-            // 3.3) projectile hits physical object
-            // 3.4) projectile hits kart
-            if(upB->is(UserPointer::UP_TRACK          ) ||
-               upB->is(UserPointer::UP_FLYABLE        ) ||
-               upB->is(UserPointer::UP_PHYSICAL_OBJECT) ||
-               upB->is(UserPointer::UP_KART           )   )
-            {
-                m_all_collisions.push_back(
-                    upA, contact_manifold->getContactPoint(0).m_localPointA,
-                    upB, contact_manifold->getContactPoint(0).m_localPointB);
-            }
-        }
-        // Object is a physical object
-        // ===========================
-        else if(upA->is(UserPointer::UP_PHYSICAL_OBJECT))
-        {
-            if(upB->is(UserPointer::UP_FLYABLE))
-                m_all_collisions.push_back(
-                    upB, contact_manifold->getContactPoint(0).m_localPointB,
-                    upA, contact_manifold->getContactPoint(0).m_localPointA);
-            else if(upB->is(UserPointer::UP_KART))
-                m_all_collisions.push_back(
-                    upA, contact_manifold->getContactPoint(0).m_localPointA,
-                    upB, contact_manifold->getContactPoint(0).m_localPointB);
-            else if(upB->is(UserPointer::UP_TRACK))
-            {
-                int n = contact_manifold->getContactPoint(0).m_index1;
-                const Material *m
-                    = n>=0 ? upB->getPointerTriangleMesh()->getMaterial(n)
-                           : NULL;
-                const btVector3 &normal = contact_manifold->getContactPoint(0)
-                                                           .m_normalWorldOnB;
-                upA->getPointerPhysicalObject()->hit(m, normal);
-            }
-        }
-        else if (upA->is(UserPointer::UP_ANIMATION))
-        {
-            if(upB->is(UserPointer::UP_KART))
-                m_all_collisions.push_back(
-                    upA, contact_manifold->getContactPoint(0).m_localPointA,
-                    upB, contact_manifold->getContactPoint(0).m_localPointB);
-        }
-        else
-            assert("Unknown user pointer");           // 4) Should never happen
+        ManifoldHandler handler =
+            m_manifold_handler[upA->getType()][upB->getType()];
+        if(handler)
+            (this->*handler)(upA, upB, contact_manifold);
     }   // for i<numManifolds
 
     return returnValue;
 }   // solveGroup
 
+// ----------------------------------------------------------------------------
+/** Stores a collision pair with object A first, e.g. a projectile (A)
+ *  hitting a kart (B).
+ *  \param up_a User pointer of object A of the manifold.
+ *  \param up_b User pointer of object B of the manifold.
+ *  \param manifold The contact manifold.
+ */
+void Physics::addCollisionAB(const UserPointer *up_a, const UserPointer *up_b,
+                             const btPersistentManifold *manifold)
+{
+    const btManifoldPoint &cp = manifold->getContactPoint(0);
+    m_all_collisions.push_back(up_a, cp.m_localPointA,
+                               up_b, cp.m_localPointB);
+}   // addCollisionAB
+
+// ----------------------------------------------------------------------------
+/** Stores a collision pair with object B first, e.g. a kart (A) hitting
+ *  a projectile (B).
+ *  \param up_a User pointer of object A of the manifold.
+ *  \param up_b User pointer of object B of the manifold.
+ *  \param manifold The contact manifold.
+ */
+void Physics::addCollisionBA(const UserPointer *up_a, const UserPointer *up_b,
+                             const btPersistentManifold *manifold)
+{
+    const btManifoldPoint &cp = manifold->getContactPoint(0);
+    m_all_collisions.push_back(up_b, cp.m_localPointB,
+                               up_a, cp.m_localPointA);
+}   // addCollisionBA
+
+// ----------------------------------------------------------------------------
+/** Track (A) hits a kart (B).
+ *  \param up_a User pointer of the track.
+ *  \param up_b User pointer of the kart.
+ *  \param manifold The contact manifold.
+ */
+void Physics::trackHitsKart(const UserPointer *up_a, const UserPointer *up_b,
+                            const btPersistentManifold *manifold)
+{
+    const btManifoldPoint &cp = manifold->getContactPoint(0);
+    int n = cp.m_index0;
+    const Material *m = n>=0 ? up_a->getPointerTriangleMesh()->getMaterial(n)
+                             : NULL;
+    // I assume that the normal needs to be flipped in this case,
+    // but  I can't verify this since it appears that bullet
+    // always has the kart as object A, not B.
+    up_b->getPointerKart()->crashed(m, -cp.m_normalWorldOnB);
+}   // trackHitsKart
+
+// ----------------------------------------------------------------------------
+/** Track (A) hits a physical object (B).
+ *  \param up_a User pointer of the track.
+ *  \param up_b User pointer of the physical object.
+ *  \param manifold The contact manifold.
+ */
+void Physics::trackHitsObject(const UserPointer *up_a, const UserPointer *up_b,
+                              const btPersistentManifold *manifold)
+{
+    const btManifoldPoint &cp = manifold->getContactPoint(0);
+    int n = cp.m_index1;
+    const Material *m = n>=0 ? up_a->getPointerTriangleMesh()->getMaterial(n)
+                             : NULL;
+    up_b->getPointerPhysicalObject()->hit(m, cp.m_normalWorldOnB);
+}   // trackHitsObject
+
+// ----------------------------------------------------------------------------
+/** Kart (A) hits the track (B).
+ *  \param up_a User pointer of the kart.
+ *  \param up_b User pointer of the track.
+ *  \param manifold The contact manifold.
+ */
+void Physics::kartHitsTrack(const UserPointer *up_a, const UserPointer *up_b,
+                            const btPersistentManifold *manifold)
+{
+    const btManifoldPoint &cp = manifold->getContactPoint(0);
+    int n = cp.m_index1;
+    const Material *m = n>=0 ? up_b->getPointerTriangleMesh()->getMaterial(n)
+                             : NULL;
+    up_a->getPointerKart()->crashed(m, cp.m_normalWorldOnB);
+}   // kartHitsTrack
+
+// ----------------------------------------------------------------------------
+/** Physical object (A) hits the track (B).
+ *  \param up_a User pointer of the physical object.
+ *  \param up_b User pointer of the track.
+ *  \param manifold The contact manifold.
+ */
+void Physics::objectHitsTrack(const UserPointer *up_a, const UserPointer *up_b,
+                              const btPersistentManifold *manifold)
+{
+    const btManifoldPoint &cp = manifold->getContactPoint(0);
+    int n = cp.m_index1;
+    const Material *m = n>=0 ? up_b->getPointerTriangleMesh()->getMaterial(n)
+                             : NULL;
+    up_a->getPointerPhysicalObject()->hit(m, cp.m_normalWorldOnB);
+}   // objectHitsTrack
+
 // ----------------------------------------------------------------------------
 /** A debug draw function to show the track and all karts.
  */
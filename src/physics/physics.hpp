@@ -24,6 +24,7 @@
   * Contains various physics utilities.
   */
 
+#include <algorithm>
 #include <set>
 #include <vector>
 
@@ -34,6 +35,7 @@
 #include "physics/user_pointer.hpp"
 
 class AbstractKart;
+class SnapshotBuffer;
 class STKDynamicsWorld;
 class Vec3;
 
@@ -51,8 +53,8 @@ private:
      *  of objects.
      *  While this is a natural application of std::set, the set has some
      *  overhead (since it will likely use a tree to sort the entries).
-     *  Considering that the number of collisions is usually rather small
-     *  a simple list and linear search is faster is is being used here. */
+     *  Instead a vector is used, together with a small hash table to
+     *  detect duplicates (see CollisionList). */
     class CollisionPair {
     private:
         /** The user pointer of the objects involved in this collision. */
@@ -102,18 +104,66 @@ private:
 
     // ========================================================================
     // This class is the list of collision objects, where each collision
-    // pair is stored as most once.
+    // pair is stored as most once. Duplicates are found with a hash table
+    // (open addressing) instead of a linear search, since in battle and
+    // soccer mode there can be many collisions at the same time.
     class CollisionList : public std::vector<CollisionPair>
     {
     private:
+        /** For each slot the index+1 of the collision pair stored in it,
+         *  or 0 if the slot is empty. The size is a power of 2, and at
+         *  least twice the number of pairs. */
+        std::vector<unsigned int> m_hash_table;
+        // --------------------------------------------------------------------
+        /** Returns the hash value of a collision pair. */
+        static unsigned int hash(const CollisionPair &p)
+        {
+            size_t a = (size_t)p.getUserPointer(0);
+            size_t b = (size_t)p.getUserPointer(1);
+            unsigned int h = (unsigned int)((a>>3)*31 + (b>>3));
+            h ^= h >> 16;
+            h *= 0x45d9f3b;
+            h ^= h >> 16;
+            return h;
+        }   // hash
+        // --------------------------------------------------------------------
+        /** Returns the slot in the hash table which either contains the
+         *  pair, or is the empty slot in which it is to be stored. */
+        unsigned int findSlot(const CollisionPair &p)
+        {
+            unsigned int mask = m_hash_table.size()-1;
+            unsigned int slot = hash(p) & mask;
+            while(m_hash_table[slot] && !((*this)[m_hash_table[slot]-1]==p))
+                slot = (slot+1) & mask;
+            return slot;
+        }   // findSlot
+        // --------------------------------------------------------------------
+        /** Resizes the hash table and inserts all pairs again. */
+        void rehash(unsigned int n)
+        {
+            m_hash_table.assign(n, 0);
+            for(unsigned int i=0; i<size(); i++)
+                m_hash_table[findSlot((*this)[i])] = i+1;
+        }   // rehash
+        // --------------------------------------------------------------------
         void push_back(CollisionPair p) {
+            if(2*(size()+1) > m_hash_table.size())
+                rehash(m_hash_table.empty() ? 64 : 2*m_hash_table.size());
             // only add a pair if it's not already in there
-            for(iterator i=begin(); i!=end(); i++) {
-                if((*i)==p) return;
-            }
+            unsigned int slot = findSlot(p);
+            if(m_hash_table[slot]) return;
             std::vector<CollisionPair>::push_back(p);
+            m_hash_table[slot] = size();
         };  // push_back
     public:
+        /** Removes all collisions, but keeps the allocated memory. */
+        void clear()
+        {
+            if(empty()) return;
+            std::vector<CollisionPair>::clear();
+            std::fill(m_hash_table.begin(), m_hash_table.end(), 0);
+        }   // clear
+        // --------------------------------------------------------------------
         /** Adds information about a collision to this vector. */
         void push_back(const UserPointer *a, const btVector3 &contact_point_a,
                        const UserPointer *b, const btVector3 &contact_point_b)
@@ -141,10 +191,60 @@ private:
     /** Used in physics debugging to draw the physics world. */
     IrrDebugDrawer                  *m_debug_drawer;
     btCollisionDispatcher           *m_dispatcher;
-    btBroadphaseInterface           *m_axis_sweep;
+    btBroadphaseInterface           *m_broadphase;
     btDefaultCollisionConfiguration *m_collision_conf;
     CollisionList                    m_all_collisions;
 
+    /** A function that handles the contact manifold of two objects as
+     *  reported by bullet in solveGroup. */
+    typedef void (Physics::*ManifoldHandler)(const UserPointer *up_a,
+                                             const UserPointer *up_b,
+                                      const btPersistentManifold *manifold);
+
+    /** A function that handles a collision pair in update. */
+    typedef void (Physics::*CollisionHandler)(const CollisionPair &p);
+
+    /** The manifold handler for each combination of the user pointer types
+     *  of the two objects, NULL if nothing needs to be done. */
+    ManifoldHandler  m_manifold_handler[UserPointer::UP_COUNT]
+                                       [UserPointer::UP_COUNT];
+
+    /** The collision handler for each combination of the user pointer
+     *  types of a collision pair, NULL if nothing needs to be done. */
+    CollisionHandler m_collision_handler[UserPointer::UP_COUNT]
+                                        [UserPointer::UP_COUNT];
+
+    /** Number of handled collision pairs for each combination of the
+     *  user pointer types (for profiling). */
+    unsigned int     m_num_collisions[UserPointer::UP_COUNT]
+                                     [UserPointer::UP_COUNT];
+
+    void  addCollisionAB      (const UserPointer *up_a,
+                               const UserPointer *up_b,
+                               const btPersistentManifold *manifold);
+    void  addCollisionBA      (const UserPointer *up_a,
+                               const UserPointer *up_b,
+                               const btPersistentManifold *manifold);
+    void  trackHitsKart       (const UserPointer *up_a,
+                               const UserPointer *up_b,
+                               const btPersistentManifold *manifold);
+    void  trackHitsObject     (const UserPointer *up_a,
+                               const UserPointer *up_b,
+                               const btPersistentManifold *manifold);
+    void  kartHitsTrack       (const UserPointer *up_a,
+                               const UserPointer *up_b,
+                               const btPersistentManifold *manifold);
+    void  objectHitsTrack     (const UserPointer *up_a,
+                               const UserPointer *up_b,
+                               const btPersistentManifold *manifold);
+    void  handleKartKart      (const CollisionPair &p);
+    void  handleObjectKart    (const CollisionPair &p);
+    void  handleAnimationKart (const CollisionPair &p);
+    void  handleFlyableTrack  (const CollisionPair &p);
+    void  handleFlyableObject (const CollisionPair &p);
+    void  handleFlyableKart   (const CollisionPair &p);
+    void  handleFlyableFlyable(const CollisionPair &p);
+
 public:
           Physics          ();
          ~Physics          ();
@@ -157,8 +257,20 @@ public:
                             AbstractKart *kb, const Vec3 &contact_point_b);
     void  update           (float dt);
     void  draw             ();
+    void  saveState        (SnapshotBuffer *buffer) const;
+    void  restoreState     (SnapshotBuffer *buffer);
     STKDynamicsWorld*
           getPhysicsWorld  () const {return m_dynamics_world;}
+    // ------------------------------------------------------------------------
+    /** Returns the number of handled collisions between objects of type a
+     *  and b (with a being the first object of the collision pair, e.g. a
+     *  flyable hitting a kart is counted as UP_FLYABLE, UP_KART). */
+    unsigned int getNumCollisions(UserPointer::UserPointerType a,
+                                  UserPointer::UserPointerType b) const
+    {
+        return m_num_collisions[a][b];
+    }   // getNumCollisions
+    // ------------------------------------------------------------------------
     /** Activates the next debug mode (or switches it off again).
      */
     void  nextDebugMode    () {m_debug_drawer->nextDebugMode(); }
@@ -0,0 +1,121 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2014 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+
+#include "physics/physics_benchmark.hpp"
+
+#include "config/user_config.hpp"
+#include "karts/abstract_kart.hpp"
+#include "karts/kart_properties.hpp"
+#include "modes/world.hpp"
+#include "physics/btKart.hpp"
+#include "physics/physics.hpp"
+#include "tracks/track.hpp"
+#include "utils/log.hpp"
+#include "utils/time.hpp"
+
+#include <math.h>
+#include <stdio.h>
+
+// ----------------------------------------------------------------------------
+/** Runs the benchmark in the current world, and writes the results as JSON.
+ *  \param num_steps Number of physics steps to simulate.
+ *  \param filename Name of the file to write the results to. If empty, the
+ *         results are printed to stdout.
+ */
+void PhysicsBenchmark::run(unsigned int num_steps, const std::string &filename)
+{
+    World *world           = World::getWorld();
+    unsigned int num_karts = world->getNumKarts();
+    // Without a fixed simulation rate (one step per frame) use 60 steps
+    // per second, since the benchmark does not render any frames.
+    const int fps          = UserConfigParams::m_simulation_fps;
+    const float dt         = fps>0 ? 1.0f/fps : 1.0f/60.0f;
+
+    btKart::enableTimings(true);
+    uint64_t start = StkTime::getMonoTimeNs();
+    for(unsigned int step=0; step<num_steps; step++)
+    {
+        for(unsigned int i=0; i<num_karts; i++)
+        {
+            AbstractKart *kart       = world->getKart(i);
+            btKart *vehicle          = kart->getVehicle();
+            const KartProperties *kp = kart->getKartProperties();
+            // Use a different steering period for each kart, so that
+            // they do not all drive in parallel.
+            float steer = kart->getMaxSteerAngle()
+                        * sinf(step*dt*(1.0f+0.1f*i));
+            vehicle->setSteeringValue(steer, 0);
+            vehicle->setSteeringValue(steer, 1);
+            // Same 40-60 split as in Kart::applyEngineForce
+            for(unsigned int j=0; j<4; j++)
+                vehicle->applyEngineForce(kp->getMaxPower()*(j<2 ? 0.4f
+                                                                 : 0.6f),
+                                          j);
+            vehicle->capSpeed(kp->getMaxSpeed());
+        }   // for i<num_karts
+        world->getPhysics()->update(dt);
+    }   // for step<num_steps
+    uint64_t total_ns = StkTime::getMonoTimeNs() - start;
+    btKart::enableTimings(false);
+
+    FILE *f = filename.empty() ? stdout : fopen(filename.c_str(), "w");
+    if(!f)
+    {
+        Log::error("PhysicsBenchmark", "Can not open '%s'.",
+                   filename.c_str());
+        return;
+    }
+
+    static const char *names[btKart::TIMING_COUNT] =
+        {"updateVehicle", "castWheelRays", "rayCast", "updateSuspension",
+         "updateFriction"};
+    double kart_steps = (double)num_steps*num_karts;
+    if(kart_steps==0) kart_steps = 1;
+
+    fprintf(f, "{\n");
+    fprintf(f, "  \"track\": \"%s\",\n",
+            world->getTrack()->getIdent().c_str());
+    fprintf(f, "  \"karts\": %u,\n", num_karts);
+    fprintf(f, "  \"steps\": %u,\n", num_steps);
+    fprintf(f, "  \"dt\": %f,\n", dt);
+    fprintf(f, "  \"total_ms\": %f,\n", total_ns*1.0e-6);
+    fprintf(f, "  \"steps_per_second\": %f,\n",
+            total_ns>0 ? num_steps*1.0e9/total_ns : 0.0);
+    fprintf(f, "  \"functions\": {\n");
+    for(unsigned int i=0; i<btKart::TIMING_COUNT; i++)
+    {
+        btKart::TimingType t = (btKart::TimingType)i;
+        uint64_t calls = btKart::getTimingCalls(t);
+        fprintf(f, "    \"%s\": {\"calls\": %llu, \"ns_per_kart_step\": %f, "
+                   "\"ns_per_call\": %f}%s\n",
+                names[i], (unsigned long long)calls,
+                btKart::getTimingNs(t)/kart_steps,
+                calls>0 ? (double)btKart::getTimingNs(t)/calls : 0.0,
+                i+1<btKart::TIMING_COUNT ? "," : "");
+    }
+    fprintf(f, "  }\n");
+    fprintf(f, "}\n");
+
+    if(f!=stdout)
+    {
+        fclose(f);
+        Log::info("PhysicsBenchmark", "Results written to '%s'.",
+                  filename.c_str());
+    }
+}   // run
@@ -0,0 +1,43 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2014 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+
+#ifndef HEADER_PHYSICS_BENCHMARK_HPP
+#define HEADER_PHYSICS_BENCHMARK_HPP
+
+#include <string>
+
+/**
+ * \brief A headless benchmark of the kart physics.
+ *  It is run in profile mode once the world is set up: all karts are driven
+ *  with scripted controls (full throttle and steering left and right with a
+ *  different period for each kart) for a fixed number of physics steps.
+ *  Only the physics is updated, i.e. no controllers, kart updates or
+ *  rendering are involved. The time spent in the main btKart functions is
+ *  reported in nanoseconds per kart and step, together with the total
+ *  number of steps per second, as JSON, so that results can be compared
+ *  between commits.
+ * \ingroup physics
+ */
+class PhysicsBenchmark
+{
+public:
+    static void run(unsigned int num_steps, const std::string &filename);
+};   // PhysicsBenchmark
+
+#endif
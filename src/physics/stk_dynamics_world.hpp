@@ -21,8 +21,22 @@
 
 #include "btBulletDynamicsCommon.h"
 
+#include "utils/time.hpp"
+#include "utils/types.hpp"
+
 class STKDynamicsWorld : public btDiscreteDynamicsWorld
 {
+private:
+    /** Number of collision detection steps since the start. */
+    uint32_t m_num_broadphase_steps;
+
+    /** Time spent in the broadphase (updating the AABBs and the overlapping
+     *  pairs) since the start, in microseconds. */
+    uint64_t m_broadphase_time;
+
+    /** Sum of the number of overlapping pairs after each step. */
+    uint64_t m_num_broadphase_pairs;
+
 public:
     /** The standard constructor which just created a btDiscreteDynamicsWorld. */
     STKDynamicsWorld(btDispatcher*             dispatcher,
@@ -34,12 +48,51 @@ public:
                                              constraintSolver,
                                              collisionConfiguration)
     {
+        m_num_broadphase_steps = 0;
+        m_broadphase_time      = 0;
+        m_num_broadphase_pairs = 0;
     }
 
     /** Resets m_localTime to 0. This allows more precise replay of
      *  physics, which is important for replaying histories. */
     virtual void resetLocalTime() { m_localTime = 0; }
 
+    /** Returns the time that was not yet simulated in the last step (the
+     *  remainder of the time step when using fixed substeps). */
+    btScalar getLocalTime() const { return m_localTime; }
+
+    /** Sets the time that was not yet simulated, used when restoring a
+     *  snapshot. */
+    void setLocalTime(btScalar t) { m_localTime = t; }
+
+    /** Does the same as btCollisionWorld, but measures the time needed by
+     *  the broadphase. */
+    virtual void performDiscreteCollisionDetection()
+    {
+        uint64_t start = StkTime::getMicrosecondsSinceEpoch();
+        updateAabbs();
+        m_broadphasePairCache->calculateOverlappingPairs(m_dispatcher1);
+        m_broadphase_time += StkTime::getMicrosecondsSinceEpoch() - start;
+        m_num_broadphase_steps++;
+
+        btOverlappingPairCache *pairs =
+            m_broadphasePairCache->getOverlappingPairCache();
+        m_num_broadphase_pairs += pairs->getNumOverlappingPairs();
+        btDispatcher *dispatcher = getDispatcher();
+        if(dispatcher)
+            dispatcher->dispatchAllCollisionPairs(pairs, getDispatchInfo(),
+                                                  m_dispatcher1);
+    }
+
+    /** Returns the number of collision detection steps. */
+    uint32_t getNumBroadphaseSteps() const { return m_num_broadphase_steps; }
+
+    /** Returns the total time spent in the broadphase in microseconds. */
+    uint64_t getBroadphaseTime() const { return m_broadphase_time; }
+
+    /** Returns the sum of the number of overlapping pairs of all steps. */
+    uint64_t getNumBroadphasePairs() const { return m_num_broadphase_pairs; }
+
 };   // STKDynamicsWorld
 #endif
 /* EOF */
@@ -19,13 +19,18 @@
 #include "physics/triangle_mesh.hpp"
 
 #include "btBulletDynamicsCommon.h"
+#include "BulletCollision/CollisionShapes/btOptimizedBvh.h"
+#include "BulletCollision/NarrowPhaseCollision/btRaycastCallback.h"
 
+#include "config/stk_config.hpp"
 #include "modes/world.hpp"
+#include "physics/bvh_cache.hpp"
 #include "physics/physics.hpp"
 #include "utils/constants.hpp"
+#include "utils/log.hpp"
 #include "utils/time.hpp"
 
-#include <fstream>
+#include <algorithm>
 
 // -----------------------------------------------------------------------------
 /** Constructor: Initialises all data structures with zero.
@@ -41,6 +46,7 @@ TriangleMesh::TriangleMesh() : m_mesh()
     // (and m_mesh->m_weldingThreshold at m_normals
     m_collision_shape  = NULL;
     m_collision_object = NULL;
+    m_bvh_cache        = NULL;
     m_user_pointer.set(this);
 }   // TriangleMesh
 
@@ -81,10 +87,13 @@ void TriangleMesh::addTriangle(const btVector3 &t1, const btVector3 &t2,
 // -----------------------------------------------------------------------------
 /** Creates a collision body only, which can be used for raycasting, but
  *  has no physical properties.
- *  @param serialized_bhv if non-null, load the serialized bhv from file instead
- *                        of builing it on the fly
+ *  The BVH uses quantized AABBs if this is enabled in stk_config.
+ *  \param bvh_cache_file If not empty, the BVH is loaded from this cache
+ *         file if it matches the mesh. Otherwise the BVH is built on the fly
+ *         and saved to this file, so that it can be loaded next time.
  */
-void TriangleMesh::createCollisionShape(bool create_collision_object, const char* serialized_bhv)
+void TriangleMesh::createCollisionShape(bool create_collision_object,
+                                        const std::string &bvh_cache_file)
 {
     if(m_triangleIndex2Material.size()==0)
     {
@@ -96,54 +105,34 @@ void TriangleMesh::createCollisionShape(bool create_collision_object, const char
     }
     // Now convert the triangle mesh into a static rigid body
     btBvhTriangleMeshShape* bhv_triangle_mesh;
+    const bool quantized = stk_config->m_quantized_bvh;
 
-    if (serialized_bhv != NULL)
+    btOptimizedBvh *bvh = NULL;
+    if (bvh_cache_file != "")
     {
-        FILE *f = fopen(serialized_bhv, "rb");
-        fseek(f, 0, SEEK_END);
-        long pos = ftell(f);
-        assert(pos != -1L);
-        fseek(f, 0, SEEK_SET);
-
-        void* bytes = btAlignedAlloc(pos, 16);
-        fread(bytes, pos, 1, f);
-        fclose(f);
-
-        btOptimizedBvh* bhv = btOptimizedBvh::deSerializeInPlace(bytes, pos, !IS_LITTLE_ENDIAN);
-        if (bhv == NULL)
+        m_bvh_cache = new BvhCache();
+        bvh = m_bvh_cache->load(bvh_cache_file, *this, quantized);
+        if (!bvh)
         {
-            fprintf(stderr, "[TriangleMesh] WARNING, failed to load serialized BHV\n");
-            bhv_triangle_mesh = new btBvhTriangleMeshShape(&m_mesh, false /* useQuantizedAabbCompression */);
+            delete m_bvh_cache;
+            m_bvh_cache = NULL;
         }
-        else
-        {
-            bhv_triangle_mesh = new btBvhTriangleMeshShape(&m_mesh, false /* useQuantizedAabbCompression */,
-                                                           false /* buildBvh */);
-            bhv_triangle_mesh->setOptimizedBvh( bhv );
-        }
-        // Do *NOT* free the bytes, 'deSerializeInPlace' makes the btOptimizedBvh object
-        // directly at this memory location
-        //free(bytes);
+    }
 
+    if (bvh)
+    {
+        // The BVH is stored in the mapped cache file, which is only
+        // unmapped in removeAll (the shape does not own the BVH).
+        bhv_triangle_mesh = new btBvhTriangleMeshShape(&m_mesh, quantized,
+                                                       /*buildBvh*/false);
+        bhv_triangle_mesh->setOptimizedBvh(bvh);
     }
     else
     {
-        bhv_triangle_mesh = new btBvhTriangleMeshShape(&m_mesh, false /* useQuantizedAabbCompression */);
-
-        /*
-         // code to serialize triangle mesh
-        btOptimizedBvh* bvh = bhv_triangle_mesh->getOptimizedBvh();
-        unsigned int ssize = bvh->calculateSerializeBufferSize();
-        char* buffer = (char*)btAlignedAlloc(ssize, 16);
-        bool success = bvh->serialize(buffer, ssize, !IS_LITTLE_ENDIAN);
-        printf("serialization success = %i\n", success);
-
-        std::ofstream fileout("/tmp/btOptimizedBvh");
-        fileout.write(buffer, ssize);
-        fileout.close();
-
-        btAlignedFree(buffer);
-         */
+        bhv_triangle_mesh = new btBvhTriangleMeshShape(&m_mesh, quantized);
+        if (bvh_cache_file != "")
+            BvhCache::save(bvh_cache_file, *this, quantized,
+                           *bhv_triangle_mesh->getOptimizedBvh());
     }
 
     m_collision_shape = bhv_triangle_mesh;
@@ -168,15 +157,15 @@ void TriangleMesh::createCollisionShape(bool create_collision_object, const char
  *  removed and all objects together with the track is converted again into
  *  a single rigid body. This avoids using irrlicht (or the graphics engine)
  *  for height of terrain detection).
- *  @param serializedBhv if non-NULL, the bhv is deserialized instead of
- *                       being calculated on the fly
+ *  \param bvh_cache_file If not empty, the name of the BVH cache file,
+ *         see createCollisionShape.
  */
 void TriangleMesh::createPhysicalBody(btCollisionObject::CollisionFlags flags,
-                                      const char* serializedBhv)
+                                      const std::string &bvh_cache_file)
 {
     // We need the collision shape, but not the collision object (since
     // this will be created when the dynamics body is anyway).
-    createCollisionShape(/*create_collision_object*/false, serializedBhv);
+    createCollisionShape(/*create_collision_object*/false, bvh_cache_file);
     btTransform startTransform;
     startTransform.setIdentity();
     m_motion_state = new btDefaultMotionState(startTransform);
@@ -215,6 +204,10 @@ void TriangleMesh::removeAll()
     }
     delete m_collision_shape;
     m_collision_shape = NULL;
+    // The BVH of the shape might be stored in the cache file, so it can
+    // only be unmapped once the shape is deleted.
+    delete m_bvh_cache;
+    m_bvh_cache = NULL;
 }   // removeAll
 
 // -----------------------------------------------------------------------------
@@ -274,13 +267,17 @@ btVector3 TriangleMesh::getInterpolatedNormal(unsigned int index,
  *  \param xyz The position in world where the ray hit.
  *  \param material The material of the mesh that was hit.
  *  \param normal The intrapolated normal at that position.
+ *  \param triangle_index If not NULL, set to the index of the triangle hit,
+ *         or -1 if nothing was hit.
  *  \return True if a triangle was hit, false otherwise (and no output
  *          variable will be set.
  */
 bool TriangleMesh::castRay(const btVector3 &from, const btVector3 &to,
                            btVector3 *xyz, const Material **material,
-                           btVector3 *normal) const
+                           btVector3 *normal, int *triangle_index) const
 {
+    if(triangle_index)
+        *triangle_index = -1;
     if(!m_collision_shape)
     {
         *material=NULL;
@@ -306,20 +303,22 @@ bool TriangleMesh::castRay(const btVector3 &from, const btVector3 &to,
     public:
         const Material* m_material;
         const TriangleMesh *m_this;
+        int m_triangle_index;
         // --------------------------------------------------------------------
         MaterialRayResult(const btVector3 &p1, const btVector3 &p2,
                           const TriangleMesh *me)
                         : btCollisionWorld::ClosestRayResultCallback(p1,p2)
         {
-            m_material = NULL;
-            m_this     = me;
+            m_material       = NULL;
+            m_this           = me;
+            m_triangle_index = -1;
         }   // MaterialRayResult
         // --------------------------------------------------------------------
         virtual btScalar addSingleResult(btCollisionWorld::LocalRayResult& rayResult,
                                          bool normalInWorldSpace)
         {
-            m_material =
-                m_this->getMaterial(rayResult.m_localShapeInfo->m_triangleIndex);
+            m_triangle_index = rayResult.m_localShapeInfo->m_triangleIndex;
+            m_material       = m_this->getMaterial(m_triangle_index);
             return btCollisionWorld::ClosestRayResultCallback
                     ::addSingleResult(rayResult, normalInWorldSpace);
         }   // AddSingleResult
@@ -339,6 +338,8 @@ bool TriangleMesh::castRay(const btVector3 &from, const btVector3 &to,
     {
         *xyz      = ray_callback.m_hitPointWorld;
         *material = ray_callback.m_material;
+        if(triangle_index)
+            *triangle_index = ray_callback.m_triangle_index;
         if(normal)
         {
             *normal   = ray_callback.m_hitNormalWorld;
@@ -354,3 +355,303 @@ bool TriangleMesh::castRay(const btVector3 &from, const btVector3 &to,
     return ray_callback.hasHit();
 
 }   // castRay
+
+// ----------------------------------------------------------------------------
+namespace
+{
+    /** Keeps the closest triangle hit by a ray, using the same ray/triangle
+     *  test as a bullet raycast. */
+    class ClosestTriangle : public btTriangleRaycastCallback
+    {
+    public:
+        btVector3 m_normal;
+        int       m_triangle_index;
+        // --------------------------------------------------------------------
+        ClosestTriangle(const btVector3 &from, const btVector3 &to)
+                      : btTriangleRaycastCallback(from, to)
+        {
+            m_triangle_index = -1;
+        }   // ClosestTriangle
+        // --------------------------------------------------------------------
+        virtual btScalar reportHit(const btVector3 &normal, btScalar fraction,
+                                   int part_id, int triangle_index)
+        {
+            m_normal         = normal;
+            m_triangle_index = triangle_index;
+            return fraction;
+        }   // reportHit
+    };   // ClosestTriangle
+
+    // ------------------------------------------------------------------------
+    /** Detects if a ray hits any other triangle than a given one at (or
+     *  very close to) the given fraction. In this case the closest triangle
+     *  depends on the order in which the triangles are tested. */
+    class OtherTriangleHit : public btTriangleRaycastCallback
+    {
+    public:
+        btScalar m_max_fraction;
+        int      m_triangle_index;
+        bool     m_is_hit;
+        // --------------------------------------------------------------------
+        OtherTriangleHit(const btVector3 &from, const btVector3 &to,
+                         btScalar fraction, int triangle_index)
+                       : btTriangleRaycastCallback(from, to)
+        {
+            m_max_fraction   = fraction + SIMD_EPSILON;
+            m_hitFraction    = m_max_fraction;
+            m_triangle_index = triangle_index;
+            m_is_hit         = false;
+        }   // OtherTriangleHit
+        // --------------------------------------------------------------------
+        virtual btScalar reportHit(const btVector3 &normal, btScalar fraction,
+                                   int part_id, int triangle_index)
+        {
+            if(triangle_index!=m_triangle_index)
+                m_is_hit = true;
+            return m_max_fraction;
+        }   // reportHit
+    };   // OtherTriangleHit
+
+    // ------------------------------------------------------------------------
+    /** Tests all triangles of the BVH nodes that overlap with a box. */
+    class TriangleTester : public btNodeOverlapCallback
+    {
+    public:
+        const TriangleMesh *m_mesh;
+        btTriangleCallback *m_callback;
+        // --------------------------------------------------------------------
+        virtual void processNode(int sub_part, int triangle_index)
+        {
+            btVector3 triangle[3];
+            m_mesh->getTriangle(triangle_index, &triangle[0], &triangle[1],
+                                &triangle[2]);
+            m_callback->processTriangle(triangle, 0, triangle_index);
+        }   // processNode
+    };   // TriangleTester
+
+    // ------------------------------------------------------------------------
+    /** A vertex of a triangle, used to find triangles sharing a vertex. */
+    struct VertexRef
+    {
+        btScalar     m_x, m_y, m_z;
+        unsigned int m_triangle;
+        // --------------------------------------------------------------------
+        bool samePosition(const VertexRef &other) const
+        {
+            return m_x==other.m_x && m_y==other.m_y && m_z==other.m_z;
+        }   // samePosition
+        // --------------------------------------------------------------------
+        bool operator<(const VertexRef &other) const
+        {
+            if(m_x!=other.m_x) return m_x<other.m_x;
+            if(m_y!=other.m_y) return m_y<other.m_y;
+            return m_z<other.m_z;
+        }   // operator<
+    };   // VertexRef
+}   // namespace
+
+// ----------------------------------------------------------------------------
+/** Casts a ray like castRay, but uses the triangle hit by the previous ray
+ *  of the same object to avoid a full raycast: if the ray hits the previous
+ *  triangle or one of its neighbours (see buildAdjacency), only the
+ *  triangles close to the segment from 'from' to that hit point are tested,
+ *  since only they can be hit before. This gives the same result as castRay,
+ *  and falls back to castRay if none of the neighbours is hit. It also falls
+ *  back to castRay if the ray hits several triangles at the same distance
+ *  (e.g. on a shared edge), since then castRay returns the first of them
+ *  in the order of the BVH traversal.
+ *  \param from/to The from and to position for the raycast.
+ *  \param last_triangle The triangle hit by the previous ray (or -1), on
+ *         return the triangle hit by this ray (or -1).
+ *  \param xyz The position in world where the ray hit.
+ *  \param material The material of the mesh that was hit.
+ *  \param normal The normal of the triangle hit.
+ *  \return True if a triangle was hit.
+ */
+bool TriangleMesh::castRayCached(const btVector3 &from, const btVector3 &to,
+                                 int *last_triangle, btVector3 *xyz,
+                                 const Material **material,
+                                 btVector3 *normal) const
+{
+    const btOptimizedBvh *bvh = getBvh();
+    int last = *last_triangle;
+    if(!bvh || last<0 || last+1>=(int)m_adjacency_start.size())
+        return castRay(from, to, xyz, material, normal, last_triangle);
+
+    ClosestTriangle closest(from, to);
+    btVector3 triangle[3];
+    getTriangle(last, &triangle[0], &triangle[1], &triangle[2]);
+    closest.processTriangle(triangle, 0, last);
+    for(unsigned int i=m_adjacency_start[last];
+        i<m_adjacency_start[last+1]; i++)
+    {
+        getTriangle(m_adjacency[i], &triangle[0], &triangle[1], &triangle[2]);
+        closest.processTriangle(triangle, 0, m_adjacency[i]);
+    }
+    if(closest.m_triangle_index<0)
+        return castRay(from, to, xyz, material, normal, last_triangle);
+
+    // Any triangle hit before must intersect the segment to the hit point
+    btVector3 hit_point;
+    hit_point.setInterpolate3(from, to, closest.m_hitFraction);
+    btVector3 aabb_min = from, aabb_max = from;
+    aabb_min.setMin(hit_point);
+    aabb_max.setMax(hit_point);
+    TriangleTester tester;
+    tester.m_mesh     = this;
+    tester.m_callback = &closest;
+    bvh->reportAabbOverlappingNodex(&tester, aabb_min, aabb_max);
+
+    // Any other triangle hit at the same distance touches the same box.
+    OtherTriangleHit other(from, to, closest.m_hitFraction,
+                           closest.m_triangle_index);
+    tester.m_callback = &other;
+    bvh->reportAabbOverlappingNodex(&tester, aabb_min, aabb_max);
+    if(other.m_is_hit)
+        return castRay(from, to, xyz, material, normal, last_triangle);
+
+    *last_triangle = closest.m_triangle_index;
+    xyz->setInterpolate3(from, to, closest.m_hitFraction);
+    *material = getMaterial(closest.m_triangle_index);
+    *normal   = closest.m_normal;
+    normal->normalize();
+    return true;
+}   // castRayCached
+
+// ----------------------------------------------------------------------------
+/** Builds the table of neighbours of each triangle (all triangles sharing a
+ *  vertex with it), which is used by castRayCached.
+ */
+void TriangleMesh::buildAdjacency()
+{
+    const unsigned int num_triangles = getNumTriangles();
+    std::vector<VertexRef> vertices;
+    vertices.reserve(3*num_triangles);
+    for(unsigned int i=0; i<num_triangles; i++)
+    {
+        btVector3 p[3];
+        getTriangle(i, &p[0], &p[1], &p[2]);
+        for(unsigned int j=0; j<3; j++)
+        {
+            VertexRef v;
+            v.m_x = p[j].getX(); v.m_y = p[j].getY(); v.m_z = p[j].getZ();
+            v.m_triangle = i;
+            vertices.push_back(v);
+        }
+    }
+    std::sort(vertices.begin(), vertices.end());
+
+    std::vector<std::vector<unsigned int> > neighbours(num_triangles);
+    unsigned int start = 0;
+    while(start<vertices.size())
+    {
+        unsigned int end = start+1;
+        while(end<vertices.size() &&
+              vertices[end].samePosition(vertices[start])  )
+            end++;
+        for(unsigned int i=start; i<end; i++)
+        {
+            for(unsigned int j=start; j<end; j++)
+            {
+                if(vertices[i].m_triangle!=vertices[j].m_triangle)
+                    neighbours[vertices[i].m_triangle]
+                        .push_back(vertices[j].m_triangle);
+            }
+        }
+        start = end;
+    }
+
+    m_adjacency_start.clear();
+    m_adjacency.clear();
+    m_adjacency_start.reserve(num_triangles+1);
+    for(unsigned int i=0; i<num_triangles; i++)
+    {
+        std::vector<unsigned int> &n = neighbours[i];
+        std::sort(n.begin(), n.end());
+        n.erase(std::unique(n.begin(), n.end()), n.end());
+        m_adjacency_start.push_back(m_adjacency.size());
+        m_adjacency.insert(m_adjacency.end(), n.begin(), n.end());
+    }
+    m_adjacency_start.push_back(m_adjacency.size());
+}   // buildAdjacency
+
+// ----------------------------------------------------------------------------
+/** Compares the BVH without and with quantized AABB compression for this
+ *  mesh: builds both BVHs, and prints the build time, the size of each BVH
+ *  and the time to cast num_rays vertical rays (the same rays are used for
+ *  both BVHs). This is used with --benchmark-bvh.
+ *  \param name Name of the mesh (e.g. the track) used in the output.
+ *  \param num_rays Number of rays to cast.
+ */
+void TriangleMesh::benchmarkBvh(const std::string &name,
+                                unsigned int num_rays)
+{
+    if(m_triangleIndex2Material.size()==0 || num_rays==0)
+        return;
+
+    class HitCounter : public btTriangleRaycastCallback
+    {
+    public:
+        unsigned int m_num_hits;
+        // --------------------------------------------------------------------
+        HitCounter(const btVector3 &from, const btVector3 &to)
+                 : btTriangleRaycastCallback(from, to)
+        {
+            m_num_hits = 0;
+        }   // HitCounter
+        // --------------------------------------------------------------------
+        virtual btScalar reportHit(const btVector3 &normal, btScalar fraction,
+                                   int part_id, int triangle_index)
+        {
+            m_num_hits++;
+            // Only look for closer hits, like a closest-hit raycast does
+            return fraction;
+        }   // reportHit
+    };   // HitCounter
+
+    // Vertical rays through the bounding box of the mesh. A simple linear
+    // congruential generator is used so that the rays are the same in
+    // each run (and the global random state is not modified).
+    btVector3 aabb_min, aabb_max;
+    m_mesh.calculateAabbBruteForce(aabb_min, aabb_max);
+    btVector3 extent = aabb_max - aabb_min;
+    AlignedArray<btVector3> ray_from, ray_to;
+    uint32_t seed = 12345;
+    for(unsigned int i=0; i<num_rays; i++)
+    {
+        seed = seed*1664525u + 1013904223u;
+        float x = aabb_min.getX() + extent.getX()*(seed>>8)/16777216.0f;
+        seed = seed*1664525u + 1013904223u;
+        float z = aabb_min.getZ() + extent.getZ()*(seed>>8)/16777216.0f;
+        ray_from.push_back(btVector3(x, aabb_max.getY()+1.0f, z));
+        ray_to.push_back  (btVector3(x, aabb_min.getY()-1.0f, z));
+    }
+
+    for(unsigned int quantized=0; quantized<2; quantized++)
+    {
+        uint64_t start = StkTime::getMicrosecondsSinceEpoch();
+        btBvhTriangleMeshShape *shape =
+            new btBvhTriangleMeshShape(&m_mesh, quantized==1);
+        uint64_t built = StkTime::getMicrosecondsSinceEpoch();
+
+        unsigned int num_hits = 0;
+        for(unsigned int i=0; i<num_rays; i++)
+        {
+            HitCounter counter(ray_from[i], ray_to[i]);
+            shape->performRaycast(&counter, ray_from[i], ray_to[i]);
+            if(counter.m_num_hits>0)
+                num_hits++;
+        }
+        uint64_t end = StkTime::getMicrosecondsSinceEpoch();
+
+        Log::info("TriangleMesh", "BVH benchmark '%s' %s: %u triangles, "
+                  "%u bytes, built in %.2f ms, %u rays in %.2f ms "
+                  "(%.3f us/ray), %u hits.", name.c_str(),
+                  quantized ? "quantized  " : "unquantized",
+                  getNumTriangles(),
+                  shape->getOptimizedBvh()->calculateSerializeBufferSize(),
+                  (built-start)*0.001f, num_rays, (end-built)*0.001f,
+                  float(end-built)/num_rays, num_hits);
+        delete shape;
+    }
+}   // benchmarkBvh
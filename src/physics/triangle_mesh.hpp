@@ -19,12 +19,14 @@
 #ifndef HEADER_TRIANGLE_MESH_HPP
 #define HEADER_TRIANGLE_MESH_HPP
 
+#include <string>
 #include <vector>
 #include "btBulletDynamicsCommon.h"
 
 #include "physics/user_pointer.hpp"
 #include "utils/aligned_array.hpp"
 
+class BvhCache;
 class Material;
 
 /**
@@ -44,6 +46,14 @@ private:
     btCollisionShape            *m_collision_shape;
     /** The three normals for each triangle. */
     AlignedArray<btVector3>      m_normals;
+    /** The mapped cache file if the BVH was loaded from the cache. */
+    BvhCache                    *m_bvh_cache;
+    /** The triangles sharing a vertex with triangle i are stored in
+     *  m_adjacency[m_adjacency_start[i]] to
+     *  m_adjacency[m_adjacency_start[i+1]-1]. Empty if buildAdjacency
+     *  was not called. */
+    std::vector<unsigned int>    m_adjacency_start;
+    std::vector<unsigned int>    m_adjacency;
 public:
          TriangleMesh();
         ~TriangleMesh();
@@ -51,15 +61,21 @@ public:
                      const btVector3 &t3, const btVector3 &n1,
                      const btVector3 &n2, const btVector3 &n3,
                      const Material* m);
-    void createCollisionShape(bool create_collision_object=true, const char* serialized_bhv=NULL);
+    void createCollisionShape(bool create_collision_object=true,
+                              const std::string &bvh_cache_file="");
     void createPhysicalBody(btCollisionObject::CollisionFlags flags=
                                (btCollisionObject::CollisionFlags)0,
-                            const char* serializedBhv = NULL);
+                            const std::string &bvh_cache_file="");
     void removeAll();
     void removeCollisionObject();
+    void benchmarkBvh(const std::string &name, unsigned int num_rays);
     btVector3 getInterpolatedNormal(unsigned int index,
                                     const btVector3 &position) const;
     // ------------------------------------------------------------------------
+    /** Returns the number of triangles in this mesh. */
+    unsigned int getNumTriangles() const
+                                  { return m_triangleIndex2Material.size(); }
+    // ------------------------------------------------------------------------
     const Material* getMaterial(int n) const
                                           {return m_triangleIndex2Material[n];}
     // ------------------------------------------------------------------------
@@ -68,9 +84,27 @@ public:
     // ------------------------------------------------------------------------
     btCollisionShape &getCollisionShape() { return *m_collision_shape; }
     // ------------------------------------------------------------------------
+    /** Returns the object used for collisions with this mesh: the collision
+     *  object, or the rigid body if a physical body was created. */
+    const btCollisionObject *getCollisionObject() const
+    {
+        return m_collision_object ? m_collision_object : m_body;
+    }   // getCollisionObject
+    // ------------------------------------------------------------------------
+    /** Returns the BVH of this mesh, or NULL if no collision shape exists. */
+    const btOptimizedBvh *getBvh() const
+    {
+        if(!m_collision_shape) return NULL;
+        return ((btBvhTriangleMeshShape*)m_collision_shape)->getOptimizedBvh();
+    }   // getBvh
+    // ------------------------------------------------------------------------
     bool castRay(const btVector3 &from, const btVector3 &to,
                  btVector3 *xyz, const Material **material,
-                 btVector3 *normal=NULL) const;
+                 btVector3 *normal=NULL, int *triangle_index=NULL) const;
+    bool castRayCached(const btVector3 &from, const btVector3 &to,
+                       int *last_triangle, btVector3 *xyz,
+                       const Material **material, btVector3 *normal) const;
+    void buildAdjacency();
     // ------------------------------------------------------------------------
     /** Returns the points of the 'indx' triangle.
      *  \param indx Index of the triangle to get.
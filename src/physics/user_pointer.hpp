@@ -38,12 +38,13 @@ public:
     /** List of all possibles STK objects that are represented in the
      *  physics. */
     enum   UserPointerType {UP_UNDEF, UP_KART, UP_FLYABLE, UP_TRACK,
-                            UP_PHYSICAL_OBJECT, UP_ANIMATION};
+                            UP_PHYSICAL_OBJECT, UP_ANIMATION, UP_COUNT};
 private:
     void*  m_pointer;
     UserPointerType m_user_pointer_type;
 public:
     bool            is(UserPointerType t)      const {return m_user_pointer_type==t;     }
+    UserPointerType getType()                  const {return m_user_pointer_type;        }
     TriangleMesh*   getPointerTriangleMesh()   const {return (TriangleMesh*)m_pointer;   }
     Moveable*       getPointerMoveable()       const {return (Moveable*)m_pointer;       }
     Flyable*        getPointerFlyable()        const {return (Flyable*)m_pointer;        }
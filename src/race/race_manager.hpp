@@ -531,6 +531,14 @@ public:
     // ------------------------------------------------------------------------
     unsigned int getFinishedPlayers() const { return m_num_finished_players; }
     // ------------------------------------------------------------------------
+    /** Sets the number of finished karts and players, used when a snapshot
+     *  of the world is restored. */
+    void setFinishedKarts(unsigned int karts, unsigned int players)
+    {
+        m_num_finished_karts   = karts;
+        m_num_finished_players = players;
+    }   // setFinishedKarts
+    // ------------------------------------------------------------------------
     int getKartGPRank(const int kart_id)const
     {
         return m_kart_status[kart_id].m_gp_rank;
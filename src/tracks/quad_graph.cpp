@@ -22,6 +22,7 @@
 
 #include <IMesh.h>
 #include <ICameraSceneNode.h>
+#include <algorithm>
 
 #include "config/user_config.hpp"
 #include "graphics/callbacks.hpp"
@@ -112,6 +113,7 @@ void QuadGraph::load(const std::string &filename)
             m_lap_length = 10.0f;
         }
 
+        buildSectorGrid();
         return;
     }
 
@@ -201,8 +203,54 @@ void QuadGraph::load(const std::string &filename)
         if(l > m_lap_length)
             m_lap_length = l;
     }
+    buildSectorGrid();
 }   // load
 
+// ----------------------------------------------------------------------------
+/** Creates the 2d grid used to speed up findRoadSector and
+ *  findOutOfRoadSector. Each graph node is stored in all cells that are
+ *  overlapped by the (slightly enlarged) 2d bounding box of its quad. This
+ *  box also contains the center line of the node which is used in
+ *  findOutOfRoadSector, so one grid is sufficient for both searches.
+ */
+void QuadGraph::buildSectorGrid()
+{
+    m_sector_grid.clear();
+    if(m_all_nodes.size()==0) return;
+
+    // Enlarge the boxes a bit so that floating point errors in
+    // Quad::pointInQuad can not result in a point being considered
+    // inside of a quad, but outside of the cells it is stored in.
+    const Vec3 eps(0.01f);
+    std::vector<Vec3> all_min, all_max;
+    Vec3 grid_min( 999999.9f), grid_max(-999999.9f);
+    float size_sum = 0;
+    for(unsigned int i=0; i<m_all_nodes.size(); i++)
+    {
+        const Quad &q = getQuadOfNode(i);
+        Vec3 quad_min = q[0], quad_max = q[0];
+        for(unsigned int j=1; j<4; j++)
+        {
+            quad_min.min(q[j]);
+            quad_max.max(q[j]);
+        }
+        quad_min -= eps;
+        quad_max += eps;
+        grid_min.min(quad_min);
+        grid_max.max(quad_max);
+        size_sum += std::max(quad_max.getX()-quad_min.getX(),
+                             quad_max.getZ()-quad_min.getZ());
+        all_min.push_back(quad_min);
+        all_max.push_back(quad_max);
+    }
+
+    // Use the average quad size as cell size, which results in only a
+    // few graph nodes per cell.
+    m_sector_grid.init(grid_min, grid_max, size_sum/m_all_nodes.size());
+    for(unsigned int i=0; i<m_all_nodes.size(); i++)
+        m_sector_grid.add(i, all_min[i], all_max[i]);
+}   // buildSectorGrid
+
 // ----------------------------------------------------------------------------
 /** Returns the index of the first graph node (i.e. the graph node which
  *  will trigger a new lap when a kart first enters it). This is always
@@ -841,6 +889,36 @@ void QuadGraph::findRoadSector(const Vec3& xyz, int *sector,
                             ? all_sectors->size()
                             : m_all_nodes.size();
     *sector = UNKNOWN_SECTOR;
+
+    // If the whole graph needs to be searched, use the sector grid to only
+    // test the graph nodes that can contain the point. To get exactly the
+    // same result as the linear search below, a node with the same height
+    // distance is only preferred if it would have been tested earlier in
+    // the linear search (which starts at indx+1).
+    if(!all_sectors && !m_sector_grid.isEmpty())
+    {
+        if(!m_sector_grid.contains(xyz.getX(), xyz.getZ()))
+            return;
+        const int num_nodes = m_all_nodes.size();
+        int min_order       = num_nodes;
+        const std::vector<int> &nodes = m_sector_grid.getObjects(xyz);
+        for(unsigned int i=0; i<nodes.size(); i++)
+        {
+            const Quad &q = getQuadOfNode(nodes[i]);
+            float dist    = xyz.getY() - q.getMinHeight();
+            if(dist>min_dist || dist<=-1.0f || !q.pointInQuad(xyz))
+                continue;
+            int order = (nodes[i] - indx - 1 + num_nodes) % num_nodes;
+            if(dist<min_dist || order<min_order)
+            {
+                min_dist  = dist;
+                min_order = order;
+                *sector   = nodes[i];
+            }
+        }   // for i<nodes.size()
+        return;
+    }   // if use sector grid
+
     for(unsigned int i=0; i<max_count; i++)
     {
         if(all_sectors)
@@ -920,6 +998,14 @@ int QuadGraph::findOutOfRoadSector(const Vec3& xyz,
     int   min_sector = UNKNOWN_SECTOR;
     float min_dist_2 = 999999.0f*999999.0f;
 
+    if(!all_sectors && !m_sector_grid.isEmpty())
+    {
+        min_sector = findOutOfRoadSectorInGrid(xyz, current_sector);
+        if(min_sector==UNKNOWN_SECTOR)
+            Log::info("Quad Grap", "unknown sector found.");
+        return min_sector;
+    }
+
     // If a kart is falling and in between (or too far below)
     // a driveline point it might not fulfill
     // the height condition. So we run the test twice: first with height
@@ -967,6 +1053,83 @@ int QuadGraph::findOutOfRoadSector(const Vec3& xyz,
     return min_sector;
 }   // findOutOfRoadSector
 
+//-----------------------------------------------------------------------------
+/** Implements findOutOfRoadSector using the sector grid. The cells are
+ *  searched in rings of increasing distance around the cell containing
+ *  the point, and the search stops as soon as no cell in a ring can contain
+ *  a closer graph node. The result is identical to the linear search: if
+ *  two nodes have the same distance, the one that the linear search
+ *  (starting at start_sector+1) would have tested first is used.
+ *  \param xyz The point for which to find the closest graph node.
+ *  \param start_sector The node before the first node the linear search
+ *         would test.
+ */
+int QuadGraph::findOutOfRoadSectorInGrid(const Vec3 &xyz,
+                                         int start_sector) const
+{
+    const int num_nodes = m_all_nodes.size();
+    const float x = xyz.getX(), z = xyz.getZ();
+    int cx, cz;
+    m_sector_grid.getCell(x, z, &cx, &cz);
+    const int max_ring = std::max(m_sector_grid.getNumX(),
+                                  m_sector_grid.getNumZ());
+
+    // See findOutOfRoadSector why two phases are used.
+    for(int phase=0; phase<2; phase++)
+    {
+        int   min_sector = UNKNOWN_SECTOR;
+        int   min_order  = num_nodes;
+        float min_dist_2 = 999999.0f*999999.0f;
+        for(int ring=0; ring<=max_ring; ring++)
+        {
+            float ring_min_2 = 999999.0f*999999.0f;
+            for(int iz=cz-ring; iz<=cz+ring; iz++)
+            {
+                if(iz<0 || iz>=m_sector_grid.getNumZ()) continue;
+                // Only the cells on the border of the ring are tested:
+                // the first and last row completely, otherwise only
+                // the leftmost and rightmost cell.
+                int step = (iz==cz-ring || iz==cz+ring) ? 1 : 2*ring;
+                for(int ix=cx-ring; ix<=cx+ring; ix+=step)
+                {
+                    if(ix<0 || ix>=m_sector_grid.getNumX()) continue;
+                    float cell_dist_2 =
+                        m_sector_grid.getDistance2ToCell(x, z, ix, iz);
+                    if(cell_dist_2<ring_min_2) ring_min_2 = cell_dist_2;
+                    if(cell_dist_2>min_dist_2) continue;
+
+                    const std::vector<int> &nodes =
+                        m_sector_grid.getObjects(ix, iz);
+                    for(unsigned int i=0; i<nodes.size(); i++)
+                    {
+                        float dist_2 =
+                            m_all_nodes[nodes[i]]->getDistance2FromPoint(xyz);
+                        if(dist_2>min_dist_2) continue;
+                        int order = ( (nodes[i]-start_sector-1) % num_nodes
+                                     + num_nodes) % num_nodes;
+                        if(dist_2==min_dist_2 && order>=min_order)
+                            continue;
+                        const Quad &q = getQuadOfNode(nodes[i]);
+                        float dist    = xyz.getY() - q.getMinHeight();
+                        if(phase==1 || (dist < 5.0f && dist>-1.0f) )
+                        {
+                            min_dist_2 = dist_2;
+                            min_order  = order;
+                            min_sector = nodes[i];
+                        }
+                    }   // for i<nodes.size()
+                }   // for ix
+            }   // for iz
+            // No cell in any further ring can contain a closer node.
+            if(ring_min_2>min_dist_2) break;
+        }   // for ring
+
+        if(min_sector!=UNKNOWN_SECTOR)
+            return min_sector;
+    }   // for phase
+    return UNKNOWN_SECTOR;
+}   // findOutOfRoadSectorInGrid
+
 //-----------------------------------------------------------------------------
 /** Takes a snapshot of the driveline quads so they can be used as minimap.
  */
@@ -25,6 +25,7 @@
 
 #include "tracks/graph_node.hpp"
 #include "tracks/quad_set.hpp"
+#include "tracks/spatial_grid.hpp"
 #include "utils/aligned_array.hpp"
 #include "utils/no_copy.hpp"
 
@@ -78,6 +79,11 @@ private:
     /** Wether the graph should be reverted or not */
     bool                     m_reverse;
 
+    /** A 2d grid storing for each cell all graph nodes whose quad overlaps
+     *  this cell. Used to speed up findRoadSector and findOutOfRoadSector
+     *  so that not all graph nodes need to be tested. */
+    SpatialGrid              m_sector_grid;
+
     void setDefaultSuccessors();
     void computeChecklineRequirements(GraphNode* node, int latest_checkline);
     void computeDirectionData();
@@ -87,6 +93,8 @@ private:
     void addSuccessor(unsigned int from, unsigned int to);
     void load         (const std::string &filename);
     void computeDistanceFromStart(unsigned int start_node, float distance);
+    void buildSectorGrid();
+    int  findOutOfRoadSectorInGrid(const Vec3 &xyz, int start_sector) const;
     void createMesh(bool show_invisible=true,
                     bool enable_transparency=false,
                     const video::SColor *track_color=NULL,
@@ -0,0 +1,150 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2014 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "tracks/spatial_grid.hpp"
+
+#include <algorithm>
+#include <math.h>
+
+SpatialGrid::SpatialGrid()
+{
+    m_min_x         = 0;
+    m_min_z         = 0;
+    m_cell_size     = 1.0f;
+    m_inv_cell_size = 1.0f;
+    m_num_x         = 0;
+    m_num_z         = 0;
+}   // SpatialGrid
+
+// ----------------------------------------------------------------------------
+/** Sets up an empty grid covering the specified area. If the requested cell
+ *  size would result in more than max_cells_per_axis cells along one axis,
+ *  the cell size is increased accordingly.
+ *  \param min, max Minimum and maximum coordinates of the covered area.
+ *  \param cell_size Requested size of a cell.
+ *  \param max_cells_per_axis Maximum number of cells in X or Z direction.
+ */
+void SpatialGrid::init(const Vec3 &min, const Vec3 &max, float cell_size,
+                       int max_cells_per_axis)
+{
+    // Keep the allocated cells, since the kart spatial index calls this
+    // for every time step.
+    for(unsigned int i=0; i<m_cells.size(); i++)
+        m_cells[i].clear();
+    m_min_x = min.getX();
+    m_min_z = min.getZ();
+    float dx = std::max(max.getX()-min.getX(), 0.001f);
+    float dz = std::max(max.getZ()-min.getZ(), 0.001f);
+
+    float longest = std::max(dx, dz);
+    if(cell_size*max_cells_per_axis < longest)
+        cell_size = longest/max_cells_per_axis;
+    if(cell_size<=0)
+        cell_size = longest;
+
+    m_cell_size     = cell_size;
+    m_inv_cell_size = 1.0f/cell_size;
+    m_num_x         = std::max(1, (int)ceilf(dx*m_inv_cell_size));
+    m_num_z         = std::max(1, (int)ceilf(dz*m_inv_cell_size));
+    m_cells.resize(m_num_x*m_num_z);
+}   // init
+
+// ----------------------------------------------------------------------------
+/** Removes all cells. */
+void SpatialGrid::clear()
+{
+    m_cells.clear();
+    m_num_x = 0;
+    m_num_z = 0;
+}   // clear
+
+// ----------------------------------------------------------------------------
+/** Adds an object to all cells overlapped by its bounding box.
+ *  \param index The index of the object to store.
+ *  \param min, max The bounding box of the object.
+ */
+void SpatialGrid::add(int index, const Vec3 &min, const Vec3 &max)
+{
+    int x0, z0, x1, z1;
+    getCell(min.getX(), min.getZ(), &x0, &z0);
+    getCell(max.getX(), max.getZ(), &x1, &z1);
+    for(int cz=z0; cz<=z1; cz++)
+    {
+        for(int cx=x0; cx<=x1; cx++)
+            m_cells[cz*m_num_x+cx].push_back(index);
+    }
+}   // add
+
+// ----------------------------------------------------------------------------
+/** Removes an object from all cells overlapped by its bounding box. The
+ *  box must be the same that was used when adding the object.
+ *  \param index The index of the object to remove.
+ *  \param min, max The bounding box of the object.
+ */
+void SpatialGrid::remove(int index, const Vec3 &min, const Vec3 &max)
+{
+    int x0, z0, x1, z1;
+    getCell(min.getX(), min.getZ(), &x0, &z0);
+    getCell(max.getX(), max.getZ(), &x1, &z1);
+    for(int cz=z0; cz<=z1; cz++)
+    {
+        for(int cx=x0; cx<=x1; cx++)
+        {
+            std::vector<int> &cell = m_cells[cz*m_num_x+cx];
+            std::vector<int>::iterator i = std::find(cell.begin(),
+                                                     cell.end(), index);
+            if(i!=cell.end())
+                cell.erase(i);
+        }
+    }
+}   // remove
+
+// ----------------------------------------------------------------------------
+/** Computes the cell a point is in. Points outside of the grid are clamped
+ *  to the closest cell.
+ *  \param x, z The coordinates of the point.
+ *  \param cx, cz On return the cell coordinates.
+ */
+void SpatialGrid::getCell(float x, float z, int *cx, int *cz) const
+{
+    *cx = (int)floorf((x-m_min_x)*m_inv_cell_size);
+    *cz = (int)floorf((z-m_min_z)*m_inv_cell_size);
+    if(*cx<0)        *cx = 0;
+    if(*cx>=m_num_x) *cx = m_num_x-1;
+    if(*cz<0)        *cz = 0;
+    if(*cz>=m_num_z) *cz = m_num_z-1;
+}   // getCell
+
+// ----------------------------------------------------------------------------
+/** Returns the squared 2d distance of a point to the closest point of a
+ *  cell (0 if the point is inside of the cell). This is a lower bound for
+ *  the distance to any object stored in this cell.
+ *  \param x, z The coordinates of the point.
+ *  \param cx, cz The cell.
+ */
+float SpatialGrid::getDistance2ToCell(float x, float z, int cx, int cz) const
+{
+    float cell_min_x = m_min_x + cx*m_cell_size;
+    float cell_min_z = m_min_z + cz*m_cell_size;
+    float dx = 0, dz = 0;
+    if(x<cell_min_x)                  dx = cell_min_x - x;
+    else if(x>cell_min_x+m_cell_size) dx = x - (cell_min_x+m_cell_size);
+    if(z<cell_min_z)                  dz = cell_min_z - z;
+    else if(z>cell_min_z+m_cell_size) dz = z - (cell_min_z+m_cell_size);
+    return dx*dx + dz*dz;
+}   // getDistance2ToCell
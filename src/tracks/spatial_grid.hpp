@@ -0,0 +1,101 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2014 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef HEADER_SPATIAL_GRID_HPP
+#define HEADER_SPATIAL_GRID_HPP
+
+#include <assert.h>
+#include <vector>
+
+#include "utils/vec3.hpp"
+
+/**
+ *  \brief A uniform 2d grid (in the X/Z plane) that maps cells to a list of
+ *  object indices.
+ *  An object is added with its 2d bounding box, and is then stored in all
+ *  cells overlapped by this box. A query for a point returns the list of
+ *  all objects whose bounding box might contain the point. The grid does
+ *  not store any other information about the objects, it is up to the
+ *  caller to do the exact tests. The height (Y coordinate) is ignored.
+ * \ingroup tracks
+ */
+class SpatialGrid
+{
+private:
+    /** Minimum X/Z coordinates of the area covered by the grid. */
+    float m_min_x, m_min_z;
+
+    /** Size of a cell. */
+    float m_cell_size;
+
+    /** 1.0f/m_cell_size, saves a division in getCell. */
+    float m_inv_cell_size;
+
+    /** Number of cells in X and Z direction. */
+    int   m_num_x, m_num_z;
+
+    /** For each cell the list of object indices overlapping this cell. */
+    std::vector<std::vector<int> > m_cells;
+
+public:
+         SpatialGrid();
+    void init(const Vec3 &min, const Vec3 &max, float cell_size,
+              int max_cells_per_axis=256);
+    void add(int index, const Vec3 &min, const Vec3 &max);
+    void remove(int index, const Vec3 &min, const Vec3 &max);
+    void clear();
+    void getCell(float x, float z, int *cx, int *cz) const;
+    float getDistance2ToCell(float x, float z, int cx, int cz) const;
+    // ------------------------------------------------------------------------
+    /** Returns true if the grid was initialised. */
+    bool isEmpty() const { return m_cells.empty(); }
+    // ------------------------------------------------------------------------
+    /** Returns the number of cells in X direction. */
+    int getNumX() const { return m_num_x; }
+    // ------------------------------------------------------------------------
+    /** Returns the number of cells in Z direction. */
+    int getNumZ() const { return m_num_z; }
+    // ------------------------------------------------------------------------
+    /** Returns true if the specified point is inside of the area covered
+     *  by the grid. */
+    bool contains(float x, float z) const
+    {
+        return x>=m_min_x && z>=m_min_z &&
+               x<=m_min_x+m_num_x*m_cell_size &&
+               z<=m_min_z+m_num_z*m_cell_size;
+    }   // contains
+    // ------------------------------------------------------------------------
+    /** Returns the list of objects stored in the specified cell. */
+    const std::vector<int>& getObjects(int cx, int cz) const
+    {
+        assert(cx>=0 && cx<m_num_x && cz>=0 && cz<m_num_z);
+        return m_cells[cz*m_num_x + cx];
+    }   // getObjects
+    // ------------------------------------------------------------------------
+    /** Returns the list of objects that might contain the specified point.
+     *  The point must be inside of the grid (see contains()). */
+    const std::vector<int>& getObjects(const Vec3 &xyz) const
+    {
+        int cx, cz;
+        getCell(xyz.getX(), xyz.getZ(), &cx, &cz);
+        return getObjects(cx, cz);
+    }   // getObjects
+
+};   // SpatialGrid
+
+#endif
@@ -32,6 +32,7 @@ TerrainInfo::TerrainInfo()
 {
     m_last_material = NULL;
     m_material      = NULL;
+    m_last_triangle = -1;
 }   // TerrainInfo
 
 //-----------------------------------------------------------------------------
@@ -43,6 +44,7 @@ TerrainInfo::TerrainInfo(const Vec3 &pos)
     // initialise HoT
     m_last_material = NULL;
     m_material = NULL;
+    m_last_triangle = -1;
     update(pos);
 }   // TerrainInfo
 
@@ -57,7 +59,8 @@ void TerrainInfo::update(const Vec3 &from)
     to.setY(-10000.0f);
 
     const TriangleMesh &tm = World::getWorld()->getTrack()->getTriangleMesh();
-    tm.castRay(from, to, &m_hit_point, &m_material, &m_normal);
+    tm.castRayCached(from, to, &m_last_triangle, &m_hit_point, &m_material,
+                     &m_normal);
 }   // update
 //-----------------------------------------------------------------------------
 /** Update the terrain information based on the latest position.
@@ -71,7 +74,8 @@ void TerrainInfo::update(const btTransform &trans, const Vec3 &offset)
     to = trans(to);
 
     const TriangleMesh &tm = World::getWorld()->getTrack()->getTriangleMesh();
-    tm.castRay(from, to, &m_hit_point, &m_material, &m_normal);
+    tm.castRayCached(from, to, &m_last_triangle, &m_hit_point, &m_material,
+                     &m_normal);
 }   // update
 
 // -----------------------------------------------------------------------------
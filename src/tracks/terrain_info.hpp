@@ -39,6 +39,9 @@ private:
     const Material   *m_last_material;
     /** The point that was hit. */
     Vec3              m_hit_point;
+    /** Index of the track triangle hit by the last raycast, or -1. This
+     *  speeds up the next raycast, see TriangleMesh::castRayCached. */
+    int               m_last_triangle;
 
 public:
              TerrainInfo();
@@ -46,6 +46,7 @@
 #include "modes/linear_world.hpp"
 #include "modes/easter_egg_hunt.hpp"
 #include "modes/world.hpp"
+#include "physics/bvh_cache.hpp"
 #include "physics/physical_object.hpp"
 #include "physics/physics.hpp"
 #include "physics/triangle_mesh.hpp"
@@ -61,6 +62,7 @@
 #include "utils/log.hpp"
 #include "utils/string_utils.hpp"
 #include "utils/translation.hpp"
+#include "utils/worker_pool.hpp"
 
 #include <IBillboardTextSceneNode.h>
 #include <ILightSceneNode.h>
@@ -72,6 +74,8 @@
 #include <iostream>
 #include <stdexcept>
 #include <sstream>
+#include <stdio.h>
+#include <string.h>
 
 using namespace irr;
 
@@ -231,6 +235,7 @@ void Track::cleanup()
 
     delete m_track_mesh;
     m_track_mesh = NULL;
+    m_height_map.clear();
 
     delete m_gfx_effect_mesh;
     m_gfx_effect_mesh = NULL;
@@ -587,8 +592,11 @@ void Track::mapPoint2MiniMap(const Vec3 &xyz, Vec3 *draw_at) const
  *  \param main_track_count The number of meshes that are already converted
  *         when the main track was converted. Only the additional meshes
  *         added later still need to be converted.
+ *  \param reverse_track True if the track is driven in reverse. The BVH of
+ *         the track is cached separately for both directions.
  */
-void Track::createPhysicsModel(unsigned int main_track_count)
+void Track::createPhysicsModel(unsigned int main_track_count,
+                               bool reverse_track)
 {
     // Remove the temporary track rigid body, and then convert all objects
     // (i.e. the track and all additional objects) into a new rigid body
@@ -611,8 +619,16 @@ void Track::createPhysicsModel(unsigned int main_track_count)
     {
         convertTrackToBullet(m_all_nodes[i]);
     }
-    m_track_mesh->createPhysicalBody();
+    std::string bvh_cache_file =
+        BvhCache::getFilename(m_ident, reverse_track,
+                              stk_config->m_quantized_bvh);
+    m_track_mesh->createPhysicalBody((btCollisionObject::CollisionFlags)0,
+                                     bvh_cache_file);
+    m_track_mesh->buildAdjacency();
     m_gfx_effect_mesh->createCollisionShape();
+    if(UserConfigParams::m_bvh_benchmark>0)
+        m_track_mesh->benchmarkBvh(m_ident,
+                                   UserConfigParams::m_bvh_benchmark);
 }   // createPhysicsModel
 
 // -----------------------------------------------------------------------------
@@ -1648,7 +1664,7 @@ void Track::loadTrackModel(bool reverse_track, unsigned int mode_id)
     }
 
 
-    createPhysicsModel(main_track_count);
+    createPhysicsModel(main_track_count, reverse_track);
 
 
     for (unsigned int i=0; i<root->getNumNodes(); i++)
@@ -2146,42 +2162,172 @@ bool Track::setTerrainHeight(Vec3 *pos) const
 
 // ----------------------------------------------------------------------------
 
-std::vector< std::vector<float> > Track::buildHeightMap()
+namespace
 {
-    std::vector< std::vector<float> > out(HEIGHT_MAP_RESOLUTION);
+    /** Must be increased whenever the height map file format changes. */
+    const uint32_t HEIGHT_MAP_VERSION = 1;
+
+    /** Header of a height map cache file, followed by the heights. */
+    struct HeightMapHeader
+    {
+        char     m_magic[8];
+        uint32_t m_version;
+        uint32_t m_resolution;
+        uint64_t m_hash;
+        float    m_aabb[6];
+    };   // HeightMapHeader
+
+    const char HEIGHT_MAP_MAGIC[8] = {'S', 'T', 'K', 'H', 'M', 'A', 'P', 0};
+
+    // ------------------------------------------------------------------------
+    /** Computes one row of the height map per task. */
+    class HeightMapJob : public WorkerPool::Job
+    {
+    public:
+        const TriangleMesh *m_mesh;
+        float              *m_heights;
+        Vec3                m_aabb_min;
+        float               m_x_step, m_z_step;
+        // --------------------------------------------------------------------
+        virtual void runTask(unsigned int i)
+        {
+            const float x = m_aabb_min.getX() + i*m_x_step;
+            // Neighbouring points mostly hit the same or adjacent
+            // triangles, which castRayCached takes advantage of.
+            int last_triangle = -1;
+            for (int j=0; j<HEIGHT_MAP_RESOLUTION; j++)
+            {
+                btVector3 pos(x, 100.0f, m_aabb_min.getZ() + j*m_z_step);
+                btVector3 to = pos;
+                to.setY(-100000.f);
+
+                btVector3 hitpoint;
+                const Material* material;
+                btVector3 normal;
+                float height = m_aabb_min.getY();
+                if(m_mesh->castRayCached(pos, to, &last_triangle, &hitpoint,
+                                         &material, &normal))
+                    height = hitpoint.getY();
+                m_heights[i*HEIGHT_MAP_RESOLUTION+j] = height;
+            }   // j<HEIGHT_MAP_RESOLUTION
+        }   // runTask
+    };   // HeightMapJob
+}   // namespace
 
-    float x = m_aabb_min.getX();
-    const float x_len = m_aabb_max.getX() - m_aabb_min.getX();
-    const float z_len = m_aabb_max.getZ() - m_aabb_min.getZ();
+// ----------------------------------------------------------------------------
+/** Returns the height map of this track, which is used for the collision
+ *  of weather particles with the track. It is computed once per track and
+ *  cached on disk, so all callers share the same data.
+ */
+const std::vector<float>& Track::getHeightMap()
+{
+    if(!m_height_map.empty())
+        return m_height_map;
 
-    const float x_step = x_len/HEIGHT_MAP_RESOLUTION;
-    const float z_step = z_len/HEIGHT_MAP_RESOLUTION;
+    std::string filename =
+        file_manager->getCachedTrackFile(m_ident + ".heightmap");
+    uint64_t hash = BvhCache::computeHash(*m_track_mesh);
+    if(loadHeightMap(filename, hash))
+        return m_height_map;
 
-    btVector3 hitpoint;
-    const Material* material;
-    btVector3 normal;
+    buildHeightMap();
+    saveHeightMap(filename, hash);
+    return m_height_map;
+}   // getHeightMap
 
-    for (int i=0; i<HEIGHT_MAP_RESOLUTION; i++)
-    {
-        out[i].resize(HEIGHT_MAP_RESOLUTION);
-        float z = m_aabb_min.getZ();
+// ----------------------------------------------------------------------------
+/** Computes the height map by casting a ray downwards at each point of the
+ *  grid. The rows are computed in parallel.
+ */
+void Track::buildHeightMap()
+{
+    m_height_map.resize(HEIGHT_MAP_RESOLUTION*HEIGHT_MAP_RESOLUTION);
 
-        for (int j=0; j<HEIGHT_MAP_RESOLUTION; j++)
-        {
-            btVector3 pos(x, 100.0f, z);
-            btVector3 to = pos;
-            to.setY(-100000.f);
+    HeightMapJob job;
+    job.m_mesh     = m_track_mesh;
+    job.m_heights  = &m_height_map[0];
+    job.m_aabb_min = m_aabb_min;
+    job.m_x_step   = (m_aabb_max.getX() - m_aabb_min.getX())
+                   / HEIGHT_MAP_RESOLUTION;
+    job.m_z_step   = (m_aabb_max.getZ() - m_aabb_min.getZ())
+                   / HEIGHT_MAP_RESOLUTION;
+
+    WorkerPool pool(WorkerPool::getNumberOfCores()-1);
+    pool.run(&job, HEIGHT_MAP_RESOLUTION);
+}   // buildHeightMap
 
-            m_track_mesh->castRay(pos, to, &hitpoint, &material, &normal);
-            z += z_step;
+// ----------------------------------------------------------------------------
+/** Loads the height map from a cache file.
+ *  \param filename Name of the cache file.
+ *  \param hash Hash of the track mesh, see BvhCache::computeHash.
+ *  \return True if the file exists and matches this track.
+ */
+bool Track::loadHeightMap(const std::string &filename, uint64_t hash)
+{
+    FILE *file = fopen(filename.c_str(), "rb");
+    if(!file)
+        return false;
 
-            out[i][j] = hitpoint.getY();
-        }   // j<HEIGHT_MAP_RESOLUTION
-        x += x_step;
+    HeightMapHeader header;
+    bool ok = fread(&header, sizeof(header), 1, file) == 1  &&
+        memcmp(header.m_magic, HEIGHT_MAP_MAGIC, sizeof(header.m_magic))==0 &&
+        header.m_version    == HEIGHT_MAP_VERSION           &&
+        header.m_resolution == (uint32_t)HEIGHT_MAP_RESOLUTION &&
+        header.m_hash       == hash                         &&
+        header.m_aabb[0] == m_aabb_min.getX() &&
+        header.m_aabb[1] == m_aabb_min.getY() &&
+        header.m_aabb[2] == m_aabb_min.getZ() &&
+        header.m_aabb[3] == m_aabb_max.getX() &&
+        header.m_aabb[4] == m_aabb_max.getY() &&
+        header.m_aabb[5] == m_aabb_max.getZ();
+    if(ok)
+    {
+        m_height_map.resize(HEIGHT_MAP_RESOLUTION*HEIGHT_MAP_RESOLUTION);
+        ok = fread(&m_height_map[0], sizeof(float), m_height_map.size(),
+                   file) == m_height_map.size();
+        if(!ok)
+            m_height_map.clear();
     }
+    fclose(file);
+    return ok;
+}   // loadHeightMap
 
-    return out;
-}
+// ----------------------------------------------------------------------------
+/** Saves the height map to a cache file.
+ *  \param filename Name of the cache file.
+ *  \param hash Hash of the track mesh, see BvhCache::computeHash.
+ */
+void Track::saveHeightMap(const std::string &filename, uint64_t hash) const
+{
+    HeightMapHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.m_magic, HEIGHT_MAP_MAGIC, sizeof(header.m_magic));
+    header.m_version    = HEIGHT_MAP_VERSION;
+    header.m_resolution = HEIGHT_MAP_RESOLUTION;
+    header.m_hash       = hash;
+    header.m_aabb[0]    = m_aabb_min.getX();
+    header.m_aabb[1]    = m_aabb_min.getY();
+    header.m_aabb[2]    = m_aabb_min.getZ();
+    header.m_aabb[3]    = m_aabb_max.getX();
+    header.m_aabb[4]    = m_aabb_max.getY();
+    header.m_aabb[5]    = m_aabb_max.getZ();
+
+    FILE *file = fopen(filename.c_str(), "wb");
+    bool ok = file != NULL;
+    if(file)
+    {
+        ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+             fwrite(&m_height_map[0], sizeof(float), m_height_map.size(),
+                    file) == m_height_map.size();
+        ok = fclose(file)==0 && ok;
+    }
+    if(!ok)
+    {
+        Log::warn("track", "Can not write height map '%s'.",
+                  filename.c_str());
+        file_manager->removeFile(filename);
+    }
+}   // saveHeightMap
 
 // ----------------------------------------------------------------------------
 /** Returns the rotation of the sun. */
@@ -44,6 +44,7 @@ class LodNodeLoader;
 #include "tracks/quad_graph.hpp"
 #include "utils/aligned_array.hpp"
 #include "utils/translation.hpp"
+#include "utils/types.hpp"
 #include "utils/vec3.hpp"
 #include "utils/ptr_vector.hpp"
 
@@ -232,6 +233,10 @@ private:
      *  allowing the kart to drive in/partly under water), but the
      *  actual surface position is needed for the water splash effect. */
     TriangleMesh*            m_gfx_effect_mesh;
+    /** Height of the track on a regular grid of HEIGHT_MAP_RESOLUTION^2
+     *  points covering the track, point (i,j) is stored at index
+     *  i*HEIGHT_MAP_RESOLUTION+j. Empty until getHeightMap is called. */
+    std::vector<float>       m_height_map;
     /** Minimum coordinates of this track. */
     Vec3                     m_aabb_min;
     /** Maximum coordinates of this track. */
@@ -401,6 +406,9 @@ private:
                              std::vector<MusicInformation*>& m_music   );
     void loadCurves(const XMLNode &node);
     void handleSky(const XMLNode &root, const std::string &filename);
+    void buildHeightMap();
+    bool loadHeightMap(const std::string &filename, uint64_t hash);
+    void saveHeightMap(const std::string &filename, uint64_t hash) const;
     void loadObjects(const XMLNode* root, const std::string& path, LodNodeLoader& lod_loader,
                      bool create_lod_definitions, scene::ISceneNode* parent,
                      std::map<std::string, XMLNode*>& library_nodes);
@@ -419,7 +427,8 @@ public:
     void               startMusic        () const;
 
     bool               setTerrainHeight(Vec3 *pos) const;
-    void               createPhysicsModel(unsigned int main_track_count);
+    void               createPhysicsModel(unsigned int main_track_count,
+                                          bool reverse_track);
     void               update(float dt);
     void               reset();
     void               adjustForFog(scene::ISceneNode *node);
@@ -437,7 +446,7 @@ public:
                                         unsigned int mode_id=0);
     bool findGround(AbstractKart *kart);
 
-    std::vector< std::vector<float> > buildHeightMap();
+    const std::vector<float>& getHeightMap();
     // ------------------------------------------------------------------------
     /** Returns the texture with the mini map for this track. */
     const video::ITexture*    getMiniMap    () const { return m_mini_map; }
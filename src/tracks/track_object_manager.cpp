@@ -85,6 +85,52 @@ void TrackObjectManager::reset()
     }
 }   // reset
 
+// ----------------------------------------------------------------------------
+/** Saves the state of all physical track objects (see World::saveState).
+ *  Animated objects are not saved.
+ *  \param buffer The snapshot buffer to write to.
+ */
+void TrackObjectManager::saveState(SnapshotBuffer *buffer) const
+{
+    unsigned int num_physical = 0;
+    const TrackObject* curr;
+    for_in (curr, m_all_objects)
+    {
+        if(curr->getPhysicalObject())
+            num_physical++;
+    }
+    buffer->add(num_physical);
+    for_in (curr, m_all_objects)
+    {
+        if(curr->getPhysicalObject())
+            curr->getPhysicalObject()->saveState(buffer);
+    }
+}   // saveState
+
+// ----------------------------------------------------------------------------
+/** Restores the state of all physical track objects. During a race objects
+ *  are only added at the end (e.g. the tires in a battle), so only the
+ *  objects that existed when the state was saved are restored. The game
+ *  mode that added the other objects must remove them.
+ *  \param buffer The snapshot buffer to read from.
+ */
+void TrackObjectManager::restoreState(SnapshotBuffer *buffer)
+{
+    unsigned int num_physical;
+    buffer->get(&num_physical);
+    TrackObject* curr;
+    for_in (curr, m_all_objects)
+    {
+        if(num_physical==0) break;
+        if(curr->getPhysicalObject())
+        {
+            curr->getPhysicalObject()->restoreState(buffer);
+            num_physical--;
+        }
+    }
+    assert(num_physical==0);
+}   // restoreState
+
 // ----------------------------------------------------------------------------
 /** Handles an explosion, i.e. it makes sure that all physical objects are
  *  affected accordingly.
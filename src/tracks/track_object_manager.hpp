@@ -23,6 +23,7 @@
 #include "tracks/track_object.hpp"
 #include "utils/ptr_vector.hpp"
 
+class SnapshotBuffer;
 class Track;
 class Vec3;
 class XMLNode;
@@ -55,6 +56,8 @@ public:
                          bool secondary_hits=true);
     void reset();
     void init();
+    void saveState(SnapshotBuffer *buffer) const;
+    void restoreState(SnapshotBuffer *buffer);
 
     /** Enable or disable fog on objects */
     void enableFog(bool enable);
@@ -42,6 +42,9 @@ namespace Debug {
         GUI events would be blocked while in a race... */
 static bool g_debug_menu_visible = false;
 
+/** Id of the last snapshot taken with the debug menu. */
+static int g_snapshot_id = -1;
+
 // -----------------------------------------------------------------------------
 // Commands for the debug menu
 enum DebugMenuCommand
@@ -63,6 +66,8 @@ enum DebugMenuCommand
     DEBUG_FPS,
     DEBUG_SAVE_REPLAY,
     DEBUG_SAVE_HISTORY,
+    DEBUG_TAKE_SNAPSHOT,
+    DEBUG_RESTORE_SNAPSHOT,
     DEBUG_POWERUP_BOWLING,
     DEBUG_POWERUP_BUBBLEGUM,
     DEBUG_POWERUP_CAKE,
@@ -185,6 +190,8 @@ bool onEvent(const SEvent &event)
             mnu->addItem(L"FPS",DEBUG_FPS);
             mnu->addItem(L"Save replay", DEBUG_SAVE_REPLAY);
             mnu->addItem(L"Save history", DEBUG_SAVE_HISTORY);
+            mnu->addItem(L"Take snapshot", DEBUG_TAKE_SNAPSHOT);
+            mnu->addItem(L"Restore snapshot", DEBUG_RESTORE_SNAPSHOT);
             mnu->addItem(L"Toggle GUI", DEBUG_TOGGLE_GUI);
 
 
@@ -321,6 +328,18 @@ bool onEvent(const SEvent &event)
                 {
                     history->Save();
                 }
+                else if (cmdID == DEBUG_TAKE_SNAPSHOT)
+                {
+                    World* world = World::getWorld();
+                    if (world == NULL) return false;
+                    g_snapshot_id = world->takeSnapshot();
+                }
+                else if (cmdID == DEBUG_RESTORE_SNAPSHOT)
+                {
+                    World* world = World::getWorld();
+                    if (world == NULL) return false;
+                    world->restoreSnapshot(g_snapshot_id);
+                }
                 else if (cmdID == DEBUG_POWERUP_BOWLING)
                 {
                     addPowerup(PowerupManager::POWERUP_BOWLING);
@@ -0,0 +1,131 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2014 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef HEADER_MPSC_QUEUE_HPP
+#define HEADER_MPSC_QUEUE_HPP
+
+#include "utils/no_copy.hpp"
+
+#include <stddef.h>
+
+#ifdef WIN32
+#  define WIN32_LEAN_AND_MEAN
+#  define _WINSOCKAPI_
+#  include <windows.h>
+#endif
+
+/** A lock-free, unbounded queue of pointers that can be filled by any
+ *  number of threads, but must only be emptied by a single thread.
+ *  A push is a single atomic exchange and never blocks, so a producer
+ *  (e.g. the network listening thread) is never delayed by the consumer.
+ *  The queue does not take ownership of the objects: any objects still
+ *  queued when the queue is destroyed must be removed by the caller first.
+ *  Based on the non-intrusive MPSC node queue by Dmitry Vyukov.
+ */
+template<typename TYPE>
+class MPSCQueue : public NoCopy
+{
+private:
+    struct Node
+    {
+        Node * volatile m_next;
+        TYPE           *m_data;
+    };
+
+    /** The most recently added node, modified by the producers. */
+    Node * volatile m_head;
+
+    /** A dummy node preceding the oldest element, only accessed by the
+     *  consumer. */
+    Node           *m_tail;
+
+    // ------------------------------------------------------------------------
+    /** Full memory barrier. */
+    static void memoryBarrier()
+    {
+#ifdef WIN32
+        MemoryBarrier();
+#else
+        __sync_synchronize();
+#endif
+    }   // memoryBarrier
+    // ------------------------------------------------------------------------
+    /** Atomically replaces m_head with node and returns the old value. */
+    Node* exchangeHead(Node *node)
+    {
+#ifdef WIN32
+        return (Node*)InterlockedExchangePointer((PVOID volatile*)&m_head,
+                                                 node);
+#else
+        // __sync_lock_test_and_set is only an acquire barrier, so make
+        // sure the node content is visible before it is published.
+        __sync_synchronize();
+        return __sync_lock_test_and_set(&m_head, node);
+#endif
+    }   // exchangeHead
+
+public:
+    // ------------------------------------------------------------------------
+    MPSCQueue()
+    {
+        Node *stub   = new Node();
+        stub->m_next = NULL;
+        stub->m_data = NULL;
+        m_head       = stub;
+        m_tail       = stub;
+    }   // MPSCQueue
+    // ------------------------------------------------------------------------
+    /** Frees the internal nodes. The queue should be empty. */
+    ~MPSCQueue()
+    {
+        while (pop()) {}
+        delete m_tail;
+    }   // ~MPSCQueue
+    // ------------------------------------------------------------------------
+    /** Adds an element to the queue. Can be called from any thread. */
+    void push(TYPE *data)
+    {
+        Node *node   = new Node();
+        node->m_next = NULL;
+        node->m_data = data;
+        Node *prev   = exchangeHead(node);
+        memoryBarrier();
+        prev->m_next = node;
+    }   // push
+    // ------------------------------------------------------------------------
+    /** Removes the oldest element from the queue and returns it, or returns
+     *  NULL if the queue is empty. Must only be called from the consumer
+     *  thread. An element whose push has not completed yet might not be
+     *  returned, so a producer should wake up the consumer after pushing.
+     */
+    TYPE* pop()
+    {
+        Node *tail = m_tail;
+        Node *next = tail->m_next;
+        if (!next)
+            return NULL;
+        memoryBarrier();
+        TYPE *data   = next->m_data;
+        next->m_data = NULL;
+        m_tail       = next;
+        delete tail;
+        return data;
+    }   // pop
+};   // MPSCQueue
+
+#endif
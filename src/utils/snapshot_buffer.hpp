@@ -0,0 +1,189 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2014 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef HEADER_SNAPSHOT_BUFFER_HPP
+#define HEADER_SNAPSHOT_BUFFER_HPP
+
+#include "utils/no_copy.hpp"
+
+#include <assert.h>
+#include <string.h>
+#include <vector>
+
+/** \brief A buffer that stores a copy of the simulation state.
+ *  Objects append their state with add() and read it back in the same
+ *  order with get(). Only plain data (numbers, bullet vectors and
+ *  transforms, arrays of those) must be stored, the bytes are copied as
+ *  they are. The memory of the buffer is kept when it is cleared, so once
+ *  it is large enough, saving a state does not allocate memory.
+ *  A snapshot is only valid in the process that created it (it is not
+ *  meant to be stored or sent over the network).
+ * \ingroup utils
+ */
+class SnapshotBuffer
+{
+private:
+    /** The data, its size is the capacity of the buffer. */
+    std::vector<char> m_data;
+
+    /** Number of bytes written. */
+    unsigned int      m_size;
+
+    /** Position of the next get. */
+    unsigned int      m_read_pos;
+
+public:
+    SnapshotBuffer() : m_size(0), m_read_pos(0) {}
+    // ------------------------------------------------------------------------
+    /** Removes all data, but keeps the memory. */
+    void clear() { m_size = 0; m_read_pos = 0; }
+    // ------------------------------------------------------------------------
+    /** Starts reading again at the beginning of the buffer. */
+    void rewind() { m_read_pos = 0; }
+    // ------------------------------------------------------------------------
+    /** Makes sure that at least n bytes can be stored without allocating
+     *  memory. */
+    void reserve(unsigned int n) { if(n > m_data.size()) m_data.resize(n); }
+    // ------------------------------------------------------------------------
+    /** Returns the number of bytes stored. */
+    unsigned int getSize() const { return m_size; }
+    // ------------------------------------------------------------------------
+    /** Appends n bytes. */
+    void addBytes(const void *data, unsigned int n)
+    {
+        if(m_size + n > m_data.size())
+            m_data.resize(2*(m_size + n));
+        memcpy(&m_data[m_size], data, n);
+        m_size += n;
+    }   // addBytes
+    // ------------------------------------------------------------------------
+    /** Reads n bytes. */
+    void getBytes(void *data, unsigned int n)
+    {
+        assert(m_read_pos + n <= m_size);
+        memcpy(data, &m_data[m_read_pos], n);
+        m_read_pos += n;
+    }   // getBytes
+    // ------------------------------------------------------------------------
+    /** Appends a value. */
+    template<typename T>
+    void add(const T &value) { addBytes(&value, sizeof(T)); }
+    // ------------------------------------------------------------------------
+    /** Reads a value that was stored with add. */
+    template<typename T>
+    void get(T *value) { getBytes(value, sizeof(T)); }
+    // ------------------------------------------------------------------------
+    /** Appends an array of n values. */
+    template<typename T>
+    void addArray(const T *values, unsigned int n)
+    {
+        if(n>0) addBytes(values, n*sizeof(T));
+    }   // addArray
+    // ------------------------------------------------------------------------
+    /** Reads an array of n values that was stored with addArray. */
+    template<typename T>
+    void getArray(T *values, unsigned int n)
+    {
+        if(n>0) getBytes(values, n*sizeof(T));
+    }   // getArray
+    // ------------------------------------------------------------------------
+    /** Appends the size and the elements of a vector. */
+    template<typename T>
+    void addVector(const std::vector<T> &values)
+    {
+        add((unsigned int)values.size());
+        if(!values.empty()) addArray(&values[0], values.size());
+    }   // addVector
+    // ------------------------------------------------------------------------
+    /** Reads a vector that was stored with addVector. The vector is only
+     *  resized (which might allocate memory) if its size differs. */
+    template<typename T>
+    void getVector(std::vector<T> *values)
+    {
+        unsigned int n;
+        get(&n);
+        values->resize(n);
+        if(n>0) getArray(&(*values)[0], n);
+    }   // getVector
+};   // SnapshotBuffer
+
+// ============================================================================
+/** \brief A ring of snapshot buffers. Each snapshot gets an increasing id,
+ *  and once all buffers are used the oldest snapshot is overwritten. The
+ *  buffers are allocated once and keep their memory, so taking snapshots
+ *  does not allocate memory (unless the state grows).
+ * \ingroup utils
+ */
+class SnapshotRing : public NoCopy
+{
+private:
+    /** The buffers. */
+    std::vector<SnapshotBuffer> m_buffers;
+
+    /** The id of the snapshot stored in each buffer, -1 if none. */
+    std::vector<int>            m_ids;
+
+    /** The id of the next snapshot. */
+    int                         m_next_id;
+
+public:
+    /** Creates a ring with the given number of buffers. */
+    SnapshotRing(unsigned int num_buffers)
+        : m_buffers(num_buffers), m_ids(num_buffers, -1), m_next_id(0) {}
+    // ------------------------------------------------------------------------
+    /** Removes all snapshots, but keeps the memory of the buffers. */
+    void clear()
+    {
+        for(unsigned int i=0; i<m_ids.size(); i++)
+            m_ids[i] = -1;
+    }   // clear
+    // ------------------------------------------------------------------------
+    /** Makes sure that each buffer can store n bytes without allocating
+     *  memory. */
+    void reserve(unsigned int n)
+    {
+        for(unsigned int i=0; i<m_buffers.size(); i++)
+            m_buffers[i].reserve(n);
+    }   // reserve
+    // ------------------------------------------------------------------------
+    /** Returns the (cleared) buffer for a new snapshot, overwriting the
+     *  oldest snapshot.
+     *  \param id On return the id of the new snapshot. */
+    SnapshotBuffer* newSnapshot(int *id)
+    {
+        unsigned int n = m_next_id % m_buffers.size();
+        *id            = m_next_id++;
+        m_ids[n]       = *id;
+        m_buffers[n].clear();
+        return &m_buffers[n];
+    }   // newSnapshot
+    // ------------------------------------------------------------------------
+    /** Returns the snapshot with the given id (ready for reading), or NULL
+     *  if it was overwritten or does not exist. */
+    SnapshotBuffer* getSnapshot(int id)
+    {
+        if(id<0) return NULL;
+        unsigned int n = id % m_buffers.size();
+        if(m_ids[n]!=id) return NULL;
+        m_buffers[n].rewind();
+        return &m_buffers[n];
+    }   // getSnapshot
+};   // SnapshotRing
+
+#endif
+/* EOF */
@@ -28,9 +28,12 @@
 #else
 #  include <stdint.h>
 #  include <sys/time.h>
+#  include <time.h>
 #  include <unistd.h>
 #endif
 
+#include "utils/types.hpp"
+
 #include <string>
 #include <stdio.h>
 
@@ -81,6 +84,52 @@ public:
 #endif
     };   // getTimeSinceEpoch
 
+    // ------------------------------------------------------------------------
+    /** Returns the number of microseconds since 1.1.1970. Unlike
+     *  getRealTime() this does not depend on the irrlicht device, so it can
+     *  be used from any thread (e.g. for timeouts and network timestamps).
+     */
+    static uint64_t getMicrosecondsSinceEpoch()
+    {
+#ifdef WIN32
+        FILETIME ft;
+        GetSystemTimeAsFileTime(&ft);
+        ULARGE_INTEGER t;
+        t.LowPart  = ft.dwLowDateTime;
+        t.HighPart = ft.dwHighDateTime;
+        // 100ns intervals since 1.1.1601 to microseconds since 1.1.1970
+        return t.QuadPart/10 - 11644473600000000ULL;
+#else
+        struct timeval tv;
+        gettimeofday(&tv, NULL);
+        return (uint64_t)tv.tv_sec*1000000 + tv.tv_usec;
+#endif
+    }   // getMicrosecondsSinceEpoch
+
+    // ------------------------------------------------------------------------
+    /** Returns a monotonic time stamp in nanoseconds (from an arbitrary
+     *  starting point). This is meant for measuring short durations, e.g.
+     *  in benchmarks, and can be used from any thread.
+     */
+    static uint64_t getMonoTimeNs()
+    {
+#ifdef WIN32
+        static LARGE_INTEGER frequency = {0};
+        if(frequency.QuadPart==0)
+            QueryPerformanceFrequency(&frequency);
+        LARGE_INTEGER counter;
+        QueryPerformanceCounter(&counter);
+        return (uint64_t)((double)counter.QuadPart*1.0e9
+                          / (double)frequency.QuadPart);
+#elif defined(__APPLE__)
+        return getMicrosecondsSinceEpoch()*1000;
+#else
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint64_t)ts.tv_sec*1000000000 + ts.tv_nsec;
+#endif
+    }   // getMonoTimeNs
+
     // ------------------------------------------------------------------------
     /** Returns a time based on an arbitrary 'epoch' (e.g. could be start
      *  time of the application, 1.1.1970, ...).
@@ -0,0 +1,158 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2014 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#include "utils/worker_pool.hpp"
+
+#include "utils/log.hpp"
+
+#ifdef WIN32
+#  define WIN32_LEAN_AND_MEAN
+#  include <windows.h>
+#else
+#  include <unistd.h>
+#endif
+
+/** Creates the worker threads.
+ *  \param num_threads Number of worker threads. With 0 threads all tasks
+ *         are executed by the thread calling run().
+ */
+WorkerPool::WorkerPool(unsigned int num_threads)
+{
+    pthread_mutex_init(&m_mutex, NULL);
+    pthread_cond_init(&m_job_started, NULL);
+    pthread_cond_init(&m_job_done, NULL);
+    m_job        = NULL;
+    m_num_tasks  = 0;
+    m_next_task  = 0;
+    m_tasks_done = 0;
+    m_abort      = false;
+
+    for(unsigned int i=0; i<num_threads; i++)
+    {
+        pthread_t thread;
+        if(pthread_create(&thread, NULL, &WorkerPool::threadFunction, this))
+        {
+            Log::warn("WorkerPool", "Could only create %d of %d threads.",
+                      i, num_threads);
+            break;
+        }
+        m_threads.push_back(thread);
+    }
+}   // WorkerPool
+
+// ----------------------------------------------------------------------------
+/** Stops and joins all worker threads. */
+WorkerPool::~WorkerPool()
+{
+    pthread_mutex_lock(&m_mutex);
+    m_abort = true;
+    pthread_cond_broadcast(&m_job_started);
+    pthread_mutex_unlock(&m_mutex);
+
+    for(unsigned int i=0; i<m_threads.size(); i++)
+        pthread_join(m_threads[i], NULL);
+
+    pthread_cond_destroy(&m_job_done);
+    pthread_cond_destroy(&m_job_started);
+    pthread_mutex_destroy(&m_mutex);
+}   // ~WorkerPool
+
+// ----------------------------------------------------------------------------
+/** Returns the number of processor cores of this computer (at least 1). */
+unsigned int WorkerPool::getNumberOfCores()
+{
+#ifdef WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    long n = info.dwNumberOfProcessors;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    return n > 0 ? (unsigned int)n : 1;
+}   // getNumberOfCores
+
+// ----------------------------------------------------------------------------
+/** Executes tasks of the current job until no task is left. Must be called
+ *  with m_mutex locked, which is unlocked while a task is executed.
+ *  \return True if this thread finished the last task of the job.
+ */
+bool WorkerPool::runTasks()
+{
+    bool finished_last = false;
+    while(m_job && m_next_task < m_num_tasks)
+    {
+        unsigned int task = m_next_task++;
+        Job *job = m_job;
+        pthread_mutex_unlock(&m_mutex);
+        job->runTask(task);
+        pthread_mutex_lock(&m_mutex);
+        m_tasks_done++;
+        if(m_tasks_done==m_num_tasks)
+            finished_last = true;
+    }
+    return finished_last;
+}   // runTasks
+
+// ----------------------------------------------------------------------------
+/** The main function of a worker thread: waits for a job and executes its
+ *  tasks. */
+void* WorkerPool::threadFunction(void *data)
+{
+    WorkerPool *pool = (WorkerPool*)data;
+    pthread_mutex_lock(&pool->m_mutex);
+    while(!pool->m_abort)
+    {
+        if(pool->m_job && pool->m_next_task < pool->m_num_tasks)
+        {
+            if(pool->runTasks())
+                pthread_cond_signal(&pool->m_job_done);
+        }
+        else
+            pthread_cond_wait(&pool->m_job_started, &pool->m_mutex);
+    }
+    pthread_mutex_unlock(&pool->m_mutex);
+    return NULL;
+}   // threadFunction
+
+// ----------------------------------------------------------------------------
+/** Executes all tasks of a job, and returns once all of them are done. The
+ *  calling thread executes tasks as well.
+ *  \param job The job to execute.
+ *  \param num_tasks Number of tasks; runTask is called once for each task
+ *         index from 0 to num_tasks-1.
+ */
+void WorkerPool::run(Job *job, unsigned int num_tasks)
+{
+    if(num_tasks==0)
+        return;
+    pthread_mutex_lock(&m_mutex);
+    m_job        = job;
+    m_num_tasks  = num_tasks;
+    m_next_task  = 0;
+    m_tasks_done = 0;
+    if(m_threads.size()>0)
+        pthread_cond_broadcast(&m_job_started);
+
+    runTasks();
+    while(m_tasks_done < m_num_tasks)
+        pthread_cond_wait(&m_job_done, &m_mutex);
+    m_job = NULL;
+    pthread_mutex_unlock(&m_mutex);
+}   // run
+
+/* EOF */
@@ -0,0 +1,89 @@
+//
+//  SuperTuxKart - a fun racing game with go-kart
+//  Copyright (C) 2014 SuperTuxKart-Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+#ifndef HEADER_WORKER_POOL_HPP
+#define HEADER_WORKER_POOL_HPP
+
+#include "utils/no_copy.hpp"
+
+#include <pthread.h>
+#include <vector>
+
+/** A set of threads that execute the tasks of a job in parallel. A job is
+ *  split into a number of independent tasks (e.g. one per row of a height
+ *  map), which are distributed to the worker threads and to the thread
+ *  calling run(). run() returns once all tasks are done, so a job can use
+ *  data on the stack of the caller.
+ *  Only one thread must call run() at a time.
+ */
+class WorkerPool : public NoCopy
+{
+public:
+    /** The interface for a job. runTask is called from different threads
+     *  at the same time, each time with a different task index. */
+    class Job
+    {
+    public:
+        virtual      ~Job() {}
+        virtual void runTask(unsigned int task) = 0;
+    };   // Job
+
+private:
+    /** The worker threads. */
+    std::vector<pthread_t> m_threads;
+
+    /** Protects all following variables. */
+    pthread_mutex_t m_mutex;
+
+    /** Signalled when a new job is started or the pool is destroyed. */
+    pthread_cond_t  m_job_started;
+
+    /** Signalled when the last task of a job is done. */
+    pthread_cond_t  m_job_done;
+
+    /** The current job, NULL if there is none. */
+    Job            *m_job;
+
+    /** Number of tasks of the current job. */
+    unsigned int    m_num_tasks;
+
+    /** Index of the next task to be started. */
+    unsigned int    m_next_task;
+
+    /** Number of tasks which are done. */
+    unsigned int    m_tasks_done;
+
+    /** Set when the pool is destroyed to stop the threads. */
+    bool            m_abort;
+
+    bool runTasks();
+    static void* threadFunction(void *data);
+
+public:
+                 WorkerPool(unsigned int num_threads);
+                ~WorkerPool();
+    void         run(Job *job, unsigned int num_tasks);
+    static unsigned int getNumberOfCores();
+    // ------------------------------------------------------------------------
+    /** Returns the number of worker threads (not counting the thread that
+     *  calls run). */
+    unsigned int getNumThreads() const { return m_threads.size(); }
+};   // WorkerPool
+
+#endif
+/* EOF */
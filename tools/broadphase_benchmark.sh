@@ -0,0 +1,32 @@
+#!/bin/sh
+#
+# Compares the physics broadphases (axis-sweep and dbvt) in a projectile
+# heavy race. The AI races on one track without graphics, and a fixed
+# number of cakes, bowling balls and rubber balls is kept on the track at
+# all times. The broadphase statistics printed at the end of the profile
+# run (average time per step and average number of overlapping pairs)
+# are collected for each broadphase.
+#
+# Usage: broadphase_benchmark.sh [track] [projectiles] [seconds]
+# Environment:
+#   STK     Path to the supertuxkart executable
+#           (default: cmake_build/bin/supertuxkart).
+#   KARTS   Number of karts (default: 8).
+
+TRACK=${1:-lighthouse}
+NUM_PROJECTILES=${2:-50}
+RACE_SECONDS=${3:-60}
+STK=${STK:-cmake_build/bin/supertuxkart}
+KARTS=${KARTS:-8}
+
+if [ ! -x "$STK" ]; then
+    echo "Can not find the supertuxkart executable '$STK', set STK."
+    exit 1
+fi
+
+for broadphase in axis-sweep dbvt; do
+    "$STK" --no-graphics --track="$TRACK" --numkarts=$KARTS \
+           --profile-time=$RACE_SECONDS \
+           --profile-projectiles=$NUM_PROJECTILES --broadphase=$broadphase \
+           2>&1 | grep -E "^(Broadphase|Number of frames)"
+done
@@ -0,0 +1,33 @@
+#!/bin/sh
+#
+# Compares the memory usage and raycast performance of the track BVH with
+# and without quantized AABB compression on all race tracks. Each track is
+# loaded without graphics, raced by the AI for one second, and the output of
+# --benchmark-bvh is collected.
+#
+# Usage: bvh_benchmark.sh [number of rays]
+# Environment:
+#   STK     Path to the supertuxkart executable
+#           (default: cmake_build/bin/supertuxkart).
+#   TRACKS  Directory containing the tracks (default: data/tracks).
+
+NUM_RAYS=${1:-100000}
+STK=${STK:-cmake_build/bin/supertuxkart}
+TRACKS=${TRACKS:-data/tracks}
+
+if [ ! -x "$STK" ]; then
+    echo "Can not find the supertuxkart executable '$STK', set STK."
+    exit 1
+fi
+
+for dir in "$TRACKS"/*/; do
+    track=$(basename "$dir")
+    [ -f "$dir/track.xml" ] || continue
+    # Arenas, soccer fields and cutscenes can not be used in a normal race.
+    if grep -q -E '(arena|soccer|cutscene|internal)="(Y|y|true)"' \
+            "$dir/track.xml"; then
+        continue
+    fi
+    "$STK" --no-graphics --track="$track" --numkarts=1 --profile-time=1 \
+           --benchmark-bvh=$NUM_RAYS 2>&1 | grep "BVH benchmark"
+done
@@ -0,0 +1,155 @@
+#!/usr/bin/env python
+#
+#  SuperTuxKart - a fun racing game with go-kart
+#  Copyright (C) 2014 SuperTuxKart-Team
+#
+#  This program is free software; you can redistribute it and/or
+#  modify it under the terms of the GNU General Public License
+#  as published by the Free Software Foundation; either version 3
+#  of the License, or (at your option) any later version.
+#
+#  This program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program; if not, write to the Free Software
+#  Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+"""Prints the content of a packet capture file written by STK (see
+src/network/packet_capture.hpp), with the messages of each packet grouped
+by protocol type.
+
+Usage: decode_packet_capture.py [--summary] [--hex] capture.stkcap
+  --summary  Only print the number of messages and bytes per protocol type.
+  --hex      Also print the bytes of each message.
+"""
+
+import struct
+import sys
+
+MAGIC = b"STKCAP01"
+RECORD_HEADER = struct.Struct("!QBIHIH")
+
+CAPTURE_INCOMING = 1
+CAPTURE_RAW      = 2
+
+# Must match PacketBatch::BATCH_MARKER
+BATCH_MARKER = 0xff
+
+# Must match PROTOCOL_TYPE in src/network/protocol.hpp
+PROTOCOL_NAMES = {
+    0: "NONE",
+    1: "CONNECTION",
+    2: "LOBBY_ROOM",
+    3: "START_GAME",
+    4: "SYNCHRONIZATION",
+    5: "KART_UPDATE",
+    6: "GAME_EVENTS",
+    7: "CONTROLLER_EVENTS",
+}
+
+
+def protocol_name(protocol_type):
+    return PROTOCOL_NAMES.get(protocol_type, "UNKNOWN(%d)" % protocol_type)
+
+
+def read_records(f):
+    """Yields (time, flags, address, port, size, data) for each packet."""
+    while True:
+        header = f.read(RECORD_HEADER.size)
+        if len(header) < RECORD_HEADER.size:
+            return
+        time, flags, address, port, size, captured = RECORD_HEADER.unpack(header)
+        data = bytearray(f.read(captured))
+        if len(data) < captured:
+            return
+        yield time, flags, address, port, size, data
+
+
+def split_messages(data):
+    """Returns the messages of an ENet packet, unpacking framed packets."""
+    if len(data) == 0 or data[0] != BATCH_MARKER:
+        return [data]
+    messages = []
+    pos = 1
+    while pos + 2 <= len(data):
+        size = (data[pos] << 8) | data[pos + 1]
+        pos += 2
+        messages.append(data[pos:pos + size])
+        pos += size
+    return messages
+
+
+def format_address(address, port):
+    if address == 0 and port == 0:
+        return "broadcast"
+    return "%d.%d.%d.%d:%d" % ((address >> 24) & 0xff, (address >> 16) & 0xff,
+                               (address >> 8) & 0xff, address & 0xff, port)
+
+
+def main(argv):
+    summary_only = "--summary" in argv
+    show_hex     = "--hex" in argv
+    files = [a for a in argv[1:] if not a.startswith("--")]
+    if len(files) != 1:
+        sys.stderr.write(__doc__)
+        return 1
+
+    f = open(files[0], "rb")
+    if f.read(len(MAGIC)) != MAGIC:
+        sys.stderr.write("%s is not a packet capture file.\n" % files[0])
+        return 1
+
+    # protocol name -> [messages in, bytes in, messages out, bytes out]
+    stats = {}
+    start = None
+    packets = 0
+    for time, flags, address, port, size, data in read_records(f):
+        packets += 1
+        if start is None:
+            start = time
+        incoming = flags & CAPTURE_INCOMING
+        if flags & CAPTURE_RAW:
+            messages = [None]
+        else:
+            messages = split_messages(data)
+
+        if not summary_only:
+            truncated = " (truncated)" if len(data) < size else ""
+            print("%12.6f %s %-21s %5d bytes%s%s"
+                  % ((time - start) / 1000000.0, "<--" if incoming else "-->",
+                     format_address(address, port), size,
+                     " raw" if flags & CAPTURE_RAW else "", truncated))
+
+        for message in messages:
+            if message is None:
+                name, length = "RAW", len(data)
+            elif len(message) == 0:
+                name, length = "EMPTY", 0
+            else:
+                name, length = protocol_name(message[0]), len(message)
+            entry = stats.setdefault(name, [0, 0, 0, 0])
+            index = 0 if incoming else 2
+            entry[index] += 1
+            entry[index + 1] += length
+            if not summary_only and message is not None:
+                line = "             %-18s %5d bytes" % (name, length)
+                if show_hex:
+                    line += "  " + " ".join("%02x" % b for b in message)
+                print(line)
+
+    print("")
+    print("%d packets" % packets)
+    print("%-18s %10s %10s %10s %10s" % ("protocol", "msgs in", "bytes in",
+                                         "msgs out", "bytes out"))
+    for name in sorted(stats):
+        entry = stats[name]
+        print("%-18s %10d %10d %10d %10d" % (name, entry[0], entry[1],
+                                             entry[2], entry[3]))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
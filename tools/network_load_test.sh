@@ -0,0 +1,77 @@
+#!/bin/sh
+#
+# Starts a LAN server and a number of bot clients on this computer, runs
+# the kart selection and one race, and prints the statistics reported by
+# the server (tick time, event queue size, bandwidth per peer).
+# No online account and no access to the addons server are needed: the
+# server is started with --lan-server, and the bots connect directly to
+# it over loopback with --connect-to.
+#
+# Usage: network_load_test.sh [number of bots] [race seconds]
+# Environment:
+#   STK       Path to the supertuxkart executable
+#             (default: cmake_build/bin/supertuxkart).
+#   OUT       Directory for the logs (default: network_load_test).
+#   INTERVAL  Seconds between two statistics reports (default: 5).
+#
+# Note that the bots use the player profile of the local configuration, so
+# the game must have been started once to create it. Each process runs in
+# its own directory of $OUT, so that packet captures don't collide.
+
+NUM_BOTS=${1:-4}
+RACE_SECONDS=${2:-60}
+STK=${STK:-cmake_build/bin/supertuxkart}
+OUT=${OUT:-network_load_test}
+INTERVAL=${INTERVAL:-5}
+
+case "$STK" in
+    /*) ;;
+    *) STK="$(pwd)/$STK" ;;
+esac
+
+if [ ! -x "$STK" ]; then
+    echo "Can not find the supertuxkart executable '$STK', set STK."
+    exit 1
+fi
+
+rm -rf "$OUT"
+mkdir -p "$OUT/server"
+
+# The server reads its commands from stdin, use a fifo to send them.
+FIFO="$OUT/server/commands"
+mkfifo "$FIFO"
+(cd "$OUT/server" && exec "$STK" --server --lan-server --no-graphics \
+     --max-players=$NUM_BOTS --network-stats=$INTERVAL \
+     < commands > server.log 2>&1) &
+SERVER_PID=$!
+exec 3> "$FIFO"
+sleep 5
+
+echo "Starting $NUM_BOTS bots."
+BOT_PIDS=""
+i=1
+while [ $i -le $NUM_BOTS ]; do
+    mkdir -p "$OUT/bot$i"
+    (cd "$OUT/bot$i" && exec "$STK" --no-graphics --network-bot=$i \
+         --connect-to=127.0.0.1:7321 < /dev/null > bot.log 2>&1) &
+    BOT_PIDS="$BOT_PIDS $!"
+    i=$((i + 1))
+done
+sleep 10
+
+echo "Starting the kart selection."
+echo "selection" >&3
+sleep 5
+
+echo "Starting the race for $RACE_SECONDS seconds."
+echo "start" >&3
+sleep $RACE_SECONDS
+
+echo "quit" >&3
+exec 3>&-
+sleep 2
+kill $BOT_PIDS $SERVER_PID 2> /dev/null
+wait 2> /dev/null
+
+echo "Server statistics (all logs are in $OUT):"
+grep "NetworkStatistics" "$OUT/server/server.log"
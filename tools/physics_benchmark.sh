@@ -0,0 +1,27 @@
+#!/bin/sh
+#
+# Runs the headless kart physics benchmark: all karts are driven with
+# scripted controls on one track without graphics, and only the physics is
+# updated. The time per kart and step spent in the main btKart functions
+# and the number of steps per second are written as JSON, which can be
+# compared between commits.
+#
+# Usage: physics_benchmark.sh [track] [karts] [steps] [output file]
+# Environment:
+#   STK     Path to the supertuxkart executable
+#           (default: cmake_build/bin/supertuxkart).
+
+TRACK=${1:-lighthouse}
+KARTS=${2:-8}
+STEPS=${3:-10000}
+OUTPUT=${4:-physics_benchmark.json}
+STK=${STK:-cmake_build/bin/supertuxkart}
+
+if [ ! -x "$STK" ]; then
+    echo "Can not find the supertuxkart executable '$STK', set STK."
+    exit 1
+fi
+
+"$STK" --no-graphics --track="$TRACK" --numkarts=$KARTS \
+       --benchmark-physics=$STEPS --benchmark-output="$OUTPUT" \
+    && cat "$OUTPUT"